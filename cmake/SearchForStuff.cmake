@@ -131,3 +131,7 @@ else()
   set(IGN_MATH_VER ${ignition-math6_VERSION_MAJOR})
   message(STATUS "Looking for ignition-math${IGN_MATH_VER}-config.cmake - found")
 endif()
+
+########################################
+# Find the threads library, used to read included files in parallel
+find_package(Threads REQUIRED)
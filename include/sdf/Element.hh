@@ -18,13 +18,18 @@
 #define SDF_ELEMENT_HH_
 
 #include <any>
+#include <cstddef>
+#include <iterator>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "sdf/InternedString.hh"
 #include "sdf/Param.hh"
 #include "sdf/sdf_config.h"
 #include "sdf/system_util.hh"
@@ -63,6 +68,100 @@ namespace sdf
   /// \addtogroup sdf
   /// \{
 
+  /// \class ElementRange Element.hh sdf/sdf.hh
+  /// \brief A range over the child elements of an Element, optionally
+  /// restricted to the children with a given name. See Element::Children().
+  ///
+  /// The range refers to the children of the Element it was created from,
+  /// and is invalidated when children are added to or removed from it.
+  class SDFORMAT_VISIBLE ElementRange
+  {
+    /// \brief Forward iterator over the elements in a range.
+    public: class SDFORMAT_VISIBLE Iterator
+    {
+      /// \brief Iterator category.
+      public: using iterator_category = std::forward_iterator_tag;
+
+      /// \brief Type of the elements.
+      public: using value_type = ElementPtr;
+
+      /// \brief Type of the difference between iterators.
+      public: using difference_type = std::ptrdiff_t;
+
+      /// \brief Pointer to an element.
+      public: using pointer = const ElementPtr *;
+
+      /// \brief Reference to an element.
+      public: using reference = const ElementPtr &;
+
+      /// \brief Constructor.
+      /// \param[in] _range Range to iterate over.
+      /// \param[in] _index Index of the first child element to consider.
+      public: Iterator(const ElementRange *_range, std::size_t _index);
+
+      /// \brief Get the current element.
+      /// \return The current element.
+      public: reference operator*() const;
+
+      /// \brief Get a pointer to the current element.
+      /// \return Pointer to the current element.
+      public: pointer operator->() const;
+
+      /// \brief Advance to the next element in the range.
+      /// \return This iterator.
+      public: Iterator &operator++();
+
+      /// \brief Advance to the next element in the range.
+      /// \return A copy of this iterator before it was advanced.
+      public: Iterator operator++(int);
+
+      /// \brief Equality operator.
+      /// \param[in] _other Iterator to compare with.
+      /// \return True if both iterators point at the same position.
+      public: bool operator==(const Iterator &_other) const;
+
+      /// \brief Inequality operator.
+      /// \param[in] _other Iterator to compare with.
+      /// \return True if the iterators point at different positions.
+      public: bool operator!=(const Iterator &_other) const;
+
+      /// \brief Move forward to the first element at or after the current
+      /// position that is part of the range.
+      private: void SkipToMatch();
+
+      /// \brief The range being iterated over.
+      private: const ElementRange *range;
+
+      /// \brief Index of the current element in the child elements.
+      private: std::size_t index;
+    };
+
+    /// \brief Constructor.
+    /// \param[in] _elements Child elements of an Element.
+    /// \param[in] _name Only include elements with this name, or all
+    /// elements if empty.
+    public: ElementRange(const std::pmr::vector<ElementPtr> &_elements,
+                         const std::string &_name);
+
+    /// \brief Get an iterator to the first element in the range.
+    /// \return Iterator to the first element.
+    public: Iterator begin() const;
+
+    /// \brief Get an iterator past the last element in the range.
+    /// \return Iterator past the last element.
+    public: Iterator end() const;
+
+    /// \brief Check whether the range has no elements.
+    /// \return True if there are no elements in the range.
+    public: bool empty() const;
+
+    /// \brief Child elements of an Element.
+    private: const std::pmr::vector<ElementPtr> *elements;
+
+    /// \brief Name of the elements in the range, empty for all elements.
+    private: std::string name;
+  };
+
   /// \class Element Element.hh sdf/sdf.hh
   /// \brief SDF Element class
   class SDFORMAT_VISIBLE Element :
@@ -78,6 +177,17 @@ namespace sdf
     /// \return A copy of this Element.
     public: ElementPtr Clone() const;
 
+    /// \brief Create a copy of this Element that shares its element
+    /// descriptions with this Element.
+    ///
+    /// Clone() recursively copies every element description below this
+    /// Element. This function only copies the attributes, the value and
+    /// the child elements, while the element descriptions are shared by
+    /// reference. It is intended for creating elements from a description
+    /// when parsing. The shared descriptions must be treated as read-only.
+    /// \return A copy of this Element with shared element descriptions.
+    public: ElementPtr CloneWithSharedDescriptions() const;
+
     /// \brief Copy values from an Element.
     /// \param[in] _elem Element to copy value from.
     public: void Copy(const ElementPtr _elem);
@@ -293,8 +403,21 @@ namespace sdf
     /// This can be used in combination with GetFirstElement() to walk the SDF
     /// tree. First call parent->GetFirstElement() to get the first child. Call
     /// child = child->GetNextElement() to iterate through the children.
+    /// Iterating over all children this way takes linear time in the number
+    /// of children. Children() is a more convenient alternative.
     public: ElementPtr GetNextElement(const std::string &_name = "") const;
 
+    /// \brief Get a range over the child elements of this element, for use
+    /// in a range-based for loop:
+    ///
+    ///     for (const sdf::ElementPtr &model : world->Children("model"))
+    ///
+    /// \param[in] _name Only include child elements with this name, or all
+    /// child elements if empty.
+    /// \return Range over the child elements. It is invalidated when child
+    /// elements are added to or removed from this element.
+    public: ElementRange Children(const std::string &_name = "") const;
+
     /// \brief Get set of child element type names.
     /// \return A set of the names of the child elements.
     public: std::set<std::string> GetElementTypeNames() const;
@@ -414,6 +537,43 @@ namespace sdf
     private: void PrintValuesImpl(const std::string &_prefix,
                                   std::ostringstream &_out) const;
 
+    /// \brief Find a child element without copying its shared pointer.
+    /// \param[in] _name Name of the child element.
+    /// \return Pointer to the child element in the children of this
+    /// element, or nullptr if there is none. It is invalidated when child
+    /// elements are added or removed.
+    private: const ElementPtr *FindElement(const std::string &_name) const;
+
+    /// \brief Find an attribute without copying its shared pointer.
+    /// \param[in] _key Key of the attribute.
+    /// \return Pointer to the attribute in the attributes of this element,
+    /// or nullptr if there is none. It is invalidated when attributes are
+    /// added.
+    private: const ParamPtr *FindAttribute(const std::string &_key) const;
+
+    /// \brief Find an element description without copying its shared
+    /// pointer.
+    /// \param[in] _name Name of the element description.
+    /// \return Pointer to the description in the descriptions of this
+    /// element, or nullptr if there is none. It is invalidated when
+    /// descriptions are added.
+    private: const ElementPtr *FindElementDescription(
+                 const std::string &_name) const;
+
+    /// \brief Append a child element and update the element index.
+    /// \param[in] _elem The child element.
+    private: void PushElement(ElementPtr _elem);
+
+    /// \brief Rebuild the element index after child elements were removed
+    /// or renamed.
+    private: void RebuildElementIndex();
+
+    /// \brief Create a copy of this Element.
+    /// \param[in] _shareDescriptions True to share the element descriptions
+    /// with this Element, false to copy them.
+    /// \return A copy of this Element.
+    private: ElementPtr CloneImpl(const bool _shareDescriptions) const;
+
     /// \brief Create a new Param object and return it.
     /// \param[in] _key Key for the parameter.
     /// \param[in] _type String name for the value type (double,
@@ -430,21 +590,39 @@ namespace sdf
 
 
     /// \brief Private data pointer
-    private: std::unique_ptr<ElementPrivate> dataPtr;
+    private: std::unique_ptr<ElementPrivate, ArenaDeleter<ElementPrivate>>
+        dataPtr;
+
+    /// \brief Reads and writes the private data in the binary format of
+    /// SDF::WriteBinary.
+    friend class ElementSerializer;
+
+    /// \brief Replaces the child elements of worlds that changed when a file
+    /// is read again.
+    friend class IncrementalReader;
   };
 
   /// \internal
   /// \brief Private data for Element
   class ElementPrivate
   {
+    /// \brief Constructor.
+    /// \param[in] _resource Memory resource of the containers, which is
+    /// the arena of the document when the element is placed in one.
+    public: explicit ElementPrivate(std::pmr::memory_resource *_resource)
+      : attributes(_resource), elements(_resource),
+        elementDescriptions(_resource), elementIndex(_resource)
+    {
+    }
+
     /// \brief Element name
-    public: std::string name;
+    public: InternedString name;
 
     /// \brief True if element is required
-    public: std::string required;
+    public: InternedString required;
 
     /// \brief Element description
-    public: std::string description;
+    public: InternedString description;
 
     /// \brief True if element's children should be copied.
     public: bool copyChildren;
@@ -452,29 +630,66 @@ namespace sdf
     /// \brief Element's parent
     public: ElementWeakPtr parent;
 
+    /// \def ParamVector
+    /// \brief Vector of parameters, allocated from the memory resource of
+    /// the element.
+    public: typedef std::pmr::vector<ParamPtr> ParamVector;
+
+    /// \def ElementVector
+    /// \brief Vector of elements, allocated from the memory resource of the
+    /// element.
+    public: typedef std::pmr::vector<ElementPtr> ElementVector;
+
     // Attributes of this element
-    public: Param_V attributes;
+    public: ParamVector attributes;
 
     // Value of this element
     public: ParamPtr value;
 
     // The existing child elements
-    public: ElementPtr_V elements;
+    public: ElementVector elements;
 
     // The possible child elements
-    public: ElementPtr_V elementDescriptions;
+    public: ElementVector elementDescriptions;
+
+    /// \def NameIndex
+    /// \brief Map from a name to the position of the first entry with
+    /// that name in a vector.
+    public: typedef std::pmr::unordered_map<std::string, std::size_t>
+        NameIndex;
+
+    /// \brief Position of the first child element with each name in
+    /// elements.
+    public: NameIndex elementIndex;
+
+    /// \brief Position of this element in the elements of its parent when
+    /// it was inserted. It is only a hint, because the element may have been
+    /// moved or removed since, and must be checked before it is used.
+    public: std::size_t positionInParent = 0;
+
+    /// \brief Position of each key in attributes. The index may be shared
+    /// with clones of this element, and is copied before it is modified.
+    public: std::shared_ptr<NameIndex> attributeIndex;
+
+    /// \brief Position of the first description with each name in
+    /// elementDescriptions. The index may be shared with clones of this
+    /// element, and is copied before it is modified.
+    public: std::shared_ptr<NameIndex> elementDescriptionIndex;
 
-    /// name of the include file that was used to create this element
-    public: std::string includeFilename;
+    /// name of the include file that was used to create this element. It
+    /// is shared with the clones of this element, and null if there is none.
+    public: std::shared_ptr<const std::string> includeFilename;
 
     /// \brief Name of reference sdf.
-    public: std::string referenceSDF;
+    public: InternedString referenceSDF;
 
-    /// \brief Path to file where this element came from
-    public: std::string path;
+    /// \brief Path to file where this element came from. It is shared with
+    /// the clones and the child elements of this element, and null if there
+    /// is none.
+    public: std::shared_ptr<const std::string> path;
 
     /// \brief Spec version that this was originally parsed from.
-    public: std::string originalVersion;
+    public: InternedString originalVersion;
   };
 
   ///////////////////////////////////////////////
@@ -512,18 +727,17 @@ namespace sdf
     }
     else if (!_key.empty())
     {
-      ParamPtr param = this->GetAttribute(_key);
-      if (param)
+      if (const ParamPtr *param = this->FindAttribute(_key))
       {
-        param->Get(result.first);
+        (*param)->Get(result.first);
       }
-      else if (this->HasElement(_key))
+      else if (const ElementPtr *elem = this->FindElement(_key))
       {
-        result.first = this->GetElementImpl(_key)->Get<T>();
+        result.first = (*elem)->Get<T>();
       }
-      else if (this->HasElementDescription(_key))
+      else if (const ElementPtr *desc = this->FindElementDescription(_key))
       {
-        result.first = this->GetElementDescription(_key)->Get<T>();
+        result.first = (*desc)->Get<T>();
       }
       else
       {
@@ -131,6 +131,9 @@ namespace sdf
 
     /// \brief Indicates that reading an SDF string failed.
     STRING_READ,
+
+    /// \brief Indicates that writing a file failed.
+    FILE_WRITE,
   };
 
   class SDFORMAT_VISIBLE Error
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_INTERNEDSTRING_HH_
+#define SDF_INTERNEDSTRING_HH_
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "sdf/sdf_config.h"
+#include "sdf/system_util.hh"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \class InternedString InternedString.hh sdf/sdf.hh
+  /// \brief A handle to a string stored once in a process-wide string pool.
+  ///
+  /// Element names, attribute keys, type names and descriptions repeat
+  /// across every node of a parsed document. An InternedString holds a
+  /// single pointer to the pooled copy of its value, so copying one does
+  /// not allocate, and two InternedStrings are equal exactly when they
+  /// point at the same pooled string.
+  ///
+  /// Strings are added to the pool on construction or assignment from a
+  /// std::string, which is thread-safe. Pooled strings are never released,
+  /// so values that are unbounded, such as user data, should be created
+  /// with Lookup instead, which does not add them to the pool.
+  class SDFORMAT_VISIBLE InternedString
+  {
+    /// \brief Constructor for the empty string.
+    public: InternedString();
+
+    /// \brief Constructor.
+    /// \param[in] _str Value of the string, which is added to the pool if
+    /// it is not there yet.
+    public: InternedString(const std::string &_str);
+
+    /// \brief Constructor.
+    /// \param[in] _str Value of the string, which is added to the pool if
+    /// it is not there yet.
+    public: InternedString(const char *_str);
+
+    /// \brief Assign a new value.
+    /// \param[in] _str New value, which is added to the pool if it is not
+    /// there yet.
+    /// \return Reference to this object.
+    public: InternedString &operator=(const std::string &_str);
+
+    /// \brief Assign a new value.
+    /// \param[in] _str New value, which is added to the pool if it is not
+    /// there yet.
+    /// \return Reference to this object.
+    public: InternedString &operator=(const char *_str);
+
+    /// \brief Get the value.
+    /// \return Reference to the pooled string, which stays valid for the
+    /// lifetime of the process.
+    public: const std::string &Str() const
+    {
+      return *this->str;
+    }
+
+    /// \brief Get the value as a string view.
+    /// \return View of the pooled string.
+    public: std::string_view View() const
+    {
+      return *this->str;
+    }
+
+    /// \brief Implicit conversion to the pooled string.
+    /// \return Reference to the pooled string.
+    public: operator const std::string &() const
+    {
+      return *this->str;
+    }
+
+    /// \brief Check whether the string is empty.
+    /// \return True if the string is empty.
+    public: bool empty() const
+    {
+      return this->str->empty();
+    }
+
+    /// \brief Set the value to the empty string.
+    public: void clear();
+
+    /// \brief Get a string without adding it to the pool.
+    /// \param[in] _str Value of the string.
+    /// \return The pooled string if the pool has the value, or else a copy
+    /// that is not pooled. Copies of it share its storage, which is
+    /// released with the last of them.
+    public: static InternedString Lookup(const std::string &_str);
+
+    /// \brief Compare with another interned string. This only compares
+    /// pointers, unless one of the strings is not pooled.
+    /// \param[in] _other String to compare with.
+    /// \return True if the strings are equal.
+    public: bool operator==(const InternedString &_other) const
+    {
+      return this->str == _other.str ||
+          ((this->owned || _other.owned) && *this->str == *_other.str);
+    }
+
+    /// \brief Compare with another interned string. This only compares
+    /// pointers, unless one of the strings is not pooled.
+    /// \param[in] _other String to compare with.
+    /// \return True if the strings are not equal.
+    public: bool operator!=(const InternedString &_other) const
+    {
+      return !(*this == _other);
+    }
+
+    /// \brief Compare with a string.
+    /// \param[in] _other String to compare with.
+    /// \return True if the strings are equal.
+    public: bool operator==(const std::string &_other) const
+    {
+      return *this->str == _other;
+    }
+
+    /// \brief Compare with a string.
+    /// \param[in] _other String to compare with.
+    /// \return True if the strings are not equal.
+    public: bool operator!=(const std::string &_other) const
+    {
+      return *this->str != _other;
+    }
+
+    /// \brief Compare with a string.
+    /// \param[in] _other String to compare with.
+    /// \return True if the strings are equal.
+    public: bool operator==(const char *_other) const
+    {
+      return *this->str == _other;
+    }
+
+    /// \brief Compare with a string.
+    /// \param[in] _other String to compare with.
+    /// \return True if the strings are not equal.
+    public: bool operator!=(const char *_other) const
+    {
+      return *this->str != _other;
+    }
+
+    /// \brief Compare a string with an interned string.
+    /// \param[in] _str String to compare.
+    /// \param[in] _interned Interned string to compare.
+    /// \return True if the strings are equal.
+    public: friend bool operator==(const std::string &_str,
+                                   const InternedString &_interned)
+    {
+      return _interned == _str;
+    }
+
+    /// \brief Compare a string with an interned string.
+    /// \param[in] _str String to compare.
+    /// \param[in] _interned Interned string to compare.
+    /// \return True if the strings are not equal.
+    public: friend bool operator!=(const std::string &_str,
+                                   const InternedString &_interned)
+    {
+      return _interned != _str;
+    }
+
+    /// \brief Stream insertion operator.
+    /// \param[out] _out The output stream.
+    /// \param[in] _str The string to output.
+    /// \return The output stream.
+    public: friend std::ostream &operator<<(std::ostream &_out,
+                                            const InternedString &_str)
+    {
+      return _out << _str.Str();
+    }
+
+    /// \brief Get the number of distinct strings in the pool.
+    /// \return Number of pooled strings.
+    public: static std::size_t PoolSize();
+
+    /// \brief Pointer to the pooled string, or to owned.
+    private: const std::string *str;
+
+    /// \brief The string if it is not pooled, or else null.
+    private: std::shared_ptr<const std::string> owned;
+  };
+  }
+}
+#endif
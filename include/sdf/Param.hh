@@ -27,12 +27,14 @@
 #include <sstream>
 #include <string>
 #include <typeinfo>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include <ignition/math.hh>
 
 #include "sdf/Console.hh"
+#include "sdf/InternedString.hh"
 #include "sdf/sdf_config.h"
 #include "sdf/system_util.hh"
 #include "sdf/Types.hh"
@@ -63,6 +65,40 @@ namespace sdf
   /// \internal
   class ParamPrivate;
 
+  /// \internal
+  class ParseArena;
+
+  /// \internal
+  /// \brief Deleter of the private data of elements and parameters, which
+  /// may be placed in the arena of a document. It holds a reference to the
+  /// arena, so that the arena outlives the data.
+  template<typename T>
+  class ArenaDeleter
+  {
+    /// \brief Constructor for data on the heap.
+    public: ArenaDeleter() = default;
+
+    /// \brief Constructor for data in an arena.
+    /// \param[in] _arena The arena.
+    public: explicit ArenaDeleter(std::shared_ptr<ParseArena> _arena)
+      : arena(std::move(_arena))
+    {
+    }
+
+    /// \brief Destroy the data. Memory in an arena is freed with the arena.
+    /// \param[in] _data The data.
+    public: void operator()(T *_data) const
+    {
+      if (this->arena)
+        _data->~T();
+      else
+        delete _data;
+    }
+
+    /// \brief The arena of the data, or null if it is on the heap.
+    private: std::shared_ptr<ParseArena> arena;
+  };
+
   template<class T>
   struct ParamStreamer
   {
@@ -211,12 +247,24 @@ namespace sdf
       return _out;
     }
 
+    /// \brief Private constructor used by Clone(), which copies an already
+    /// parsed value instead of converting it to and from a string.
+    private: Param();
+
     /// \brief Private method to set the Element from a passed-in string.
     /// \param[in] _value Value to set the parameter to.
     private: bool ValueFromString(const std::string &_value);
 
     /// \brief Private data
-    private: std::unique_ptr<ParamPrivate> dataPtr;
+    private: std::unique_ptr<ParamPrivate, ArenaDeleter<ParamPrivate>>
+        dataPtr;
+
+    /// \brief Reads and writes the private data in the binary format of
+    /// SDF::WriteBinary.
+    friend class ElementSerializer;
+
+    /// \brief Creates parameters in the arena of a document.
+    friend class ParseArena;
   };
 
   /// \internal
@@ -224,7 +272,7 @@ namespace sdf
   class ParamPrivate
   {
     /// \brief Key value
-    public: std::string key;
+    public: InternedString key;
 
     /// \brief True if the parameter is required.
     public: bool required;
@@ -233,14 +281,39 @@ namespace sdf
     public: bool set;
 
     //// \brief Name of the type.
-    public: std::string typeName;
+    public: InternedString typeName;
 
     /// \brief Description of the parameter.
-    public: std::string description;
+    public: InternedString description;
 
     /// \brief Update function pointer.
     public: std::function<std::any ()> updateFunc;
 
+    /// \brief Types of value that a parameter can hold.
+    public: enum class ValueType
+    {
+      UNKNOWN,
+      BOOL,
+      CHAR,
+      STRING,
+      INT,
+      UINT64,
+      UNSIGNED_INT,
+      DOUBLE,
+      FLOAT,
+      TIME,
+      COLOR,
+      VECTOR2I,
+      VECTOR2D,
+      VECTOR3D,
+      POSE,
+      QUATERNION
+    };
+
+    /// \brief Type of the value, resolved from typeName when the parameter
+    /// is created so that parsing a value does not compare type names.
+    public: ValueType valueType = ValueType::UNKNOWN;
+
     /// \def ParamVariant
     /// \brief Variant type def.
     public: typedef std::variant<bool, char, std::string, int, std::uint64_t,
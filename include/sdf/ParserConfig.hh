@@ -0,0 +1,191 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_PARSERCONFIG_HH_
+#define SDF_PARSERCONFIG_HH_
+
+#include <string>
+
+#include <sdf/sdf_config.h>
+#include "sdf/system_util.hh"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+  // Forward declare private data class.
+  class ParserConfigPrivate;
+
+  /// \brief Options that control how a document is parsed, which can be
+  /// passed to sdf::readFile and sdf::Root::Load. A default constructed
+  /// ParserConfig parses like the functions that take no configuration.
+  class SDFORMAT_VISIBLE ParserConfig
+  {
+    /// \brief Constructor
+    public: ParserConfig();
+
+    /// \brief Copy constructor
+    /// \param[in] _config ParserConfig to copy.
+    public: ParserConfig(const ParserConfig &_config);
+
+    /// \brief Move constructor
+    /// \param[in] _config ParserConfig to move.
+    public: ParserConfig(ParserConfig &&_config) noexcept;
+
+    /// \brief Move assignment operator.
+    /// \param[in] _config ParserConfig to move.
+    /// \return Reference to this.
+    public: ParserConfig &operator=(ParserConfig &&_config);
+
+    /// \brief Destructor
+    public: ~ParserConfig();
+
+    /// \brief Assignment operator.
+    /// \param[in] _config The config to set values from.
+    /// \return *this
+    public: ParserConfig &operator=(const ParserConfig &_config);
+
+    /// \brief Get whether the files of the <include> elements of a parent
+    /// element are read in parallel.
+    /// \return True if includes are read in parallel. The default is false.
+    /// \sa void SetParallelIncludes(bool)
+    public: bool ParallelIncludes() const;
+
+    /// \brief Set whether the files of the <include> elements of a parent
+    /// element are read in parallel. URI resolution and parsing of each
+    /// included file run on a pool of worker threads, and the results are
+    /// inserted in document order, so the parsed document and the returned
+    /// errors are the same as when reading the includes one by one. Only
+    /// the order of messages written to the console may differ.
+    /// \param[in] _parallel True to read includes in parallel.
+    public: void SetParallelIncludes(const bool _parallel);
+
+    /// \brief Get the maximum number of threads, including the calling
+    /// thread, that read included files at once. The includes of a parent
+    /// element are shared among these threads, and the includes of the files
+    /// that they read are read serially by the thread that reads the file.
+    /// \return Number of threads. Zero, the default, uses the number of
+    /// hardware threads.
+    /// \sa void SetIncludeThreadCount(unsigned int)
+    public: unsigned int IncludeThreadCount() const;
+
+    /// \brief Set the maximum number of threads, including the calling
+    /// thread, that read included files at once. It has no effect unless
+    /// ParallelIncludes() is true.
+    /// \param[in] _count Number of threads, or zero to use the number of
+    /// hardware threads.
+    public: void SetIncludeThreadCount(const unsigned int _count);
+
+    /// \brief Get whether parsed included files are cached.
+    /// \return True if included files are cached. The default is false.
+    /// \sa void SetCacheIncludes(bool)
+    public: bool CacheIncludes() const;
+
+    /// \brief Set whether parsed included files are cached. The first
+    /// <include> of a file parses it and stores the result in a
+    /// process-wide cache, keyed by the canonical path of the file. Later
+    /// includes of the same file clone the cached result instead of parsing
+    /// the file again, as long as the modification time and size of the file
+    /// and of the files read to parse it, such as the files it includes
+    /// itself, are unchanged. The cache keeps the 256 most recently used
+    /// files, call sdf::clearIncludeCache() to release them.
+    /// \param[in] _cache True to cache included files.
+    /// \sa void sdf::clearIncludeCache()
+    public: void SetCacheIncludes(const bool _cache);
+
+    /// \brief Get the directory of compiled documents.
+    /// \return Path of the directory, or an empty string if documents are
+    /// not cached. The default is the value of the SDF_COMPILED_CACHE_PATH
+    /// environment variable, if it is set, which sdf::readFile and
+    /// sdf::Root::Load also use when they are given no configuration.
+    /// \sa void SetCompiledCacheDirectory(const std::string &)
+    public: const std::string &CompiledCacheDirectory() const;
+
+    /// \brief Set the directory of compiled documents, which can be shared
+    /// by processes that read the same files. sdf::readFile and
+    /// sdf::Root::Load look for the document in the directory first, and
+    /// read it in the binary format of SDF::WriteBinary if none of the
+    /// files read to parse it changed since it was stored. This skips XML
+    /// parsing, conversion and the reading of included files. Otherwise the
+    /// document is parsed and stored in the directory, unless parsing
+    /// reported errors.
+    ///
+    /// A document is stored under a hash of its path and contents, the
+    /// SDFormat version and the embedded specification and conversion
+    /// files. It is used while the files that were read to parse it have the
+    /// same contents, and the URIs of its includes resolve to the same
+    /// paths with the current search paths and find callback. Messages
+    /// written to the console while parsing are not repeated when a document
+    /// is read from the directory.
+    /// \param[in] _path Path of the directory, which is created if its
+    /// parent exists, or an empty string to not cache documents.
+    public: void SetCompiledCacheDirectory(const std::string &_path);
+
+    /// \brief Get whether sdf::Root::Load defers the construction of DOM
+    /// objects until they are accessed.
+    /// \return True if DOM objects are loaded lazily. The default is false.
+    /// \sa void SetLazyLoad(bool)
+    public: bool LazyLoad() const;
+
+    /// \brief Set whether sdf::Root::Load defers the construction of DOM
+    /// objects until they are accessed. The root then only checks the
+    /// version, and loads its worlds, models, lights and actors on the first
+    /// call to one of their accessors. A world loads its scalar properties,
+    /// physics, GUI and scene, and indexes its models by name. Each model is
+    /// loaded on its own when World::ModelByIndex or World::ModelByName
+    /// first returns it. The other models, the actors, lights and frames
+    /// and the frame graphs are loaded together on the first call to any
+    /// other of their accessors. Until then, the poses of the models that
+    /// were loaded on their own can't be resolved relative to the world,
+    /// and loading the rest of the world must not run concurrently with
+    /// the use of those models.
+    ///
+    /// Errors found while loading deferred objects are not returned by
+    /// Load, call Root::LazyLoadErrors() or World::LazyLoadErrors() to get
+    /// them. A world whose deferred objects have errors is kept, while an
+    /// eagerly loaded world with errors is skipped. Duplicate model names
+    /// are found without loading the models, and are returned by Load.
+    /// \param[in] _lazy True to load DOM objects lazily.
+    public: void SetLazyLoad(const bool _lazy);
+
+    /// \brief Get whether sdf::readFile and sdf::Root::Load allocate the
+    /// elements of a document in an arena.
+    /// \return True if an arena is used. The default is false.
+    /// \sa void SetUseParseArena(bool)
+    public: bool UseParseArena() const;
+
+    /// \brief Set whether sdf::readFile and sdf::Root::Load allocate the
+    /// elements and parameters of a document, with their reference counts,
+    /// their private data and its child, attribute and index containers,
+    /// in an arena owned by the SDF object they are read into. Allocation is
+    /// then a pointer increment, and the memory of all the elements is
+    /// released at once instead of one by one when the document is
+    /// destroyed. Elements keep the arena alive, so they can still outlive
+    /// the SDF object.
+    ///
+    /// The memory is only released when every element of the document is
+    /// released, so this suits documents that are read once and dropped as
+    /// a whole, rather than documents that are edited for a long time.
+    /// \param[in] _use True to use an arena.
+    public: void SetUseParseArena(const bool _use);
+
+    /// \brief Private data pointer.
+    private: ParserConfigPrivate *dataPtr = nullptr;
+  };
+  }
+}
+#endif
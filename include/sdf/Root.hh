@@ -18,7 +18,9 @@
 #define SDF_ROOT_HH_
 
 #include <string>
+#include <vector>
 
+#include "sdf/ParserConfig.hh"
 #include "sdf/SDFImpl.hh"
 #include "sdf/Types.hh"
 #include "sdf/sdf_config.h"
@@ -60,12 +62,24 @@ namespace sdf
     public: ~Root();
 
     /// \brief Parse the given SDF file, and generate objects based on types
-    /// specified in the SDF file.
+    /// specified in the SDF file. The file is parsed with a default
+    /// constructed ParserConfig, so compiled documents are cached in the
+    /// directory of the SDF_COMPILED_CACHE_PATH environment variable, if it
+    /// is set.
     /// \param[in] _filename Name of the SDF file to parse.
     /// \return Errors, which is a vector of Error objects. Each Error includes
     /// an error code and message. An empty vector indicates no error.
     public: Errors Load(const std::string &_filename);
 
+    /// \brief Parse the given SDF file with parser options, and generate
+    /// objects based on types specified in the SDF file.
+    /// \param[in] _filename Name of the SDF file to parse.
+    /// \param[in] _config Options that control how the file is parsed.
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    public: Errors Load(const std::string &_filename,
+                        const ParserConfig &_config);
+
     /// \brief Parse the given SDF string, and generate objects based on types
     /// specified in the SDF file.
     /// \param[in] _sdf SDF string to parse.
@@ -80,6 +94,33 @@ namespace sdf
     /// an error code and message. An empty vector indicates no error.
     public: Errors Load(const SDFPtr _sdf);
 
+    /// \brief Parse the given SDF pointer with parser options, and generate
+    /// objects based on types specified in the SDF file.
+    /// \param[in] _sdf SDF pointer to parse.
+    /// \param[in] _config Options, of which ParserConfig::LazyLoad() defers
+    /// generating the objects until they are accessed.
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    public: Errors Load(const SDFPtr _sdf, const ParserConfig &_config);
+
+    /// \brief Parse the given SDF file again after it was edited, and update
+    /// the objects that changed. When the models and includes at the top
+    /// level of the worlds are all that changed since the last call, only
+    /// those that changed are parsed and loaded again. Otherwise, as on the
+    /// first call, the whole file is parsed and loaded like Load does.
+    /// The objects are loaded eagerly, whatever ParserConfig::LazyLoad() is.
+    /// \param[in] _filename Name of the SDF file to parse.
+    /// \param[in] _config Options that control how the file is parsed, which
+    /// should not change between calls.
+    /// \param[out] _changed Scoped names, such as "world_name::model_name",
+    /// of the models of the worlds that were loaded again, added or removed.
+    /// All the models are listed when the whole file was loaded.
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    public: Errors Reload(const std::string &_filename,
+                          const ParserConfig &_config,
+                          std::vector<std::string> &_changed);
+
     /// \brief Get the SDF version specified in the parsed file or SDF
     /// pointer.
     /// \return SDF version string.
@@ -161,6 +202,13 @@ namespace sdf
     /// not been called.
     public: sdf::ElementPtr Element() const;
 
+    /// \brief Get the errors found while generating the objects whose
+    /// loading was deferred, by this object and its worlds.
+    /// \return Errors found so far. It is empty if nothing was deferred or
+    /// the deferred objects were not accessed yet.
+    /// \sa void ParserConfig::SetLazyLoad(bool)
+    public: Errors LazyLoadErrors() const;
+
     /// \brief Private data pointer
     private: RootPrivate *dataPtr = nullptr;
   };
@@ -17,6 +17,7 @@
 #ifndef SDFIMPL_HH_
 #define SDFIMPL_HH_
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
@@ -44,6 +45,7 @@ namespace sdf
 
   class SDFORMAT_VISIBLE SDF;
   class SDFPrivate;
+  class ParseArena;
 
   /// \def SDFPtr
   /// \brief Shared pointer to SDF
@@ -59,22 +61,48 @@ namespace sdf
   /// \param[in] _useCallback True to find a file based on a registered
   /// callback if the file is not found via the normal mechanism.
   /// \return File's full path.
+  /// \note Files that are found are cached, so later calls with the same
+  /// arguments don't search the file system again. The cache is cleared
+  /// when addURIPath, setFindCallback or SDF::Version(const std::string &)
+  /// is called, or when SDF_PATH or the current working directory changes.
+  /// Call clearFindFileCache() after moving or deleting files that were
+  /// found.
   SDFORMAT_VISIBLE
   std::string findFile(const std::string &_filename,
                        bool _searchLocalPath = true,
                        bool _useCallback = false);
 
+  /// \brief Remove all files from the cache of findFile, and reset its
+  /// counts.
+  SDFORMAT_VISIBLE
+  void clearFindFileCache();
+
+  /// \brief Get the number of findFile calls that were answered from the
+  /// cache since it was last cleared.
+  /// \return Number of cache hits.
+  SDFORMAT_VISIBLE
+  std::size_t findFileCacheHits();
+
+  /// \brief Get the number of file system lookups that the cache of
+  /// findFile avoided since it was last cleared.
+  /// \return Number of avoided lookups.
+  SDFORMAT_VISIBLE
+  std::size_t findFileStatsAvoided();
+
   /// \brief Associate paths to a URI.
   /// Example paramters: "model://", "/usr/share/models:~/.gazebo/models"
   /// \param[in] _uri URI that will be mapped to _path
   /// \param[in] _path Colon separated set of paths.
+  /// \note This must not be called while other threads are parsing.
   SDFORMAT_VISIBLE
   void addURIPath(const std::string &_uri, const std::string &_path);
 
   /// \brief Set the callback to use when SDF can't find a file.
   /// The callback should return a complete path to the requested file, or
   /// and empty string if the file was not found in the callback.
-  /// \param[in] _cb The callback function.
+  /// \param[in] _cb The callback function. It may be called from several
+  /// threads at once if files are parsed concurrently.
+  /// \note This must not be called while other threads are parsing.
   SDFORMAT_VISIBLE
   void setFindCallback(std::function<std::string (const std::string &)> _cb);
 
@@ -89,6 +117,19 @@ namespace sdf
     public: void PrintValues();
     public: void PrintDoc();
     public: void Write(const std::string &_filename);
+
+    /// \brief Write the parsed elements in a compact binary format, which
+    /// readBinary reads back without parsing XML. Element descriptions are
+    /// not written, so the file can only be read by the same SDFormat
+    /// version, on a machine with the same byte order.
+    /// \param[in] _filename Name of the file to write, such as
+    /// binaryCachePath(FilePath()) to store it next to the source.
+    /// \param[out] _errors Errors will be appended to this variable.
+    /// \return True if the file was written.
+    /// \sa readBinary
+    public: bool WriteBinary(const std::string &_filename,
+                             Errors &_errors) const;
+
     public: std::string ToString() const;
 
     /// \brief Set SDF values from a string
@@ -154,6 +195,9 @@ namespace sdf
     /// \brief Pointer to private data.
     private: std::unique_ptr<SDFPrivate> dataPtr;
 
+    /// \brief ParseArena creates the arena of an SDF object.
+    friend class ParseArena;
+
     /// \brief The SDF version. Set to SDF_VERSION by default, or through
     /// the Version function at runtime.
     private: static std::string version;
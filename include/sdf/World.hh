@@ -18,11 +18,13 @@
 #define SDF_WORLD_HH_
 
 #include <string>
+#include <vector>
 #include <ignition/math/Vector3.hh>
 
 #include "sdf/Atmosphere.hh"
 #include "sdf/Element.hh"
 #include "sdf/Gui.hh"
+#include "sdf/ParserConfig.hh"
 #include "sdf/Scene.hh"
 #include "sdf/Types.hh"
 #include "sdf/sdf_config.h"
@@ -76,6 +78,24 @@ namespace sdf
     /// an error code and message. An empty vector indicates no error.
     public: Errors Load(ElementPtr _sdf);
 
+    /// \brief Load the world based on a element pointer and parser options.
+    /// This is *not* the usual entry point. Typical usage of the SDF DOM is
+    /// through the Root object.
+    /// \param[in] _sdf The SDF Element pointer
+    /// \param[in] _config Options, of which ParserConfig::LazyLoad() defers
+    /// loading each model until it is accessed, and the actors, lights,
+    /// frames and frame graphs until one of their accessors is called.
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    public: Errors Load(ElementPtr _sdf, const ParserConfig &_config);
+
+    /// \brief Get the errors found while loading the models, actors, lights,
+    /// frames and frame graphs, if their loading was deferred.
+    /// \return Errors found so far. It is empty if nothing was deferred or
+    /// the deferred objects that were accessed have no errors.
+    /// \sa void ParserConfig::SetLazyLoad(bool)
+    public: Errors LazyLoadErrors() const;
+
     /// \brief Get the name of the world.
     /// \return Name of the world.
     public: std::string Name() const;
@@ -269,8 +289,29 @@ namespace sdf
     /// \return True if there exists a physics profile with the given name.
     public: bool PhysicsNameExists(const std::string &_name) const;
 
+    /// \brief Load the models, actors, lights, frames and graphs if their
+    /// loading was deferred.
+    private: void LoadDeferred() const;
+
+    /// \brief Build the frame graphs, after the models, actors, lights and
+    /// frames were loaded.
+    /// \return Errors found while building the graphs.
+    private: Errors BuildGraphs() const;
+
+    /// \brief Load the models, actors, lights, frames and graphs again after
+    /// the elements of some models of the world element were replaced. The
+    /// models whose elements were not replaced are kept.
+    /// \param[out] _changed Names of the models that were loaded again,
+    /// added or removed are appended to this list.
+    /// \return Errors found while loading. The errors of the models that were
+    /// kept are not reported again.
+    private: Errors ReloadModels(std::vector<std::string> &_changed);
+
     /// \brief Private data pointer.
     private: WorldPrivate *dataPtr = nullptr;
+
+    /// \brief Root::Reload reloads the models of the worlds that changed.
+    friend class Root;
   };
   }
 }
@@ -17,8 +17,10 @@
 #ifndef SDF_PARSER_HH_
 #define SDF_PARSER_HH_
 
+#include <cstddef>
 #include <string>
 
+#include "sdf/ParserConfig.hh"
 #include "sdf/SDFImpl.hh"
 #include "sdf/sdf_config.h"
 #include "sdf/system_util.hh"
@@ -33,6 +35,14 @@
 ///
 /// XML elements that are not part of the SDF specification are copied in
 /// place. This preserves the given XML structure and data.
+///
+/// The parsing functions, as well as sdf::Root::Load, are reentrant:
+/// several threads may parse different files or strings at the same time,
+/// as long as each one parses into its own SDF, Element or Root object.
+/// Parsing never modifies process-wide state such as the C locale.
+/// Conversion from URDF is serialized internally. Process-wide settings,
+/// such as sdf::addURIPath, sdf::setFindCallback, sdf::SDF::Version and
+/// sdf::Console::SetQuiet, must not be changed while other threads parse.
 namespace sdf
 {
   // Inline bracket to help doxygen filtering.
@@ -82,6 +92,10 @@ namespace sdf
   /// This populates the given sdf pointer from a file. If the file is a URDF
   /// file it is converted to SDF first. All files are converted to the latest
   /// SDF version
+  ///
+  /// Compiled documents are cached in the directory of the
+  /// SDF_COMPILED_CACHE_PATH environment variable, if it is set, like with a
+  /// default constructed ParserConfig.
   /// \param[in] _filename Name of the SDF file
   /// \param[in] _sdf Pointer to an SDF object.
   /// \param[out] _errors Parsing errors will be appended to this variable.
@@ -89,6 +103,87 @@ namespace sdf
   SDFORMAT_VISIBLE
   bool readFile(const std::string &_filename, SDFPtr _sdf, Errors &_errors);
 
+  /// \brief Populate the SDF values from a file, with parser options
+  ///
+  /// This populates the given sdf pointer from a file. If the file is a URDF
+  /// file it is converted to SDF first. All files are converted to the latest
+  /// SDF version
+  /// \param[in] _filename Name of the SDF file
+  /// \param[in] _config Options that control how the file is parsed.
+  /// \param[out] _errors Parsing errors will be appended to this variable.
+  /// \return Populated SDF pointer.
+  SDFORMAT_VISIBLE
+  sdf::SDFPtr readFile(const std::string &_filename,
+                       const ParserConfig &_config, Errors &_errors);
+
+  /// \brief Populate the SDF values from a file, with parser options
+  ///
+  /// This populates the given sdf pointer from a file. If the file is a URDF
+  /// file it is converted to SDF first. All files are converted to the latest
+  /// SDF version
+  /// \param[in] _filename Name of the SDF file
+  /// \param[in] _config Options that control how the file is parsed.
+  /// \param[in] _sdf Pointer to an SDF object.
+  /// \param[out] _errors Parsing errors will be appended to this variable.
+  /// \return True if successful.
+  SDFORMAT_VISIBLE
+  bool readFile(const std::string &_filename, const ParserConfig &_config,
+                SDFPtr _sdf, Errors &_errors);
+
+  /// \brief Populate the SDF values from a file written by
+  /// SDF::WriteBinary, without parsing or converting XML.
+  ///
+  /// The elements get their descriptions from the specification of _sdf,
+  /// so that they behave like the elements read by readFile. The file is
+  /// memory mapped.
+  /// \param[in] _filename Name of the binary file.
+  /// \param[in] _sdf Pointer to an SDF object, initialized with sdf::init
+  /// and not read into yet.
+  /// \param[out] _errors Errors will be appended to this variable. The
+  /// file is rejected if it was written by another SDFormat version or
+  /// binary format version, or on a machine with another byte order.
+  /// \return True if successful.
+  SDFORMAT_VISIBLE
+  bool readBinary(const std::string &_filename, SDFPtr _sdf, Errors &_errors);
+
+  /// \brief Get the path of the binary file that caches an SDF file, next
+  /// to it.
+  /// \param[in] _filename Path of the SDF file.
+  /// \return Path of the binary file.
+  SDFORMAT_VISIBLE
+  std::string binaryCachePath(const std::string &_filename);
+
+  /// \brief Remove all files from the cache of included files, and reset
+  /// its hit and miss counts.
+  /// \sa ParserConfig::SetCacheIncludes(bool)
+  SDFORMAT_VISIBLE
+  void clearIncludeCache();
+
+  /// \brief Get the number of includes that were cloned from the cache of
+  /// included files since it was last cleared.
+  /// \return Number of cache hits.
+  SDFORMAT_VISIBLE
+  std::size_t includeCacheHits();
+
+  /// \brief Get the number of includes that had to parse their file, while
+  /// the cache of included files was in use, since it was last cleared.
+  /// \return Number of cache misses.
+  SDFORMAT_VISIBLE
+  std::size_t includeCacheMisses();
+
+  /// \brief Get the number of documents that were read from a compiled
+  /// cache directory by this process.
+  /// \return Number of cache hits.
+  /// \sa ParserConfig::SetCompiledCacheDirectory(const std::string &)
+  SDFORMAT_VISIBLE
+  std::size_t compiledCacheHits();
+
+  /// \brief Get the number of documents that had to be parsed, while a
+  /// compiled cache directory was in use, by this process.
+  /// \return Number of cache misses.
+  SDFORMAT_VISIBLE
+  std::size_t compiledCacheMisses();
+
   /// \brief Populate the SDF values from a file without converting to the
   /// latest SDF version
   ///
@@ -228,6 +323,50 @@ namespace sdf
   bool convertString(const std::string &_sdfString,
                      const std::string &_version, SDFPtr _sdf);
 
+  /// \brief Counts of the files handled by sdf::convertTree.
+  struct ConvertTreeReport
+  {
+    /// \brief Number of files that were converted and written.
+    std::size_t converted = 0;
+
+    /// \brief Number of files that were already at the version, or were
+    /// written by a previous conversion of the tree, and were left as is.
+    std::size_t skipped = 0;
+
+    /// \brief Number of files that could not be read, converted or
+    /// written.
+    std::size_t failed = 0;
+
+    /// \brief Time taken by the conversion, in seconds.
+    double seconds = 0;
+  };
+
+  /// \brief Convert the SDF files of a directory tree to a specific SDF
+  /// version, in place.
+  ///
+  /// The files with the .sdf and .world extensions, and the files named by
+  /// the model.config files, are found in the directory and its
+  /// subdirectories, skipping hidden ones. They are converted on a pool of
+  /// worker threads. Each converted file is written to a temporary file
+  /// which then replaces it, and the version of its entry in model.config
+  /// is updated.
+  ///
+  /// A hash of the contents of the files that are at the version is kept
+  /// in a .sdformat_converted file at the top of the tree, so that
+  /// converting the tree again skips them without parsing them.
+  /// \param[in] _path Path of the directory.
+  /// \param[in] _version Version to convert the files to.
+  /// \param[out] _report Counts of the files and time taken.
+  /// \param[out] _errors Errors will be appended to this variable, one for
+  /// each file that failed.
+  /// \param[in] _threadCount Number of worker threads, or 0 to use one per
+  /// hardware thread.
+  /// \return True if no file failed.
+  SDFORMAT_VISIBLE
+  bool convertTree(const std::string &_path, const std::string &_version,
+                   ConvertTreeReport &_report, Errors &_errors,
+                   std::size_t _threadCount = 0);
+
   /// \brief Check that for each model, the canonical_link attribute value
   /// matches the name of a link in the model if the attribute is set and
   /// not empty.
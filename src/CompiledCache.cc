@@ -0,0 +1,283 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <atomic>
+#include <cstdlib>
+#include <string>
+
+#include "sdf/Filesystem.hh"
+#include "sdf/Types.hh"
+
+#include "CompiledCache.hh"
+#include "ElementSerializer.hh"
+#include "EmbeddedSdf.hh"
+#include "MappedFile.hh"
+#include "Utils.hh"
+
+namespace sdf
+{
+inline namespace SDF_VERSION_NAMESPACE
+{
+/// \brief First line of an entry. Change the number when the layout of
+/// the list of files changes.
+static const char kEntryHeader[] = "sdformat-cache 2\n";
+
+/// \brief Start of a line of the list of files that holds a URI and the
+/// path it resolved to, separated by a tab.
+static const char kUriPrefix[] = "uri ";
+
+/// \brief Line that ends the list of files of an entry.
+static const char kEntryEnd[] = "end\n";
+
+/// \brief Number of hex digits of a hash in the list of files.
+static const std::size_t kHashDigits = 16;
+
+/// \brief Number of documents read from a cache directory.
+static std::atomic<std::size_t> g_hits{0};
+
+/// \brief Number of documents not found in a cache directory.
+static std::atomic<std::size_t> g_misses{0};
+
+/////////////////////////////////////////////////
+/// \brief Format a hash as hex digits.
+/// \param[in] _hash The hash.
+/// \return kHashDigits hex digits.
+static std::string hexHash(std::uint64_t _hash)
+{
+  static const char kDigits[] = "0123456789abcdef";
+  std::string result(kHashDigits, '0');
+  for (std::size_t i = kHashDigits; i-- > 0; _hash >>= 4)
+    result[i] = kDigits[_hash & 0xf];
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Hash the contents of a file.
+/// \param[in] _filename Path of the file.
+/// \param[out] _hash The hash.
+/// \return False if the file could not be read.
+static bool hashFile(const std::string &_filename, std::string &_hash)
+{
+  MappedFile file;
+  if (!file.Open(_filename, false))
+    return false;
+  _hash = hexHash(CompiledCache::Hash(file.Data()));
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the hash of the specification files and conversion recipes
+/// that are embedded in the library.
+/// \return The hash, computed once.
+static std::uint64_t embeddedSdfHash()
+{
+  static const std::uint64_t hash = []()
+  {
+    std::uint64_t result = CompiledCache::kHashSeed;
+    for (const auto &[name, contents] : GetEmbeddedSdf())
+    {
+      result = CompiledCache::Hash(name, result);
+      result = CompiledCache::Hash(std::string_view("", 1), result);
+      result = CompiledCache::Hash(contents, result);
+    }
+    return result;
+  }();
+  return hash;
+}
+
+/////////////////////////////////////////////////
+CompiledCache::CompiledCache(const std::string &_directory)
+  : directory(_directory)
+{
+}
+
+/////////////////////////////////////////////////
+std::uint64_t CompiledCache::Hash(std::string_view _data, std::uint64_t _hash)
+{
+  // 64 bit FNV-1a, which is stable across platforms and builds.
+  for (const char c : _data)
+  {
+    _hash ^= static_cast<unsigned char>(c);
+    _hash *= 1099511628211u;
+  }
+  return _hash;
+}
+
+/////////////////////////////////////////////////
+bool CompiledCache::Read(const std::string &_filename, SDFPtr _sdf)
+{
+  this->entryPath.clear();
+
+  MappedFile source;
+  if (!_sdf || !_sdf->Root() || !source.Open(_filename, false))
+  {
+    ++g_misses;
+    return false;
+  }
+
+  std::uint64_t key = Hash(std::string_view("", 1), embeddedSdfHash());
+  for (const std::string &field : {std::string(SDF_VERSION_FULL),
+        SDF::Version(), _sdf->Root()->GetName(), _filename})
+  {
+    key = Hash(field, key);
+    key = Hash(std::string_view("", 1), key);
+  }
+  key = Hash(source.Data(), key);
+  this->entryPath = filesystem::append(this->directory, hexHash(key) + ".sdfc");
+
+  MappedFile entry;
+  if (!filesystem::exists(this->entryPath) ||
+      !entry.Open(this->entryPath, false))
+  {
+    ++g_misses;
+    return false;
+  }
+
+  // The binary data follows the list of files, aligned to 8 bytes.
+  const std::string_view data = entry.Data();
+  const std::size_t end = data.find(std::string("\n") + kEntryEnd);
+  if (end == std::string_view::npos)
+  {
+    ++g_misses;
+    return false;
+  }
+  const std::size_t binaryOffset =
+      (end + sizeof(kEntryEnd) + 7) / 8 * 8;
+  if (binaryOffset > data.size() ||
+      !DependenciesUnchanged(data.substr(0, end + 1)))
+  {
+    ++g_misses;
+    return false;
+  }
+
+  // Read into a copy of the root, so that _sdf is unchanged if the entry is
+  // invalid.
+  SDFPtr cached(new SDF);
+  cached->Root(_sdf->Root()->CloneWithSharedDescriptions());
+  Errors errors;
+  if (!ElementSerializer::Deserialize(data.substr(binaryOffset), cached,
+        errors))
+  {
+    ++g_misses;
+    return false;
+  }
+
+  _sdf->Root(cached->Root());
+  _sdf->SetFilePath(cached->FilePath());
+  _sdf->SetOriginalVersion(cached->OriginalVersion());
+  ++g_hits;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool CompiledCache::DependenciesUnchanged(std::string_view _manifest)
+{
+  const std::string_view header(kEntryHeader, sizeof(kEntryHeader) - 1);
+  if (_manifest.substr(0, header.size()) != header)
+    return false;
+
+  std::size_t pos = header.size();
+  while (pos < _manifest.size())
+  {
+    const std::size_t lineEnd = _manifest.find('\n', pos);
+    if (lineEnd == std::string_view::npos)
+      return false;
+
+    const std::string_view uriPrefix(kUriPrefix, sizeof(kUriPrefix) - 1);
+    const std::string_view line = _manifest.substr(pos, lineEnd - pos);
+    if (line.substr(0, uriPrefix.size()) == uriPrefix)
+    {
+      const std::size_t tab = line.find('\t');
+      if (tab == std::string_view::npos)
+        return false;
+      const std::string uri(
+          line.substr(uriPrefix.size(), tab - uriPrefix.size()));
+      if (findFile(uri, true, true) != line.substr(tab + 1))
+        return false;
+      pos = lineEnd + 1;
+      continue;
+    }
+
+    if (line.size() < kHashDigits + 2 || line[kHashDigits] != ' ')
+      return false;
+
+    const std::string filename(line.substr(kHashDigits + 1));
+    std::string hash;
+    if (!hashFile(filename, hash) || hash != line.substr(0, kHashDigits))
+    {
+      return false;
+    }
+    pos = lineEnd + 1;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool CompiledCache::Write(const SDF &_sdf,
+    const std::vector<std::string> &_dependencies,
+    const std::map<std::string, std::string> &_uris) const
+{
+  if (this->entryPath.empty())
+    return false;
+
+  std::string entry = kEntryHeader;
+  for (const std::string &dependency : _dependencies)
+  {
+    std::string hash;
+    if (dependency.find('\n') != std::string::npos ||
+        !hashFile(dependency, hash))
+    {
+      return false;
+    }
+    entry += hash + ' ' + dependency + '\n';
+  }
+  for (const auto &[uri, path] : _uris)
+  {
+    if (uri.find_first_of("\t\n") != std::string::npos ||
+        path.find('\n') != std::string::npos)
+    {
+      return false;
+    }
+    entry += kUriPrefix + uri + '\t' + path + '\n';
+  }
+  entry += kEntryEnd;
+  entry.resize((entry.size() + 7) / 8 * 8, '\0');
+  entry += ElementSerializer::Serialize(_sdf);
+
+  // Other processes may create the directory at the same time.
+  if (!filesystem::is_directory(this->directory))
+  {
+    filesystem::create_directory(this->directory);
+    if (!filesystem::is_directory(this->directory))
+      return false;
+  }
+
+  return writeFileAtomically(this->entryPath, entry);
+}
+
+/////////////////////////////////////////////////
+std::size_t CompiledCache::Hits()
+{
+  return g_hits;
+}
+
+/////////////////////////////////////////////////
+std::size_t CompiledCache::Misses()
+{
+  return g_misses;
+}
+}
+}
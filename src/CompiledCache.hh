@@ -0,0 +1,109 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_COMPILEDCACHE_HH_
+#define SDF_COMPILEDCACHE_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "sdf/SDFImpl.hh"
+#include "sdf/sdf_config.h"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \brief Directory of compiled files, used when
+  /// ParserConfig::CompiledCacheDirectory() is not empty.
+  ///
+  /// Each entry holds a parsed and converted document in the binary format
+  /// of SDF::WriteBinary. An entry is named by a hash of the path and the
+  /// contents of the source file, the SDFormat library and specification
+  /// versions, and the embedded specification files and conversion
+  /// recipes. It starts with the list of files that were read to parse the
+  /// document, with a hash of their contents, and the paths that the URIs
+  /// of its includes resolved to, so that the entry is only used while none
+  /// of the files changed and the URIs resolve to the same paths.
+  ///
+  /// Entries are written to a temporary file which is then renamed, so
+  /// processes that share the directory never read a partial entry.
+  class CompiledCache
+  {
+    /// \brief Constructor.
+    /// \param[in] _directory Path of the cache directory.
+    public: explicit CompiledCache(const std::string &_directory);
+
+    /// \brief Read a document from its entry.
+    /// \param[in] _filename Path of the source file.
+    /// \param[in,out] _sdf SDF object to read into, initialized with the
+    /// specification. It is unchanged if the entry can't be used.
+    /// \return True if the entry exists, none of the files it depends on
+    /// changed and it was read.
+    public: bool Read(const std::string &_filename, SDFPtr _sdf);
+
+    /// \brief Write the entry of the document that was passed to the last
+    /// call to Read.
+    /// \param[in] _sdf The parsed document.
+    /// \param[in] _dependencies Paths of the files that were read to parse
+    /// the document.
+    /// \param[in] _uris Paths that the URIs of includes resolved to, by URI.
+    /// \return True if the entry was written.
+    public: bool Write(const SDF &_sdf,
+                       const std::vector<std::string> &_dependencies,
+                       const std::map<std::string, std::string> &_uris) const;
+
+    /// \brief Get the number of documents read from a cache directory, in
+    /// this process.
+    /// \return Number of hits.
+    public: static std::size_t Hits();
+
+    /// \brief Get the number of documents that were not found in a cache
+    /// directory, in this process.
+    /// \return Number of misses.
+    public: static std::size_t Misses();
+
+    /// \brief Hash data, continuing from a previous hash.
+    /// \param[in] _data The data.
+    /// \param[in] _hash Hash of the preceding data.
+    /// \return The hash.
+    public: static std::uint64_t Hash(std::string_view _data,
+                                      std::uint64_t _hash = kHashSeed);
+
+    /// \brief Initial value of Hash.
+    public: static constexpr std::uint64_t kHashSeed = 14695981039346656037u;
+
+    /// \brief Check that the files of an entry did not change, and that its
+    /// URIs resolve to the same paths.
+    /// \param[in] _manifest The list of files at the start of the entry.
+    /// \return False if a file or URI changed or the list is invalid.
+    private: static bool DependenciesUnchanged(std::string_view _manifest);
+
+    /// \brief Path of the cache directory.
+    private: std::string directory;
+
+    /// \brief Path of the entry of the last document passed to Read.
+    private: std::string entryPath;
+  };
+  }
+}
+#endif
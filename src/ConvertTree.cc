@@ -0,0 +1,424 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <tinyxml.h>
+
+#include <ignition/math/SemanticVersion.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "sdf/Error.hh"
+#include "sdf/Filesystem.hh"
+#include "sdf/parser.hh"
+
+#include "CompiledCache.hh"
+#include "Converter.hh"
+#include "MappedFile.hh"
+#include "Utils.hh"
+
+namespace sdf
+{
+inline namespace SDF_VERSION_NAMESPACE
+{
+/// \brief Name of the file, at the top of a tree, that lists the hashes of
+/// the files that are at a version.
+static const char kManifestName[] = ".sdformat_converted";
+
+/// \brief Outcome of the conversion of a file of a tree.
+enum class ConvertTreeResult
+{
+  CONVERTED,
+  SKIPPED,
+  FAILED
+};
+
+/// \brief A file of a tree and the outcome of its conversion.
+struct ConvertTreeFile
+{
+  /// \brief Path of the file.
+  std::string path;
+
+  /// \brief Outcome of the conversion.
+  ConvertTreeResult result = ConvertTreeResult::FAILED;
+
+  /// \brief Entry of the manifest for the contents of the file at the
+  /// version, or empty if it failed.
+  std::string manifestEntry;
+
+  /// \brief The error, if it failed.
+  Error error;
+};
+
+/////////////////////////////////////////////////
+/// \brief Check whether a string ends with a suffix.
+/// \param[in] _str The string.
+/// \param[in] _suffix The suffix.
+/// \return True if _str ends with _suffix.
+static bool endsWith(const std::string &_str, const std::string &_suffix)
+{
+  return _str.size() >= _suffix.size() &&
+      _str.compare(_str.size() - _suffix.size(), _suffix.size(), _suffix) == 0;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the entry of the manifest for the contents of a file.
+/// \param[in] _contents The contents of the file.
+/// \param[in] _version The version of the file.
+/// \return The hash of the contents in hex digits, followed by the version.
+static std::string manifestEntry(std::string_view _contents,
+    const std::string &_version)
+{
+  std::ostringstream entry;
+  entry << std::hex << CompiledCache::Hash(_contents) << ' ' << _version;
+  return entry.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Print an XML document like SDF files are written.
+/// \param[in] _doc The document.
+/// \return The text of the document.
+static std::string printXml(const TiXmlDocument &_doc)
+{
+  TiXmlPrinter printer;
+  printer.SetIndent("  ");
+  _doc.Accept(&printer);
+  return printer.Str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Find the files of a directory and its subdirectories, skipping
+/// hidden ones.
+/// \param[in] _path Path of the directory.
+/// \param[out] _sdfFiles The .sdf and .world files.
+/// \param[out] _configFiles The model.config files.
+static void findTreeFiles(const std::string &_path,
+    std::set<std::string> &_sdfFiles, std::vector<std::string> &_configFiles)
+{
+  for (filesystem::DirIter file(_path); file != filesystem::DirIter(); ++file)
+  {
+    const std::string path = *file;
+    const std::string name = filesystem::basename(path);
+    if (name.empty() || name[0] == '.')
+      continue;
+
+    if (filesystem::is_directory(path))
+      findTreeFiles(path, _sdfFiles, _configFiles);
+    else if (name == "model.config")
+      _configFiles.push_back(path);
+    else if (endsWith(name, ".sdf") || endsWith(name, ".world"))
+      _sdfFiles.insert(path);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the <sdf> entries of a model.config file that are converted.
+/// Of several entries, only the one that getModelFilePath reads is
+/// converted, which is the newest one that this version of the parser
+/// supports, or else the first one. The files of the other versions are
+/// left as they are.
+/// \param[in] _config The model.config document.
+/// \param[in] _configPath Path of the model.config file.
+/// \param[out] _others Paths of the files of the other entries, or nullptr.
+/// \return The entries, with the paths of the files that they name.
+static std::vector<std::pair<TiXmlElement *, std::string>> configEntries(
+    TiXmlDocument &_config, const std::string &_configPath,
+    std::vector<std::string> *_others = nullptr)
+{
+  std::vector<std::pair<TiXmlElement *, std::string>> entries;
+  TiXmlElement *model = _config.FirstChildElement("model");
+  if (!model)
+    return entries;
+
+  const std::string directory = _configPath.substr(0,
+      _configPath.size() - filesystem::basename(_configPath).size());
+  const ignition::math::SemanticVersion parserVersion(SDF_VERSION);
+  ignition::math::SemanticVersion bestVersion("0.0");
+  for (TiXmlElement *entry = model->FirstChildElement("sdf"); entry;
+       entry = entry->NextSiblingElement("sdf"))
+  {
+    const char *text = entry->GetText();
+    if (!text || text[0] == '\0')
+      continue;
+
+    const char *versionStr = entry->Attribute("version");
+    const ignition::math::SemanticVersion version(
+        versionStr ? versionStr : "0.0");
+    if (entries.empty() ||
+        (version > bestVersion && version <= parserVersion))
+    {
+      if (!entries.empty() && _others)
+        _others->push_back(entries.back().second);
+      entries.assign(1, {entry, directory + text});
+      if (version <= parserVersion)
+        bestVersion = version;
+    }
+    else if (_others)
+    {
+      _others->push_back(directory + text);
+    }
+  }
+  return entries;
+}
+
+/////////////////////////////////////////////////
+/// \brief Convert a file of a tree in place.
+/// \param[in] _version Version to convert the file to.
+/// \param[in] _manifest Entries of the manifest of the tree.
+/// \param[in,out] _file The file, which gets the outcome.
+static void convertTreeFile(const std::string &_version,
+    const std::set<std::string> &_manifest, ConvertTreeFile &_file)
+{
+  MappedFile source;
+  if (!source.Open(_file.path))
+  {
+    _file.error = Error(ErrorCode::FILE_READ,
+        "Unable to read file[" + _file.path + "]");
+    return;
+  }
+
+  const std::string entry = manifestEntry(source.Data(), _version);
+  if (_manifest.count(entry) > 0)
+  {
+    _file.result = ConvertTreeResult::SKIPPED;
+    _file.manifestEntry = entry;
+    return;
+  }
+
+  TiXmlDocument xmlDoc;
+  xmlDoc.Parse(source.CStr());
+  if (xmlDoc.Error())
+  {
+    _file.error = Error(ErrorCode::FILE_READ, "Error parsing XML in file[" +
+        _file.path + "]: " + xmlDoc.ErrorDesc());
+    return;
+  }
+
+  TiXmlElement *sdfNode = xmlDoc.FirstChildElement("sdf");
+  if (!sdfNode || !sdfNode->Attribute("version"))
+  {
+    _file.error = Error(ErrorCode::FILE_READ,
+        "Unable to determine the SDF version of file[" + _file.path + "]");
+    return;
+  }
+
+  if (sdfNode->Attribute("version") == _version)
+  {
+    _file.result = ConvertTreeResult::SKIPPED;
+    _file.manifestEntry = entry;
+    return;
+  }
+
+  if (!Converter::Convert(&xmlDoc, _version, true))
+  {
+    _file.error = Error(ErrorCode::FILE_READ, "Unable to convert file[" +
+        _file.path + "] to SDF version " + _version);
+    return;
+  }
+
+  const std::string converted = printXml(xmlDoc);
+  if (!writeFileAtomically(_file.path, converted))
+  {
+    _file.error = Error(ErrorCode::FILE_WRITE,
+        "Unable to write file[" + _file.path + "]");
+    return;
+  }
+
+  _file.result = ConvertTreeResult::CONVERTED;
+  _file.manifestEntry = manifestEntry(converted, _version);
+}
+
+/////////////////////////////////////////////////
+bool convertTree(const std::string &_path, const std::string &_version,
+                 ConvertTreeReport &_report, Errors &_errors,
+                 std::size_t _threadCount)
+{
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  _report = ConvertTreeReport();
+
+  if (!filesystem::is_directory(_path))
+  {
+    _errors.push_back({ErrorCode::DIRECTORY_NONEXISTANT,
+        "Directory[" + _path + "] does not exist"});
+    return false;
+  }
+
+  std::set<std::string> sdfFiles;
+  std::vector<std::string> configFiles;
+  findTreeFiles(_path, sdfFiles, configFiles);
+
+  // The model.config files may name files with other extensions.
+  std::vector<std::unique_ptr<TiXmlDocument>> configs;
+  std::vector<std::string> otherVersions;
+  for (const std::string &configPath : configFiles)
+  {
+    configs.push_back(std::make_unique<TiXmlDocument>());
+    MappedFile source;
+    if (source.Open(configPath))
+      configs.back()->Parse(source.CStr());
+    for (const auto &entry : configEntries(*configs.back(), configPath,
+           &otherVersions))
+    {
+      sdfFiles.insert(entry.second);
+    }
+  }
+
+  // The files of the versions of a model that are not read are kept.
+  for (const std::string &path : otherVersions)
+  {
+    if (sdfFiles.erase(path) > 0)
+      ++_report.skipped;
+  }
+
+  const std::string manifestPath =
+      filesystem::append(_path, kManifestName);
+  std::set<std::string> manifest;
+  {
+    std::ifstream in(manifestPath);
+    for (std::string line; std::getline(in, line);)
+      manifest.insert(line);
+  }
+
+  std::vector<ConvertTreeFile> files(sdfFiles.size());
+  std::transform(sdfFiles.begin(), sdfFiles.end(), files.begin(),
+      [](const std::string &_file)
+      {
+        ConvertTreeFile file;
+        file.path = _file;
+        return file;
+      });
+
+  if (_threadCount == 0)
+    _threadCount = std::max(1u, std::thread::hardware_concurrency());
+  _threadCount = std::max<std::size_t>(1,
+      std::min(_threadCount, files.size()));
+
+  // Each worker converts the next file that has not been taken yet.
+  std::atomic<std::size_t> next(0);
+  auto worker = [&files, &next, &manifest, &_version]()
+  {
+    for (std::size_t i = next++; i < files.size(); i = next++)
+      convertTreeFile(_version, manifest, files[i]);
+  };
+
+  // The calling thread is one of the workers.
+  std::vector<std::thread> threads;
+  for (std::size_t t = 1; t < _threadCount; ++t)
+    threads.emplace_back(worker);
+  worker();
+
+  for (auto &thread : threads)
+    thread.join();
+
+  std::map<std::string, const ConvertTreeFile *> filesByPath;
+  std::set<std::string> newManifest;
+  for (const ConvertTreeFile &file : files)
+  {
+    filesByPath[file.path] = &file;
+    switch (file.result)
+    {
+      case ConvertTreeResult::CONVERTED:
+        ++_report.converted;
+        break;
+      case ConvertTreeResult::SKIPPED:
+        ++_report.skipped;
+        break;
+      case ConvertTreeResult::FAILED:
+        ++_report.failed;
+        _errors.push_back(file.error);
+        break;
+    }
+    if (!file.manifestEntry.empty())
+      newManifest.insert(file.manifestEntry);
+  }
+
+  // Update the versions of the entries of model.config for the files that
+  // are now at the version.
+  for (std::size_t i = 0; i < configFiles.size(); ++i)
+  {
+    if (configs[i]->Error())
+    {
+      ++_report.failed;
+      _errors.push_back({ErrorCode::FILE_READ, "Error parsing XML in file[" +
+          configFiles[i] + "]: " + configs[i]->ErrorDesc()});
+      continue;
+    }
+
+    bool changed = false;
+    for (const auto &[entry, path] : configEntries(*configs[i], configFiles[i]))
+    {
+      const ConvertTreeFile *file = filesByPath[path];
+      const char *version = entry->Attribute("version");
+      if (file->result != ConvertTreeResult::FAILED &&
+          (!version || version != _version))
+      {
+        entry->SetAttribute("version", _version);
+        changed = true;
+      }
+    }
+
+    if (!changed)
+    {
+      ++_report.skipped;
+    }
+    else if (writeFileAtomically(configFiles[i], printXml(*configs[i])))
+    {
+      ++_report.converted;
+    }
+    else
+    {
+      ++_report.failed;
+      _errors.push_back({ErrorCode::FILE_WRITE,
+          "Unable to write file[" + configFiles[i] + "]"});
+    }
+  }
+
+  // Keep the previous entries, since files may be copied back into the
+  // tree.
+  newManifest.insert(manifest.begin(), manifest.end());
+  if (newManifest != manifest)
+  {
+    std::string contents;
+    for (const std::string &entry : newManifest)
+      contents += entry + '\n';
+    if (!writeFileAtomically(manifestPath, contents))
+    {
+      _errors.push_back({ErrorCode::FILE_WRITE,
+          "Unable to write file[" + manifestPath + "]"});
+    }
+  }
+
+  _report.seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  return _report.failed == 0;
+}
+}
+}
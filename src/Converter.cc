@@ -17,9 +17,11 @@
 
 #include <algorithm>
 #include <map>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -31,6 +33,117 @@
 #include "Converter.hh"
 #include "EmbeddedSdf.hh"
 
+namespace sdf
+{
+inline namespace SDF_VERSION_NAMESPACE
+{
+/// \brief An operation of a conversion recipe, with the operands that the
+/// interpreter used to read from the XML of the recipe. Operands that are
+/// not set were missing in the recipe.
+struct ConvertOperation
+{
+  /// \brief Kinds of operations, named after their XML elements.
+  enum class Kind
+  {
+    RENAME,
+    COPY,
+    MAP,
+    MOVE,
+    ADD,
+    REMOVE,
+    UNKNOWN
+  };
+
+  /// \brief Kind of the operation.
+  Kind kind = Kind::UNKNOWN;
+
+  /// \brief The element and attribute attributes of the <from> child of
+  /// rename, copy and move.
+  std::optional<std::string> fromElement;
+  std::optional<std::string> fromAttribute;
+
+  /// \brief The element and attribute attributes of the <to> child of
+  /// rename, copy and move.
+  std::optional<std::string> toElement;
+  std::optional<std::string> toAttribute;
+
+  /// \brief The element, attribute and value attributes of add and remove.
+  std::optional<std::string> element;
+  std::optional<std::string> attribute;
+  std::optional<std::string> value;
+
+  /// \brief The source and destination paths of map, split on '/', or of
+  /// copy and move, split on '::'.
+  std::vector<std::string> fromTokens;
+  std::vector<std::string> toTokens;
+
+  /// \brief The values of map.
+  std::map<std::string, std::string> valueMap;
+
+  /// \brief Error in the recipe, printed when the operation runs, like the
+  /// interpreter did. For an unknown operation, its element name.
+  std::string error;
+};
+
+/// \brief A recipe that a recipe applies to the child elements with a
+/// given name.
+struct ConvertRule
+{
+  /// \brief Index of the nested recipe in the children of the recipe.
+  std::size_t child = 0;
+
+  /// \brief True to look for the descendants of the child element that are
+  /// named by the descendant_name of the nested recipe, false to apply the
+  /// nested recipe to the child element.
+  bool scan = false;
+
+  /// \brief True if the rule comes from the descendant_name of the nested
+  /// recipe, so that it does not apply within plugins.
+  bool descendant = false;
+};
+
+/// \brief A 'convert' element of a conversion recipe, compiled.
+struct ConvertRecipe
+{
+  /// \brief The name attribute, which selects child elements.
+  std::optional<std::string> name;
+
+  /// \brief The descendant_name attribute, which selects descendants.
+  std::optional<std::string> descendantName;
+
+  /// \brief The paths of the deprecated elements, split on '/'.
+  std::vector<std::vector<std::string>> deprecated;
+
+  /// \brief The nested 'convert' elements.
+  std::vector<ConvertRecipe> children;
+
+  /// \brief The operations, in document order.
+  std::vector<ConvertOperation> operations;
+
+  /// \brief The rules of the nested recipes by the name of the child
+  /// elements that they apply to, in the order of the nested recipes.
+  std::unordered_map<std::string, std::vector<ConvertRule>> dispatch;
+
+  /// \brief The rules for child elements with other names, which look for
+  /// the descendants named by nested recipes.
+  std::vector<ConvertRule> scans;
+};
+
+/// \brief A recipe to run on an element during the traversal of a
+/// document.
+struct ConvertTask
+{
+  /// \brief The recipe.
+  const ConvertRecipe *recipe = nullptr;
+
+  /// \brief True to look for the descendants of the element that are named
+  /// by the descendant_name of the recipe, false to apply the recipe to the
+  /// element.
+  bool scan = false;
+};
+}
+}
+
 using namespace sdf;
 
 namespace {
@@ -39,6 +152,317 @@ bool EndsWith(const std::string& _a, const std::string& _b)
   return (_a.size() >= _b.size()) &&
       (_a.compare(_a.size() - _b.size(), _b.size(), _b) == 0);
 }
+
+/////////////////////////////////////////////////
+/// \brief Get an attribute of an element.
+/// \param[in] _elem The element, which may be null.
+/// \param[in] _name Name of the attribute.
+/// \return The value, or nullopt if there is no such attribute.
+std::optional<std::string> attribute(const TiXmlElement *_elem,
+    const char *_name)
+{
+  const char *value = _elem ? _elem->Attribute(_name) : nullptr;
+  if (!value)
+    return std::nullopt;
+  return std::string(value);
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the C string of an operand, like the attribute it came from.
+/// \param[in] _operand The operand.
+/// \return The string, or nullptr if the operand is not set.
+const char *cstr(const std::optional<std::string> &_operand)
+{
+  return _operand ? _operand->c_str() : nullptr;
+}
+
+/////////////////////////////////////////////////
+/// \brief Compile the <from> and <to> children of a map operation, checking
+/// them like the interpreter did before it read the document.
+/// \param[in] _mapElem The map element.
+/// \param[out] _op The operation.
+void compileMap(TiXmlElement *_mapElem, ConvertOperation &_op)
+{
+  TiXmlElement *fromConvertElem = _mapElem->FirstChildElement("from");
+  TiXmlElement *toConvertElem = _mapElem->FirstChildElement("to");
+
+  if (!fromConvertElem)
+  {
+    _op.error = "<map> element requires a <from> child element.\n";
+    return;
+  }
+  if (!toConvertElem)
+  {
+    _op.error = "<map> element requires a <to> child element.\n";
+    return;
+  }
+
+  const char *fromNameStr = fromConvertElem->Attribute("name");
+  const char *toNameStr = toConvertElem->Attribute("name");
+
+  if (!fromNameStr || fromNameStr[0] == '\0')
+  {
+    _op.error = "Map: <from> element requires a non-empty name attribute.\n";
+    return;
+  }
+  if (!toNameStr || toNameStr[0] == '\0')
+  {
+    _op.error = "Map: <to> element requires a non-empty name attribute.\n";
+    return;
+  }
+
+  // create map of input and output values
+  TiXmlElement *fromValueElem = fromConvertElem->FirstChildElement("value");
+  TiXmlElement *toValueElem = toConvertElem->FirstChildElement("value");
+  if (!fromValueElem)
+  {
+    _op.error =
+        "Map: <from> element requires at least one <value> element.\n";
+    return;
+  }
+  if (!toValueElem)
+  {
+    _op.error = "Map: <to> element requires at least one <value> element.\n";
+    return;
+  }
+  if (!fromValueElem->GetText())
+  {
+    _op.error = "Map: from value must not be empty.\n";
+    return;
+  }
+  if (!toValueElem->GetText())
+  {
+    _op.error = "Map: to value must not be empty.\n";
+    return;
+  }
+  _op.valueMap[fromValueElem->GetText()] = toValueElem->GetText();
+  while (fromValueElem->NextSiblingElement("value"))
+  {
+    fromValueElem = fromValueElem->NextSiblingElement("value");
+    if (toValueElem->NextSiblingElement("value"))
+    {
+      toValueElem = toValueElem->NextSiblingElement("value");
+    }
+    if (!fromValueElem->GetText())
+    {
+      _op.error = "Map: from value must not be empty.\n";
+      return;
+    }
+    if (!toValueElem->GetText())
+    {
+      _op.error = "Map: to value must not be empty.\n";
+      return;
+    }
+    _op.valueMap[fromValueElem->GetText()] = toValueElem->GetText();
+  }
+
+  // tokenize 'from' and 'to' name attributes
+  _op.fromTokens = split(fromNameStr, "/");
+  _op.toTokens = split(toNameStr, "/");
+}
+
+/////////////////////////////////////////////////
+/// \brief Compile the <from> and <to> children of a rename, copy or move
+/// operation.
+/// \param[in] _opElem The operation element.
+/// \param[out] _op The operation.
+void compileFromTo(TiXmlElement *_opElem, ConvertOperation &_op)
+{
+  TiXmlElement *fromConvertElem = _opElem->FirstChildElement("from");
+  TiXmlElement *toConvertElem = _opElem->FirstChildElement("to");
+  _op.fromElement = attribute(fromConvertElem, "element");
+  _op.fromAttribute = attribute(fromConvertElem, "attribute");
+  _op.toElement = attribute(toConvertElem, "element");
+  _op.toAttribute = attribute(toConvertElem, "attribute");
+
+  if (_op.kind == ConvertOperation::Kind::RENAME)
+    return;
+
+  // tokenize 'from' and 'to' strs
+  std::string fromStr = "";
+  if (_op.fromElement)
+  {
+    fromStr = *_op.fromElement;
+  }
+  else if (_op.fromAttribute)
+  {
+    fromStr = *_op.fromAttribute;
+  }
+  std::string toStr = "";
+  if (_op.toElement)
+  {
+    toStr = *_op.toElement;
+  }
+  else if (_op.toAttribute)
+  {
+    toStr = *_op.toAttribute;
+  }
+
+  _op.fromTokens = split(fromStr, "::");
+  _op.toTokens = split(toStr, "::");
+}
+
+/////////////////////////////////////////////////
+/// \brief Compile a 'convert' element of a conversion recipe.
+/// \param[in] _convert The element.
+/// \return The compiled recipe.
+ConvertRecipe compileRecipe(TiXmlElement *_convert)
+{
+  ConvertRecipe recipe;
+  recipe.name = attribute(_convert, "name");
+  recipe.descendantName = attribute(_convert, "descendant_name");
+
+  for (TiXmlElement *deprecatedElem = _convert->FirstChildElement("deprecated");
+       deprecatedElem;
+       deprecatedElem = deprecatedElem->NextSiblingElement("deprecated"))
+  {
+    const char *text = deprecatedElem->GetText();
+    recipe.deprecated.push_back(split(text ? text : "", "/"));
+  }
+
+  for (TiXmlElement *convertElem = _convert->FirstChildElement("convert");
+       convertElem; convertElem = convertElem->NextSiblingElement("convert"))
+  {
+    recipe.children.push_back(compileRecipe(convertElem));
+  }
+
+  for (TiXmlElement *childElem = _convert->FirstChildElement();
+       childElem; childElem = childElem->NextSiblingElement())
+  {
+    const std::string &kind = childElem->ValueStr();
+    if (kind == "convert")
+      continue;
+
+    ConvertOperation op;
+    if (kind == "rename")
+    {
+      op.kind = ConvertOperation::Kind::RENAME;
+      compileFromTo(childElem, op);
+    }
+    else if (kind == "copy" || kind == "move")
+    {
+      op.kind = kind == "copy" ?
+          ConvertOperation::Kind::COPY : ConvertOperation::Kind::MOVE;
+      compileFromTo(childElem, op);
+    }
+    else if (kind == "map")
+    {
+      op.kind = ConvertOperation::Kind::MAP;
+      compileMap(childElem, op);
+    }
+    else if (kind == "add" || kind == "remove")
+    {
+      op.kind = kind == "add" ?
+          ConvertOperation::Kind::ADD : ConvertOperation::Kind::REMOVE;
+      op.element = attribute(childElem, "element");
+      op.attribute = attribute(childElem, "attribute");
+      op.value = attribute(childElem, "value");
+    }
+    else
+    {
+      op.kind = ConvertOperation::Kind::UNKNOWN;
+      op.error = kind;
+    }
+    recipe.operations.push_back(std::move(op));
+  }
+
+  // Build the dispatch table of the nested recipes, keeping their order
+  // for each name of child element.
+  for (std::size_t i = 0; i < recipe.children.size(); ++i)
+  {
+    const ConvertRecipe &child = recipe.children[i];
+    if (child.name)
+      recipe.dispatch[*child.name];
+    if (child.descendantName)
+      recipe.dispatch[*child.descendantName];
+  }
+  for (std::size_t i = 0; i < recipe.children.size(); ++i)
+  {
+    const ConvertRecipe &child = recipe.children[i];
+    for (auto &[name, rules] : recipe.dispatch)
+    {
+      if (child.name && *child.name == name)
+        rules.push_back({i, false, false});
+      if (child.descendantName)
+      {
+        if (*child.descendantName == name)
+          rules.push_back({i, false, true});
+        rules.push_back({i, true, true});
+      }
+    }
+    if (child.descendantName)
+      recipe.scans.push_back({i, true, true});
+  }
+
+  return recipe;
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether descendant_name recipes look into an element.
+/// \param[in] _elem The element.
+/// \return False for plugins and elements of custom namespaces.
+bool scansInto(const TiXmlElement *_elem)
+{
+  return _elem->ValueStr() != "plugin" &&
+      _elem->ValueStr().find(":") == std::string::npos;
+}
+
+/////////////////////////////////////////////////
+/// \brief A step of the conversion between two versions.
+struct ConversionStep
+{
+  /// \brief Version that the step converts to.
+  std::string toVersion;
+
+  /// \brief Error parsing the recipe, which is empty if it is valid.
+  std::string error;
+
+  /// \brief The compiled recipe.
+  ConvertRecipe recipe;
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the conversion steps of the embedded recipes, which are
+/// parsed and compiled on the first call.
+/// \return The steps by the version that they convert from.
+const std::map<std::string, ConversionStep> &conversionSteps()
+{
+  static const std::map<std::string, ConversionStep> steps = []()
+  {
+    // The conversion recipes within the embedded files database are named,
+    // e.g., "1.8/1_7.convert" to upgrade from 1.7 to 1.8.
+    std::map<std::string, ConversionStep> result;
+    const std::string extension = ".convert";
+    for (const auto& [pathname, data] : GetEmbeddedSdf())
+    {
+      const std::size_t slash = pathname.rfind('/');
+      if (slash == std::string::npos || !EndsWith(pathname, extension))
+        continue;
+
+      std::string fromVersion = pathname.substr(slash + 1,
+          pathname.size() - slash - 1 - extension.size());
+      std::replace(fromVersion.begin(), fromVersion.end(), '_', '.');
+
+      // Like a search of the embedded files, the first recipe is used.
+      if (result.count(fromVersion) > 0)
+        continue;
+
+      ConversionStep step;
+      step.toVersion = pathname.substr(0, slash);
+      TiXmlDocument xmlDoc;
+      xmlDoc.Parse(data.c_str());
+      if (xmlDoc.Error())
+        step.error = xmlDoc.ErrorDesc();
+      else if (!xmlDoc.FirstChildElement("convert"))
+        step.error = "Missing <convert> element";
+      else
+        step.recipe = compileRecipe(xmlDoc.FirstChildElement("convert"));
+      result.emplace(fromVersion, std::move(step));
+    }
+    return result;
+  }();
+  return steps;
+}
 }
 
 /////////////////////////////////////////////////
@@ -79,44 +503,30 @@ bool Converter::Convert(TiXmlDocument *_doc, const std::string &_toVersion,
 
   elem->SetAttribute("version", _toVersion);
 
-  // The conversion recipes within the embedded files database are named, e.g.,
-  // "1.8/1_7.convert" to upgrade from 1.7 to 1.8.
-  const std::map<std::string, std::string> &embedded = GetEmbeddedSdf();
-
-  // Apply the conversions one at a time until we reach the desired _toVersion.
+  // Collect the conversions until we reach the desired _toVersion, and
+  // apply them in a single traversal of the document.
+  const std::map<std::string, ConversionStep> &steps = conversionSteps();
+  std::vector<ConvertTask> tasks;
   std::string curVersion = origVersion;
   while (curVersion != _toVersion)
   {
-    // Find the (at most one) file named, e.g., ".../1_7.convert".
-    std::string snakeVersion = curVersion;
-    std::replace(snakeVersion.begin(), snakeVersion.end(), '.', '_');
-    const std::string suffix = "/" + snakeVersion + ".convert";
-    const char* convertXml = nullptr;
-    for (const auto& [pathname, data] : embedded)
-    {
-      if (EndsWith(pathname, suffix))
-      {
-        curVersion = pathname.substr(0, pathname.size() - suffix.size());
-        convertXml = data.c_str();
-        break;
-      }
-    }
-    if (convertXml == nullptr)
+    auto step = steps.find(curVersion);
+    if (step == steps.end())
     {
       break;
     }
+    curVersion = step->second.toVersion;
 
-    // Parse and apply the conversion XML.
-    TiXmlDocument xmlDoc;
-    xmlDoc.Parse(convertXml);
-    if (xmlDoc.Error())
+    if (!step->second.error.empty())
     {
+      ConvertImpl(elem, tasks);
       sdferr << "Error parsing XML from string: "
-             << xmlDoc.ErrorDesc() << '\n';
+             << step->second.error << '\n';
       return false;
     }
-    ConvertImpl(elem, xmlDoc.FirstChildElement("convert"));
+    tasks.push_back({&step->second.recipe, false});
   }
+  ConvertImpl(elem, tasks);
 
   // Check that we actually converted to the desired final version.
   if (curVersion != _toVersion)
@@ -135,115 +545,123 @@ void Converter::Convert(TiXmlDocument *_doc, TiXmlDocument *_convertDoc)
   SDF_ASSERT(_doc != NULL, "SDF XML doc is NULL");
   SDF_ASSERT(_convertDoc != NULL, "Convert XML doc is NULL");
 
-  ConvertImpl(_doc->FirstChildElement(), _convertDoc->FirstChildElement());
+  SDF_ASSERT(_convertDoc->FirstChildElement() != NULL,
+      "Convert element is NULL");
+
+  const ConvertRecipe recipe = compileRecipe(_convertDoc->FirstChildElement());
+  ConvertImpl(_doc->FirstChildElement(), {{&recipe, false}});
 }
 
 /////////////////////////////////////////////////
-void Converter::ConvertDescendantsImpl(TiXmlElement *_e, TiXmlElement *_c)
+void Converter::ConvertImpl(TiXmlElement *_elem,
+    const std::vector<ConvertTask> &_tasks)
 {
-  if (!_c->Attribute("descendant_name"))
-  {
-    return;
-  }
-
-  if (_e->ValueStr() == "plugin")
-  {
-    return;
-  }
-
-  if (_e->ValueStr().find(":") != std::string::npos)
-  {
-    return;
-  }
+  SDF_ASSERT(_elem != NULL, "SDF element is NULL");
 
-  std::string name = _c->Attribute("descendant_name");
-  TiXmlElement *e = _e->FirstChildElement();
-  while (e)
+  const bool scanChildren = scansInto(_elem);
+  std::vector<ConvertTask> childTasks;
+
+  // The tasks run as if each one converted the element and its
+  // descendants in turn. Since a recipe only edits the element that it
+  // applies to and its descendants, the tasks share a traversal of the
+  // child elements until one of them has operations, which edit the
+  // element before the next tasks run, or has deprecated elements, which
+  // are checked before it converts the child elements.
+  std::size_t begin = 0;
+  while (begin < _tasks.size())
   {
-    if (name == e->ValueStr())
+    std::size_t end = begin;
+    do
     {
-      ConvertImpl(e, _c);
+      const ConvertTask &task = _tasks[end++];
+      if (!task.scan && !task.recipe->operations.empty())
+        break;
     }
-    ConvertDescendantsImpl(e, _c);
-    e = e->NextSiblingElement();
-  }
-}
-
-/////////////////////////////////////////////////
-void Converter::ConvertImpl(TiXmlElement *_elem, TiXmlElement *_convert)
-{
-  SDF_ASSERT(_elem != NULL, "SDF element is NULL");
-  SDF_ASSERT(_convert != NULL, "Convert element is NULL");
+    while (end < _tasks.size() &&
+        (_tasks[end].scan || _tasks[end].recipe->deprecated.empty()));
 
-  CheckDeprecation(_elem, _convert);
+    if (!_tasks[begin].scan)
+      CheckDeprecation(_elem, *_tasks[begin].recipe);
 
-  for (TiXmlElement *convertElem = _convert->FirstChildElement("convert");
-       convertElem; convertElem = convertElem->NextSiblingElement("convert"))
-  {
-    if (convertElem->Attribute("name"))
+    for (TiXmlElement *elem = _elem->FirstChildElement(); elem;
+         elem = elem->NextSiblingElement())
     {
-      TiXmlElement *elem = _elem->FirstChildElement(
-          convertElem->Attribute("name"));
-      while (elem)
+      childTasks.clear();
+      for (std::size_t i = begin; i < end; ++i)
       {
-        ConvertImpl(elem, convertElem);
-        elem = elem->NextSiblingElement(convertElem->Attribute("name"));
+        const ConvertRecipe *recipe = _tasks[i].recipe;
+        if (_tasks[i].scan)
+        {
+          if (!scanChildren)
+            continue;
+          if (*recipe->descendantName == elem->ValueStr())
+            childTasks.push_back({recipe, false});
+          childTasks.push_back({recipe, true});
+          continue;
+        }
+
+        auto rules = recipe->dispatch.find(elem->ValueStr());
+        for (const ConvertRule &rule : rules != recipe->dispatch.end() ?
+             rules->second : recipe->scans)
+        {
+          if (scanChildren || !rule.descendant)
+            childTasks.push_back({&recipe->children[rule.child], rule.scan});
+        }
       }
+
+      if (!childTasks.empty())
+        ConvertImpl(elem, childTasks);
     }
-    if (convertElem->Attribute("descendant_name"))
-    {
-      ConvertDescendantsImpl(_elem, convertElem);
-    }
+
+    if (!_tasks[end - 1].scan)
+      ConvertOperations(_elem, *_tasks[end - 1].recipe);
+    begin = end;
   }
+}
 
-  for (TiXmlElement *childElem = _convert->FirstChildElement();
-       childElem; childElem = childElem->NextSiblingElement())
+/////////////////////////////////////////////////
+void Converter::ConvertOperations(TiXmlElement *_elem,
+    const ConvertRecipe &_recipe)
+{
+  for (const ConvertOperation &op : _recipe.operations)
   {
-    if (childElem->ValueStr() == "rename")
+    switch (op.kind)
     {
-      Rename(_elem, childElem);
-    }
-    else if (childElem->ValueStr() == "copy")
-    {
-      Move(_elem, childElem, true);
-    }
-    else if (childElem->ValueStr() == "map")
-    {
-      Map(_elem, childElem);
-    }
-    else if (childElem->ValueStr() == "move")
-    {
-      Move(_elem, childElem, false);
-    }
-    else if (childElem->ValueStr() == "add")
-    {
-      Add(_elem, childElem);
-    }
-    else if (childElem->ValueStr() == "remove")
-    {
-      Remove(_elem, childElem);
-    }
-    else if (childElem->ValueStr() != "convert")
-    {
-      sdferr << "Unknown convert element[" << childElem->ValueStr() << "]\n";
+      case ConvertOperation::Kind::RENAME:
+        Rename(_elem, op);
+        break;
+      case ConvertOperation::Kind::COPY:
+        Move(_elem, op, true);
+        break;
+      case ConvertOperation::Kind::MAP:
+        Map(_elem, op);
+        break;
+      case ConvertOperation::Kind::MOVE:
+        Move(_elem, op, false);
+        break;
+      case ConvertOperation::Kind::ADD:
+        Add(_elem, op);
+        break;
+      case ConvertOperation::Kind::REMOVE:
+        Remove(_elem, op);
+        break;
+      case ConvertOperation::Kind::UNKNOWN:
+        sdferr << "Unknown convert element[" << op.error << "]\n";
+        break;
     }
   }
 }
 
 /////////////////////////////////////////////////
-void Converter::Rename(TiXmlElement *_elem, TiXmlElement *_renameElem)
+void Converter::Rename(TiXmlElement *_elem, const ConvertOperation &_rename)
 {
   SDF_ASSERT(_elem != NULL, "SDF element is NULL");
-  SDF_ASSERT(_renameElem != NULL, "Rename element is NULL");
 
-  TiXmlElement *fromConvertElem = _renameElem->FirstChildElement("from");
-  TiXmlElement *toConvertElem = _renameElem->FirstChildElement("to");
+  const char *fromElemName = cstr(_rename.fromElement);
+  const char *fromAttrName = cstr(_rename.fromAttribute);
 
-  const char *fromElemName = fromConvertElem->Attribute("element");
-  const char *fromAttrName = fromConvertElem->Attribute("attribute");
-
-  const char *toElemName = toConvertElem->Attribute("element");
-  const char *toAttrName = toConvertElem->Attribute("attribute");
+  const char *toElemName = cstr(_rename.toElement);
+  const char *toAttrName = cstr(_rename.toAttribute);
 
   const char *value = GetValue(fromElemName, fromAttrName, _elem);
   if (!value)
@@ -294,14 +712,13 @@ void Converter::Rename(TiXmlElement *_elem, TiXmlElement *_renameElem)
 }
 
 /////////////////////////////////////////////////
-void Converter::Add(TiXmlElement *_elem, TiXmlElement *_addElem)
+void Converter::Add(TiXmlElement *_elem, const ConvertOperation &_add)
 {
   SDF_ASSERT(_elem != NULL, "SDF element is NULL");
-  SDF_ASSERT(_addElem != NULL, "Add element is NULL");
 
-  const char *attributeName = _addElem->Attribute("attribute");
-  const char *elementName = _addElem->Attribute("element");
-  const char *value = _addElem->Attribute("value");
+  const char *attributeName = cstr(_add.attribute);
+  const char *elementName = cstr(_add.element);
+  const char *value = cstr(_add.value);
 
   if (!((attributeName == nullptr) ^ (elementName == nullptr)))
   {
@@ -335,13 +752,12 @@ void Converter::Add(TiXmlElement *_elem, TiXmlElement *_addElem)
 }
 
 /////////////////////////////////////////////////
-void Converter::Remove(TiXmlElement *_elem, TiXmlElement *_removeElem)
+void Converter::Remove(TiXmlElement *_elem, const ConvertOperation &_remove)
 {
   SDF_ASSERT(_elem != NULL, "SDF element is NULL");
-  SDF_ASSERT(_removeElem != NULL, "Move element is NULL");
 
-  const char *attributeName = _removeElem->Attribute("attribute");
-  const char *elementName = _removeElem->Attribute("element");
+  const char *attributeName = cstr(_remove.attribute);
+  const char *elementName = cstr(_remove.element);
 
   if (!((attributeName == nullptr) ^ (elementName == nullptr)))
   {
@@ -366,90 +782,18 @@ void Converter::Remove(TiXmlElement *_elem, TiXmlElement *_removeElem)
 }
 
 /////////////////////////////////////////////////
-void Converter::Map(TiXmlElement *_elem, TiXmlElement *_mapElem)
+void Converter::Map(TiXmlElement *_elem, const ConvertOperation &_map)
 {
   SDF_ASSERT(_elem != nullptr, "SDF element is nullptr");
-  SDF_ASSERT(_mapElem != nullptr, "Map element is nullptr");
-
-  TiXmlElement *fromConvertElem = _mapElem->FirstChildElement("from");
-  TiXmlElement *toConvertElem = _mapElem->FirstChildElement("to");
-
-  if (!fromConvertElem)
-  {
-    sdferr << "<map> element requires a <from> child element.\n";
-    return;
-  }
-  if (!toConvertElem)
-  {
-    sdferr << "<map> element requires a <to> child element.\n";
-    return;
-  }
-
-  const char *fromNameStr = fromConvertElem->Attribute("name");
-  const char *toNameStr = toConvertElem->Attribute("name");
 
-  if (!fromNameStr || fromNameStr[0] == '\0')
-  {
-    sdferr << "Map: <from> element requires a non-empty name attribute.\n";
-    return;
-  }
-  if (!toNameStr || toNameStr[0] == '\0')
-  {
-    sdferr << "Map: <to> element requires a non-empty name attribute.\n";
-    return;
-  }
-
-  // create map of input and output values
-  std::map<std::string, std::string> valueMap;
-  TiXmlElement *fromValueElem = fromConvertElem->FirstChildElement("value");
-  TiXmlElement *toValueElem = toConvertElem->FirstChildElement("value");
-  if (!fromValueElem)
-  {
-    sdferr << "Map: <from> element requires at least one <value> element.\n";
-    return;
-  }
-  if (!toValueElem)
-  {
-    sdferr << "Map: <to> element requires at least one <value> element.\n";
-    return;
-  }
-  if (!fromValueElem->GetText())
-  {
-    sdferr << "Map: from value must not be empty.\n";
-    return;
-  }
-  if (!toValueElem->GetText())
+  if (!_map.error.empty())
   {
-    sdferr << "Map: to value must not be empty.\n";
+    sdferr << _map.error;
     return;
   }
-  valueMap[fromValueElem->GetText()] = toValueElem->GetText();
-  while (fromValueElem->NextSiblingElement("value"))
-  {
-    fromValueElem = fromValueElem->NextSiblingElement("value");
-    if (toValueElem->NextSiblingElement("value"))
-    {
-      toValueElem = toValueElem->NextSiblingElement("value");
-    }
-    if (!fromValueElem->GetText())
-    {
-      sdferr << "Map: from value must not be empty.\n";
-      return;
-    }
-    if (!toValueElem->GetText())
-    {
-      sdferr << "Map: to value must not be empty.\n";
-      return;
-    }
-    valueMap[fromValueElem->GetText()] = toValueElem->GetText();
-  }
 
-  // tokenize 'from' and 'to' name attributes
-  std::string fromStr = fromNameStr;
-  std::string toStr = toNameStr;
-
-  std::vector<std::string> fromTokens = split(fromStr, "/");
-  std::vector<std::string> toTokens = split(toStr, "/");
+  const std::vector<std::string> &fromTokens = _map.fromTokens;
+  const std::vector<std::string> &toTokens = _map.toTokens;
 
   // split() always returns at least one element, even with the
   // empty string.  Thus we don't check if the fromTokens or toTokens are empty.
@@ -486,12 +830,14 @@ void Converter::Map(TiXmlElement *_elem, TiXmlElement *_mapElem)
     fromValue = GetValue(fromLeaf, nullptr, fromElem);
   }
 
-  if (!fromValue || valueMap.end() == valueMap.find(std::string(fromValue)))
+  auto mapped = fromValue ?
+      _map.valueMap.find(std::string(fromValue)) : _map.valueMap.end();
+  if (mapped == _map.valueMap.end())
   {
     // No match, no message to avoid spam.
     return;
   }
-  const char *toValue = valueMap[std::string(fromValue)].c_str();
+  const char *toValue = mapped->second.c_str();
   // sdfdbg << "Map from [" << fromValue << "] to [" << toValue << "]\n";
 
   // check if destination elements before leaf exist and create if necessary
@@ -551,43 +897,19 @@ void Converter::Map(TiXmlElement *_elem, TiXmlElement *_mapElem)
 }
 
 /////////////////////////////////////////////////
-void Converter::Move(TiXmlElement *_elem, TiXmlElement *_moveElem,
+void Converter::Move(TiXmlElement *_elem, const ConvertOperation &_move,
                      const bool _copy)
 {
   SDF_ASSERT(_elem != NULL, "SDF element is NULL");
-  SDF_ASSERT(_moveElem != NULL, "Move element is NULL");
 
-  TiXmlElement *fromConvertElem = _moveElem->FirstChildElement("from");
-  TiXmlElement *toConvertElem = _moveElem->FirstChildElement("to");
+  const char *fromElemStr = cstr(_move.fromElement);
+  const char *fromAttrStr = cstr(_move.fromAttribute);
 
-  const char *fromElemStr = fromConvertElem->Attribute("element");
-  const char *fromAttrStr = fromConvertElem->Attribute("attribute");
+  const char *toElemStr = cstr(_move.toElement);
+  const char *toAttrStr = cstr(_move.toAttribute);
 
-  const char *toElemStr = toConvertElem->Attribute("element");
-  const char *toAttrStr = toConvertElem->Attribute("attribute");
-
-  // tokenize 'from' and 'to' strs
-  std::string fromStr = "";
-  if (fromElemStr)
-  {
-    fromStr = fromElemStr;
-  }
-  else if (fromAttrStr)
-  {
-    fromStr = fromAttrStr;
-  }
-  std::string toStr = "";
-  if (toElemStr)
-  {
-    toStr = toElemStr;
-  }
-  else if (toAttrStr)
-  {
-    toStr = toAttrStr;
-  }
-
-  std::vector<std::string> fromTokens = split(fromStr, "::");
-  std::vector<std::string> toTokens = split(toStr, "::");
+  const std::vector<std::string> &fromTokens = _move.fromTokens;
+  const std::vector<std::string> &toTokens = _move.toTokens;
 
   // split() always returns at least one element, even with the
   // empty string.  Thus we don't check if the fromTokens or toTokens are empty.
@@ -733,15 +1055,12 @@ const char *Converter::GetValue(const char *_valueElem, const char *_valueAttr,
 }
 
 /////////////////////////////////////////////////
-void Converter::CheckDeprecation(TiXmlElement *_elem, TiXmlElement *_convert)
+void Converter::CheckDeprecation(TiXmlElement *_elem,
+    const ConvertRecipe &_convert)
 {
   // Process deprecated elements
-  for (TiXmlElement *deprecatedElem = _convert->FirstChildElement("deprecated");
-       deprecatedElem;
-       deprecatedElem = deprecatedElem->NextSiblingElement("deprecated"))
+  for (const std::vector<std::string> &valueSplit : _convert.deprecated)
   {
-    std::string value = deprecatedElem->GetText();
-    std::vector<std::string> valueSplit = split(value, "/");
 
     bool found = false;
     TiXmlElement *e = _elem;
@@ -20,6 +20,7 @@
 #include <tinyxml.h>
 
 #include <string>
+#include <vector>
 
 #include <sdf/sdf_config.h>
 #include "sdf/system_util.hh"
@@ -30,7 +31,19 @@ namespace sdf
   inline namespace SDF_VERSION_NAMESPACE {
   //
 
-  /// \brief Convert from one version of SDF to another
+  // Forward declarations.
+  struct ConvertOperation;
+  struct ConvertRecipe;
+  struct ConvertTask;
+
+  /// \brief Convert from one version of SDF to another.
+  ///
+  /// The embedded conversion recipes are parsed and compiled once, the first
+  /// time a document is converted, into a tree of operations that is then
+  /// run on every document without parsing the recipes again. The recipes
+  /// of all the versions between the version of a document and the target
+  /// version run in a single traversal of the document, with the nested
+  /// recipes that apply to each element looked up by its name.
   class Converter
   {
     /// \brief Convert SDF to the specified version.
@@ -51,63 +64,60 @@ namespace sdf
                                 TiXmlDocument *_convertDoc);
     /// \endcond
 
-    /// \brief Implementation of Convert functionality.
+    /// \brief Implementation of Convert functionality, which runs the
+    /// recipes of an element and of its descendants in a single traversal.
     /// \param[in] _elem SDF xml element tree to convert.
-    /// \param[in] _convert Convert xml element tree.
+    /// \param[in] _tasks Compiled recipes to run on the element, in order.
     private: static void ConvertImpl(TiXmlElement *_elem,
-                                     TiXmlElement *_convert);
+                                     const std::vector<ConvertTask> &_tasks);
 
-    /// \brief Recursive helper function for ConvertImpl that converts
-    /// elements named by the descendant_name attribute.
-    /// \param[in] _e SDF xml element tree to convert.
-    /// \param[in] _c Convert xml element tree.
-    private: static void ConvertDescendantsImpl(TiXmlElement *_e,
-                                                TiXmlElement *_c);
+    /// \brief Run the operations of a recipe on an element.
+    /// \param[in] _elem SDF xml element to convert.
+    /// \param[in] _recipe Compiled convert element.
+    private: static void ConvertOperations(TiXmlElement *_elem,
+                                           const ConvertRecipe &_recipe);
 
     /// \brief Rename an element or attribute.
     /// \param[in] _elem The element to be renamed, or the element which
     /// has the attribute to be renamed.
-    /// \param[in] _renameElem A 'convert' element that describes the rename
-    /// operation.
+    /// \param[in] _rename A compiled 'rename' operation.
     private: static void Rename(TiXmlElement *_elem,
-                                TiXmlElement *_renameElem);
+                                const ConvertOperation &_rename);
 
     /// \brief Map values from one element or attribute to another.
     /// \param[in] _elem Ancestor element of the element or attribute to
     /// be mapped.
-    /// \param[in] _mapElem A 'convert' element that describes the map
-    /// operation.
+    /// \param[in] _map A compiled 'map' operation.
     private: static void Map(TiXmlElement *_elem,
-                             TiXmlElement *_mapElem);
+                             const ConvertOperation &_map);
 
     /// \brief Move an element or attribute within a common ancestor element.
     /// \param[in] _elem Ancestor element of the element or attribute to
     /// be moved.
-    /// \param[in] _moveElem A 'convert' element that describes the move
-    /// operation.
+    /// \param[in] _move A compiled 'move' or 'copy' operation.
     /// \param[in] _copy True to copy the element
     private: static void Move(TiXmlElement *_elem,
-                              TiXmlElement *_moveElem,
+                              const ConvertOperation &_move,
                               const bool _copy);
 
     /// \brief Add an element or attribute to an element.
     /// \param[in] _elem The element to receive the value.
-    /// \param[in] _addElem A 'convert' element that describes the add
-    /// operation.
+    /// \param[in] _add A compiled 'add' operation.
     private: static void Add(TiXmlElement *_elem,
-                             TiXmlElement *_addElem);
+                             const ConvertOperation &_add);
 
     /// \brief Remove an element.
     /// \param[in] _elem The element that has the _removeElem child.
-    /// \param[in] _removeElem The element to remove.
-    private: static void Remove(TiXmlElement *_elem, TiXmlElement *_removeElem);
+    /// \param[in] _remove A compiled 'remove' operation.
+    private: static void Remove(TiXmlElement *_elem,
+                                const ConvertOperation &_remove);
 
     private: static const char *GetValue(const char *_valueElem,
                                          const char *_valueAttr,
                                          TiXmlElement *_elem);
 
     private: static void CheckDeprecation(TiXmlElement *_elem,
-                                          TiXmlElement *_convert);
+                                          const ConvertRecipe &_convert);
   };
   }
 }
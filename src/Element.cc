@@ -18,19 +18,125 @@
 #include <algorithm>
 #include <sstream>
 #include <string>
+#include <unordered_set>
 
 #include "sdf/Assert.hh"
 #include "sdf/Element.hh"
 #include "sdf/Filesystem.hh"
 
+#include "ParseArena.hh"
+
 using namespace sdf;
 
+/////////////////////////////////////////////////
+/// \brief Get a name index that can be modified. A new index is created if
+/// there is none, and a shared index is copied first.
+/// \param[in,out] _index The index.
+/// \return The index, which is not shared with any other element.
+static ElementPrivate::NameIndex &writableIndex(
+    std::shared_ptr<ElementPrivate::NameIndex> &_index)
+{
+  if (!_index)
+    _index = std::make_shared<ElementPrivate::NameIndex>();
+  else if (_index.use_count() > 1)
+    _index = std::make_shared<ElementPrivate::NameIndex>(*_index);
+  return *_index;
+}
+
+/////////////////////////////////////////////////
+/// \brief Append an attribute and add it to the attribute index.
+/// \param[in] _data Private data of the element.
+/// \param[in] _param The attribute.
+static void pushAttribute(ElementPrivate &_data, ParamPtr _param)
+{
+  writableIndex(_data.attributeIndex).emplace(
+      _param->GetKey(), _data.attributes.size());
+  _data.attributes.push_back(_param);
+}
+
+/////////////////////////////////////////////////
+/// \brief Append an element description and add it to the description
+/// index.
+/// \param[in] _data Private data of the element.
+/// \param[in] _elem The element description.
+static void pushElementDescription(ElementPrivate &_data, ElementPtr _elem)
+{
+  writableIndex(_data.elementDescriptionIndex).emplace(
+      _elem->GetName(), _data.elementDescriptions.size());
+  _data.elementDescriptions.push_back(_elem);
+}
+
+/////////////////////////////////////////////////
+/// \brief Find the first entry with a given name using a name index.
+/// If the indexed entry was renamed after it was added, fall back to a
+/// linear search.
+/// \param[in] _index The name index, may be null.
+/// \param[in] _vec The indexed vector.
+/// \param[in] _name Name to look for.
+/// \param[in] _getName Function that returns the name of an entry.
+/// \param[in] _scanOnMiss True to also search linearly for names that are
+/// not in the index, for entries that may be renamed without the index
+/// knowing. Otherwise names that are not in the index are not in the
+/// vector.
+/// \return Pointer to the entry in the vector, or nullptr if not found.
+template<typename T, typename F>
+static const T *findByName(const ElementPrivate::NameIndex *_index,
+                           const std::pmr::vector<T> &_vec,
+                           const std::string &_name, F _getName,
+                           const bool _scanOnMiss = false)
+{
+  if (!_index && !_scanOnMiss)
+    return nullptr;
+
+  if (_index)
+  {
+    auto it = _index->find(_name);
+    if (it == _index->end() && !_scanOnMiss)
+      return nullptr;
+
+    if (it != _index->end() && it->second < _vec.size() &&
+        _getName(_vec[it->second]) == _name)
+    {
+      return &_vec[it->second];
+    }
+  }
+
+  for (const auto &entry : _vec)
+  {
+    if (_getName(entry) == _name)
+      return &entry;
+  }
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+/// \brief Create a string that is shared between elements.
+/// \param[in] _str Value of the string.
+/// \return The shared string, or null if it is empty.
+static std::shared_ptr<const std::string> sharedString(const std::string &_str)
+{
+  if (_str.empty())
+    return nullptr;
+  return std::make_shared<const std::string>(_str);
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the value of a string that is shared between elements.
+/// \param[in] _str The shared string, may be null.
+/// \return Value of the string, which is empty if it is null.
+static const std::string &sharedValue(
+    const std::shared_ptr<const std::string> &_str)
+{
+  static const std::string empty;
+  return _str ? *_str : empty;
+}
+
 /////////////////////////////////////////////////
 Element::Element()
-  : dataPtr(new ElementPrivate)
+  : dataPtr(ParseArena::MakeUnique<ElementPrivate>(ParseArena::Resource()))
 {
   this->dataPtr->copyChildren = false;
-  this->dataPtr->referenceSDF = "";
+  this->dataPtr->referenceSDF.clear();
 }
 
 /////////////////////////////////////////////////
@@ -49,24 +155,37 @@ void Element::SetParent(const ElementPtr _parent)
 {
   this->dataPtr->parent = _parent;
 
-  // If this element doesn't have a path, get it from the parent
-  if (nullptr != _parent && (this->FilePath().empty() ||
-      this->FilePath() == "data-string"))
+  // If this element doesn't have a path, get it from the parent. The path
+  // is shared rather than copied.
+  if (nullptr != _parent && (!this->dataPtr->path ||
+      *this->dataPtr->path == "data-string"))
   {
-    this->SetFilePath(_parent->FilePath());
+    this->dataPtr->path = _parent->dataPtr->path;
   }
 
   // If this element doesn't have an original version, get it from the parent
-  if (nullptr != _parent && this->OriginalVersion().empty())
+  if (nullptr != _parent && this->dataPtr->originalVersion.empty())
   {
-    this->SetOriginalVersion(_parent->OriginalVersion());
+    this->dataPtr->originalVersion = _parent->dataPtr->originalVersion;
   }
 }
 
 /////////////////////////////////////////////////
 void Element::SetName(const std::string &_name)
 {
-  this->dataPtr->name = _name;
+  if (this->dataPtr->name == _name)
+    return;
+
+  // Keep the parent's element index in sync. If the old name is not in the
+  // index, this element has not been inserted into its parent yet.
+  auto parent = this->dataPtr->parent.lock();
+  bool inParentIndex = parent &&
+      parent->dataPtr->elementIndex.count(this->dataPtr->name) > 0;
+
+  this->dataPtr->name = InternedString::Lookup(_name);
+
+  if (inParentIndex)
+    parent->RebuildElementIndex();
 }
 
 /////////////////////////////////////////////////
@@ -128,8 +247,8 @@ ParamPtr Element::CreateParam(const std::string &_key,
                               bool _required,
                               const std::string &_description)
 {
-  return ParamPtr(
-      new Param(_key, _type, _defaultValue, _required, _description));
+  return ParseArena::MakeShared<Param>(
+      _key, _type, _defaultValue, _required, _description);
 }
 
 /////////////////////////////////////////////////
@@ -139,14 +258,26 @@ void Element::AddAttribute(const std::string &_key,
                            bool _required,
                            const std::string &_description)
 {
-  this->dataPtr->attributes.push_back(
+  pushAttribute(*this->dataPtr,
       this->CreateParam(_key, _type, _defaultValue, _required, _description));
 }
 
 /////////////////////////////////////////////////
 ElementPtr Element::Clone() const
 {
-  ElementPtr clone(new Element);
+  return this->CloneImpl(false);
+}
+
+/////////////////////////////////////////////////
+ElementPtr Element::CloneWithSharedDescriptions() const
+{
+  return this->CloneImpl(true);
+}
+
+/////////////////////////////////////////////////
+ElementPtr Element::CloneImpl(const bool _shareDescriptions) const
+{
+  ElementPtr clone = ParseArena::MakeShared<Element>();
   clone->dataPtr->description = this->dataPtr->description;
   clone->dataPtr->name = this->dataPtr->name;
   clone->dataPtr->required = this->dataPtr->required;
@@ -156,25 +287,36 @@ ElementPtr Element::Clone() const
   clone->dataPtr->path = this->dataPtr->path;
   clone->dataPtr->originalVersion = this->dataPtr->originalVersion;
 
-  Param_V::const_iterator aiter;
+  ElementPrivate::ParamVector::const_iterator aiter;
   for (aiter = this->dataPtr->attributes.begin();
        aiter != this->dataPtr->attributes.end(); ++aiter)
   {
     clone->dataPtr->attributes.push_back((*aiter)->Clone());
   }
+  clone->dataPtr->attributeIndex = this->dataPtr->attributeIndex;
 
-  ElementPtr_V::const_iterator eiter;
-  for (eiter = this->dataPtr->elementDescriptions.begin();
-      eiter != this->dataPtr->elementDescriptions.end(); ++eiter)
+  ElementPrivate::ElementVector::const_iterator eiter;
+  if (_shareDescriptions)
   {
-    clone->dataPtr->elementDescriptions.push_back((*eiter)->Clone());
+    clone->dataPtr->elementDescriptions = this->dataPtr->elementDescriptions;
   }
+  else
+  {
+    for (eiter = this->dataPtr->elementDescriptions.begin();
+        eiter != this->dataPtr->elementDescriptions.end(); ++eiter)
+    {
+      clone->dataPtr->elementDescriptions.push_back((*eiter)->Clone());
+    }
+  }
+  clone->dataPtr->elementDescriptionIndex =
+      this->dataPtr->elementDescriptionIndex;
 
   for (eiter = this->dataPtr->elements.begin();
        eiter != this->dataPtr->elements.end(); ++eiter)
   {
-    clone->dataPtr->elements.push_back((*eiter)->Clone());
-    clone->dataPtr->elements.back()->SetParent(clone);
+    ElementPtr elem = (*eiter)->CloneImpl(_shareDescriptions);
+    elem->SetParent(clone);
+    clone->PushElement(elem);
   }
 
   if (this->dataPtr->value)
@@ -188,21 +330,22 @@ ElementPtr Element::Clone() const
 /////////////////////////////////////////////////
 void Element::Copy(const ElementPtr _elem)
 {
-  this->dataPtr->name = _elem->GetName();
-  this->dataPtr->description = _elem->GetDescription();
-  this->dataPtr->required = _elem->GetRequired();
+  this->SetName(_elem->GetName());
+  this->dataPtr->description = _elem->dataPtr->description;
+  this->dataPtr->required = _elem->dataPtr->required;
   this->dataPtr->copyChildren = _elem->GetCopyChildren();
   this->dataPtr->includeFilename = _elem->dataPtr->includeFilename;
-  this->dataPtr->referenceSDF = _elem->ReferenceSDF();
-  this->dataPtr->originalVersion = _elem->OriginalVersion();
-  this->dataPtr->path = _elem->FilePath();
+  this->dataPtr->referenceSDF = _elem->dataPtr->referenceSDF;
+  this->dataPtr->originalVersion = _elem->dataPtr->originalVersion;
+  this->dataPtr->path = _elem->dataPtr->path;
 
-  for (Param_V::iterator iter = _elem->dataPtr->attributes.begin();
+  for (ElementPrivate::ParamVector::iterator iter =
+       _elem->dataPtr->attributes.begin();
        iter != _elem->dataPtr->attributes.end(); ++iter)
   {
     if (!this->HasAttribute((*iter)->GetKey()))
     {
-      this->dataPtr->attributes.push_back((*iter)->Clone());
+      pushAttribute(*this->dataPtr, (*iter)->Clone());
     }
     ParamPtr param = this->GetAttribute((*iter)->GetKey());
     (*param) = (**iter);
@@ -221,21 +364,25 @@ void Element::Copy(const ElementPtr _elem)
   }
 
   this->dataPtr->elementDescriptions.clear();
-  for (ElementPtr_V::const_iterator iter =
+  for (ElementPrivate::ElementVector::const_iterator iter =
        _elem->dataPtr->elementDescriptions.begin();
        iter != _elem->dataPtr->elementDescriptions.end(); ++iter)
   {
     this->dataPtr->elementDescriptions.push_back((*iter)->Clone());
   }
+  this->dataPtr->elementDescriptionIndex =
+      _elem->dataPtr->elementDescriptionIndex;
 
   this->dataPtr->elements.clear();
-  for (ElementPtr_V::iterator iter = _elem->dataPtr->elements.begin();
+  this->dataPtr->elementIndex.clear();
+  for (ElementPrivate::ElementVector::iterator iter =
+       _elem->dataPtr->elements.begin();
        iter != _elem->dataPtr->elements.end(); ++iter)
   {
     ElementPtr elem = (*iter)->Clone();
     elem->Copy(*iter);
     elem->SetParent(shared_from_this());
-    this->dataPtr->elements.push_back(elem);
+    this->PushElement(elem);
   }
 }
 
@@ -258,7 +405,7 @@ void Element::PrintDescription(const std::string &_prefix) const
   std::cout << _prefix << "  <description>" << this->dataPtr->description
             << "</description>\n";
 
-  Param_V::iterator aiter;
+  ElementPrivate::ParamVector::iterator aiter;
   for (aiter = this->dataPtr->attributes.begin();
       aiter != this->dataPtr->attributes.end(); ++aiter)
   {
@@ -284,7 +431,7 @@ void Element::PrintDescription(const std::string &_prefix) const
               << "' required ='*'/>\n";
   }
 
-  ElementPtr_V::iterator eiter;
+  ElementPrivate::ElementVector::iterator eiter;
   for (eiter = this->dataPtr->elementDescriptions.begin();
       eiter != this->dataPtr->elementDescriptions.end(); ++eiter)
   {
@@ -299,7 +446,7 @@ void Element::PrintDocRightPane(std::string &_html, int _spacing,
                                 int &_index) const
 {
   std::ostringstream stream;
-  ElementPtr_V::iterator eiter;
+  ElementPrivate::ElementVector::iterator eiter;
 
   int start = _index++;
 
@@ -351,7 +498,7 @@ void Element::PrintDocRightPane(std::string &_html, int _spacing,
            << "display:inline-block;'>\n";
     stream << "<font style='font-weight:bold'>Attributes</font><br>";
 
-    Param_V::iterator aiter;
+    ElementPrivate::ParamVector::iterator aiter;
     for (aiter = this->dataPtr->attributes.begin();
         aiter != this->dataPtr->attributes.end(); ++aiter)
     {
@@ -395,7 +542,7 @@ void Element::PrintDocLeftPane(std::string &_html, int _spacing,
                                int &_index) const
 {
   std::ostringstream stream;
-  ElementPtr_V::iterator eiter;
+  ElementPrivate::ElementVector::iterator eiter;
 
   int start = _index++;
 
@@ -422,7 +569,7 @@ void Element::PrintValuesImpl(const std::string &_prefix,
 {
   _out << _prefix << "<" << this->dataPtr->name;
 
-  Param_V::const_iterator aiter;
+  ElementPrivate::ParamVector::const_iterator aiter;
   for (aiter = this->dataPtr->attributes.begin();
        aiter != this->dataPtr->attributes.end(); ++aiter)
   {
@@ -441,7 +588,7 @@ void Element::PrintValuesImpl(const std::string &_prefix,
   if (this->dataPtr->elements.size() > 0)
   {
     _out << ">\n";
-    ElementPtr_V::const_iterator eiter;
+    ElementPrivate::ElementVector::const_iterator eiter;
     for (eiter = this->dataPtr->elements.begin();
          eiter != this->dataPtr->elements.end(); ++eiter)
     {
@@ -483,31 +630,30 @@ std::string Element::ToString(const std::string &_prefix) const
 void Element::ToString(const std::string &_prefix,
                        std::ostringstream &_out) const
 {
-  if (this->dataPtr->includeFilename.empty())
+  if (!this->dataPtr->includeFilename)
   {
     PrintValuesImpl(_prefix, _out);
   }
   else
   {
     _out << _prefix << "<include filename='"
-         << this->dataPtr->includeFilename << "'/>\n";
+         << *this->dataPtr->includeFilename << "'/>\n";
   }
 }
 
 /////////////////////////////////////////////////
 bool Element::HasAttribute(const std::string &_key) const
 {
-  return this->GetAttribute(_key) != nullptr;
+  return this->FindAttribute(_key) != nullptr;
 }
 
 /////////////////////////////////////////////////
 bool Element::GetAttributeSet(const std::string &_key) const
 {
   bool result = false;
-  ParamPtr p = this->GetAttribute(_key);
-  if (p)
+  if (const ParamPtr *p = this->FindAttribute(_key))
   {
-    result = p->GetSet();
+    result = (*p)->GetSet();
   }
 
   return result;
@@ -516,16 +662,16 @@ bool Element::GetAttributeSet(const std::string &_key) const
 /////////////////////////////////////////////////
 ParamPtr Element::GetAttribute(const std::string &_key) const
 {
-  Param_V::const_iterator iter;
-  for (iter = this->dataPtr->attributes.begin();
-      iter != this->dataPtr->attributes.end(); ++iter)
-  {
-    if ((*iter)->GetKey() == _key)
-    {
-      return (*iter);
-    }
-  }
-  return ParamPtr();
+  const ParamPtr *param = this->FindAttribute(_key);
+  return param ? *param : ParamPtr();
+}
+
+/////////////////////////////////////////////////
+const ParamPtr *Element::FindAttribute(const std::string &_key) const
+{
+  return findByName(this->dataPtr->attributeIndex.get(),
+      this->dataPtr->attributes, _key,
+      [](const ParamPtr &_p) -> const std::string & {return _p->GetKey();});
 }
 
 /////////////////////////////////////////////////
@@ -566,17 +712,20 @@ ElementPtr Element::GetElementDescription(unsigned int _index) const
 /////////////////////////////////////////////////
 ElementPtr Element::GetElementDescription(const std::string &_key) const
 {
-  ElementPtr_V::const_iterator iter;
-  for (iter = this->dataPtr->elementDescriptions.begin();
-       iter != this->dataPtr->elementDescriptions.end(); ++iter)
-  {
-    if ((*iter)->GetName() == _key)
-    {
-      return (*iter);
-    }
-  }
+  const ElementPtr *desc = this->FindElementDescription(_key);
+  return desc ? *desc : ElementPtr();
+}
 
-  return ElementPtr();
+/////////////////////////////////////////////////
+const ElementPtr *Element::FindElementDescription(
+    const std::string &_name) const
+{
+  // A description may be renamed with SetName, which doesn't know about
+  // the elements that it describes.
+  return findByName(this->dataPtr->elementDescriptionIndex.get(),
+      this->dataPtr->elementDescriptions, _name,
+      [](const ElementPtr &_e) -> const std::string & {return _e->GetName();},
+      true);
 }
 
 /////////////////////////////////////////////////
@@ -588,23 +737,22 @@ ParamPtr Element::GetValue() const
 /////////////////////////////////////////////////
 bool Element::HasElement(const std::string &_name) const
 {
-  return this->GetElementImpl(_name) != ElementPtr();
+  return this->FindElement(_name) != nullptr;
 }
 
 /////////////////////////////////////////////////
 ElementPtr Element::GetElementImpl(const std::string &_name) const
 {
-  ElementPtr_V::const_iterator iter;
-  for (iter = this->dataPtr->elements.begin();
-       iter != this->dataPtr->elements.end(); ++iter)
-  {
-    if ((*iter)->GetName() == _name)
-    {
-      return (*iter);
-    }
-  }
+  const ElementPtr *elem = this->FindElement(_name);
+  return elem ? *elem : ElementPtr();
+}
 
-  return ElementPtr();
+/////////////////////////////////////////////////
+const ElementPtr *Element::FindElement(const std::string &_name) const
+{
+  return findByName(&this->dataPtr->elementIndex,
+      this->dataPtr->elements, _name,
+      [](const ElementPtr &_e) -> const std::string & {return _e->GetName();});
 }
 
 /////////////////////////////////////////////////
@@ -623,35 +771,31 @@ ElementPtr Element::GetFirstElement() const
 /////////////////////////////////////////////////
 ElementPtr Element::GetNextElement(const std::string &_name) const
 {
-  auto parent = this->dataPtr->parent.lock();
-  if (parent)
+  // The parent is locked, so that another thread can't destroy it while
+  // its children are searched.
+  if (ElementPtr parent = this->dataPtr->parent.lock())
   {
-    ElementPtr_V::const_iterator iter;
-    iter = std::find(parent->dataPtr->elements.begin(),
-        parent->dataPtr->elements.end(), shared_from_this());
+    const ElementPrivate::ElementVector &siblings = parent->dataPtr->elements;
 
-    if (iter == parent->dataPtr->elements.end())
+    // Use the position this element was inserted at if it is still valid,
+    // otherwise search for this element.
+    std::size_t index = this->dataPtr->positionInParent;
+    if (index >= siblings.size() || siblings[index].get() != this)
     {
-      return ElementPtr();
+      auto iter = std::find_if(siblings.begin(), siblings.end(),
+          [this](const ElementPtr &_elem) {return _elem.get() == this;});
+      if (iter == siblings.end())
+      {
+        return ElementPtr();
+      }
+      index = static_cast<std::size_t>(iter - siblings.begin());
     }
 
-    ++iter;
-    if (iter == parent->dataPtr->elements.end())
+    for (++index; index < siblings.size(); ++index)
     {
-      return ElementPtr();
-    }
-    else if (_name.empty())
-    {
-      return *(iter);
-    }
-    else
-    {
-      for (; iter != parent->dataPtr->elements.end(); ++iter)
+      if (_name.empty() || siblings[index]->GetName() == _name)
       {
-        if ((*iter)->GetName() == _name)
-        {
-          return (*iter);
-        }
+        return siblings[index];
       }
     }
   }
@@ -659,16 +803,19 @@ ElementPtr Element::GetNextElement(const std::string &_name) const
   return ElementPtr();
 }
 
+/////////////////////////////////////////////////
+ElementRange Element::Children(const std::string &_name) const
+{
+  return ElementRange(this->dataPtr->elements, _name);
+}
+
 /////////////////////////////////////////////////
 std::set<std::string> Element::GetElementTypeNames() const
 {
   std::set<std::string> result;
-  auto elem = this->GetFirstElement();
-  while (elem)
+  for (const ElementPtr &elem : this->Children())
   {
-    std::string typeName = elem->GetName();
-    result.insert(typeName);
-    elem = elem->GetNextElement();
+    result.insert(elem->GetName());
   }
   return result;
 }
@@ -676,10 +823,12 @@ std::set<std::string> Element::GetElementTypeNames() const
 /////////////////////////////////////////////////
 bool Element::HasUniqueChildNames(const std::string &_type) const
 {
-  auto namedElementsCount = this->CountNamedElements(_type);
-  for (auto &iter : namedElementsCount)
+  // Stop at the first duplicate name instead of counting all the names.
+  std::unordered_set<std::string> names;
+  for (const ElementPtr &elem : this->Children(_type))
   {
-    if (iter.second > 1)
+    if (elem->HasAttribute("name") &&
+        !names.insert(elem->Get<std::string>("name")).second)
     {
       return false;
     }
@@ -693,35 +842,15 @@ Element::CountNamedElements(const std::string &_type) const
 {
   std::map<std::string, std::size_t> result;
 
-  sdf::ElementPtr elem;
-  if (_type.empty())
-  {
-    elem = this->GetFirstElement();
-  }
-  else
-  {
-    elem = this->GetElementImpl(_type);
-  }
-
-  while (elem)
+  for (const ElementPtr &elem : this->Children(_type))
   {
     if (elem->HasAttribute("name"))
     {
       // Get("name") returns attribute value if it exists before checking
       // for the value of a child element <name>, so it's safe to use
       // here since we've checked HasAttribute("name").
-      std::string childNameAttributeValue = elem->Get<std::string>("name");
-      if (result.find(childNameAttributeValue) == result.end())
-      {
-        result[childNameAttributeValue] = 1;
-      }
-      else
-      {
-        ++result[childNameAttributeValue];
-      }
+      ++result[elem->Get<std::string>("name")];
     }
-
-    elem = elem->GetNextElement(_type);
   }
 
   return result;
@@ -742,13 +871,13 @@ ElementPtr Element::GetElement(const std::string &_name)
 /////////////////////////////////////////////////
 void Element::InsertElement(ElementPtr _elem)
 {
-  this->dataPtr->elements.push_back(_elem);
+  this->PushElement(_elem);
 }
 
 /////////////////////////////////////////////////
 bool Element::HasElementDescription(const std::string &_name) const
 {
-  return this->GetElementDescription(_name) != ElementPtr();
+  return this->FindElementDescription(_name) != nullptr;
 }
 
 /////////////////////////////////////////////////
@@ -761,36 +890,28 @@ ElementPtr Element::AddElement(const std::string &_name)
       this->dataPtr->elementDescriptions.empty() && parent &&
       parent->GetName() == this->dataPtr->name)
   {
-    for (unsigned int i = 0; i < parent->GetElementDescriptionCount(); ++i)
-    {
-      this->dataPtr->elementDescriptions.push_back(
-          parent->GetElementDescription(i)->Clone());
-    }
+    this->dataPtr->elementDescriptions = parent->dataPtr->elementDescriptions;
+    this->dataPtr->elementDescriptionIndex =
+        parent->dataPtr->elementDescriptionIndex;
   }
 
-  ElementPtr_V::const_iterator iter, iter2;
-  for (iter = this->dataPtr->elementDescriptions.begin();
-      iter != this->dataPtr->elementDescriptions.end(); ++iter)
+  if (const ElementPtr *desc = this->FindElementDescription(_name))
   {
-    if ((*iter)->dataPtr->name == _name)
-    {
-      ElementPtr elem = (*iter)->Clone();
-      elem->SetParent(shared_from_this());
-      this->dataPtr->elements.push_back(elem);
+    ElementPtr elem = (*desc)->CloneWithSharedDescriptions();
+    elem->SetParent(shared_from_this());
+    this->PushElement(elem);
 
-      // Add all child elements.
-      for (iter2 = elem->dataPtr->elementDescriptions.begin();
-           iter2 != elem->dataPtr->elementDescriptions.end(); ++iter2)
+    // Add all child elements.
+    for (const ElementPtr &childDesc : elem->dataPtr->elementDescriptions)
+    {
+      // Add only required child element
+      if (childDesc->GetRequired() == "1")
       {
-        // Add only required child element
-        if ((*iter2)->GetRequired() == "1")
-        {
-          elem->AddElement((*iter2)->dataPtr->name);
-        }
+        elem->AddElement(childDesc->dataPtr->name);
       }
-
-      return this->dataPtr->elements.back();
     }
+
+    return this->dataPtr->elements.back();
   }
 
   sdferr << "Missing element description for [" << _name << "]\n";
@@ -802,31 +923,35 @@ void Element::Clear()
 {
   this->ClearElements();
   this->dataPtr->originalVersion.clear();
-  this->dataPtr->path.clear();
+  this->dataPtr->path.reset();
 }
 
 /////////////////////////////////////////////////
 void Element::ClearElements()
 {
-  for (sdf::ElementPtr_V::iterator iter = this->dataPtr->elements.begin();
+  for (ElementPrivate::ElementVector::iterator iter =
+       this->dataPtr->elements.begin();
       iter != this->dataPtr->elements.end(); ++iter)
   {
     (*iter)->ClearElements();
   }
 
   this->dataPtr->elements.clear();
+  this->dataPtr->elementIndex.clear();
 }
 
 /////////////////////////////////////////////////
 void Element::Update()
 {
-  for (sdf::Param_V::iterator iter = this->dataPtr->attributes.begin();
+  for (ElementPrivate::ParamVector::iterator iter =
+       this->dataPtr->attributes.begin();
       iter != this->dataPtr->attributes.end(); ++iter)
   {
     (*iter)->Update();
   }
 
-  for (sdf::ElementPtr_V::iterator iter = this->dataPtr->elements.begin();
+  for (ElementPrivate::ElementVector::iterator iter =
+       this->dataPtr->elements.begin();
       iter != this->dataPtr->elements.end(); ++iter)
   {
     (*iter)->Update();
@@ -841,7 +966,8 @@ void Element::Update()
 /////////////////////////////////////////////////
 void Element::Reset()
 {
-  for (ElementPtr_V::iterator iter = this->dataPtr->elements.begin();
+  for (ElementPrivate::ElementVector::iterator iter =
+       this->dataPtr->elements.begin();
       iter != this->dataPtr->elements.end(); ++iter)
   {
     if (*iter)
@@ -851,17 +977,12 @@ void Element::Reset()
     (*iter).reset();
   }
 
-  for (ElementPtr_V::iterator iter = this->dataPtr->elementDescriptions.begin();
-      iter != this->dataPtr->elementDescriptions.end(); ++iter)
-  {
-    if (*iter)
-    {
-      (*iter)->Reset();
-    }
-    (*iter).reset();
-  }
+  // Element descriptions may be shared with other elements, see
+  // CloneWithSharedDescriptions(), so only release the references to them.
   this->dataPtr->elements.clear();
+  this->dataPtr->elementIndex.clear();
   this->dataPtr->elementDescriptions.clear();
+  this->dataPtr->elementDescriptionIndex.reset();
 
   this->dataPtr->value.reset();
 
@@ -871,31 +992,31 @@ void Element::Reset()
 /////////////////////////////////////////////////
 void Element::AddElementDescription(ElementPtr _elem)
 {
-  this->dataPtr->elementDescriptions.push_back(_elem);
+  pushElementDescription(*this->dataPtr, _elem);
 }
 
 /////////////////////////////////////////////////
 void Element::SetInclude(const std::string &_filename)
 {
-  this->dataPtr->includeFilename = _filename;
+  this->dataPtr->includeFilename = sharedString(_filename);
 }
 
 /////////////////////////////////////////////////
 std::string Element::GetInclude() const
 {
-  return this->dataPtr->includeFilename;
+  return sharedValue(this->dataPtr->includeFilename);
 }
 
 /////////////////////////////////////////////////
 void Element::SetFilePath(const std::string &_path)
 {
-  this->dataPtr->path = _path;
+  this->dataPtr->path = sharedString(_path);
 }
 
 /////////////////////////////////////////////////
 const std::string &Element::FilePath() const
 {
-  return this->dataPtr->path;
+  return sharedValue(this->dataPtr->path);
 }
 
 /////////////////////////////////////////////////
@@ -928,13 +1049,14 @@ void Element::RemoveFromParent()
   auto parent = this->dataPtr->parent.lock();
   if (parent)
   {
-    ElementPtr_V::iterator iter;
+    ElementPrivate::ElementVector::iterator iter;
     iter = std::find(parent->dataPtr->elements.begin(),
         parent->dataPtr->elements.end(), shared_from_this());
 
     if (iter != parent->dataPtr->elements.end())
     {
       parent->dataPtr->elements.erase(iter);
+      parent->RebuildElementIndex();
       parent.reset();
     }
   }
@@ -945,7 +1067,7 @@ void Element::RemoveChild(ElementPtr _child)
 {
   SDF_ASSERT(_child, "Cannot remove a nullptr child pointer");
 
-  ElementPtr_V::iterator iter;
+  ElementPrivate::ElementVector::iterator iter;
   iter = std::find(this->dataPtr->elements.begin(),
                    this->dataPtr->elements.end(), _child);
 
@@ -953,6 +1075,28 @@ void Element::RemoveChild(ElementPtr _child)
   {
     _child->SetParent(ElementPtr());
     this->dataPtr->elements.erase(iter);
+    this->RebuildElementIndex();
+  }
+}
+
+/////////////////////////////////////////////////
+void Element::PushElement(ElementPtr _elem)
+{
+  _elem->dataPtr->positionInParent = this->dataPtr->elements.size();
+  this->dataPtr->elementIndex.emplace(
+      _elem->GetName(), this->dataPtr->elements.size());
+  this->dataPtr->elements.push_back(_elem);
+}
+
+/////////////////////////////////////////////////
+void Element::RebuildElementIndex()
+{
+  this->dataPtr->elementIndex.clear();
+  for (std::size_t i = 0; i < this->dataPtr->elements.size(); ++i)
+  {
+    ElementPtr &elem = this->dataPtr->elements[i];
+    elem->dataPtr->positionInParent = i;
+    this->dataPtr->elementIndex.emplace(elem->GetName(), i);
   }
 }
 
@@ -970,34 +1114,112 @@ std::any Element::GetAny(const std::string &_key) const
   }
   else if (!_key.empty())
   {
-    ParamPtr param = this->GetAttribute(_key);
-    if (param)
+    if (const ParamPtr *param = this->FindAttribute(_key))
     {
-      if (!this->GetAttribute(_key)->GetAny(result))
+      if (!(*param)->GetAny(result))
       {
         sdferr << "Couldn't get attribute [" << _key << "] as std::any\n";
       }
     }
+    else if (const ElementPtr *elem = this->FindElement(_key))
+    {
+      result = (*elem)->GetAny();
+    }
+    else if (const ElementPtr *desc = this->FindElementDescription(_key))
+    {
+      result = (*desc)->GetAny();
+    }
     else
     {
-      ElementPtr tmp = this->GetElementImpl(_key);
-      if (tmp != ElementPtr())
-      {
-        result = tmp->GetAny();
-      }
-      else
-      {
-        tmp = this->GetElementDescription(_key);
-        if (tmp != ElementPtr())
-        {
-          result = tmp->GetAny();
-        }
-        else
-        {
-          sdferr << "Unable to find value for key [" << _key << "]\n";
-        }
-      }
+      sdferr << "Unable to find value for key [" << _key << "]\n";
     }
   }
   return result;
 }
+
+/////////////////////////////////////////////////
+ElementRange::ElementRange(const std::pmr::vector<ElementPtr> &_elements,
+                           const std::string &_name)
+  : elements(&_elements), name(_name)
+{
+}
+
+/////////////////////////////////////////////////
+ElementRange::Iterator ElementRange::begin() const
+{
+  return Iterator(this, 0);
+}
+
+/////////////////////////////////////////////////
+ElementRange::Iterator ElementRange::end() const
+{
+  return Iterator(this, this->elements->size());
+}
+
+/////////////////////////////////////////////////
+bool ElementRange::empty() const
+{
+  return this->begin() == this->end();
+}
+
+/////////////////////////////////////////////////
+ElementRange::Iterator::Iterator(const ElementRange *_range,
+                                 std::size_t _index)
+  : range(_range), index(_index)
+{
+  this->SkipToMatch();
+}
+
+/////////////////////////////////////////////////
+ElementRange::Iterator::reference ElementRange::Iterator::operator*() const
+{
+  return (*this->range->elements)[this->index];
+}
+
+/////////////////////////////////////////////////
+ElementRange::Iterator::pointer ElementRange::Iterator::operator->() const
+{
+  return &(*this->range->elements)[this->index];
+}
+
+/////////////////////////////////////////////////
+ElementRange::Iterator &ElementRange::Iterator::operator++()
+{
+  ++this->index;
+  this->SkipToMatch();
+  return *this;
+}
+
+/////////////////////////////////////////////////
+ElementRange::Iterator ElementRange::Iterator::operator++(int)
+{
+  Iterator result = *this;
+  ++(*this);
+  return result;
+}
+
+/////////////////////////////////////////////////
+bool ElementRange::Iterator::operator==(const Iterator &_other) const
+{
+  return this->range == _other.range && this->index == _other.index;
+}
+
+/////////////////////////////////////////////////
+bool ElementRange::Iterator::operator!=(const Iterator &_other) const
+{
+  return !(*this == _other);
+}
+
+/////////////////////////////////////////////////
+void ElementRange::Iterator::SkipToMatch()
+{
+  if (this->range->name.empty())
+    return;
+
+  const ElementPrivate::ElementVector &elements = *this->range->elements;
+  while (this->index < elements.size() &&
+         elements[this->index]->GetName() != this->range->name)
+  {
+    ++this->index;
+  }
+}
@@ -0,0 +1,814 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "ElementSerializer.hh"
+#include "ParseArena.hh"
+
+namespace sdf
+{
+inline namespace SDF_VERSION_NAMESPACE
+{
+/// \brief First bytes of the binary format.
+static const char kMagic[4] = {'S', 'D', 'F', 'B'};
+
+/// \brief Version of the binary format. Increment it when the layout of
+/// the records or the encoding of a value changes.
+static const std::uint32_t kFormatVersion = 1;
+
+/// \brief Number stored in the header to detect the byte order.
+static const std::uint32_t kByteOrderMark = 0x01020304;
+
+/// \brief Element flag set if the element copies its children.
+static const std::uint32_t kCopyChildren = 1;
+
+/// \brief Element flag set if the element has a value.
+static const std::uint32_t kHasValue = 2;
+
+/// \brief Parameter flag set if the parameter is required.
+static const std::uint8_t kRequired = 1;
+
+/// \brief Parameter flag set if the parameter was set.
+static const std::uint8_t kSet = 2;
+
+/// \brief Header of the binary format. The sections are 8 byte aligned.
+struct BinaryHeader
+{
+  /// \brief kMagic.
+  char magic[4];
+
+  /// \brief kFormatVersion.
+  std::uint32_t formatVersion;
+
+  /// \brief kByteOrderMark.
+  std::uint32_t byteOrder;
+
+  /// \brief String index of the SDFormat version of the specification.
+  std::uint32_t specVersion;
+
+  /// \brief String index of SDF::FilePath().
+  std::uint32_t filePath;
+
+  /// \brief String index of SDF::OriginalVersion().
+  std::uint32_t originalVersion;
+
+  /// \brief Number of StringRecords.
+  std::uint32_t stringCount;
+
+  /// \brief Number of ElementRecords.
+  std::uint32_t elementCount;
+
+  /// \brief Number of ParamRecords.
+  std::uint32_t paramCount;
+
+  /// \brief Unused, zero.
+  std::uint32_t reserved;
+
+  /// \brief Offset of the StringRecords.
+  std::uint64_t stringOffset;
+
+  /// \brief Offset of the ElementRecords.
+  std::uint64_t elementOffset;
+
+  /// \brief Offset of the ParamRecords.
+  std::uint64_t paramOffset;
+
+  /// \brief Offset of the payload.
+  std::uint64_t payloadOffset;
+
+  /// \brief Size of the payload.
+  std::uint64_t payloadSize;
+};
+
+/// \brief A string of the string table.
+struct StringRecord
+{
+  /// \brief Offset of the characters in the payload.
+  std::uint64_t offset;
+
+  /// \brief Number of characters.
+  std::uint64_t size;
+};
+
+/// \brief An element. Elements are stored in document order, each followed
+/// by its descendants, and refer to strings by index.
+struct ElementRecord
+{
+  /// \brief Name.
+  std::uint32_t name;
+
+  /// \brief Requirement string.
+  std::uint32_t required;
+
+  /// \brief Description.
+  std::uint32_t description;
+
+  /// \brief Include filename.
+  std::uint32_t includeFilename;
+
+  /// \brief Name of the reference SDF.
+  std::uint32_t referenceSDF;
+
+  /// \brief File path.
+  std::uint32_t path;
+
+  /// \brief Original version.
+  std::uint32_t originalVersion;
+
+  /// \brief kCopyChildren and kHasValue.
+  std::uint32_t flags;
+
+  /// \brief Index of the first attribute. The value, if any, follows the
+  /// attributes.
+  std::uint32_t firstParam;
+
+  /// \brief Number of attributes.
+  std::uint32_t attributeCount;
+
+  /// \brief Number of child elements.
+  std::uint32_t childCount;
+
+  /// \brief Unused, zero.
+  std::uint32_t reserved;
+};
+
+/// \brief An attribute or a value.
+struct ParamRecord
+{
+  /// \brief Key.
+  std::uint32_t key;
+
+  /// \brief Type name.
+  std::uint32_t typeName;
+
+  /// \brief Description.
+  std::uint32_t description;
+
+  /// \brief ParamPrivate::ValueType.
+  std::uint8_t valueType;
+
+  /// \brief kRequired and kSet.
+  std::uint8_t flags;
+
+  /// \brief Index of the type of the value in ParamVariant.
+  std::uint8_t valueIndex;
+
+  /// \brief Index of the type of the default value in ParamVariant.
+  std::uint8_t defaultIndex;
+
+  /// \brief Offset of the value in the payload.
+  std::uint64_t value;
+
+  /// \brief Offset of the default value in the payload.
+  std::uint64_t defaultValue;
+};
+
+static_assert(sizeof(BinaryHeader) % 8 == 0 && sizeof(StringRecord) % 8 == 0
+    && sizeof(ElementRecord) % 8 == 0 && sizeof(ParamRecord) % 8 == 0,
+    "Records must keep the sections 8 byte aligned");
+
+/////////////////////////////////////////////////
+/// \brief Append a record to a section.
+/// \param[in,out] _section The section.
+/// \param[in] _record The record.
+template<typename T>
+static void appendRecord(std::string &_section, const T &_record)
+{
+  _section.append(reinterpret_cast<const char *>(&_record), sizeof(T));
+}
+
+/////////////////////////////////////////////////
+/// \brief Copy a record out of the data. The records are copied instead of
+/// cast in place, so that data that is not aligned can be read as well.
+/// \param[in] _data The data.
+/// \param[in] _offset Offset of the first record.
+/// \param[in] _index Index of the record.
+/// \return The record.
+template<typename T>
+static T readRecord(std::string_view _data, std::uint64_t _offset,
+    std::uint32_t _index)
+{
+  T record;
+  std::memcpy(&record, _data.data() + _offset + _index * sizeof(T),
+      sizeof(T));
+  return record;
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether a section of records is within the data.
+/// \param[in] _data The data.
+/// \param[in] _offset Offset of the section.
+/// \param[in] _count Number of records.
+/// \param[in] _recordSize Size of a record.
+/// \return True if it is.
+static bool sectionInRange(std::string_view _data, std::uint64_t _offset,
+    std::uint64_t _count, std::size_t _recordSize)
+{
+  return _offset <= _data.size() &&
+      _count <= (_data.size() - _offset) / _recordSize;
+}
+
+/////////////////////////////////////////////////
+/// \brief Append an error about binary data to a list of errors.
+/// \param[out] _errors The list of errors.
+/// \param[in] _message The error message.
+/// \return False.
+static bool binaryError(Errors &_errors, const std::string &_message)
+{
+  _errors.push_back({ErrorCode::FILE_READ, "Invalid binary SDF: " + _message});
+  return false;
+}
+
+/////////////////////////////////////////////////
+std::string ElementSerializer::Serialize(const SDF &_sdf)
+{
+  ElementSerializer serializer;
+  BinaryHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.formatVersion = kFormatVersion;
+  header.byteOrder = kByteOrderMark;
+  header.specVersion = serializer.AddString(SDF::Version());
+  header.filePath = serializer.AddString(_sdf.FilePath());
+  header.originalVersion = serializer.AddString(_sdf.OriginalVersion());
+
+  serializer.AddElement(*_sdf.Root());
+
+  header.stringCount = static_cast<std::uint32_t>(
+      serializer.strings.size() / sizeof(StringRecord));
+  header.elementCount = static_cast<std::uint32_t>(
+      serializer.elements.size() / sizeof(ElementRecord));
+  header.paramCount = static_cast<std::uint32_t>(
+      serializer.params.size() / sizeof(ParamRecord));
+  header.stringOffset = sizeof(BinaryHeader);
+  header.elementOffset = header.stringOffset + serializer.strings.size();
+  header.paramOffset = header.elementOffset + serializer.elements.size();
+  header.payloadOffset = header.paramOffset + serializer.params.size();
+  header.payloadSize = serializer.payload.size();
+
+  std::string result;
+  result.reserve(header.payloadOffset + header.payloadSize);
+  appendRecord(result, header);
+  result += serializer.strings;
+  result += serializer.elements;
+  result += serializer.params;
+  result += serializer.payload;
+  return result;
+}
+
+/////////////////////////////////////////////////
+std::uint32_t ElementSerializer::AddString(const std::string &_str)
+{
+  auto inserted = this->stringIndex.emplace(_str, static_cast<std::uint32_t>(
+      this->strings.size() / sizeof(StringRecord)));
+  if (inserted.second)
+  {
+    StringRecord record;
+    record.offset = this->AddPayload(_str.data(), _str.size(), 1);
+    record.size = _str.size();
+    appendRecord(this->strings, record);
+  }
+  return inserted.first->second;
+}
+
+/////////////////////////////////////////////////
+std::uint64_t ElementSerializer::AddPayload(const void *_data,
+    std::size_t _size, std::size_t _align)
+{
+  this->payload.resize((this->payload.size() + _align - 1) / _align * _align);
+  const std::uint64_t offset = this->payload.size();
+  this->payload.append(static_cast<const char *>(_data), _size);
+  return offset;
+}
+
+/////////////////////////////////////////////////
+std::uint64_t ElementSerializer::AddValue(
+    const ParamPrivate::ParamVariant &_value)
+{
+  return std::visit([this](const auto &_v) -> std::uint64_t
+    {
+      using T = std::decay_t<decltype(_v)>;
+      if constexpr (std::is_same_v<T, bool>)
+      {
+        const std::uint8_t b = _v ? 1 : 0;
+        return this->AddPayload(&b, sizeof(b), 1);
+      }
+      else if constexpr (std::is_same_v<T, std::string>)
+      {
+        const std::uint32_t index = this->AddString(_v);
+        return this->AddPayload(&index, sizeof(index), sizeof(index));
+      }
+      else if constexpr (std::is_arithmetic_v<T>)
+      {
+        return this->AddPayload(&_v, sizeof(_v), sizeof(_v));
+      }
+      else if constexpr (std::is_same_v<T, sdf::Time>)
+      {
+        const std::int32_t v[] = {_v.sec, _v.nsec};
+        return this->AddPayload(v, sizeof(v), sizeof(v[0]));
+      }
+      else if constexpr (std::is_same_v<T, ignition::math::Angle>)
+      {
+        const double v = _v.Radian();
+        return this->AddPayload(&v, sizeof(v), sizeof(v));
+      }
+      else if constexpr (std::is_same_v<T, ignition::math::Color>)
+      {
+        const float v[] = {_v.R(), _v.G(), _v.B(), _v.A()};
+        return this->AddPayload(v, sizeof(v), sizeof(v[0]));
+      }
+      else if constexpr (std::is_same_v<T, ignition::math::Vector2i>)
+      {
+        const int v[] = {_v.X(), _v.Y()};
+        return this->AddPayload(v, sizeof(v), sizeof(v[0]));
+      }
+      else if constexpr (std::is_same_v<T, ignition::math::Vector2d>)
+      {
+        const double v[] = {_v.X(), _v.Y()};
+        return this->AddPayload(v, sizeof(v), sizeof(v[0]));
+      }
+      else if constexpr (std::is_same_v<T, ignition::math::Vector3d>)
+      {
+        const double v[] = {_v.X(), _v.Y(), _v.Z()};
+        return this->AddPayload(v, sizeof(v), sizeof(v[0]));
+      }
+      else if constexpr (std::is_same_v<T, ignition::math::Quaterniond>)
+      {
+        const double v[] = {_v.W(), _v.X(), _v.Y(), _v.Z()};
+        return this->AddPayload(v, sizeof(v), sizeof(v[0]));
+      }
+      else
+      {
+        static_assert(std::is_same_v<T, ignition::math::Pose3d>,
+            "Every type of ParamVariant must be serialized");
+        const double v[] = {_v.Pos().X(), _v.Pos().Y(), _v.Pos().Z(),
+            _v.Rot().W(), _v.Rot().X(), _v.Rot().Y(), _v.Rot().Z()};
+        return this->AddPayload(v, sizeof(v), sizeof(v[0]));
+      }
+    }, _value);
+}
+
+/////////////////////////////////////////////////
+void ElementSerializer::AddParam(const Param &_param)
+{
+  const ParamPrivate &data = *_param.dataPtr;
+  ParamRecord record{};
+  record.key = this->AddString(data.key);
+  record.typeName = this->AddString(data.typeName);
+  record.description = this->AddString(data.description);
+  record.valueType = static_cast<std::uint8_t>(data.valueType);
+  record.flags = static_cast<std::uint8_t>(
+      (data.required ? kRequired : 0) | (data.set ? kSet : 0));
+  record.valueIndex = static_cast<std::uint8_t>(data.value.index());
+  record.defaultIndex = static_cast<std::uint8_t>(data.defaultValue.index());
+  record.value = this->AddValue(data.value);
+  record.defaultValue = this->AddValue(data.defaultValue);
+  appendRecord(this->params, record);
+}
+
+/////////////////////////////////////////////////
+void ElementSerializer::AddElement(const Element &_elem)
+{
+  const ElementPrivate &data = *_elem.dataPtr;
+  ElementRecord record{};
+  record.name = this->AddString(data.name);
+  record.required = this->AddString(data.required);
+  record.description = this->AddString(data.description);
+  record.includeFilename = this->AddString(_elem.GetInclude());
+  record.referenceSDF = this->AddString(data.referenceSDF);
+  record.path = this->AddString(_elem.FilePath());
+  record.originalVersion = this->AddString(data.originalVersion);
+  record.flags = (data.copyChildren ? kCopyChildren : 0) |
+      (data.value ? kHasValue : 0);
+  record.firstParam = static_cast<std::uint32_t>(
+      this->params.size() / sizeof(ParamRecord));
+  record.attributeCount = static_cast<std::uint32_t>(data.attributes.size());
+  record.childCount = static_cast<std::uint32_t>(data.elements.size());
+  appendRecord(this->elements, record);
+
+  for (const ParamPtr &attribute : data.attributes)
+    this->AddParam(*attribute);
+  if (data.value)
+    this->AddParam(*data.value);
+
+  for (const ElementPtr &child : data.elements)
+    this->AddElement(*child);
+}
+
+/////////////////////////////////////////////////
+bool ElementSerializer::Deserialize(std::string_view _data, SDFPtr _sdf,
+    Errors &_errors)
+{
+  if (!_sdf || !_sdf->Root())
+    return binaryError(_errors, "SDF pointer or its Root is null");
+
+  BinaryHeader header;
+  if (_data.size() < sizeof(header))
+    return binaryError(_errors, "the data is shorter than its header");
+  std::memcpy(&header, _data.data(), sizeof(header));
+
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+    return binaryError(_errors, "the data is not binary SDF");
+  if (header.byteOrder != kByteOrderMark)
+    return binaryError(_errors, "the data was written with another byte order");
+  if (header.formatVersion != kFormatVersion)
+  {
+    return binaryError(_errors, "the data has format version " +
+        std::to_string(header.formatVersion) + " instead of " +
+        std::to_string(kFormatVersion));
+  }
+
+  ElementSerializer serializer;
+  serializer.data = _data;
+  serializer.stringCount = header.stringCount;
+  serializer.stringOffset = header.stringOffset;
+  serializer.elementCount = header.elementCount;
+  serializer.elementOffset = header.elementOffset;
+  serializer.paramCount = header.paramCount;
+  serializer.paramOffset = header.paramOffset;
+  serializer.payloadOffset = header.payloadOffset;
+  serializer.payloadSize = header.payloadSize;
+
+  if (!sectionInRange(_data, header.stringOffset, header.stringCount,
+                      sizeof(StringRecord)) ||
+      !sectionInRange(_data, header.elementOffset, header.elementCount,
+                      sizeof(ElementRecord)) ||
+      !sectionInRange(_data, header.paramOffset, header.paramCount,
+                      sizeof(ParamRecord)) ||
+      !sectionInRange(_data, header.payloadOffset, header.payloadSize, 1))
+  {
+    return binaryError(_errors, "the data is truncated");
+  }
+  serializer.interned.resize(header.stringCount);
+  serializer.isInterned.resize(header.stringCount);
+  serializer.shared.resize(header.stringCount);
+
+  std::string_view specVersion;
+  std::string_view filePath;
+  std::string_view originalVersion;
+  if (!serializer.String(header.specVersion, specVersion) ||
+      !serializer.String(header.filePath, filePath) ||
+      !serializer.String(header.originalVersion, originalVersion))
+  {
+    return binaryError(_errors, "a string index is out of range");
+  }
+
+  // The element descriptions come from the specification, which must be
+  // the one the data was written with.
+  if (specVersion != SDF::Version())
+  {
+    return binaryError(_errors, "the data was written for SDFormat " +
+        std::string(specVersion) + " instead of " + SDF::Version());
+  }
+
+  _sdf->SetFilePath(std::string(filePath));
+  _sdf->SetOriginalVersion(std::string(originalVersion));
+
+  if (header.elementCount == 0 || !serializer.ReadElement(_sdf->Root()))
+    return binaryError(_errors, "an element is invalid");
+  if (serializer.nextElement != header.elementCount)
+    return binaryError(_errors, "the data has more than one root element");
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool ElementSerializer::String(std::uint32_t _index,
+    std::string_view &_str) const
+{
+  if (_index >= this->stringCount)
+    return false;
+
+  const StringRecord record = readRecord<StringRecord>(
+      this->data, this->stringOffset, _index);
+  if (record.offset > this->payloadSize ||
+      record.size > this->payloadSize - record.offset)
+  {
+    return false;
+  }
+  _str = this->data.substr(this->payloadOffset + record.offset, record.size);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool ElementSerializer::Interned(std::uint32_t _index, InternedString &_str)
+{
+  if (_index >= this->stringCount)
+    return false;
+
+  if (!this->isInterned[_index])
+  {
+    std::string_view str;
+    if (!this->String(_index, str))
+      return false;
+    this->interned[_index] = InternedString::Lookup(std::string(str));
+    this->isInterned[_index] = true;
+  }
+  _str = this->interned[_index];
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool ElementSerializer::Shared(std::uint32_t _index,
+    std::shared_ptr<const std::string> &_str)
+{
+  if (_index >= this->stringCount)
+    return false;
+
+  if (!this->shared[_index])
+  {
+    std::string_view str;
+    if (!this->String(_index, str))
+      return false;
+    if (str.empty())
+    {
+      _str.reset();
+      return true;
+    }
+    this->shared[_index] = std::make_shared<const std::string>(str);
+  }
+  _str = this->shared[_index];
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Read numbers from the payload.
+/// \param[in] _payload The payload.
+/// \param[in] _offset Offset of the numbers.
+/// \param[out] _values The numbers.
+/// \return False if the numbers are out of range.
+template<typename T, std::size_t N>
+static bool readNumbers(std::string_view _payload, std::uint64_t _offset,
+    T (&_values)[N])
+{
+  if (_offset > _payload.size() || sizeof(_values) > _payload.size() - _offset)
+    return false;
+  std::memcpy(_values, _payload.data() + _offset, sizeof(_values));
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Decode a value whose type is one of the types of ParamVariant,
+/// from the I-th on.
+/// \param[in] _payload The payload.
+/// \param[in] _offset Offset of the value.
+/// \param[in] _typeIndex Index of the type in ParamVariant.
+/// \param[out] _value The value.
+/// \param[in] _string Function that reads a string of the string table.
+/// \return False if the value is out of range or the type is unknown.
+template<std::size_t I = 0, typename F>
+static bool readVariant(std::string_view _payload, std::uint64_t _offset,
+    std::uint8_t _typeIndex, ParamPrivate::ParamVariant &_value, F _string)
+{
+  using Variant = ParamPrivate::ParamVariant;
+  if constexpr (I == std::variant_size_v<Variant>)
+  {
+    return false;
+  }
+  else
+  {
+    if (_typeIndex != I)
+      return readVariant<I + 1>(_payload, _offset, _typeIndex, _value, _string);
+
+    using T = std::variant_alternative_t<I, Variant>;
+    if constexpr (std::is_same_v<T, bool>)
+    {
+      std::uint8_t v[1];
+      if (!readNumbers(_payload, _offset, v))
+        return false;
+      _value.emplace<I>(v[0] != 0);
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+      std::uint32_t v[1];
+      std::string_view str;
+      if (!readNumbers(_payload, _offset, v) || !_string(v[0], str))
+        return false;
+      _value.emplace<I>(str);
+    }
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+      T v[1];
+      if (!readNumbers(_payload, _offset, v))
+        return false;
+      _value.emplace<I>(v[0]);
+    }
+    else if constexpr (std::is_same_v<T, sdf::Time>)
+    {
+      std::int32_t v[2];
+      if (!readNumbers(_payload, _offset, v))
+        return false;
+      _value.emplace<I>(v[0], v[1]);
+    }
+    else if constexpr (std::is_same_v<T, ignition::math::Angle>)
+    {
+      double v[1];
+      if (!readNumbers(_payload, _offset, v))
+        return false;
+      _value.emplace<I>(v[0]);
+    }
+    else if constexpr (std::is_same_v<T, ignition::math::Color>)
+    {
+      float v[4];
+      if (!readNumbers(_payload, _offset, v))
+        return false;
+      _value.emplace<I>(v[0], v[1], v[2], v[3]);
+    }
+    else if constexpr (std::is_same_v<T, ignition::math::Vector2i>)
+    {
+      int v[2];
+      if (!readNumbers(_payload, _offset, v))
+        return false;
+      _value.emplace<I>(v[0], v[1]);
+    }
+    else if constexpr (std::is_same_v<T, ignition::math::Vector2d>)
+    {
+      double v[2];
+      if (!readNumbers(_payload, _offset, v))
+        return false;
+      _value.emplace<I>(v[0], v[1]);
+    }
+    else if constexpr (std::is_same_v<T, ignition::math::Vector3d>)
+    {
+      double v[3];
+      if (!readNumbers(_payload, _offset, v))
+        return false;
+      _value.emplace<I>(v[0], v[1], v[2]);
+    }
+    else if constexpr (std::is_same_v<T, ignition::math::Quaterniond>)
+    {
+      double v[4];
+      if (!readNumbers(_payload, _offset, v))
+        return false;
+      _value.emplace<I>(v[0], v[1], v[2], v[3]);
+    }
+    else
+    {
+      static_assert(std::is_same_v<T, ignition::math::Pose3d>,
+          "Every type of ParamVariant must be deserialized");
+      double v[7];
+      if (!readNumbers(_payload, _offset, v))
+        return false;
+      _value.emplace<I>(ignition::math::Vector3d(v[0], v[1], v[2]),
+          ignition::math::Quaterniond(v[3], v[4], v[5], v[6]));
+    }
+    return true;
+  }
+}
+
+/////////////////////////////////////////////////
+bool ElementSerializer::ReadValue(std::uint64_t _offset,
+    std::uint8_t _typeIndex, ParamPrivate::ParamVariant &_value) const
+{
+  return readVariant(this->data.substr(this->payloadOffset, this->payloadSize),
+      _offset, _typeIndex, _value,
+      [this](std::uint32_t _index, std::string_view &_str)
+      {
+        return this->String(_index, _str);
+      });
+}
+
+/////////////////////////////////////////////////
+bool ElementSerializer::ReadParam(std::uint32_t _index, ParamPtr &_param)
+{
+  if (_index >= this->paramCount)
+    return false;
+
+  const ParamRecord record = readRecord<ParamRecord>(
+      this->data, this->paramOffset, _index);
+  if (record.valueType >
+      static_cast<std::uint8_t>(ParamPrivate::ValueType::QUATERNION))
+  {
+    return false;
+  }
+
+  _param = ParseArena::MakeShared<Param>();
+  ParamPrivate &data = *_param->dataPtr;
+  data.required = (record.flags & kRequired) != 0;
+  data.set = (record.flags & kSet) != 0;
+  data.valueType = static_cast<ParamPrivate::ValueType>(record.valueType);
+  return this->Interned(record.key, data.key) &&
+      this->Interned(record.typeName, data.typeName) &&
+      this->Interned(record.description, data.description) &&
+      this->ReadValue(record.value, record.valueIndex, data.value) &&
+      this->ReadValue(record.defaultValue, record.defaultIndex,
+                      data.defaultValue);
+}
+
+/////////////////////////////////////////////////
+bool ElementSerializer::ReadElement(const ElementPtr &_elem)
+{
+  if (this->nextElement >= this->elementCount)
+    return false;
+
+  const ElementRecord record = readRecord<ElementRecord>(
+      this->data, this->elementOffset, this->nextElement++);
+
+  // The root element was initialized from the specification, the other
+  // elements must have been created with the same name.
+  ElementPrivate &data = *_elem->dataPtr;
+  InternedString name;
+  if (!this->Interned(record.name, name) ||
+      (!data.name.empty() && data.name != name))
+  {
+    return false;
+  }
+  data.name = name;
+
+  if (!this->Interned(record.required, data.required) ||
+      !this->Interned(record.description, data.description) ||
+      !this->Shared(record.includeFilename, data.includeFilename) ||
+      !this->Interned(record.referenceSDF, data.referenceSDF) ||
+      !this->Shared(record.path, data.path) ||
+      !this->Interned(record.originalVersion, data.originalVersion))
+  {
+    return false;
+  }
+  data.copyChildren = (record.flags & kCopyChildren) != 0;
+
+  // Share the attribute index of the element, which comes from the
+  // description, when the attributes have the same keys.
+  ElementPrivate::ParamVector attributes(record.attributeCount,
+      ParamPtr(), data.attributes.get_allocator());
+  bool sameKeys = data.attributes.size() == attributes.size();
+  for (std::uint32_t i = 0; i < record.attributeCount; ++i)
+  {
+    if (!this->ReadParam(record.firstParam + i, attributes[i]))
+      return false;
+    sameKeys = sameKeys &&
+        data.attributes[i]->GetKey() == attributes[i]->GetKey();
+  }
+  if (!sameKeys)
+  {
+    data.attributeIndex = std::make_shared<ElementPrivate::NameIndex>();
+    for (std::size_t i = 0; i < attributes.size(); ++i)
+      data.attributeIndex->emplace(attributes[i]->GetKey(), i);
+  }
+  data.attributes = std::move(attributes);
+
+  data.value.reset();
+  if ((record.flags & kHasValue) &&
+      !this->ReadParam(record.firstParam + record.attributeCount, data.value))
+  {
+    return false;
+  }
+
+  // Each element uses at least one record, which bounds the recursion.
+  if (record.childCount > this->elementCount - this->nextElement)
+    return false;
+
+  data.elements.reserve(record.childCount);
+  for (std::uint32_t i = 0; i < record.childCount; ++i)
+  {
+    if (this->nextElement >= this->elementCount)
+      return false;
+    const ElementRecord childRecord = readRecord<ElementRecord>(
+        this->data, this->elementOffset, this->nextElement);
+    std::string_view childName;
+    if (!this->String(childRecord.name, childName))
+      return false;
+
+    // Like the parser, described child elements share the descriptions of
+    // their element description. Others, such as unknown elements that
+    // were copied, have none.
+    ElementPtr child = ParseArena::MakeShared<Element>();
+    ElementPtr desc = _elem->GetElementDescription(std::string(childName));
+    if (desc)
+    {
+      child->dataPtr->name = desc->dataPtr->name;
+      child->dataPtr->attributes = desc->dataPtr->attributes;
+      child->dataPtr->attributeIndex = desc->dataPtr->attributeIndex;
+      child->dataPtr->elementDescriptions =
+          desc->dataPtr->elementDescriptions;
+      child->dataPtr->elementDescriptionIndex =
+          desc->dataPtr->elementDescriptionIndex;
+    }
+    child->dataPtr->parent = _elem;
+
+    if (!this->ReadElement(child))
+      return false;
+    _elem->PushElement(child);
+  }
+
+  return true;
+}
+}
+}
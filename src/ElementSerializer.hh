@@ -0,0 +1,198 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_ELEMENTSERIALIZER_HH_
+#define SDF_ELEMENTSERIALIZER_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "sdf/Element.hh"
+#include "sdf/Param.hh"
+#include "sdf/SDFImpl.hh"
+#include "sdf/sdf_config.h"
+#include "sdf/Types.hh"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \brief Converts a parsed SDF object to and from the binary format of
+  /// SDF::WriteBinary and readBinary.
+  ///
+  /// The format is a header followed by four sections: a table of strings,
+  /// the elements in document order, the attributes and values of the
+  /// elements, and a payload with the characters of the strings and the
+  /// typed values of the parameters. Sections refer to each other by index
+  /// or by offset from the start of the data, so the data can be used where
+  /// it is mapped. Numbers are stored in the byte order of the machine that
+  /// wrote them, and data with another byte order is rejected.
+  ///
+  /// Element descriptions are not stored: they are taken from the
+  /// specification of the SDF object that the data is read into.
+  class ElementSerializer
+  {
+    /// \brief Serialize an SDF object.
+    /// \param[in] _sdf The SDF object.
+    /// \return The binary data.
+    public: static std::string Serialize(const SDF &_sdf);
+
+    /// \brief Read binary data into an SDF object, which was initialized
+    /// with the specification of the same SDFormat version.
+    /// \param[in] _data The binary data.
+    /// \param[in] _sdf The SDF object, whose root element has no child
+    /// elements yet.
+    /// \param[out] _errors Errors found while reading.
+    /// \return True if successful.
+    public: static bool Deserialize(std::string_view _data, SDFPtr _sdf,
+                                    Errors &_errors);
+
+    /// \brief Constructor, for one serialization.
+    private: ElementSerializer() = default;
+
+    /// \brief Add a string to the string table, once.
+    /// \param[in] _str The string.
+    /// \return Index of the string.
+    private: std::uint32_t AddString(const std::string &_str);
+
+    /// \brief Append bytes to the payload.
+    /// \param[in] _data The bytes.
+    /// \param[in] _size Number of bytes.
+    /// \param[in] _align Alignment of the bytes in the payload.
+    /// \return Offset of the bytes in the payload.
+    private: std::uint64_t AddPayload(const void *_data, std::size_t _size,
+                                      std::size_t _align);
+
+    /// \brief Append a typed value to the payload.
+    /// \param[in] _value The value.
+    /// \return Offset of the value in the payload.
+    private: std::uint64_t AddValue(const ParamPrivate::ParamVariant &_value);
+
+    /// \brief Add a parameter to the parameter section.
+    /// \param[in] _param The parameter.
+    private: void AddParam(const Param &_param);
+
+    /// \brief Add an element and its descendants to the element section.
+    /// \param[in] _elem The element.
+    private: void AddElement(const Element &_elem);
+
+    /// \brief Get a string of the string table.
+    /// \param[in] _index Index of the string.
+    /// \param[out] _str The string.
+    /// \return False if the index is out of range.
+    private: bool String(std::uint32_t _index, std::string_view &_str) const;
+
+    /// \brief Get an interned string of the string table. Each string is
+    /// looked up once. Strings that are not in the string pool, such as the
+    /// names of copied elements, are not added to it.
+    /// \param[in] _index Index of the string.
+    /// \param[out] _str The interned string.
+    /// \return False if the index is out of range.
+    private: bool Interned(std::uint32_t _index, InternedString &_str);
+
+    /// \brief Get a shared string of the string table, for file paths.
+    /// Each string is copied once.
+    /// \param[in] _index Index of the string.
+    /// \param[out] _str The shared string, which is null if it is empty.
+    /// \return False if the index is out of range.
+    private: bool Shared(std::uint32_t _index,
+                         std::shared_ptr<const std::string> &_str);
+
+    /// \brief Read a typed value from the payload.
+    /// \param[in] _offset Offset of the value in the payload.
+    /// \param[in] _typeIndex Index of the type in ParamVariant.
+    /// \param[out] _value The value.
+    /// \return False if the value is out of range.
+    private: bool ReadValue(std::uint64_t _offset, std::uint8_t _typeIndex,
+                            ParamPrivate::ParamVariant &_value) const;
+
+    /// \brief Read a parameter.
+    /// \param[in] _index Index of the parameter.
+    /// \param[out] _param The parameter.
+    /// \return False if the parameter is invalid.
+    private: bool ReadParam(std::uint32_t _index, ParamPtr &_param);
+
+    /// \brief Read the next element of the element section and its
+    /// descendants.
+    /// \param[in] _elem Element to read into, which has its element
+    /// descriptions.
+    /// \return False if the element is invalid.
+    private: bool ReadElement(const ElementPtr &_elem);
+
+    /// \brief Strings of the string table, by value, when writing.
+    private: std::unordered_map<std::string, std::uint32_t> stringIndex;
+
+    /// \brief String section.
+    private: std::string strings;
+
+    /// \brief Element section.
+    private: std::string elements;
+
+    /// \brief Parameter section.
+    private: std::string params;
+
+    /// \brief Payload.
+    private: std::string payload;
+
+    /// \brief Binary data, when reading.
+    private: std::string_view data;
+
+    /// \brief Number of strings, when reading.
+    private: std::uint32_t stringCount = 0;
+
+    /// \brief Offset of the string section, when reading.
+    private: std::uint64_t stringOffset = 0;
+
+    /// \brief Number of elements, when reading.
+    private: std::uint32_t elementCount = 0;
+
+    /// \brief Offset of the element section, when reading.
+    private: std::uint64_t elementOffset = 0;
+
+    /// \brief Number of parameters, when reading.
+    private: std::uint32_t paramCount = 0;
+
+    /// \brief Offset of the parameter section, when reading.
+    private: std::uint64_t paramOffset = 0;
+
+    /// \brief Offset of the payload, when reading.
+    private: std::uint64_t payloadOffset = 0;
+
+    /// \brief Size of the payload, when reading.
+    private: std::uint64_t payloadSize = 0;
+
+    /// \brief Index of the next element to read.
+    private: std::uint32_t nextElement = 0;
+
+    /// \brief Interned strings of the string table, when reading.
+    private: std::vector<InternedString> interned;
+
+    /// \brief Whether each string was interned, when reading.
+    private: std::vector<bool> isInterned;
+
+    /// \brief Shared strings of the string table, when reading.
+    private: std::vector<std::shared_ptr<const std::string>> shared;
+  };
+  }
+}
+#endif
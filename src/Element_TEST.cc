@@ -15,6 +15,9 @@
  *
  */
 
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "sdf/Element.hh"
@@ -285,6 +288,50 @@ TEST(Element, Clone)
   ASSERT_EQ(newelem->GetAttributeCount(), 1UL);
 }
 
+/////////////////////////////////////////////////
+TEST(Element, CloneWithSharedDescriptions)
+{
+  sdf::ElementPtr parent = std::make_shared<sdf::Element>();
+  sdf::ElementPtr child = std::make_shared<sdf::Element>();
+  sdf::ElementPtr desc = std::make_shared<sdf::Element>();
+  desc->SetName("desc");
+
+  parent->InsertElement(child);
+  parent->AddElementDescription(desc);
+  parent->AddAttribute("test", "string", "foo", false, "foo description");
+  parent->AddValue("string", "foo", false, "foo description");
+
+  sdf::ElementPtr newelem = parent->CloneWithSharedDescriptions();
+  ASSERT_NE(newelem->GetFirstElement(), nullptr);
+  EXPECT_NE(child, newelem->GetFirstElement());
+  ASSERT_EQ(newelem->GetElementDescriptionCount(), 1UL);
+  ASSERT_EQ(newelem->GetAttributeCount(), 1UL);
+
+  // The description is shared, the attribute and value are not.
+  EXPECT_EQ(desc, newelem->GetElementDescription("desc"));
+  EXPECT_NE(parent->GetAttribute("test"), newelem->GetAttribute("test"));
+  EXPECT_NE(parent->GetValue(), newelem->GetValue());
+
+  newelem->GetAttribute("test")->Set<std::string>("bar");
+  EXPECT_EQ("foo", parent->GetAttribute("test")->GetAsString());
+
+  // Adding a description to the clone does not change the original.
+  newelem->AddElementDescription(std::make_shared<sdf::Element>());
+  EXPECT_EQ(2UL, newelem->GetElementDescriptionCount());
+  EXPECT_EQ(1UL, parent->GetElementDescriptionCount());
+
+  // Clone() still copies descriptions.
+  EXPECT_NE(desc, parent->Clone()->GetElementDescription("desc"));
+
+  // Resetting the clone leaves the shared description intact.
+  desc->AddValue("string", "bar", false);
+  newelem->Reset();
+  EXPECT_EQ(0UL, newelem->GetElementDescriptionCount());
+  EXPECT_EQ(1UL, parent->GetElementDescriptionCount());
+  EXPECT_EQ("desc", desc->GetName());
+  EXPECT_NE(nullptr, desc->GetValue());
+}
+
 /////////////////////////////////////////////////
 TEST(Element, ClearElements)
 {
@@ -629,6 +676,104 @@ TEST(Element, GetNextElementMultiple)
   ASSERT_EQ(child2->GetNextElement(""), nullptr);
 }
 
+/////////////////////////////////////////////////
+TEST(Element, GetNextElementAfterRemoval)
+{
+  sdf::ElementPtr parent = std::make_shared<sdf::Element>();
+  std::vector<sdf::ElementPtr> children;
+  for (const std::string name : {"a", "b", "a", "b", "a"})
+  {
+    sdf::ElementPtr child = std::make_shared<sdf::Element>();
+    child->SetParent(parent);
+    child->SetName(name);
+    parent->InsertElement(child);
+    children.push_back(child);
+  }
+
+  EXPECT_EQ(children[1], children[0]->GetNextElement());
+  EXPECT_EQ(children[2], children[0]->GetNextElement("a"));
+  EXPECT_EQ(children[4], children[2]->GetNextElement("a"));
+  EXPECT_EQ(nullptr, children[4]->GetNextElement("a"));
+  EXPECT_EQ(nullptr, children[3]->GetNextElement("b"));
+
+  // Removing an element shifts the positions of its later siblings.
+  parent->RemoveChild(children[1]);
+  EXPECT_EQ(nullptr, children[1]->GetNextElement());
+  EXPECT_EQ(children[2], children[0]->GetNextElement());
+  EXPECT_EQ(children[3], children[2]->GetNextElement());
+  EXPECT_EQ(children[4], children[2]->GetNextElement("a"));
+
+  // An element can be iterated from a parent that did not insert it last.
+  sdf::ElementPtr other = std::make_shared<sdf::Element>();
+  other->InsertElement(std::make_shared<sdf::Element>());
+  other->InsertElement(children[0]);
+  EXPECT_EQ(children[2], children[0]->GetNextElement());
+}
+
+/////////////////////////////////////////////////
+TEST(Element, GetNextElementParentLifetime)
+{
+  sdf::ElementPtr parent = std::make_shared<sdf::Element>();
+  sdf::ElementPtr child1 = std::make_shared<sdf::Element>();
+  sdf::ElementPtr child2 = std::make_shared<sdf::Element>();
+  child1->SetParent(parent);
+  child2->SetParent(parent);
+  parent->InsertElement(child1);
+  parent->InsertElement(child2);
+  EXPECT_EQ(child2, child1->GetNextElement());
+
+  // Siblings are not reachable once the parent is reset or destroyed.
+  child2->Reset();
+  EXPECT_EQ(nullptr, child2->GetParent());
+  EXPECT_EQ(nullptr, child2->GetNextElement());
+
+  parent.reset();
+  EXPECT_EQ(nullptr, child1->GetParent());
+  EXPECT_EQ(nullptr, child1->GetNextElement());
+}
+
+/////////////////////////////////////////////////
+TEST(Element, Children)
+{
+  sdf::ElementPtr parent = std::make_shared<sdf::Element>();
+  EXPECT_TRUE(parent->Children().empty());
+  EXPECT_TRUE(parent->Children("a").empty());
+
+  std::vector<sdf::ElementPtr> children;
+  for (const std::string name : {"a", "b", "a", "c", "a"})
+  {
+    sdf::ElementPtr child = std::make_shared<sdf::Element>();
+    child->SetParent(parent);
+    child->SetName(name);
+    parent->InsertElement(child);
+    children.push_back(child);
+  }
+
+  std::vector<sdf::ElementPtr> all;
+  for (const sdf::ElementPtr &elem : parent->Children())
+  {
+    all.push_back(elem);
+  }
+  EXPECT_EQ(children, all);
+
+  std::vector<sdf::ElementPtr> named;
+  for (const sdf::ElementPtr &elem : parent->Children("a"))
+  {
+    named.push_back(elem);
+  }
+  ASSERT_EQ(3u, named.size());
+  EXPECT_EQ(children[0], named[0]);
+  EXPECT_EQ(children[2], named[1]);
+  EXPECT_EQ(children[4], named[2]);
+
+  auto range = parent->Children("c");
+  ASSERT_FALSE(range.empty());
+  EXPECT_EQ(children[3], *range.begin());
+  EXPECT_EQ("c", range.begin()->get()->GetName());
+  EXPECT_EQ(range.end(), ++range.begin());
+  EXPECT_TRUE(parent->Children("d").empty());
+}
+
 /////////////////////////////////////////////////
 TEST(Element, CountNamedElements)
 {
@@ -718,6 +863,71 @@ TEST(Element, CountNamedElements)
   EXPECT_EQ(allMap.at("child3"), 1u);
 }
 
+/////////////////////////////////////////////////
+TEST(Element, NameLookupAfterModification)
+{
+  sdf::ElementPtr parent = std::make_shared<sdf::Element>();
+  std::vector<sdf::ElementPtr> children;
+  for (const std::string name : {"a", "b", "a", "c"})
+  {
+    sdf::ElementPtr child = std::make_shared<sdf::Element>();
+    child->SetParent(parent);
+    child->SetName(name);
+    parent->InsertElement(child);
+    children.push_back(child);
+  }
+
+  // Lookup returns the first child with a name.
+  EXPECT_EQ(children[0], parent->GetElementImpl("a"));
+  EXPECT_EQ(children[1], parent->GetElementImpl("b"));
+  EXPECT_EQ(children[3], parent->GetElementImpl("c"));
+  EXPECT_FALSE(parent->HasElement("d"));
+
+  // Removing a child updates the lookup.
+  parent->RemoveChild(children[0]);
+  EXPECT_EQ(children[2], parent->GetElementImpl("a"));
+  children[1]->RemoveFromParent();
+  EXPECT_FALSE(parent->HasElement("b"));
+  EXPECT_EQ(children[3], parent->GetElementImpl("c"));
+
+  // Renaming a child updates the lookup.
+  children[3]->SetName("d");
+  EXPECT_FALSE(parent->HasElement("c"));
+  EXPECT_EQ(children[3], parent->GetElementImpl("d"));
+  children[3]->SetName("a");
+  EXPECT_EQ(children[2], parent->GetElementImpl("a"));
+
+  // Clones have their own lookup.
+  sdf::ElementPtr clone = parent->Clone();
+  ASSERT_NE(nullptr, clone->GetElementImpl("a"));
+  EXPECT_NE(children[2], clone->GetElementImpl("a"));
+  clone->ClearElements();
+  EXPECT_FALSE(clone->HasElement("a"));
+  EXPECT_EQ(children[2], parent->GetElementImpl("a"));
+
+  // Attributes and descriptions added to a clone are not visible in the
+  // original.
+  parent->AddAttribute("name", "string", "", false);
+  parent->AddElementDescription(children[0]);
+  clone = parent->CloneWithSharedDescriptions();
+  clone->AddAttribute("extra", "string", "", false);
+  clone->AddElementDescription(children[1]);
+  EXPECT_NE(nullptr, clone->GetAttribute("name"));
+  EXPECT_NE(nullptr, clone->GetAttribute("extra"));
+  EXPECT_EQ(children[0], clone->GetElementDescription("a"));
+  EXPECT_EQ(children[1], clone->GetElementDescription("b"));
+  EXPECT_NE(nullptr, parent->GetAttribute("name"));
+  EXPECT_EQ(nullptr, parent->GetAttribute("extra"));
+  EXPECT_EQ(children[0], parent->GetElementDescription("a"));
+  EXPECT_EQ(nullptr, parent->GetElementDescription("b"));
+
+  // Renaming a description after it was added is seen by the lookup.
+  children[0]->SetName("renamed");
+  EXPECT_TRUE(parent->HasElementDescription("renamed"));
+  EXPECT_EQ(children[0], parent->GetElementDescription("renamed"));
+  EXPECT_FALSE(parent->HasElementDescription("a"));
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
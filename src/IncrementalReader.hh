@@ -0,0 +1,97 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_INCREMENTALREADER_HH_
+#define SDF_INCREMENTALREADER_HH_
+
+#include <memory>
+#include <string>
+
+#include "sdf/Element.hh"
+#include "sdf/ParserConfig.hh"
+#include "sdf/SDFImpl.hh"
+#include "sdf/Types.hh"
+#include "sdf/sdf_config.h"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  // Forward declaration.
+  class IncrementalReaderPrivate;
+
+  /// \brief Reads a file again after it was edited, parsing only what
+  /// changed. It is used by Root::Reload.
+  ///
+  /// The models and includes at the top level of the worlds of the file are
+  /// read separately, and a hash of their XML and of the files that they
+  /// read is kept. When the same file is read again, and nothing else
+  /// changed, the elements of the models and includes whose hashes are
+  /// unchanged are kept, and only the others are parsed again into the
+  /// world elements of the previous document. Anything else, such as a
+  /// change of another element of a world or a document that must be
+  /// converted to the current SDF version, reads the whole file again.
+  ///
+  /// The includes of the worlds are read serially, since the files that
+  /// each one reads are recorded, and the compiled cache directory is not
+  /// used.
+  class IncrementalReader
+  {
+    /// \brief Constructor.
+    public: IncrementalReader();
+
+    /// \brief Destructor.
+    public: ~IncrementalReader();
+
+    /// \brief Read a file.
+    /// \param[in] _filename Name of the file.
+    /// \param[in] _config Options that control how the file is parsed,
+    /// which should not change between reads of the same file.
+    /// \param[out] _errors Errors found while parsing. The errors of the
+    /// models and includes that were not parsed again are reported again.
+    /// \return The document, or nullptr if the file could not be read.
+    /// After a partial read, this is the document of the previous read,
+    /// updated in place.
+    public: SDFPtr Read(const std::string &_filename,
+                        const ParserConfig &_config, Errors &_errors);
+
+    /// \brief Check whether the last Read updated the document of the
+    /// previous read instead of reading the whole file.
+    /// \return True after a partial read.
+    public: bool Partial() const;
+
+    /// \brief Get the child elements of an element, which are edited in
+    /// place by partial reads.
+    /// \param[in] _element The element.
+    /// \return The child elements.
+    private: static ElementPrivate::ElementVector &ChildElements(
+        Element &_element);
+
+    /// \brief Rebuild the element index of an element after its child
+    /// elements were edited.
+    /// \param[in] _element The element.
+    private: static void RebuildElementIndex(Element &_element);
+
+    /// \brief Private data pointer.
+    private: std::unique_ptr<IncrementalReaderPrivate> dataPtr;
+
+    friend class IncrementalReaderPrivate;
+  };
+  }
+}
+#endif
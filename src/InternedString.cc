@@ -0,0 +1,158 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include "sdf/InternedString.hh"
+
+namespace sdf
+{
+inline namespace SDF_VERSION_NAMESPACE {
+
+/// \brief The process-wide string pool. Elements of an unordered_set are
+/// never moved, so pointers to them stay valid as the pool grows.
+class StringPool
+{
+  /// \brief Get the pooled copy of a string, adding it if needed.
+  /// \param[in] _str The string.
+  /// \return Pointer to the pooled string.
+  public: const std::string *Intern(const std::string &_str)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return &*this->strings.insert(_str).first;
+  }
+
+  /// \brief Get the pooled copy of a string, without adding it.
+  /// \param[in] _str The string.
+  /// \return Pointer to the pooled string, or null if it is not pooled.
+  public: const std::string *Find(const std::string &_str)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->strings.find(_str);
+    return it == this->strings.end() ? nullptr : &*it;
+  }
+
+  /// \brief Get the number of pooled strings.
+  /// \return Number of pooled strings.
+  public: std::size_t Size()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->strings.size();
+  }
+
+  /// \brief The pooled empty string, which is not stored in the set so that
+  /// default construction does not need the lock.
+  public: const std::string empty;
+
+  /// \brief Mutex that protects strings.
+  private: std::mutex mutex;
+
+  /// \brief The pooled strings.
+  private: std::unordered_set<std::string> strings;
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the string pool. It is intentionally never destroyed, so that
+/// InternedStrings in static objects stay valid during shutdown.
+/// \return The string pool.
+static StringPool &pool()
+{
+  static StringPool *instance = new StringPool;
+  return *instance;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the pooled copy of a string.
+/// \param[in] _str The string.
+/// \return Pointer to the pooled string.
+static const std::string *intern(const std::string &_str)
+{
+  if (_str.empty())
+    return &pool().empty;
+  return pool().Intern(_str);
+}
+
+/////////////////////////////////////////////////
+InternedString::InternedString()
+  : str(&pool().empty)
+{
+}
+
+/////////////////////////////////////////////////
+InternedString::InternedString(const std::string &_str)
+  : str(intern(_str))
+{
+}
+
+/////////////////////////////////////////////////
+InternedString::InternedString(const char *_str)
+  : str(intern(_str ? std::string(_str) : std::string()))
+{
+}
+
+/////////////////////////////////////////////////
+InternedString &InternedString::operator=(const std::string &_str)
+{
+  this->str = intern(_str);
+  this->owned.reset();
+  return *this;
+}
+
+/////////////////////////////////////////////////
+InternedString &InternedString::operator=(const char *_str)
+{
+  this->str = intern(_str ? std::string(_str) : std::string());
+  this->owned.reset();
+  return *this;
+}
+
+/////////////////////////////////////////////////
+void InternedString::clear()
+{
+  this->str = &pool().empty;
+  this->owned.reset();
+}
+
+/////////////////////////////////////////////////
+InternedString InternedString::Lookup(const std::string &_str)
+{
+  InternedString result;
+  if (_str.empty())
+    return result;
+
+  const std::string *pooled = pool().Find(_str);
+  if (pooled)
+  {
+    result.str = pooled;
+  }
+  else
+  {
+    result.owned = std::make_shared<const std::string>(_str);
+    result.str = result.owned.get();
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+std::size_t InternedString::PoolSize()
+{
+  return pool().Size();
+}
+}
+}
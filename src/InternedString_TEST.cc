@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "sdf/Element.hh"
+#include "sdf/InternedString.hh"
+
+/////////////////////////////////////////////////
+TEST(InternedString, Construction)
+{
+  sdf::InternedString empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ("", empty);
+  EXPECT_EQ(sdf::InternedString(""), empty);
+  EXPECT_EQ(sdf::InternedString(std::string()), empty);
+
+  sdf::InternedString link("link");
+  EXPECT_FALSE(link.empty());
+  EXPECT_EQ("link", link.Str());
+  EXPECT_EQ("link", link.View());
+  EXPECT_EQ(std::string("link"), link);
+  EXPECT_NE("model", link);
+
+  std::ostringstream stream;
+  stream << link;
+  EXPECT_EQ("link", stream.str());
+
+  link.clear();
+  EXPECT_EQ(empty, link);
+}
+
+/////////////////////////////////////////////////
+TEST(InternedString, SharedStorage)
+{
+  sdf::InternedString a(std::string("shared_value"));
+  sdf::InternedString b("shared_value");
+  sdf::InternedString c = a;
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(a, c);
+  EXPECT_EQ(&a.Str(), &b.Str());
+  EXPECT_EQ(&a.Str(), &c.Str());
+
+  std::size_t size = sdf::InternedString::PoolSize();
+  b = "other_value";
+  EXPECT_NE(a, b);
+  EXPECT_EQ(size + 1, sdf::InternedString::PoolSize());
+  b = std::string("shared_value");
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(size + 1, sdf::InternedString::PoolSize());
+}
+
+/////////////////////////////////////////////////
+TEST(InternedString, Lookup)
+{
+  sdf::InternedString pooled("lookup_pooled");
+  std::size_t size = sdf::InternedString::PoolSize();
+
+  sdf::InternedString found =
+      sdf::InternedString::Lookup(std::string("lookup_pooled"));
+  EXPECT_EQ(&pooled.Str(), &found.Str());
+  EXPECT_EQ(pooled, found);
+
+  sdf::InternedString a = sdf::InternedString::Lookup("lookup_unpooled");
+  sdf::InternedString b = sdf::InternedString::Lookup("lookup_unpooled");
+  sdf::InternedString c = a;
+  EXPECT_EQ("lookup_unpooled", a.Str());
+  EXPECT_EQ(a, b);
+  EXPECT_NE(&a.Str(), &b.Str());
+  EXPECT_EQ(&a.Str(), &c.Str());
+  EXPECT_NE(pooled, a);
+  EXPECT_EQ(size, sdf::InternedString::PoolSize());
+
+  EXPECT_TRUE(sdf::InternedString::Lookup("").empty());
+  a.clear();
+  EXPECT_EQ(sdf::InternedString(), a);
+}
+
+/////////////////////////////////////////////////
+TEST(InternedString, Element)
+{
+  // Names that are in the pool, such as those of the specification, are
+  // shared. Other names are user data and are not added to the pool.
+  sdf::InternedString pooledName("interned_element");
+  sdf::ElementPtr elem1(new sdf::Element);
+  sdf::ElementPtr elem2(new sdf::Element);
+  elem1->SetName("interned_element");
+  elem2->SetName(std::string("interned_") + "element");
+  EXPECT_EQ(&elem1->GetName(), &elem2->GetName());
+
+  std::size_t size = sdf::InternedString::PoolSize();
+  sdf::ElementPtr user(new sdf::Element);
+  user->SetName("user_element");
+  user->AddAttribute("user_key", "string", "", false);
+  user->AddValue("string", "", false);
+  EXPECT_EQ("user_element", user->GetName());
+  EXPECT_EQ("user_key", user->GetAttribute(0)->GetKey());
+  EXPECT_EQ(size, sdf::InternedString::PoolSize());
+
+  elem1->AddAttribute("interned_key", "string", "", false);
+  sdf::ElementPtr clone = elem1->Clone();
+  EXPECT_EQ(&elem1->GetAttribute(0)->GetTypeName(),
+            &clone->GetAttribute(0)->GetTypeName());
+
+  // Clones share the names and paths, whether or not they are pooled.
+  user->SetFilePath("/path/to/user.sdf");
+  sdf::ElementPtr userClone = user->Clone();
+  EXPECT_EQ(&user->GetName(), &userClone->GetName());
+  EXPECT_EQ(&user->GetAttribute(0)->GetKey(),
+            &userClone->GetAttribute(0)->GetKey());
+  EXPECT_EQ(&user->FilePath(), &userClone->FilePath());
+}
+
+/////////////////////////////////////////////////
+TEST(InternedString, Threads)
+{
+  std::vector<std::thread> threads;
+  std::vector<const std::string *> results(8);
+  for (std::size_t i = 0; i < results.size(); ++i)
+  {
+    threads.emplace_back([i, &results]()
+    {
+      for (int j = 0; j < 1000; ++j)
+      {
+        sdf::InternedString str("thread_" + std::to_string(j));
+        if (j == 999)
+          results[i] = &str.Str();
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  for (const std::string *result : results)
+  {
+    EXPECT_EQ(results[0], result);
+    EXPECT_EQ("thread_999", *result);
+  }
+}
@@ -28,6 +28,7 @@
 #include "sdf/Sensor.hh"
 #include "sdf/Types.hh"
 #include "sdf/Visual.hh"
+#include "NameIndex.hh"
 #include "Utils.hh"
 
 using namespace sdf;
@@ -55,6 +56,18 @@ class sdf::LinkPrivate
   /// \brief The sensors specified in this link.
   public: std::vector<Sensor> sensors;
 
+  /// \brief Index of the visuals by name.
+  public: NameIndex visualIndex;
+
+  /// \brief Index of the lights by name.
+  public: NameIndex lightIndex;
+
+  /// \brief Index of the collisions by name.
+  public: NameIndex collisionIndex;
+
+  /// \brief Index of the sensors by name.
+  public: NameIndex sensorIndex;
+
   /// \brief The inertial information for this link.
   public: ignition::math::Inertiald inertial {{1.0,
             ignition::math::Vector3d::One, ignition::math::Vector3d::Zero},
@@ -163,6 +176,11 @@ Errors Link::Load(ElementPtr _sdf)
       this->dataPtr->sensors);
   errors.insert(errors.end(), sensorLoadErrors.begin(), sensorLoadErrors.end());
 
+  this->dataPtr->visualIndex.Build(this->dataPtr->visuals);
+  this->dataPtr->collisionIndex.Build(this->dataPtr->collisions);
+  this->dataPtr->lightIndex.Build(this->dataPtr->lights);
+  this->dataPtr->sensorIndex.Build(this->dataPtr->sensors);
+
   ignition::math::Vector3d xxyyzz = ignition::math::Vector3d::One;
   ignition::math::Vector3d xyxzyz = ignition::math::Vector3d::Zero;
   ignition::math::Pose3d inertiaPose;
@@ -239,14 +257,8 @@ const Visual *Link::VisualByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Link::VisualNameExists(const std::string &_name) const
 {
-  for (auto const &v : this->dataPtr->visuals)
-  {
-    if (v.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->visualIndex.Find(
+      this->dataPtr->visuals, _name) != nullptr;
 }
 
 /////////////////////////////////////////////////
@@ -266,14 +278,8 @@ const Collision *Link::CollisionByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Link::CollisionNameExists(const std::string &_name) const
 {
-  for (auto const &c : this->dataPtr->collisions)
-  {
-    if (c.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->collisionIndex.Find(
+      this->dataPtr->collisions, _name) != nullptr;
 }
 
 /////////////////////////////////////////////////
@@ -313,27 +319,14 @@ const Sensor *Link::SensorByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Link::SensorNameExists(const std::string &_name) const
 {
-  for (auto const &s : this->dataPtr->sensors)
-  {
-    if (s.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->sensorIndex.Find(
+      this->dataPtr->sensors, _name) != nullptr;
 }
 
 /////////////////////////////////////////////////
 const Sensor *Link::SensorByName(const std::string &_name) const
 {
-  for (auto const &s : this->dataPtr->sensors)
-  {
-    if (s.Name() == _name)
-    {
-      return &s;
-    }
-  }
-  return nullptr;
+  return this->dataPtr->sensorIndex.Find(this->dataPtr->sensors, _name);
 }
 
 /////////////////////////////////////////////////
@@ -439,40 +432,19 @@ sdf::SemanticPose Link::SemanticPose() const
 /////////////////////////////////////////////////
 const Visual *Link::VisualByName(const std::string &_name) const
 {
-  for (auto const &v : this->dataPtr->visuals)
-  {
-    if (v.Name() == _name)
-    {
-      return &v;
-    }
-  }
-  return nullptr;
+  return this->dataPtr->visualIndex.Find(this->dataPtr->visuals, _name);
 }
 
 /////////////////////////////////////////////////
 const Collision *Link::CollisionByName(const std::string &_name) const
 {
-  for (auto const &c : this->dataPtr->collisions)
-  {
-    if (c.Name() == _name)
-    {
-      return &c;
-    }
-  }
-  return nullptr;
+  return this->dataPtr->collisionIndex.Find(this->dataPtr->collisions, _name);
 }
 
 /////////////////////////////////////////////////
 const Light *Link::LightByName(const std::string &_name) const
 {
-  for (auto const &c : this->dataPtr->lights)
-  {
-    if (c.Name() == _name)
-    {
-      return &c;
-    }
-  }
-  return nullptr;
+  return this->dataPtr->lightIndex.Find(this->dataPtr->lights, _name);
 }
 
 /////////////////////////////////////////////////
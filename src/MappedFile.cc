@@ -0,0 +1,172 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.hh"
+
+namespace sdf
+{
+inline namespace SDF_VERSION_NAMESPACE {
+
+/////////////////////////////////////////////////
+/// \brief Copy text, replacing "\r\n" and lone '\r' with '\n'.
+/// \param[in] _text The text.
+/// \return The normalized text.
+static std::string normalizeLineEndings(std::string_view _text)
+{
+  std::string result;
+  result.reserve(_text.size());
+  for (std::size_t i = 0; i < _text.size(); ++i)
+  {
+    if (_text[i] == '\r')
+    {
+      result.push_back('\n');
+      if (i + 1 < _text.size() && _text[i + 1] == '\n')
+        ++i;
+    }
+    else
+    {
+      result.push_back(_text[i]);
+    }
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+MappedFile::~MappedFile()
+{
+  this->Close();
+}
+
+/////////////////////////////////////////////////
+bool MappedFile::Open(const std::string &_filename, const bool _text)
+{
+  this->Close();
+
+#ifndef _WIN32
+  int fd = ::open(_filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat fileStat;
+  if (::fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+  {
+    ::close(fd);
+    return false;
+  }
+  const std::size_t fileSize = static_cast<std::size_t>(fileStat.st_size);
+
+  // Reserve zeroed memory that is at least one byte longer than the file,
+  // then map the file over its start. The bytes after the end of the file
+  // are zero, which terminates the contents.
+  const std::size_t pageSize =
+      static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  const std::size_t mappedSize = (fileSize / pageSize + 1) * pageSize;
+  void *region = ::mmap(nullptr, mappedSize, PROT_READ,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (region != MAP_FAILED && fileSize > 0 &&
+      ::mmap(region, fileSize, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) ==
+      MAP_FAILED)
+  {
+    ::munmap(region, mappedSize);
+    region = MAP_FAILED;
+  }
+  ::close(fd);
+
+  if (region != MAP_FAILED)
+  {
+    this->data = static_cast<const char *>(region);
+    this->size = fileSize;
+    this->mappedSize = mappedSize;
+  }
+#endif
+
+  if (!this->data)
+  {
+    std::ifstream file(_filename, std::ios::in | std::ios::binary);
+    if (!file)
+      return false;
+    this->buffer.assign(std::istreambuf_iterator<char>(file),
+                        std::istreambuf_iterator<char>());
+    if (file.bad())
+    {
+      this->buffer.clear();
+      return false;
+    }
+    this->data = this->buffer.c_str();
+    this->size = this->buffer.size();
+  }
+
+  if (_text && std::memchr(this->data, '\r', this->size))
+  {
+    std::string normalized = normalizeLineEndings(this->Data());
+    this->Close();
+    this->buffer = std::move(normalized);
+    this->data = this->buffer.c_str();
+    this->size = this->buffer.size();
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::string_view MappedFile::Data() const
+{
+  return this->data ? std::string_view(this->data, this->size) :
+      std::string_view();
+}
+
+/////////////////////////////////////////////////
+const char *MappedFile::CStr() const
+{
+  return this->data ? this->data : "";
+}
+
+/////////////////////////////////////////////////
+bool MappedFile::IsMapped() const
+{
+  return this->mappedSize > 0;
+}
+
+/////////////////////////////////////////////////
+void MappedFile::Close()
+{
+#ifndef _WIN32
+  if (this->mappedSize > 0)
+  {
+    ::munmap(const_cast<char *>(this->data), this->mappedSize);
+  }
+#endif
+  this->data = nullptr;
+  this->size = 0;
+  this->mappedSize = 0;
+  this->buffer.clear();
+}
+}
+}
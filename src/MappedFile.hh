@@ -0,0 +1,92 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_MAPPEDFILE_HH_
+#define SDF_MAPPEDFILE_HH_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "sdf/sdf_config.h"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \brief Read-only contents of a file. The file is memory mapped where
+  /// possible, so that reading it does not copy it to the heap. The contents
+  /// are followed by a null character, so they can be parsed as a C string.
+  ///
+  /// Line endings are normalized to '\n' like TiXmlDocument::LoadFile does.
+  /// Files that contain a '\r' are copied to normalize them.
+  class MappedFile
+  {
+    /// \brief Constructor for an empty file.
+    public: MappedFile() = default;
+
+    /// \brief Copy constructor is deleted, the mapping has one owner.
+    public: MappedFile(const MappedFile &) = delete;
+
+    /// \brief Copy assignment is deleted, the mapping has one owner.
+    public: MappedFile &operator=(const MappedFile &) = delete;
+
+    /// \brief Destructor, which unmaps the file.
+    public: ~MappedFile();
+
+    /// \brief Map a file, unmapping the previous one.
+    /// \param[in] _filename Path of the file.
+    /// \param[in] _text True to normalize the line endings of a text file,
+    /// false to map a binary file as is.
+    /// \return False if the file could not be opened or read.
+    public: bool Open(const std::string &_filename, const bool _text = true);
+
+    /// \brief Get the contents of the file.
+    /// \return View of the contents, without the terminating null character.
+    /// It is valid until the file is unmapped.
+    public: std::string_view Data() const;
+
+    /// \brief Get the contents of the file as a C string.
+    /// \return Pointer to the null terminated contents. It is valid until
+    /// the file is unmapped.
+    public: const char *CStr() const;
+
+    /// \brief Check whether the contents are memory mapped.
+    /// \return True if the contents are memory mapped, false if they were
+    /// copied to the heap.
+    public: bool IsMapped() const;
+
+    /// \brief Unmap the file.
+    private: void Close();
+
+    /// \brief Start of the contents.
+    private: const char *data = nullptr;
+
+    /// \brief Size of the contents.
+    private: std::size_t size = 0;
+
+    /// \brief Size of the mapped memory, zero if the file is not mapped.
+    private: std::size_t mappedSize = 0;
+
+    /// \brief Copy of the contents, used if the file can't be mapped or its
+    /// line endings need to be normalized.
+    private: std::string buffer;
+  };
+  }
+}
+#endif
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "MappedFile.hh"
+
+/////////////////////////////////////////////////
+/// \brief Write a file in a new temporary directory.
+/// \param[in] _contents Contents of the file.
+/// \return Path of the file.
+std::string writeTempFile(const std::string &_contents)
+{
+  char tmpl[] = "/tmp/sdf_mapped_XXXXXX";
+  int fd = mkstemp(tmpl);
+  EXPECT_GE(fd, 0);
+  close(fd);
+
+  std::ofstream out(tmpl, std::ios::binary);
+  out << _contents;
+  return tmpl;
+}
+
+/////////////////////////////////////////////////
+TEST(MappedFile, Open)
+{
+  sdf::MappedFile file;
+  EXPECT_TRUE(file.Data().empty());
+  EXPECT_STREQ("", file.CStr());
+
+  EXPECT_FALSE(file.Open("/this/file/does/not/exist.sdf"));
+  EXPECT_FALSE(file.Open("/tmp"));
+
+  const std::string filename = writeTempFile("<sdf version='1.7'/>");
+  ASSERT_TRUE(file.Open(filename));
+  EXPECT_TRUE(file.IsMapped());
+  EXPECT_EQ("<sdf version='1.7'/>", file.Data());
+  EXPECT_STREQ("<sdf version='1.7'/>", file.CStr());
+
+  EXPECT_EQ(0, std::remove(filename.c_str()));
+}
+
+/////////////////////////////////////////////////
+TEST(MappedFile, NullTerminated)
+{
+  // A file that fills whole pages is still followed by a null character.
+  const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  const std::string filename = writeTempFile(std::string(pageSize, 'x'));
+
+  sdf::MappedFile file;
+  ASSERT_TRUE(file.Open(filename));
+  EXPECT_EQ(pageSize, file.Data().size());
+  EXPECT_EQ('\0', file.CStr()[pageSize]);
+  EXPECT_EQ(0, std::remove(filename.c_str()));
+
+  const std::string emptyFilename = writeTempFile("");
+  ASSERT_TRUE(file.Open(emptyFilename));
+  EXPECT_TRUE(file.Data().empty());
+  EXPECT_STREQ("", file.CStr());
+  EXPECT_EQ(0, std::remove(emptyFilename.c_str()));
+}
+
+/////////////////////////////////////////////////
+TEST(MappedFile, LineEndings)
+{
+  const std::string filename = writeTempFile("a\r\nb\rc\n");
+
+  sdf::MappedFile file;
+  ASSERT_TRUE(file.Open(filename));
+  EXPECT_FALSE(file.IsMapped());
+  EXPECT_EQ("a\nb\nc\n", file.Data());
+
+  EXPECT_EQ(0, std::remove(filename.c_str()));
+}
+
+/////////////////////////////////////////////////
+TEST(MappedFile, Binary)
+{
+  const std::string contents("a\r\n\0b\r", 6);
+  const std::string filename = writeTempFile(contents);
+
+  sdf::MappedFile file;
+  ASSERT_TRUE(file.Open(filename, false));
+  EXPECT_TRUE(file.IsMapped());
+  EXPECT_EQ(contents, file.Data());
+
+  EXPECT_EQ(0, std::remove(filename.c_str()));
+}
@@ -27,6 +27,7 @@
 #include "sdf/Model.hh"
 #include "sdf/Types.hh"
 #include "FrameSemantics.hh"
+#include "NameIndex.hh"
 #include "Utils.hh"
 
 using namespace sdf;
@@ -67,6 +68,15 @@ class sdf::ModelPrivate
   /// \brief The frames specified in this model.
   public: std::vector<Frame> frames;
 
+  /// \brief Index of the links by name.
+  public: NameIndex linkIndex;
+
+  /// \brief Index of the joints by name.
+  public: NameIndex jointIndex;
+
+  /// \brief Index of the frames by name.
+  public: NameIndex frameIndex;
+
   /// \brief The SDF element pointer used during load.
   public: sdf::ElementPtr sdf;
 
@@ -311,6 +321,12 @@ Errors Model::Load(ElementPtr _sdf)
     frameNames.insert(frameName);
   }
 
+  // Index the links, joints and frames by name once they are renamed, and
+  // before the graphs are built, which look them up by name.
+  this->dataPtr->linkIndex.Build(this->dataPtr->links);
+  this->dataPtr->jointIndex.Build(this->dataPtr->joints);
+  this->dataPtr->frameIndex.Build(this->dataPtr->frames);
+
   // Build the graphs.
 
   // Build the FrameAttachedToGraph if the model is not static.
@@ -437,14 +453,8 @@ const Link *Model::LinkByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Model::LinkNameExists(const std::string &_name) const
 {
-  for (auto const &l : this->dataPtr->links)
-  {
-    if (l.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->linkIndex.Find(
+      this->dataPtr->links, _name) != nullptr;
 }
 
 /////////////////////////////////////////////////
@@ -464,27 +474,14 @@ const Joint *Model::JointByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Model::JointNameExists(const std::string &_name) const
 {
-  for (auto const &j : this->dataPtr->joints)
-  {
-    if (j.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->jointIndex.Find(
+      this->dataPtr->joints, _name) != nullptr;
 }
 
 /////////////////////////////////////////////////
 const Joint *Model::JointByName(const std::string &_name) const
 {
-  for (auto const &j : this->dataPtr->joints)
-  {
-    if (j.Name() == _name)
-    {
-      return &j;
-    }
-  }
-  return nullptr;
+  return this->dataPtr->jointIndex.Find(this->dataPtr->joints, _name);
 }
 
 /////////////////////////////////////////////////
@@ -504,27 +501,14 @@ const Frame *Model::FrameByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Model::FrameNameExists(const std::string &_name) const
 {
-  for (auto const &f : this->dataPtr->frames)
-  {
-    if (f.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->frameIndex.Find(
+      this->dataPtr->frames, _name) != nullptr;
 }
 
 /////////////////////////////////////////////////
 const Frame *Model::FrameByName(const std::string &_name) const
 {
-  for (auto const &f : this->dataPtr->frames)
-  {
-    if (f.Name() == _name)
-    {
-      return &f;
-    }
-  }
-  return nullptr;
+  return this->dataPtr->frameIndex.Find(this->dataPtr->frames, _name);
 }
 
 /////////////////////////////////////////////////
@@ -620,14 +604,7 @@ sdf::SemanticPose Model::SemanticPose() const
 /////////////////////////////////////////////////
 const Link *Model::LinkByName(const std::string &_name) const
 {
-  for (auto const &l : this->dataPtr->links)
-  {
-    if (l.Name() == _name)
-    {
-      return &l;
-    }
-  }
-  return nullptr;
+  return this->dataPtr->linkIndex.Find(this->dataPtr->links, _name);
 }
 
 /////////////////////////////////////////////////
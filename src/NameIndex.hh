@@ -0,0 +1,116 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_NAMEINDEX_HH_
+#define SDF_NAMEINDEX_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sdf/sdf_config.h"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \brief Positions of the objects of a vector by name, which the DOM
+  /// classes use to find their children by name in constant time.
+  ///
+  /// The index is built once the vector is loaded, and only read by the
+  /// accessors, so that const DOM objects can be used from several threads.
+  /// The first object with a name is found, like a linear search does. If
+  /// the vector changed size since the index was built, Find searches it
+  /// linearly.
+  class NameIndex
+  {
+    /// \brief Build the index of a vector.
+    /// \param[in] _objects Objects with a Name() accessor.
+    public: template<typename T>
+            void Build(const std::vector<T> &_objects)
+    {
+      this->indices.clear();
+      this->indices.reserve(_objects.size());
+      for (std::size_t i = 0; i < _objects.size(); ++i)
+        this->indices.emplace(_objects[i].Name(), i);
+      this->size = _objects.size();
+    }
+
+    /// \brief Add the position of an object before it is loaded, for
+    /// objects that are loaded one at a time. The index must not be built
+    /// again while the objects are looked up by position.
+    /// \param[in] _name Name of the object.
+    /// \param[in] _position Position of the object in its vector.
+    /// \return False if an object with the name is already indexed.
+    public: bool Insert(const std::string &_name, std::size_t _position)
+    {
+      if (!this->indices.emplace(_name, _position).second)
+        return false;
+      this->size = std::max(this->size, _position + 1);
+      return true;
+    }
+
+    /// \brief Get the position of the first object with a name, without
+    /// reading the objects.
+    /// \param[in] _name Name of the object.
+    /// \return The position, or npos if no object has the name.
+    public: std::size_t Position(const std::string &_name) const
+    {
+      auto it = this->indices.find(_name);
+      return it == this->indices.end() ? npos : it->second;
+    }
+
+    /// \brief Find an object by name.
+    /// \param[in] _objects The vector that the index was built from.
+    /// \param[in] _name Name of the object.
+    /// \return The first object with the name, or nullptr if there is none.
+    public: template<typename T>
+            const T *Find(const std::vector<T> &_objects,
+                          const std::string &_name) const
+    {
+      if (this->size == _objects.size())
+      {
+        auto it = this->indices.find(_name);
+        if (it == this->indices.end())
+          return nullptr;
+        if (_objects[it->second].Name() == _name)
+          return &_objects[it->second];
+      }
+
+      for (const T &object : _objects)
+      {
+        if (object.Name() == _name)
+          return &object;
+      }
+      return nullptr;
+    }
+
+    /// \brief Position returned by Position for names that are not indexed.
+    public: static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// \brief Position of the first object with each name.
+    private: std::unordered_map<std::string, std::size_t> indices;
+
+    /// \brief Size of the vector when the index was built.
+    private: std::size_t size = 0;
+  };
+  }
+}
+#endif
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "sdf/Frame.hh"
+#include "NameIndex.hh"
+
+/////////////////////////////////////////////////
+/// \brief Make a frame.
+/// \param[in] _name Name of the frame.
+/// \return The frame.
+sdf::Frame makeFrame(const std::string &_name)
+{
+  sdf::Frame frame;
+  frame.SetName(_name);
+  return frame;
+}
+
+/////////////////////////////////////////////////
+TEST(NameIndex, Find)
+{
+  std::vector<sdf::Frame> frames;
+  sdf::NameIndex index;
+  EXPECT_EQ(nullptr, index.Find(frames, "a"));
+
+  frames.push_back(makeFrame("a"));
+  frames.push_back(makeFrame("b"));
+  frames.push_back(makeFrame("a"));
+  index.Build(frames);
+
+  // The first object with a name is found.
+  EXPECT_EQ(&frames[0], index.Find(frames, "a"));
+  EXPECT_EQ(&frames[1], index.Find(frames, "b"));
+  EXPECT_EQ(nullptr, index.Find(frames, "c"));
+  EXPECT_EQ(nullptr, index.Find(frames, ""));
+
+  // A copy of the vector is found with a copy of the index.
+  const std::vector<sdf::Frame> copies = frames;
+  const sdf::NameIndex indexCopy = index;
+  EXPECT_EQ(&copies[1], indexCopy.Find(copies, "b"));
+}
+
+/////////////////////////////////////////////////
+TEST(NameIndex, Changed)
+{
+  std::vector<sdf::Frame> frames;
+  frames.push_back(makeFrame("a"));
+  frames.push_back(makeFrame("b"));
+  sdf::NameIndex index;
+  index.Build(frames);
+
+  // A vector that changed size is searched linearly.
+  frames.push_back(makeFrame("c"));
+  EXPECT_EQ(&frames[2], index.Find(frames, "c"));
+  EXPECT_EQ(&frames[0], index.Find(frames, "a"));
+
+  // A renamed object is not found by its previous name.
+  index.Build(frames);
+  frames[1].SetName("d");
+  EXPECT_EQ(nullptr, index.Find(frames, "b"));
+
+  // A vector that was not indexed is searched linearly.
+  EXPECT_EQ(&frames[1], sdf::NameIndex().Find(frames, "d"));
+}
@@ -16,18 +16,25 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <cstdint>
+#include <limits>
 #include <locale>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
 
-#include <locale.h>
 #include <math.h>
 
 #include "sdf/Assert.hh"
 #include "sdf/Param.hh"
 #include "sdf/Types.hh"
 
+#include "ParseArena.hh"
+
 using namespace sdf;
 
 // For some locale, the decimal separator is not a point, but a
@@ -55,15 +62,256 @@ namespace sdf
   }
 }
 
+//////////////////////////////////////////////////
+/// \brief Get the value type for a type name.
+/// \param[in] _typeName Name of the type.
+/// \return The value type, or UNKNOWN if the type name is not supported.
+static ParamPrivate::ValueType valueTypeFromName(const std::string &_typeName)
+{
+  using ValueType = ParamPrivate::ValueType;
+  static const std::unordered_map<std::string, ValueType> valueTypes = {
+    {"bool", ValueType::BOOL},
+    {"char", ValueType::CHAR},
+    {"std::string", ValueType::STRING},
+    {"string", ValueType::STRING},
+    {"int", ValueType::INT},
+    {"uint64_t", ValueType::UINT64},
+    {"unsigned int", ValueType::UNSIGNED_INT},
+    {"double", ValueType::DOUBLE},
+    {"float", ValueType::FLOAT},
+    {"sdf::Time", ValueType::TIME},
+    {"time", ValueType::TIME},
+    {"ignition::math::Color", ValueType::COLOR},
+    {"color", ValueType::COLOR},
+    {"ignition::math::Vector2i", ValueType::VECTOR2I},
+    {"vector2i", ValueType::VECTOR2I},
+    {"ignition::math::Vector2d", ValueType::VECTOR2D},
+    {"vector2d", ValueType::VECTOR2D},
+    {"ignition::math::Vector3d", ValueType::VECTOR3D},
+    {"vector3", ValueType::VECTOR3D},
+    {"ignition::math::Pose3d", ValueType::POSE},
+    {"pose", ValueType::POSE},
+    {"Pose", ValueType::POSE},
+    {"ignition::math::Quaterniond", ValueType::QUATERNION},
+    {"quaternion", ValueType::QUATERNION}};
+
+  auto iter = valueTypes.find(_typeName);
+  return iter == valueTypes.end() ? ValueType::UNKNOWN : iter->second;
+}
+
+//////////////////////////////////////////////////
+/// \brief Check whether a character is white space in the C locale.
+/// \param[in] _c The character.
+/// \return True if the character is white space.
+static bool isSpace(const char _c)
+{
+  return _c == ' ' || _c == '\t' || _c == '\n' || _c == '\v' ||
+         _c == '\f' || _c == '\r';
+}
+
+//////////////////////////////////////////////////
+/// \brief Compare a string with a lowercase string, ignoring case.
+/// \param[in] _str The string.
+/// \param[in] _lower The lowercase string to compare with.
+/// \return True if the strings are equal when ignoring case.
+static bool equalsIgnoreCase(const std::string &_str, const char *_lower)
+{
+  std::size_t i = 0;
+  for (; i < _str.size() && _lower[i] != '\0'; ++i)
+  {
+    char c = _str[i];
+    if (c >= 'A' && c <= 'Z')
+      c = static_cast<char>(c - 'A' + 'a');
+    if (c != _lower[i])
+      return false;
+  }
+  return i == _str.size() && _lower[i] == '\0';
+}
+
+//////////////////////////////////////////////////
+/// \brief Parse a floating point number without a sign or hexadecimal
+/// prefix, independently of the locale.
+/// \param[in] _first Start of the text.
+/// \param[in] _last End of the text.
+/// \param[out] _value The parsed value.
+/// \param[in] _hex True to parse hexadecimal digits.
+/// \return Position after the number and the error, if any.
+template<typename T>
+static std::from_chars_result floatFromChars(const char *_first,
+    const char *_last, T &_value, const bool _hex)
+{
+#if defined(__cpp_lib_to_chars)
+  return std::from_chars(_first, _last, _value,
+      _hex ? std::chars_format::hex : std::chars_format::general);
+#else
+  // Fall back to a classic locale stream if the standard library does not
+  // implement std::from_chars for floating point types.
+  if (_hex)
+  {
+    std::uint64_t integer = 0;
+    auto result = std::from_chars(_first, _last, integer, 16);
+    if (result.ec == std::errc())
+      _value = static_cast<T>(integer);
+    return result;
+  }
+
+  StringStreamClassicLocale ss(std::string(_first, _last));
+  T value;
+  ss >> value;
+  if (ss.fail())
+  {
+    if (value == std::numeric_limits<T>::max() ||
+        value == -std::numeric_limits<T>::max())
+    {
+      return {_first, std::errc::result_out_of_range};
+    }
+    return {_first, std::errc::invalid_argument};
+  }
+  _value = value;
+  std::streamoff consumed = ss.eof() ? _last - _first : ss.tellg();
+  return {_first + consumed, std::errc()};
+#endif
+}
+
+//////////////////////////////////////////////////
+/// \brief Parse a number at the start of some text, independently of the
+/// locale. Like the std::sto* functions, leading white space and a '+' or
+/// '-' sign are accepted, and parsing stops at the first character that is
+/// not part of the number. Negative values wrap around for unsigned types.
+/// \param[in] _first Start of the text.
+/// \param[in] _last End of the text.
+/// \param[out] _value The parsed value. It is unchanged on error.
+/// \param[in] _allowHex True to parse numbers that start with "0x" as
+/// hexadecimal. Integers are only parsed as hexadecimal if the text starts
+/// with "0x", while floating point numbers may also have a sign first.
+/// \return Position after the number and the error, if any.
+template<typename T>
+static std::from_chars_result parseNumber(const char *_first,
+    const char *_last, T &_value, const bool _allowHex)
+{
+  const char *ptr = _first;
+  while (ptr != _last && isSpace(*ptr))
+    ++ptr;
+
+  bool negative = false;
+  if (ptr != _last && (*ptr == '+' || *ptr == '-'))
+  {
+    negative = *ptr == '-';
+    ++ptr;
+  }
+
+  const bool hex = _allowHex &&
+      (std::is_floating_point_v<T> || ptr == _first) &&
+      _last - ptr > 2 && ptr[0] == '0' && (ptr[1] == 'x' || ptr[1] == 'X');
+  if (hex)
+    ptr += 2;
+
+  // A second sign is not allowed.
+  if (ptr == _last || *ptr == '+' || *ptr == '-')
+    return {_first, std::errc::invalid_argument};
+
+  std::from_chars_result result;
+  if constexpr (std::is_floating_point_v<T>)
+  {
+    T magnitude;
+    result = floatFromChars(ptr, _last, magnitude, hex);
+    if (result.ec == std::errc())
+      _value = negative ? -magnitude : magnitude;
+  }
+  else
+  {
+    std::uint64_t magnitude;
+    result = std::from_chars(ptr, _last, magnitude, hex ? 16 : 10);
+    if (result.ec == std::errc())
+    {
+      if constexpr (std::is_signed_v<T>)
+      {
+        const std::uint64_t max = std::numeric_limits<T>::max();
+        if (magnitude > max + (negative ? 1 : 0))
+        {
+          result.ec = std::errc::result_out_of_range;
+        }
+        else
+        {
+          _value = negative ?
+              static_cast<T>(-static_cast<std::int64_t>(magnitude - 1) - 1) :
+              static_cast<T>(magnitude);
+        }
+      }
+      else
+      {
+        _value = static_cast<T>(negative ? 0 - magnitude : magnitude);
+      }
+    }
+  }
+
+  if (hex && result.ec == std::errc::invalid_argument)
+  {
+    // No digits after the prefix, so only the leading zero is a number.
+    _value = 0;
+    return {ptr - 1, std::errc()};
+  }
+
+  if (result.ec != std::errc())
+    result.ptr = _first;
+  return result;
+}
+
+//////////////////////////////////////////////////
+/// \brief Parse white space separated numbers, independently of the locale.
+/// Like reading the numbers from a stream, parsing stops at the first value
+/// that is not a number, and the remaining values are left unchanged.
+/// \param[in] _str The text to parse.
+/// \param[in,out] _values The values to parse.
+/// \return The number of values that were parsed.
+template<typename T, std::size_t N>
+static std::size_t parseNumbers(std::string_view _str,
+    std::array<T, N> &_values)
+{
+  const char *ptr = _str.data();
+  const char *last = ptr + _str.size();
+  std::size_t count = 0;
+  for (; count < N; ++count)
+  {
+    auto result = parseNumber(ptr, last, _values[count], false);
+    if (result.ec != std::errc())
+      break;
+    ptr = result.ptr;
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+/// \brief Parse a single number from a string, in the same way as the
+/// std::sto* functions.
+/// \param[in] _str The text to parse.
+/// \param[out] _value The parsed value.
+/// \param[in] _allowHex True to parse numbers that start with "0x" as
+/// hexadecimal.
+/// \throws std::invalid_argument if no number could be parsed.
+/// \throws std::out_of_range if the number is out of range.
+template<typename T>
+static void parseScalar(std::string_view _str, T &_value,
+    const bool _allowHex)
+{
+  auto result = parseNumber(_str.data(), _str.data() + _str.size(), _value,
+      _allowHex);
+  if (result.ec == std::errc::result_out_of_range)
+    throw std::out_of_range(std::string(_str));
+  else if (result.ec != std::errc())
+    throw std::invalid_argument(std::string(_str));
+}
+
 //////////////////////////////////////////////////
 Param::Param(const std::string &_key, const std::string &_typeName,
              const std::string &_default, bool _required,
              const std::string &_description)
-  : dataPtr(new ParamPrivate)
+  : dataPtr(ParseArena::MakeUnique<ParamPrivate>())
 {
-  this->dataPtr->key = _key;
+  this->dataPtr->key = InternedString::Lookup(_key);
   this->dataPtr->required = _required;
   this->dataPtr->typeName = _typeName;
+  this->dataPtr->valueType = valueTypeFromName(_typeName);
   this->dataPtr->description = _description;
   this->dataPtr->set = false;
 
@@ -71,6 +319,12 @@ Param::Param(const std::string &_key, const std::string &_typeName,
   this->dataPtr->defaultValue = this->dataPtr->value;
 }
 
+//////////////////////////////////////////////////
+Param::Param()
+  : dataPtr(ParseArena::MakeUnique<ParamPrivate>())
+{
+}
+
 //////////////////////////////////////////////////
 Param::~Param()
 {
@@ -274,157 +528,165 @@ std::string Param::GetDefaultAsString() const
 //////////////////////////////////////////////////
 bool Param::ValueFromString(const std::string &_value)
 {
-  // Under some circumstances, latin locales (es_ES or pt_BR) will return a
-  // comma for decimal position instead of a dot, making the conversion
-  // to fail. See bug #60 for more information. Force to use always C
-  setlocale(LC_NUMERIC, "C");
-
-  std::string tmp(_value);
-  std::string lowerTmp = lowercase(_value);
+  // Numbers are parsed with std::from_chars and classic locale streams, so
+  // the result does not depend on the global locale (see bug #60), and the
+  // global locale is never modified.
+  using ValueType = ParamPrivate::ValueType;
 
   // "true" and "false" doesn't work properly
-  if (lowerTmp == "true")
-  {
-    tmp = "1";
-  }
-  else if (lowerTmp == "false")
-  {
-    tmp = "0";
-  }
-
-  bool isHex = lowerTmp.compare(0, 2, "0x") == 0;
+  const bool isTrue = equalsIgnoreCase(_value, "true");
+  const bool isFalse = equalsIgnoreCase(_value, "false");
+  const std::string_view tmp =
+      isTrue ? "1" : isFalse ? "0" : std::string_view(_value);
 
   try
   {
-    // Try to use stoi and stoul for integers, and
-    // stof and stod for scalar floating point values.
-    int numericBase = 10;
-    if (isHex)
+    switch (this->dataPtr->valueType)
     {
-      numericBase = 16;
-    }
-
-    if (this->dataPtr->typeName == "bool")
-    {
-      if (lowerTmp == "true" || lowerTmp == "1")
+      case ValueType::BOOL:
+        if (isTrue || _value == "1")
+        {
+          this->dataPtr->value = true;
+        }
+        else if (isFalse || _value == "0")
+        {
+          this->dataPtr->value = false;
+        }
+        else
+        {
+          sdferr << "Invalid boolean value\n";
+          return false;
+        }
+        break;
+      case ValueType::CHAR:
+        this->dataPtr->value = tmp.empty() ? '\0' : tmp[0];
+        break;
+      case ValueType::STRING:
+        this->dataPtr->value = std::string(tmp);
+        break;
+      case ValueType::INT:
       {
-        this->dataPtr->value = true;
+        int inttmp = 0;
+        parseScalar(tmp, inttmp, true);
+        this->dataPtr->value = inttmp;
+        break;
       }
-      else if (lowerTmp == "false" || lowerTmp == "0")
+      case ValueType::UINT64:
       {
-        this->dataPtr->value = false;
+        // Like reading from a stream, an invalid value is read as zero and
+        // an out of range value as the maximum.
+        std::uint64_t u64tmp = 0;
+        auto result = parseNumber(tmp.data(), tmp.data() + tmp.size(),
+            u64tmp, false);
+        if (result.ec == std::errc::result_out_of_range)
+          u64tmp = std::numeric_limits<std::uint64_t>::max();
+        this->dataPtr->value = u64tmp;
+        break;
       }
-      else
+      case ValueType::UNSIGNED_INT:
       {
-        sdferr << "Invalid boolean value\n";
-        return false;
+        // Parsed as unsigned long and then truncated, like std::stoul.
+        std::uint64_t ultmp = 0;
+        parseScalar(tmp, ultmp, true);
+        this->dataPtr->value = static_cast<unsigned int>(ultmp);
+        break;
       }
-    }
-    else if (this->dataPtr->typeName == "char")
-    {
-      this->dataPtr->value = tmp[0];
-    }
-    else if (this->dataPtr->typeName == "std::string" ||
-             this->dataPtr->typeName == "string")
-    {
-      this->dataPtr->value = tmp;
-    }
-    else if (this->dataPtr->typeName == "int")
-    {
-      this->dataPtr->value = std::stoi(tmp, nullptr, numericBase);
-    }
-    else if (this->dataPtr->typeName == "uint64_t")
-    {
-      StringStreamClassicLocale ss(tmp);
-      std::uint64_t u64tmp;
-
-      ss >> u64tmp;
-      this->dataPtr->value = u64tmp;
-    }
-    else if (this->dataPtr->typeName == "unsigned int")
-    {
-      this->dataPtr->value = static_cast<unsigned int>(
-          std::stoul(tmp, nullptr, numericBase));
-    }
-    else if (this->dataPtr->typeName == "double")
-    {
-      this->dataPtr->value = std::stod(tmp);
-    }
-    else if (this->dataPtr->typeName == "float")
-    {
-      this->dataPtr->value = std::stof(tmp);
-    }
-    else if (this->dataPtr->typeName == "sdf::Time" ||
-             this->dataPtr->typeName == "time")
-    {
-      StringStreamClassicLocale ss(tmp);
-      sdf::Time timetmp;
-
-      ss >> timetmp;
-      this->dataPtr->value = timetmp;
-    }
-    else if (this->dataPtr->typeName == "ignition::math::Color" ||
-             this->dataPtr->typeName == "color")
-    {
-      StringStreamClassicLocale ss(tmp);
-      ignition::math::Color colortmp;
-
-      ss >> colortmp;
-      this->dataPtr->value = colortmp;
-    }
-    else if (this->dataPtr->typeName == "ignition::math::Vector2i" ||
-             this->dataPtr->typeName == "vector2i")
-    {
-      StringStreamClassicLocale ss(tmp);
-      ignition::math::Vector2i vectmp;
-
-      ss >> vectmp;
-      this->dataPtr->value = vectmp;
-    }
-    else if (this->dataPtr->typeName == "ignition::math::Vector2d" ||
-             this->dataPtr->typeName == "vector2d")
-    {
-      StringStreamClassicLocale ss(tmp);
-      ignition::math::Vector2d vectmp;
-
-      ss >> vectmp;
-      this->dataPtr->value = vectmp;
-    }
-    else if (this->dataPtr->typeName == "ignition::math::Vector3d" ||
-             this->dataPtr->typeName == "vector3")
-    {
-      StringStreamClassicLocale ss(tmp);
-      ignition::math::Vector3d vectmp;
-
-      ss >> vectmp;
-      this->dataPtr->value = vectmp;
-    }
-    else if (this->dataPtr->typeName == "ignition::math::Pose3d" ||
-             this->dataPtr->typeName == "pose" ||
-             this->dataPtr->typeName == "Pose")
-    {
-      StringStreamClassicLocale ss(tmp);
-      ignition::math::Pose3d posetmp;
-
-      ss >> posetmp;
-      this->dataPtr->value = posetmp;
-    }
-    else if (this->dataPtr->typeName == "ignition::math::Quaterniond" ||
-             this->dataPtr->typeName == "quaternion")
-    {
-      StringStreamClassicLocale ss(tmp);
-      ignition::math::Quaterniond quattmp;
+      case ValueType::DOUBLE:
+      {
+        double doubletmp = 0;
+        parseScalar(tmp, doubletmp, true);
+        this->dataPtr->value = doubletmp;
+        break;
+      }
+      case ValueType::FLOAT:
+      {
+        float floattmp = 0;
+        parseScalar(tmp, floattmp, true);
+        this->dataPtr->value = floattmp;
+        break;
+      }
+      case ValueType::TIME:
+      {
+        StringStreamClassicLocale ss{std::string(tmp)};
+        sdf::Time timetmp;
 
-      ss >> quattmp;
-      this->dataPtr->value = quattmp;
-    }
-    else
-    {
-      sdferr << "Unknown parameter type[" << this->dataPtr->typeName << "]\n";
-      return false;
+        ss >> timetmp;
+        this->dataPtr->value = timetmp;
+        break;
+      }
+      case ValueType::COLOR:
+      {
+        // The alpha value is optional. The components are not clamped.
+        std::array<float, 4> values = {0, 0, 0, 1};
+        parseNumbers(tmp, values);
+        ignition::math::Color colortmp;
+        colortmp.R(values[0]);
+        colortmp.G(values[1]);
+        colortmp.B(values[2]);
+        colortmp.A(values[3]);
+        this->dataPtr->value = colortmp;
+        break;
+      }
+      case ValueType::VECTOR2I:
+      {
+        std::array<int, 2> values = {0, 0};
+        ignition::math::Vector2i vectmp;
+        if (parseNumbers(tmp, values) == values.size())
+          vectmp.Set(values[0], values[1]);
+        this->dataPtr->value = vectmp;
+        break;
+      }
+      case ValueType::VECTOR2D:
+      {
+        std::array<double, 2> values = {0, 0};
+        ignition::math::Vector2d vectmp;
+        if (parseNumbers(tmp, values) == values.size())
+          vectmp.Set(values[0], values[1]);
+        this->dataPtr->value = vectmp;
+        break;
+      }
+      case ValueType::VECTOR3D:
+      {
+        std::array<double, 3> values = {0, 0, 0};
+        ignition::math::Vector3d vectmp;
+        if (parseNumbers(tmp, values) == values.size())
+          vectmp.Set(values[0], values[1], values[2]);
+        this->dataPtr->value = vectmp;
+        break;
+      }
+      case ValueType::POSE:
+      {
+        // Position followed by roll, pitch and yaw. Like the stream
+        // operators, the position and the rotation are each only used if
+        // all of their values are present.
+        std::array<double, 6> values = {0, 0, 0, 0, 0, 0};
+        const std::size_t count = parseNumbers(tmp, values);
+        ignition::math::Vector3d pos;
+        ignition::math::Quaterniond rot;
+        if (count >= 3)
+          pos.Set(values[0], values[1], values[2]);
+        if (count == values.size())
+          rot.Euler(values[3], values[4], values[5]);
+        this->dataPtr->value = ignition::math::Pose3d(pos, rot);
+        break;
+      }
+      case ValueType::QUATERNION:
+      {
+        // Roll, pitch and yaw, only used if all three are present.
+        std::array<double, 3> values = {0, 0, 0};
+        ignition::math::Quaterniond quattmp;
+        if (parseNumbers(tmp, values) == values.size())
+          quattmp.Euler(values[0], values[1], values[2]);
+        this->dataPtr->value = quattmp;
+        break;
+      }
+      default:
+        sdferr << "Unknown parameter type[" << this->dataPtr->typeName
+               << "]\n";
+        return false;
     }
   }
-  // Catch invalid argument exception from std::stoi/stoul/stod/stof
+  // Catch invalid argument exception from parseScalar
   catch(std::invalid_argument &)
   {
     sdferr << "Invalid argument. Unable to set value ["
@@ -432,7 +694,7 @@ bool Param::ValueFromString(const std::string &_value)
            << this->dataPtr->key << "].\n";
     return false;
   }
-  // Catch out of range exception from std::stoi/stoul/stod/stof
+  // Catch out of range exception from parseScalar
   catch(std::out_of_range &)
   {
     sdferr << "Out of range. Unable to set value ["
@@ -480,10 +742,17 @@ void Param::Reset()
 //////////////////////////////////////////////////
 ParamPtr Param::Clone() const
 {
-  ParamPtr clone(new Param(this->dataPtr->key, this->dataPtr->typeName,
-                            this->GetAsString(), this->dataPtr->required,
-                            this->dataPtr->description));
+  ParamPtr clone = ParseArena::MakeShared<Param>();
+  clone->dataPtr->key = this->dataPtr->key;
+  clone->dataPtr->required = this->dataPtr->required;
   clone->dataPtr->set = this->dataPtr->set;
+  clone->dataPtr->typeName = this->dataPtr->typeName;
+  clone->dataPtr->valueType = this->dataPtr->valueType;
+  clone->dataPtr->description = this->dataPtr->description;
+
+  // The current value becomes the default of the clone.
+  clone->dataPtr->value = this->dataPtr->value;
+  clone->dataPtr->defaultValue = this->dataPtr->value;
   return clone;
 }
 
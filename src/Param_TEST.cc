@@ -16,6 +16,7 @@
  */
 
 #include <any>
+#include <climits>
 #include <cstdint>
 
 #include <gtest/gtest.h>
@@ -246,6 +247,84 @@ TEST(Param, Vector2i)
   EXPECT_EQ(value, ignition::math::Vector2i(0, 0));
 }
 
+////////////////////////////////////////////////////
+/// Test parsing signs and white space around numbers.
+TEST(Param, SignedNumbers)
+{
+  sdf::Param intParam("key", "int", "+12", false, "description");
+  int intValue;
+  EXPECT_TRUE(intParam.Get<int>(intValue));
+  EXPECT_EQ(12, intValue);
+
+  EXPECT_TRUE(intParam.SetFromString(" -7 "));
+  EXPECT_TRUE(intParam.Get<int>(intValue));
+  EXPECT_EQ(-7, intValue);
+
+  EXPECT_FALSE(intParam.SetFromString("+-7"));
+  EXPECT_FALSE(intParam.SetFromString("2147483648"));
+  EXPECT_TRUE(intParam.SetFromString("-2147483648"));
+  EXPECT_TRUE(intParam.Get<int>(intValue));
+  EXPECT_EQ(INT_MIN, intValue);
+
+  sdf::Param doubleParam("key", "double", "+1.5e2", false, "description");
+  double doubleValue;
+  EXPECT_TRUE(doubleParam.Get<double>(doubleValue));
+  EXPECT_DOUBLE_EQ(150.0, doubleValue);
+
+  EXPECT_TRUE(doubleParam.SetFromString("-0.25"));
+  EXPECT_TRUE(doubleParam.Get<double>(doubleValue));
+  EXPECT_DOUBLE_EQ(-0.25, doubleValue);
+
+  EXPECT_FALSE(doubleParam.SetFromString("abc"));
+}
+
+////////////////////////////////////////////////////
+TEST(Param, Color)
+{
+  sdf::Param colorParam("key", "color", "0.1 0.2 0.3", false, "description");
+  ignition::math::Color value;
+  EXPECT_TRUE(colorParam.Get<ignition::math::Color>(value));
+  EXPECT_EQ(ignition::math::Color(0.1f, 0.2f, 0.3f, 1.0f), value);
+
+  EXPECT_TRUE(colorParam.SetFromString("0.4 0.5 0.6 0.7"));
+  EXPECT_TRUE(colorParam.Get<ignition::math::Color>(value));
+  EXPECT_EQ(ignition::math::Color(0.4f, 0.5f, 0.6f, 0.7f), value);
+}
+
+////////////////////////////////////////////////////
+TEST(Param, Pose)
+{
+  sdf::Param poseParam("key", "pose", "1 2 3 0 0 1.5707963267948966", false,
+      "description");
+  ignition::math::Pose3d value;
+  EXPECT_TRUE(poseParam.Get<ignition::math::Pose3d>(value));
+  EXPECT_EQ(ignition::math::Pose3d(1, 2, 3, 0, 0, IGN_PI_2), value);
+
+  // The rotation is ignored unless all three angles are present.
+  EXPECT_TRUE(poseParam.SetFromString("4 5 6 1"));
+  EXPECT_TRUE(poseParam.Get<ignition::math::Pose3d>(value));
+  EXPECT_EQ(ignition::math::Pose3d(4, 5, 6, 0, 0, 0), value);
+
+  // So is the position, unless all three coordinates are present.
+  EXPECT_TRUE(poseParam.SetFromString("4 5"));
+  EXPECT_TRUE(poseParam.Get<ignition::math::Pose3d>(value));
+  EXPECT_EQ(ignition::math::Pose3d::Zero, value);
+}
+
+////////////////////////////////////////////////////
+TEST(Param, Quaternion)
+{
+  sdf::Param quatParam("key", "quaternion", "0 0 1.5707963267948966", false,
+      "description");
+  ignition::math::Quaterniond value;
+  EXPECT_TRUE(quatParam.Get<ignition::math::Quaterniond>(value));
+  EXPECT_EQ(ignition::math::Quaterniond(0, 0, IGN_PI_2), value);
+
+  EXPECT_TRUE(quatParam.SetFromString("0 1"));
+  EXPECT_TRUE(quatParam.Get<ignition::math::Quaterniond>(value));
+  EXPECT_EQ(ignition::math::Quaterniond::Identity, value);
+}
+
 ////////////////////////////////////////////////////
 TEST(Param, InvalidConstructor)
 {
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include "ParseArena.hh"
+#include "SDFImplPrivate.hh"
+
+namespace sdf
+{
+inline namespace SDF_VERSION_NAMESPACE
+{
+/// \brief Size of the first block of an arena. Later blocks grow
+/// geometrically.
+static const std::size_t kInitialBlockSize = 64 * 1024;
+
+/// \brief Arena that is current on this thread.
+static thread_local ParseArena *g_currentArena = nullptr;
+
+/////////////////////////////////////////////////
+ParseArena::Scope::Scope(ParseArena *_arena)
+  : previous(g_currentArena)
+{
+  g_currentArena = _arena;
+}
+
+/////////////////////////////////////////////////
+ParseArena::Scope::~Scope()
+{
+  g_currentArena = this->previous;
+}
+
+/////////////////////////////////////////////////
+ParseArena::ParseArena()
+  : resource(kInitialBlockSize)
+{
+}
+
+/////////////////////////////////////////////////
+void *ParseArena::Allocate(std::size_t _bytes, std::size_t _alignment)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  ++this->allocationCount;
+  return this->resource.allocate(_bytes, _alignment);
+}
+
+/////////////////////////////////////////////////
+void *ParseArena::do_allocate(std::size_t _bytes, std::size_t _alignment)
+{
+  return this->Allocate(_bytes, _alignment);
+}
+
+/////////////////////////////////////////////////
+void ParseArena::do_deallocate(void *, std::size_t, std::size_t)
+{
+}
+
+/////////////////////////////////////////////////
+bool ParseArena::do_is_equal(
+    const std::pmr::memory_resource &_other) const noexcept
+{
+  return this == &_other;
+}
+
+/////////////////////////////////////////////////
+std::size_t ParseArena::AllocationCount() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->allocationCount;
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<ParseArena> ParseArena::Of(SDF &_sdf)
+{
+  if (!_sdf.dataPtr->arena)
+    _sdf.dataPtr->arena = std::make_shared<ParseArena>();
+  return _sdf.dataPtr->arena;
+}
+
+/////////////////////////////////////////////////
+ParseArena *ParseArena::Current()
+{
+  return g_currentArena;
+}
+
+/////////////////////////////////////////////////
+std::pmr::memory_resource *ParseArena::Resource()
+{
+  if (g_currentArena)
+    return g_currentArena;
+  return std::pmr::get_default_resource();
+}
+}
+}
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_PARSEARENA_HH_
+#define SDF_PARSEARENA_HH_
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "sdf/Param.hh"
+#include "sdf/SDFImpl.hh"
+#include "sdf/sdf_config.h"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \brief Monotonic memory for the elements and parameters of the
+  /// documents read into an SDF object, used when
+  /// ParserConfig::UseParseArena() is true.
+  ///
+  /// Objects created by MakeShared while an arena is current on the thread
+  /// are placed in the arena, with their reference counts. So is the
+  /// private data created by MakeUnique, and the containers that it
+  /// allocates from Resource(). Releasing them runs their destructors but
+  /// frees nothing; the arena frees its blocks at once when the SDF object
+  /// and the last of these objects are destroyed. Every object holds a
+  /// reference to its arena, so elements can outlive the SDF object they
+  /// were read into.
+  ///
+  /// Allocations are serialized by a mutex, so the threads that load
+  /// included files can share the arena of the document.
+  class ParseArena : public std::pmr::memory_resource,
+                     public std::enable_shared_from_this<ParseArena>
+  {
+    /// \brief Makes an arena current on the calling thread for the lifetime
+    /// of the scope, then restores the previous one.
+    public: class Scope
+    {
+      /// \brief Constructor.
+      /// \param[in] _arena The arena, or nullptr to allocate on the heap.
+      public: explicit Scope(ParseArena *_arena);
+
+      /// \brief Copy constructor is deleted, scopes are nested.
+      public: Scope(const Scope &) = delete;
+
+      /// \brief Copy assignment is deleted, scopes are nested.
+      public: Scope &operator=(const Scope &) = delete;
+
+      /// \brief Destructor, which restores the previous arena.
+      public: ~Scope();
+
+      /// \brief Arena that was current before this scope.
+      private: ParseArena *previous;
+    };
+
+    /// \brief Allocator of reference counts in an arena, which keeps the
+    /// arena alive until they are released.
+    public: template<typename T> class Allocator
+    {
+      /// \brief Type of the allocated objects.
+      public: using value_type = T;
+
+      /// \brief Constructor.
+      /// \param[in] _arena The arena.
+      public: explicit Allocator(std::shared_ptr<ParseArena> _arena)
+        : arena(std::move(_arena))
+      {
+      }
+
+      /// \brief Converting constructor, required by std::shared_ptr.
+      /// \param[in] _other Allocator of another type.
+      public: template<typename U>
+              Allocator(const Allocator<U> &_other)
+        : arena(_other.arena)
+      {
+      }
+
+      /// \brief Allocate memory in the arena.
+      /// \param[in] _count Number of objects.
+      /// \return Pointer to the memory.
+      public: T *allocate(std::size_t _count)
+      {
+        return static_cast<T *>(
+            this->arena->Allocate(_count * sizeof(T), alignof(T)));
+      }
+
+      /// \brief Memory in the arena is freed with the arena.
+      public: void deallocate(T *, std::size_t)
+      {
+      }
+
+      /// \brief Equality operator.
+      /// \param[in] _other Allocator to compare with.
+      /// \return True if both allocate in the same arena.
+      public: template<typename U>
+              bool operator==(const Allocator<U> &_other) const
+      {
+        return this->arena == _other.arena;
+      }
+
+      /// \brief Inequality operator.
+      /// \param[in] _other Allocator to compare with.
+      /// \return True if they allocate in different arenas.
+      public: template<typename U>
+              bool operator!=(const Allocator<U> &_other) const
+      {
+        return this->arena != _other.arena;
+      }
+
+      /// \brief The arena.
+      private: std::shared_ptr<ParseArena> arena;
+
+      template<typename U> friend class Allocator;
+    };
+
+    /// \brief Constructor.
+    public: ParseArena();
+
+    /// \brief Copy constructor is deleted, the memory has one owner.
+    public: ParseArena(const ParseArena &) = delete;
+
+    /// \brief Copy assignment is deleted, the memory has one owner.
+    public: ParseArena &operator=(const ParseArena &) = delete;
+
+    /// \brief Allocate memory, which is freed with the arena.
+    /// \param[in] _bytes Size of the memory.
+    /// \param[in] _alignment Alignment of the memory.
+    /// \return Pointer to the memory.
+    public: void *Allocate(std::size_t _bytes, std::size_t _alignment);
+
+    /// \brief Get the number of allocations made in the arena.
+    /// \return Number of allocations.
+    public: std::size_t AllocationCount() const;
+
+    /// \brief Get the arena of an SDF object, creating it on first use.
+    /// \param[in] _sdf The SDF object.
+    /// \return The arena.
+    public: static std::shared_ptr<ParseArena> Of(SDF &_sdf);
+
+    /// \brief Get the arena that is current on the calling thread.
+    /// \return The arena, or nullptr if objects are allocated on the heap.
+    public: static ParseArena *Current();
+
+    /// \brief Get the memory resource for the containers of objects created
+    /// on the calling thread.
+    /// \return The current arena, or the default resource if there is none.
+    public: static std::pmr::memory_resource *Resource();
+
+    /// \brief Create an object in the current arena of the calling thread,
+    /// or on the heap if there is none.
+    /// \param[in] _args Arguments of the constructor of the object.
+    /// \return Shared pointer to the object.
+    public: template<typename T, typename... Args>
+            static std::shared_ptr<T> MakeShared(Args &&..._args)
+    {
+      ParseArena *current = Current();
+      if (!current)
+        return std::shared_ptr<T>(new T(std::forward<Args>(_args)...));
+
+      void *memory = current->Allocate(sizeof(T), alignof(T));
+      T *object = new (memory) T(std::forward<Args>(_args)...);
+      return std::shared_ptr<T>(object, [](T *_object) { _object->~T(); },
+          Allocator<T>(current->shared_from_this()));
+    }
+
+    /// \brief Create the private data of an object in the current arena of
+    /// the calling thread, or on the heap if there is none.
+    /// \param[in] _args Arguments of the constructor of the data.
+    /// \return Pointer to the data, whose deleter holds the arena.
+    public: template<typename T, typename... Args>
+            static std::unique_ptr<T, ArenaDeleter<T>> MakeUnique(
+                Args &&..._args)
+    {
+      ParseArena *current = Current();
+      if (!current)
+      {
+        return std::unique_ptr<T, ArenaDeleter<T>>(
+            new T(std::forward<Args>(_args)...));
+      }
+
+      void *memory = current->Allocate(sizeof(T), alignof(T));
+      T *object = new (memory) T(std::forward<Args>(_args)...);
+      return std::unique_ptr<T, ArenaDeleter<T>>(object,
+          ArenaDeleter<T>(current->shared_from_this()));
+    }
+
+    /// \brief Allocate memory for a container.
+    /// \param[in] _bytes Size of the memory.
+    /// \param[in] _alignment Alignment of the memory.
+    /// \return Pointer to the memory.
+    private: void *do_allocate(std::size_t _bytes,
+                               std::size_t _alignment) override;
+
+    /// \brief Memory in the arena is freed with the arena.
+    private: void do_deallocate(void *, std::size_t, std::size_t) override;
+
+    /// \brief Check whether memory can be freed by another resource.
+    /// \param[in] _other The other resource.
+    /// \return True if the other resource is this arena.
+    private: bool do_is_equal(
+        const std::pmr::memory_resource &_other) const noexcept override;
+
+    /// \brief Serializes allocations.
+    private: mutable std::mutex mutex;
+
+    /// \brief The memory.
+    private: std::pmr::monotonic_buffer_resource resource;
+
+    /// \brief Number of allocations.
+    private: std::size_t allocationCount = 0;
+  };
+  }
+}
+#endif
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "sdf/SDFImpl.hh"
+#include "ParseArena.hh"
+
+/////////////////////////////////////////////////
+/// \brief Object that records its destruction.
+class Counted
+{
+  /// \brief Constructor.
+  /// \param[in] _name Name of the object.
+  /// \param[in,out] _destroyed Incremented by the destructor.
+  public: Counted(const std::string &_name, int &_destroyed)
+    : name(_name), destroyed(_destroyed)
+  {
+  }
+
+  /// \brief Destructor.
+  public: ~Counted()
+  {
+    ++this->destroyed;
+  }
+
+  /// \brief Name of the object.
+  public: std::string name;
+
+  /// \brief Incremented by the destructor.
+  public: int &destroyed;
+};
+
+/////////////////////////////////////////////////
+TEST(ParseArena, Scope)
+{
+  EXPECT_EQ(nullptr, sdf::ParseArena::Current());
+
+  auto arena = std::make_shared<sdf::ParseArena>();
+  {
+    sdf::ParseArena::Scope scope(arena.get());
+    EXPECT_EQ(arena.get(), sdf::ParseArena::Current());
+    {
+      sdf::ParseArena::Scope heapScope(nullptr);
+      EXPECT_EQ(nullptr, sdf::ParseArena::Current());
+    }
+    EXPECT_EQ(arena.get(), sdf::ParseArena::Current());
+
+    // The arena is current on this thread only.
+    std::thread([]()
+    {
+      EXPECT_EQ(nullptr, sdf::ParseArena::Current());
+    }).join();
+  }
+  EXPECT_EQ(nullptr, sdf::ParseArena::Current());
+}
+
+/////////////////////////////////////////////////
+TEST(ParseArena, MakeShared)
+{
+  int destroyed = 0;
+
+  // Without an arena, objects are created on the heap.
+  std::shared_ptr<Counted> heapObject =
+      sdf::ParseArena::MakeShared<Counted>("heap", destroyed);
+  EXPECT_EQ("heap", heapObject->name);
+
+  auto arena = std::make_shared<sdf::ParseArena>();
+  std::weak_ptr<sdf::ParseArena> weakArena = arena;
+  std::shared_ptr<Counted> object;
+  {
+    sdf::ParseArena::Scope scope(arena.get());
+    object = sdf::ParseArena::MakeShared<Counted>("arena", destroyed);
+    for (int i = 0; i < 100; ++i)
+      sdf::ParseArena::MakeShared<Counted>("temporary", destroyed);
+  }
+  EXPECT_EQ(100, destroyed);
+  EXPECT_EQ("arena", object->name);
+  EXPECT_LE(101u, arena->AllocationCount());
+
+  // Objects keep their arena alive.
+  arena.reset();
+  EXPECT_FALSE(weakArena.expired());
+  EXPECT_EQ("arena", object->name);
+  object.reset();
+  EXPECT_EQ(101, destroyed);
+  EXPECT_TRUE(weakArena.expired());
+
+  heapObject.reset();
+  EXPECT_EQ(102, destroyed);
+}
+
+/////////////////////////////////////////////////
+TEST(ParseArena, Of)
+{
+  std::weak_ptr<sdf::ParseArena> weakArena;
+  {
+    sdf::SDF sdf;
+    std::shared_ptr<sdf::ParseArena> arena = sdf::ParseArena::Of(sdf);
+    ASSERT_NE(nullptr, arena);
+    EXPECT_EQ(arena, sdf::ParseArena::Of(sdf));
+    weakArena = arena;
+  }
+  EXPECT_TRUE(weakArena.expired());
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include "sdf/ParserConfig.hh"
+
+using namespace sdf;
+
+/////////////////////////////////////////////////
+/// \brief Get the directory of compiled documents from the environment.
+/// \return Value of SDF_COMPILED_CACHE_PATH, or an empty string.
+static std::string compiledCacheDirectoryFromEnv()
+{
+  const char *path = std::getenv("SDF_COMPILED_CACHE_PATH");
+  return path ? path : "";
+}
+
+// Private data class
+class sdf::ParserConfigPrivate
+{
+  /// \brief True to read the includes of an element in parallel.
+  public: bool parallelIncludes = false;
+
+  /// \brief Maximum number of threads to read includes with, or zero for
+  /// the number of hardware threads.
+  public: unsigned int includeThreadCount = 0;
+
+  /// \brief True to cache parsed included files.
+  public: bool cacheIncludes = false;
+
+  /// \brief Directory of compiled documents, or empty to not cache them.
+  public: std::string compiledCacheDirectory = compiledCacheDirectoryFromEnv();
+
+  /// \brief True to defer the construction of DOM objects.
+  public: bool lazyLoad = false;
+
+  /// \brief True to allocate the elements of a document in an arena.
+  public: bool useParseArena = false;
+};
+
+/////////////////////////////////////////////////
+ParserConfig::ParserConfig()
+  : dataPtr(new ParserConfigPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+ParserConfig::~ParserConfig()
+{
+  delete this->dataPtr;
+  this->dataPtr = nullptr;
+}
+
+//////////////////////////////////////////////////
+ParserConfig::ParserConfig(const ParserConfig &_config)
+  : dataPtr(new ParserConfigPrivate(*_config.dataPtr))
+{
+}
+
+//////////////////////////////////////////////////
+ParserConfig::ParserConfig(ParserConfig &&_config) noexcept
+  : dataPtr(std::exchange(_config.dataPtr, nullptr))
+{
+}
+
+/////////////////////////////////////////////////
+ParserConfig &ParserConfig::operator=(const ParserConfig &_config)
+{
+  return *this = ParserConfig(_config);
+}
+
+/////////////////////////////////////////////////
+ParserConfig &ParserConfig::operator=(ParserConfig &&_config)
+{
+  std::swap(this->dataPtr, _config.dataPtr);
+  return *this;
+}
+
+/////////////////////////////////////////////////
+bool ParserConfig::ParallelIncludes() const
+{
+  return this->dataPtr->parallelIncludes;
+}
+
+/////////////////////////////////////////////////
+void ParserConfig::SetParallelIncludes(const bool _parallel)
+{
+  this->dataPtr->parallelIncludes = _parallel;
+}
+
+/////////////////////////////////////////////////
+unsigned int ParserConfig::IncludeThreadCount() const
+{
+  return this->dataPtr->includeThreadCount;
+}
+
+/////////////////////////////////////////////////
+void ParserConfig::SetIncludeThreadCount(const unsigned int _count)
+{
+  this->dataPtr->includeThreadCount = _count;
+}
+
+/////////////////////////////////////////////////
+bool ParserConfig::CacheIncludes() const
+{
+  return this->dataPtr->cacheIncludes;
+}
+
+/////////////////////////////////////////////////
+void ParserConfig::SetCacheIncludes(const bool _cache)
+{
+  this->dataPtr->cacheIncludes = _cache;
+}
+
+/////////////////////////////////////////////////
+const std::string &ParserConfig::CompiledCacheDirectory() const
+{
+  return this->dataPtr->compiledCacheDirectory;
+}
+
+/////////////////////////////////////////////////
+void ParserConfig::SetCompiledCacheDirectory(const std::string &_path)
+{
+  this->dataPtr->compiledCacheDirectory = _path;
+}
+
+/////////////////////////////////////////////////
+bool ParserConfig::LazyLoad() const
+{
+  return this->dataPtr->lazyLoad;
+}
+
+/////////////////////////////////////////////////
+void ParserConfig::SetLazyLoad(const bool _lazy)
+{
+  this->dataPtr->lazyLoad = _lazy;
+}
+
+/////////////////////////////////////////////////
+bool ParserConfig::UseParseArena() const
+{
+  return this->dataPtr->useParseArena;
+}
+
+/////////////////////////////////////////////////
+void ParserConfig::SetUseParseArena(const bool _use)
+{
+  this->dataPtr->useParseArena = _use;
+}
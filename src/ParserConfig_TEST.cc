@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include "sdf/ParserConfig.hh"
+
+/////////////////////////////////////////////////
+TEST(ParserConfig, Construction)
+{
+  sdf::ParserConfig config;
+  EXPECT_FALSE(config.ParallelIncludes());
+  EXPECT_EQ(0u, config.IncludeThreadCount());
+  EXPECT_FALSE(config.CacheIncludes());
+
+  config.SetParallelIncludes(true);
+  EXPECT_TRUE(config.ParallelIncludes());
+
+  config.SetIncludeThreadCount(4);
+  EXPECT_EQ(4u, config.IncludeThreadCount());
+
+  config.SetCacheIncludes(true);
+  EXPECT_TRUE(config.CacheIncludes());
+
+  config.SetCompiledCacheDirectory("/tmp/sdf_cache");
+  EXPECT_EQ("/tmp/sdf_cache", config.CompiledCacheDirectory());
+
+  EXPECT_FALSE(config.LazyLoad());
+  config.SetLazyLoad(true);
+  EXPECT_TRUE(config.LazyLoad());
+
+  EXPECT_FALSE(config.UseParseArena());
+  config.SetUseParseArena(true);
+  EXPECT_TRUE(config.UseParseArena());
+}
+
+#ifndef _WIN32
+/////////////////////////////////////////////////
+TEST(ParserConfig, CompiledCacheDirectoryFromEnv)
+{
+  ASSERT_EQ(0, unsetenv("SDF_COMPILED_CACHE_PATH"));
+  EXPECT_TRUE(sdf::ParserConfig().CompiledCacheDirectory().empty());
+
+  ASSERT_EQ(0, setenv("SDF_COMPILED_CACHE_PATH", "/tmp/sdf_cache", 1));
+  EXPECT_EQ("/tmp/sdf_cache", sdf::ParserConfig().CompiledCacheDirectory());
+  ASSERT_EQ(0, unsetenv("SDF_COMPILED_CACHE_PATH"));
+}
+#endif  // _WIN32
+
+/////////////////////////////////////////////////
+TEST(ParserConfig, CopyConstructor)
+{
+  sdf::ParserConfig config;
+  config.SetParallelIncludes(true);
+  config.SetIncludeThreadCount(2);
+  config.SetCacheIncludes(true);
+
+  sdf::ParserConfig config2(config);
+  EXPECT_TRUE(config2.ParallelIncludes());
+  EXPECT_EQ(2u, config2.IncludeThreadCount());
+  EXPECT_TRUE(config2.CacheIncludes());
+
+  // The copy is independent of the original.
+  config2.SetParallelIncludes(false);
+  EXPECT_TRUE(config.ParallelIncludes());
+}
+
+/////////////////////////////////////////////////
+TEST(ParserConfig, CopyAssignmentOperator)
+{
+  sdf::ParserConfig config;
+  config.SetParallelIncludes(true);
+  config.SetIncludeThreadCount(3);
+
+  sdf::ParserConfig config2;
+  config2 = config;
+  EXPECT_TRUE(config2.ParallelIncludes());
+  EXPECT_EQ(3u, config2.IncludeThreadCount());
+}
+
+/////////////////////////////////////////////////
+TEST(ParserConfig, MoveConstructor)
+{
+  sdf::ParserConfig config;
+  config.SetParallelIncludes(true);
+
+  sdf::ParserConfig config2(std::move(config));
+  EXPECT_TRUE(config2.ParallelIncludes());
+}
+
+/////////////////////////////////////////////////
+TEST(ParserConfig, MoveAssignmentOperator)
+{
+  sdf::ParserConfig config;
+  config.SetIncludeThreadCount(5);
+
+  sdf::ParserConfig config2;
+  config2 = std::move(config);
+  EXPECT_EQ(5u, config2.IncludeThreadCount());
+}
+
+/////////////////////////////////////////////////
+TEST(ParserConfig, CopyAssignmentAfterMove)
+{
+  sdf::ParserConfig config1;
+  config1.SetParallelIncludes(true);
+
+  sdf::ParserConfig config2;
+  config2.SetIncludeThreadCount(6);
+
+  // This is similar to what std::swap does except it uses std::move for each
+  // assignment
+  sdf::ParserConfig tmp = std::move(config1);
+  config1 = config2;
+  config2 = tmp;
+
+  EXPECT_FALSE(config1.ParallelIncludes());
+  EXPECT_EQ(6u, config1.IncludeThreadCount());
+  EXPECT_TRUE(config2.ParallelIncludes());
+  EXPECT_EQ(0u, config2.IncludeThreadCount());
+}
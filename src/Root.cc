@@ -14,7 +14,12 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include <utility>
 
@@ -26,6 +31,8 @@
 #include "sdf/World.hh"
 #include "sdf/parser.hh"
 #include "sdf/sdf_config.h"
+#include "IncrementalReader.hh"
+#include "NameIndex.hh"
 #include "Utils.hh"
 
 using namespace sdf;
@@ -48,10 +55,138 @@ class sdf::RootPrivate
   /// \brief The actors specified under the root SDF element
   public: std::vector<Actor> actors;
 
+  /// \brief Index of the worlds by name.
+  public: NameIndex worldIndex;
+
+  /// \brief Index of the models by name.
+  public: NameIndex modelIndex;
+
+  /// \brief Index of the lights by name.
+  public: NameIndex lightIndex;
+
+  /// \brief Index of the actors by name.
+  public: NameIndex actorIndex;
+
   /// \brief The SDF element pointer generated during load.
   public: sdf::ElementPtr sdf;
+
+  /// \brief Load the worlds, models, lights and actors.
+  /// \return Errors found while loading.
+  public: Errors LoadChildren();
+
+  /// \brief Load the worlds, models, lights and actors if their loading was
+  /// deferred.
+  public: void LoadDeferred();
+
+  /// \brief Options that Load was called with.
+  public: ParserConfig config;
+
+  /// \brief True while the worlds, models, lights and actors are deferred.
+  public: std::atomic<bool> deferred{false};
+
+  /// \brief Mutex that serializes LoadDeferred.
+  public: std::mutex deferredMutex;
+
+  /// \brief Errors found by LoadDeferred.
+  public: Errors deferredErrors;
+
+  /// \brief Reader of the file of Reload, created by its first call.
+  public: std::unique_ptr<IncrementalReader> reader;
 };
 
+/////////////////////////////////////////////////
+/// \brief Get the scoped names of the models of worlds.
+/// \param[in] _worlds The worlds.
+/// \return Names such as "world_name::model_name".
+static std::vector<std::string> worldModelNames(
+    const std::vector<World> &_worlds)
+{
+  std::vector<std::string> names;
+  for (const World &world : _worlds)
+  {
+    for (uint64_t i = 0; i < world.ModelCount(); ++i)
+      names.push_back(world.Name() + "::" + world.ModelByIndex(i)->Name());
+  }
+  return names;
+}
+
+/////////////////////////////////////////////////
+Errors RootPrivate::LoadChildren()
+{
+  Errors errors;
+
+  // Read all the worlds
+  if (this->sdf->HasElement("world"))
+  {
+    std::unordered_set<std::string> worldNames;
+    ElementPtr elem = this->sdf->GetElement("world");
+    while (elem)
+    {
+      World world;
+
+      Errors worldErrors = world.Load(elem, this->config);
+      // Attempt to load the world
+      if (worldErrors.empty())
+      {
+        // Check that the world's name does not exist.
+        if (!worldNames.insert(world.Name()).second)
+        {
+          errors.push_back({ErrorCode::DUPLICATE_NAME,
+                "World with name[" + world.Name() + "] already exists."
+                " Each world must have a unique name. Skipping this world."});
+        }
+        else
+        {
+          this->worlds.push_back(std::move(world));
+        }
+      }
+      else
+      {
+        std::move(worldErrors.begin(), worldErrors.end(),
+                  std::back_inserter(errors));
+        errors.push_back({ErrorCode::ELEMENT_INVALID,
+                          "Failed to load a world."});
+      }
+      elem = elem->GetNextElement("world");
+    }
+  }
+
+  // Load all the models.
+  Errors modelLoadErrors = loadUniqueRepeated<Model>(this->sdf,
+      "model", this->models);
+  errors.insert(errors.end(), modelLoadErrors.begin(), modelLoadErrors.end());
+
+  // Load all the lights.
+  Errors lightLoadErrors = loadUniqueRepeated<Light>(this->sdf,
+      "light", this->lights);
+  errors.insert(errors.end(), lightLoadErrors.begin(), lightLoadErrors.end());
+
+  // Load all the actors.
+  Errors actorLoadErrors = loadUniqueRepeated<Actor>(this->sdf,
+      "actor", this->actors);
+  errors.insert(errors.end(), actorLoadErrors.begin(), actorLoadErrors.end());
+
+  this->worldIndex.Build(this->worlds);
+  this->modelIndex.Build(this->models);
+  this->lightIndex.Build(this->lights);
+  this->actorIndex.Build(this->actors);
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+void RootPrivate::LoadDeferred()
+{
+  if (!this->deferred)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->deferredMutex);
+  if (!this->deferred)
+    return;
+  this->deferredErrors = this->LoadChildren();
+  this->deferred = false;
+}
+
 /////////////////////////////////////////////////
 Root::Root()
   : dataPtr(new RootPrivate)
@@ -67,11 +202,17 @@ Root::~Root()
 
 /////////////////////////////////////////////////
 Errors Root::Load(const std::string &_filename)
+{
+  return this->Load(_filename, ParserConfig());
+}
+
+/////////////////////////////////////////////////
+Errors Root::Load(const std::string &_filename, const ParserConfig &_config)
 {
   Errors errors;
 
   // Read an SDF file, and store the result in sdfParsed.
-  SDFPtr sdfParsed = readFile(_filename, errors);
+  SDFPtr sdfParsed = readFile(_filename, _config, errors);
 
   // Return if we were not able to read the file.
   if (!sdfParsed)
@@ -81,7 +222,7 @@ Errors Root::Load(const std::string &_filename)
     return errors;
   }
 
-  Errors loadErrors = this->Load(sdfParsed);
+  Errors loadErrors = this->Load(sdfParsed, _config);
   errors.insert(errors.end(), loadErrors.begin(), loadErrors.end());
 
   return errors;
@@ -110,6 +251,12 @@ Errors Root::LoadSdfString(const std::string &_sdf)
 
 /////////////////////////////////////////////////
 Errors Root::Load(SDFPtr _sdf)
+{
+  return this->Load(_sdf, ParserConfig());
+}
+
+/////////////////////////////////////////////////
+Errors Root::Load(SDFPtr _sdf, const ParserConfig &_config)
 {
   Errors errors;
 
@@ -141,56 +288,82 @@ Errors Root::Load(SDFPtr _sdf)
   }
 
   this->dataPtr->version = versionPair.first;
+  this->dataPtr->config = _config;
 
-  // Read all the worlds
-  if (this->dataPtr->sdf->HasElement("world"))
+  if (_config.LazyLoad())
   {
-    ElementPtr elem = this->dataPtr->sdf->GetElement("world");
-    while (elem)
-    {
-      World world;
+    this->dataPtr->deferred = true;
+    return errors;
+  }
 
-      Errors worldErrors = world.Load(elem);
-      // Attempt to load the world
-      if (worldErrors.empty())
-      {
-        // Check that the world's name does not exist.
-        if (this->WorldNameExists(world.Name()))
-        {
-          errors.push_back({ErrorCode::DUPLICATE_NAME,
-                "World with name[" + world.Name() + "] already exists."
-                " Each world must have a unique name. Skipping this world."});
-        }
-        else
-        {
-          this->dataPtr->worlds.push_back(std::move(world));
-        }
-      }
-      else
-      {
-        std::move(worldErrors.begin(), worldErrors.end(),
-                  std::back_inserter(errors));
-        errors.push_back({ErrorCode::ELEMENT_INVALID,
-                          "Failed to load a world."});
-      }
-      elem = elem->GetNextElement("world");
+  Errors childErrors = this->dataPtr->LoadChildren();
+  errors.insert(errors.end(), childErrors.begin(), childErrors.end());
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors Root::Reload(const std::string &_filename, const ParserConfig &_config,
+    std::vector<std::string> &_changed)
+{
+  Errors errors;
+
+  // The changes are found by comparing the loaded models.
+  ParserConfig config = _config;
+  config.SetLazyLoad(false);
+
+  if (!this->dataPtr->reader)
+    this->dataPtr->reader = std::make_unique<IncrementalReader>();
+  SDFPtr sdfParsed = this->dataPtr->reader->Read(_filename, config, errors);
+  if (!sdfParsed)
+  {
+    errors.push_back(
+        {ErrorCode::FILE_READ, "Unable to read file:" + _filename});
+    return errors;
+  }
+
+  // A partial read updates the document that the worlds were loaded from,
+  // unless Load was called since or a world failed to load.
+  this->dataPtr->LoadDeferred();
+  std::size_t worldElementCount = 0;
+  ElementPtr elem = sdfParsed->Root()->HasElement("world") ?
+      sdfParsed->Root()->GetElement("world") : nullptr;
+  for (; elem; elem = elem->GetNextElement("world"))
+    ++worldElementCount;
+  if (this->dataPtr->reader->Partial() &&
+      sdfParsed->Root() == this->dataPtr->sdf &&
+      this->dataPtr->worlds.size() == worldElementCount)
+  {
+    for (World &world : this->dataPtr->worlds)
+    {
+      std::vector<std::string> names;
+      Errors worldErrors = world.ReloadModels(names);
+      errors.insert(errors.end(), worldErrors.begin(), worldErrors.end());
+      for (const std::string &name : names)
+        _changed.push_back(world.Name() + "::" + name);
     }
+    return errors;
   }
 
-  // Load all the models.
-  Errors modelLoadErrors = loadUniqueRepeated<Model>(this->dataPtr->sdf,
-      "model", this->dataPtr->models);
-  errors.insert(errors.end(), modelLoadErrors.begin(), modelLoadErrors.end());
+  const std::vector<std::string> previousNames =
+      worldModelNames(this->dataPtr->worlds);
+  this->dataPtr->worlds.clear();
+  this->dataPtr->models.clear();
+  this->dataPtr->lights.clear();
+  this->dataPtr->actors.clear();
 
-  // Load all the lights.
-  Errors lightLoadErrors = loadUniqueRepeated<Light>(this->dataPtr->sdf,
-      "light", this->dataPtr->lights);
-  errors.insert(errors.end(), lightLoadErrors.begin(), lightLoadErrors.end());
+  Errors loadErrors = this->Load(sdfParsed, config);
+  errors.insert(errors.end(), loadErrors.begin(), loadErrors.end());
 
-  // Load all the actors.
-  Errors actorLoadErrors = loadUniqueRepeated<Actor>(this->dataPtr->sdf,
-      "actor", this->dataPtr->actors);
-  errors.insert(errors.end(), actorLoadErrors.begin(), actorLoadErrors.end());
+  const std::vector<std::string> names =
+      worldModelNames(this->dataPtr->worlds);
+  const std::unordered_set<std::string> current(names.begin(), names.end());
+  _changed.insert(_changed.end(), names.begin(), names.end());
+  for (const std::string &name : previousNames)
+  {
+    if (current.count(name) == 0)
+      _changed.push_back(name);
+  }
 
   return errors;
 }
@@ -210,12 +383,14 @@ void Root::SetVersion(const std::string &_version)
 /////////////////////////////////////////////////
 uint64_t Root::WorldCount() const
 {
+  this->dataPtr->LoadDeferred();
   return this->dataPtr->worlds.size();
 }
 
 /////////////////////////////////////////////////
 const World *Root::WorldByIndex(const uint64_t _index) const
 {
+  this->dataPtr->LoadDeferred();
   if (_index < this->dataPtr->worlds.size())
     return &this->dataPtr->worlds[_index];
   return nullptr;
@@ -224,25 +399,22 @@ const World *Root::WorldByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Root::WorldNameExists(const std::string &_name) const
 {
-  for (auto const &w : this->dataPtr->worlds)
-  {
-    if (w.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  this->dataPtr->LoadDeferred();
+  return this->dataPtr->worldIndex.Find(
+      this->dataPtr->worlds, _name) != nullptr;
 }
 
 /////////////////////////////////////////////////
 uint64_t Root::ModelCount() const
 {
+  this->dataPtr->LoadDeferred();
   return this->dataPtr->models.size();
 }
 
 /////////////////////////////////////////////////
 const Model *Root::ModelByIndex(const uint64_t _index) const
 {
+  this->dataPtr->LoadDeferred();
   if (_index < this->dataPtr->models.size())
     return &this->dataPtr->models[_index];
   return nullptr;
@@ -251,25 +423,22 @@ const Model *Root::ModelByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Root::ModelNameExists(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->models)
-  {
-    if (m.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  this->dataPtr->LoadDeferred();
+  return this->dataPtr->modelIndex.Find(
+      this->dataPtr->models, _name) != nullptr;
 }
 
 /////////////////////////////////////////////////
 uint64_t Root::LightCount() const
 {
+  this->dataPtr->LoadDeferred();
   return this->dataPtr->lights.size();
 }
 
 /////////////////////////////////////////////////
 const Light *Root::LightByIndex(const uint64_t _index) const
 {
+  this->dataPtr->LoadDeferred();
   if (_index < this->dataPtr->lights.size())
     return &this->dataPtr->lights[_index];
   return nullptr;
@@ -278,25 +447,22 @@ const Light *Root::LightByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Root::LightNameExists(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->lights)
-  {
-    if (m.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  this->dataPtr->LoadDeferred();
+  return this->dataPtr->lightIndex.Find(
+      this->dataPtr->lights, _name) != nullptr;
 }
 
 /////////////////////////////////////////////////
 uint64_t Root::ActorCount() const
 {
+  this->dataPtr->LoadDeferred();
   return this->dataPtr->actors.size();
 }
 
 /////////////////////////////////////////////////
 const Actor *Root::ActorByIndex(const uint64_t _index) const
 {
+  this->dataPtr->LoadDeferred();
   if (_index < this->dataPtr->actors.size())
     return &this->dataPtr->actors[_index];
   return nullptr;
@@ -305,14 +471,28 @@ const Actor *Root::ActorByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Root::ActorNameExists(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->actors)
+  this->dataPtr->LoadDeferred();
+  return this->dataPtr->actorIndex.Find(
+      this->dataPtr->actors, _name) != nullptr;
+}
+
+/////////////////////////////////////////////////
+Errors Root::LazyLoadErrors() const
+{
+  if (this->dataPtr->deferred)
+    return Errors();
+
+  Errors errors;
   {
-    if (m.Name() == _name)
-    {
-      return true;
-    }
+    std::lock_guard<std::mutex> lock(this->dataPtr->deferredMutex);
+    errors = this->dataPtr->deferredErrors;
+  }
+  for (const World &world : this->dataPtr->worlds)
+  {
+    Errors worldErrors = world.LazyLoadErrors();
+    errors.insert(errors.end(), worldErrors.begin(), worldErrors.end());
   }
-  return false;
+  return errors;
 }
 
 /////////////////////////////////////////////////
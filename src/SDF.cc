@@ -21,7 +21,10 @@
 #include <functional>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "sdf/parser.hh"
@@ -31,6 +34,7 @@
 #include "sdf/SDFImpl.hh"
 #include "SDFImplPrivate.hh"
 #include "sdf/sdf_config.h"
+#include "ElementSerializer.hh"
 #include "EmbeddedSdf.hh"
 
 namespace sdf
@@ -38,12 +42,145 @@ namespace sdf
 inline namespace SDF_VERSION_NAMESPACE
 {
 typedef std::list<std::string> PathList;
-typedef std::map<std::string, PathList> URIPathMap;
 
-static URIPathMap g_uriPathMap;
+/// \brief Node of a prefix trie of the URIs passed to addURIPath, so that
+/// findFile visits only the URIs that are a prefix of a filename.
+struct URITrieNode
+{
+  /// \brief Child nodes, by the next character of the URI.
+  std::map<char, std::unique_ptr<URITrieNode>> children;
+
+  /// \brief Paths associated with the URI that ends at this node.
+  PathList paths;
+};
+
+static URITrieNode g_uriPathTrie;
 
 static std::function<std::string(const std::string &)> g_findFileCB;
 
+/// \brief Cache of the files found by findFile. Only files that were found
+/// are cached, so a file that is created later can still be found.
+class FindFileCache
+{
+  /// \brief A cached file.
+  private: struct Entry
+  {
+    /// \brief Path of the file.
+    std::string path;
+
+    /// \brief Number of stat calls needed to find the file.
+    std::size_t stats = 0;
+  };
+
+  /// \brief Get the cache.
+  /// \return The process-wide cache.
+  public: static FindFileCache &Instance()
+  {
+    static FindFileCache cache;
+    return cache;
+  }
+
+  /// \brief Look up a file. This also clears the cache if SDF_PATH or the
+  /// current working directory changed since the last lookup.
+  /// \param[in] _key Key of the lookup.
+  /// \param[out] _path Path of the file, if it is cached.
+  /// \param[out] _sdfPaths The directories of SDF_PATH.
+  /// \return True if the file is cached.
+  public: bool Find(const std::string &_key, std::string &_path,
+      std::shared_ptr<const std::vector<std::string>> &_sdfPaths)
+  {
+#ifndef _WIN32
+    const char *pathCStr = std::getenv("SDF_PATH");
+    const std::string sdfPath = pathCStr ? pathCStr : "";
+#else
+    char *pathCStr = nullptr;
+    size_t sz = 0;
+    _dupenv_s(&pathCStr, &sz, "SDF_PATH");
+    const std::string sdfPath = pathCStr ? pathCStr : "";
+    free(pathCStr);
+#endif
+    const std::string cwd = sdf::filesystem::current_path();
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!this->sdfPaths || sdfPath != this->sdfPath || cwd != this->cwd)
+    {
+      this->entries.clear();
+      this->sdfPath = sdfPath;
+      this->cwd = cwd;
+      this->sdfPaths = std::make_shared<const std::vector<std::string>>(
+          sdfPath.empty() ? std::vector<std::string>() :
+          sdf::split(sdfPath, ":"));
+    }
+    _sdfPaths = this->sdfPaths;
+
+    auto it = this->entries.find(_key);
+    if (it == this->entries.end())
+      return false;
+
+    ++this->hits;
+    this->statsAvoided += it->second.stats;
+    _path = it->second.path;
+    return true;
+  }
+
+  /// \brief Add a file that was found.
+  /// \param[in] _key Key of the lookup.
+  /// \param[in] _path Path of the file.
+  /// \param[in] _stats Number of stat calls needed to find the file.
+  public: void Add(const std::string &_key, const std::string &_path,
+                   const std::size_t _stats)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->entries[_key] = {_path, _stats};
+  }
+
+  /// \brief Remove all files and reset the counts.
+  public: void Clear()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->entries.clear();
+    this->hits = 0;
+    this->statsAvoided = 0;
+  }
+
+  /// \brief Get the number of cache hits.
+  /// \return Number of hits.
+  public: std::size_t Hits()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->hits;
+  }
+
+  /// \brief Get the number of stat calls that cache hits avoided.
+  /// \return Number of stat calls.
+  public: std::size_t StatsAvoided()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->statsAvoided;
+  }
+
+  /// \brief Mutex that protects the members below.
+  private: std::mutex mutex;
+
+  /// \brief The cached files, by lookup key.
+  private: std::unordered_map<std::string, Entry> entries;
+
+  /// \brief Value of SDF_PATH when the cache was filled.
+  private: std::string sdfPath;
+
+  /// \brief Directories of sdfPath.
+  private: std::shared_ptr<const std::vector<std::string>> sdfPaths;
+
+  /// \brief Current working directory when the cache was filled.
+  private: std::string cwd;
+
+  /// \brief Number of cache hits.
+  private: std::size_t hits = 0;
+
+  /// \brief Number of stat calls that cache hits avoided.
+  private: std::size_t statsAvoided = 0;
+};
+
 std::string SDF::version = SDF_VERSION;
 
 /////////////////////////////////////////////////
@@ -51,42 +188,55 @@ std::string SDF::version = SDF_VERSION;
 void setFindCallback(std::function<std::string(const std::string &)> _cb)
 {
   g_findFileCB = _cb;
+  clearFindFileCache();
 }
 
 /////////////////////////////////////////////////
-std::string findFile(const std::string &_filename, bool _searchLocalPath,
-                          bool _useCallback)
+/// \brief Find a file, without using the cache.
+/// \param[in] _filename Name of the file to find.
+/// \param[in] _searchLocalPath True to search the current working directory.
+/// \param[in] _useCallback True to use the registered callback.
+/// \param[in] _sdfPaths The directories of SDF_PATH.
+/// \param[out] _stats Number of stat calls made.
+/// \return File's full path, or an empty string if it was not found.
+static std::string findFileUncached(const std::string &_filename,
+    bool _searchLocalPath, bool _useCallback,
+    const std::vector<std::string> &_sdfPaths, std::size_t &_stats)
 {
+  auto exists = [&_stats](const std::string &_path)
+  {
+    ++_stats;
+    return sdf::filesystem::exists(_path);
+  };
+
   std::string path = _filename;
 
-  // Check to see if _filename is URI. If so, resolve the URI path.
-  for (URIPathMap::iterator iter = g_uriPathMap.begin();
-       iter != g_uriPathMap.end(); ++iter)
+  // Check to see if _filename is URI. If so, resolve the URI path. Walk the
+  // trie along _filename, which visits the URIs that are a prefix of it from
+  // the shortest to the longest.
+  const URITrieNode *node = &g_uriPathTrie;
+  for (std::size_t i = 0; node; ++i)
   {
-    // Check to see if the URI in the global map is the first part of the
-    // given filename
-    // cppcheck-suppress stlIfStrFind
-    if (_filename.find(iter->first) == 0)
+    if (!node->paths.empty())
     {
-      std::string suffix = _filename;
-      size_t index = suffix.find(iter->first);
-      if (index != std::string::npos)
-      {
-        suffix.replace(index, iter->first.length(), "");
-      }
+      const std::string suffix = _filename.substr(i);
 
       // Check each path in the list.
-      for (PathList::iterator pathIter = iter->second.begin();
-           pathIter != iter->second.end(); ++pathIter)
+      for (const auto &uriPath : node->paths)
       {
         // Return the path string if the path + suffix exists.
-        std::string pathSuffix = sdf::filesystem::append(*pathIter, suffix);
-        if (sdf::filesystem::exists(pathSuffix))
+        std::string pathSuffix = sdf::filesystem::append(uriPath, suffix);
+        if (exists(pathSuffix))
         {
           return pathSuffix;
         }
       }
     }
+
+    if (i == _filename.size())
+      break;
+    auto child = node->children.find(_filename[i]);
+    node = child != node->children.end() ? child->second.get() : nullptr;
   }
 
   // Strip scheme, if any
@@ -100,7 +250,7 @@ std::string findFile(const std::string &_filename, bool _searchLocalPath,
 
   // Next check the install path.
   path = sdf::filesystem::append(SDF_SHARE_PATH, filename);
-  if (sdf::filesystem::exists(path))
+  if (exists(path))
   {
     return path;
   }
@@ -109,38 +259,25 @@ std::string findFile(const std::string &_filename, bool _searchLocalPath,
   path = sdf::filesystem::append(SDF_SHARE_PATH,
                                  "sdformat" SDF_MAJOR_VERSION_STR,
                                  sdf::SDF::Version(), filename);
-  if (sdf::filesystem::exists(path))
+  if (exists(path))
   {
     return path;
   }
 
   // Next check to see if the given file exists.
   path = filename;
-  if (sdf::filesystem::exists(path))
+  if (exists(path))
   {
     return path;
   }
 
   // Next check SDF_PATH environment variable
-#ifndef _WIN32
-  const char *pathCStr = std::getenv("SDF_PATH");
-#else
-  char *pathCStr;
-  size_t sz = 0;
-  _dupenv_s(&pathCStr, &sz, "SDF_PATH");
-#endif
-
-  if (pathCStr)
+  for (const auto &sdfPath : _sdfPaths)
   {
-    std::vector<std::string> paths = sdf::split(pathCStr, ":");
-    for (std::vector<std::string>::iterator iter = paths.begin();
-         iter != paths.end(); ++iter)
+    path = sdf::filesystem::append(sdfPath, filename);
+    if (exists(path))
     {
-      path = sdf::filesystem::append(*iter, filename);
-      if (sdf::filesystem::exists(path))
-      {
-        return path;
-      }
+      return path;
     }
   }
 
@@ -148,7 +285,7 @@ std::string findFile(const std::string &_filename, bool _searchLocalPath,
   if (_searchLocalPath)
   {
     path = sdf::filesystem::append(sdf::filesystem::current_path(), filename);
-    if (sdf::filesystem::exists(path))
+    if (exists(path))
     {
       return path;
     }
@@ -173,22 +310,79 @@ std::string findFile(const std::string &_filename, bool _searchLocalPath,
   return std::string();
 }
 
+/////////////////////////////////////////////////
+std::string findFile(const std::string &_filename, bool _searchLocalPath,
+                          bool _useCallback)
+{
+  const std::string key = std::string(_searchLocalPath ? "1" : "0") +
+      (_useCallback ? "1" : "0") + _filename;
+
+  std::string path;
+  std::shared_ptr<const std::vector<std::string>> sdfPaths;
+  if (FindFileCache::Instance().Find(key, path, sdfPaths))
+  {
+    return path;
+  }
+
+  // The file is looked up without holding the cache lock, because the
+  // callback may call findFile itself.
+  std::size_t stats = 0;
+  path = findFileUncached(_filename, _searchLocalPath, _useCallback,
+      *sdfPaths, stats);
+  if (!path.empty())
+  {
+    FindFileCache::Instance().Add(key, path, stats);
+  }
+
+  return path;
+}
+
+/////////////////////////////////////////////////
+void clearFindFileCache()
+{
+  FindFileCache::Instance().Clear();
+}
+
+/////////////////////////////////////////////////
+std::size_t findFileCacheHits()
+{
+  return FindFileCache::Instance().Hits();
+}
+
+/////////////////////////////////////////////////
+std::size_t findFileStatsAvoided()
+{
+  return FindFileCache::Instance().StatsAvoided();
+}
+
 /////////////////////////////////////////////////
 void addURIPath(const std::string &_uri, const std::string &_path)
 {
   // Split _path on colons.
   std::vector<std::string> parts = sdf::split(_path, ":");
 
-  // Add each part of the colon separated path to the global URI map.
+  // Find or add the trie node of the URI.
+  URITrieNode *node = &g_uriPathTrie;
+  for (char c : _uri)
+  {
+    std::unique_ptr<URITrieNode> &child = node->children[c];
+    if (!child)
+      child.reset(new URITrieNode);
+    node = child.get();
+  }
+
+  // Add each part of the colon separated path to the URI.
   for (std::vector<std::string>::iterator iter = parts.begin();
        iter != parts.end(); ++iter)
   {
     // Only add valid paths
     if (!(*iter).empty() && sdf::filesystem::is_directory(*iter))
     {
-      g_uriPathMap[_uri].push_back(*iter);
+      node->paths.push_back(*iter);
     }
   }
+
+  clearFindFileCache();
 }
 
 /////////////////////////////////////////////////
@@ -344,6 +538,23 @@ void SDF::Write(const std::string &_filename)
   out.close();
 }
 
+/////////////////////////////////////////////////
+bool SDF::WriteBinary(const std::string &_filename, Errors &_errors) const
+{
+  const std::string data = ElementSerializer::Serialize(*this);
+
+  std::ofstream out(_filename, std::ios::out | std::ios::binary);
+  if (out)
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+  if (!out)
+  {
+    _errors.push_back({ErrorCode::FILE_WRITE,
+        "Unable to write binary file[" + _filename + "]"});
+    return false;
+  }
+  return true;
+}
+
 /////////////////////////////////////////////////
 std::string SDF::ToString() const
 {
@@ -431,6 +642,9 @@ std::string SDF::Version()
 void SDF::Version(const std::string &_version)
 {
   version = _version;
+
+  // The versioned install path that findFile searches changed.
+  clearFindFileCache();
 }
 
 /////////////////////////////////////////////////
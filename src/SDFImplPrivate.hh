@@ -17,6 +17,7 @@
 #ifndef _SDFIMPLPRIVATE_HH_
 #define _SDFIMPLPRIVATE_HH_
 
+#include <memory>
 #include <string>
 
 #include "sdf/Types.hh"
@@ -29,6 +30,8 @@ namespace sdf
   inline namespace SDF_VERSION_NAMESPACE {
   //
 
+  class ParseArena;
+
   /// \brief Private data for base SDF class
   class SDFPrivate
   {
@@ -46,6 +49,10 @@ namespace sdf
 
     /// \brief Spec version that this was originally parsed from.
     public: std::string originalVersion;
+
+    /// \brief Arena of the elements read into this object, created by
+    /// ParseArena::Of.
+    public: std::shared_ptr<ParseArena> arena;
   };
   /// \}
 }
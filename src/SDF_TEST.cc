@@ -710,6 +710,52 @@ TEST(SDF, WriteURIPath)
   ASSERT_EQ(std::remove(tempFile.c_str()), 0);
   ASSERT_EQ(rmdir(tempDir.c_str()), 0);
 }
+
+/////////////////////////////////////////////////
+TEST(SDF, FindFileCache)
+{
+  std::string tempDir;
+  ASSERT_TRUE(create_new_temp_dir(tempDir));
+
+  auto tempFile = tempDir + "/cached.sdf";
+  sdf::SDF sdf;
+  sdf.Write(tempFile);
+
+  sdf::addURIPath("cache://", tempDir);
+  sdf::clearFindFileCache();
+  EXPECT_EQ(0u, sdf::findFileCacheHits());
+  EXPECT_EQ(0u, sdf::findFileStatsAvoided());
+
+  // The second lookup is answered from the cache.
+  EXPECT_EQ(tempFile, sdf::findFile("cache://cached.sdf"));
+  EXPECT_EQ(0u, sdf::findFileCacheHits());
+  EXPECT_EQ(tempFile, sdf::findFile("cache://cached.sdf"));
+  EXPECT_EQ(1u, sdf::findFileCacheHits());
+  EXPECT_EQ(1u, sdf::findFileStatsAvoided());
+
+  // Files that are not found are not cached.
+  EXPECT_EQ("", sdf::findFile("cache://other.sdf", false));
+  EXPECT_EQ("", sdf::findFile("cache://other.sdf", false));
+  EXPECT_EQ(1u, sdf::findFileCacheHits());
+
+  // The cache must be cleared after deleting a file that was found.
+  ASSERT_EQ(std::remove(tempFile.c_str()), 0);
+  EXPECT_EQ(tempFile, sdf::findFile("cache://cached.sdf"));
+  sdf::clearFindFileCache();
+  EXPECT_EQ(0u, sdf::findFileCacheHits());
+  EXPECT_EQ("", sdf::findFile("cache://cached.sdf", false));
+
+  // A change of SDF_PATH is detected.
+  auto pathFile = tempDir + "/in_sdf_path.sdf";
+  sdf.Write(pathFile);
+  EXPECT_EQ("", sdf::findFile("in_sdf_path.sdf", false));
+  ASSERT_EQ(0, setenv("SDF_PATH", tempDir.c_str(), 1));
+  EXPECT_EQ(pathFile, sdf::findFile("in_sdf_path.sdf", false));
+  ASSERT_EQ(0, unsetenv("SDF_PATH"));
+
+  ASSERT_EQ(std::remove(pathFile.c_str()), 0);
+  ASSERT_EQ(rmdir(tempDir.c_str()), 0);
+}
 #endif  // _WIN32
 
 /////////////////////////////////////////////////
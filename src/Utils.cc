@@ -14,7 +14,17 @@
  * limitations under the License.
  *
 */
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <random>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
 #include "Utils.hh"
 
@@ -74,5 +84,47 @@ bool loadPose(sdf::ElementPtr _sdf, ignition::math::Pose3d &_pose,
   // on the pose element value.
   return posePair.second;
 }
+
+/////////////////////////////////////////////////
+bool writeFileAtomically(const std::string &_path, std::string_view _contents)
+{
+  // Other threads and processes may write the same file, so the temporary
+  // file is named after the thread and a random number.
+  std::random_device random;
+  const std::string tempPath = _path + "." +
+      std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()))
+      + "." + std::to_string(random()) + ".tmp";
+  {
+    std::ofstream out(tempPath, std::ios::out | std::ios::binary);
+    if (out)
+    {
+      out.write(_contents.data(),
+          static_cast<std::streamsize>(_contents.size()));
+    }
+    if (!out)
+    {
+      out.close();
+      std::remove(tempPath.c_str());
+      return false;
+    }
+  }
+
+#ifndef _WIN32
+  struct stat fileStat;
+  if (::stat(_path.c_str(), &fileStat) == 0 &&
+      ::chmod(tempPath.c_str(), fileStat.st_mode & 07777) != 0)
+  {
+    std::remove(tempPath.c_str());
+    return false;
+  }
+#endif
+
+  if (std::rename(tempPath.c_str(), _path.c_str()) != 0)
+  {
+    std::remove(tempPath.c_str());
+    return false;
+  }
+  return true;
+}
 }
 }
@@ -19,6 +19,8 @@
 
 #include <algorithm>
 #include <string>
+#include <string_view>
+#include <unordered_set>
 #include <vector>
 #include "sdf/Error.hh"
 #include "sdf/Element.hh"
@@ -55,6 +57,15 @@ namespace sdf
   bool loadPose(sdf::ElementPtr _sdf, ignition::math::Pose3d &_pose,
                 std::string &_frame);
 
+  /// \brief Replace the contents of a file at once, by writing a temporary
+  /// file next to it and renaming it, so that readers never see a partial
+  /// file. The file keeps its permissions if it exists.
+  /// \param[in] _path Path of the file.
+  /// \param[in] _contents The contents.
+  /// \return False if the file could not be written.
+  bool writeFileAtomically(const std::string &_path,
+                           std::string_view _contents);
+
   /// \brief Load all objects of a specific sdf element type. No error
   /// is returned if an element is not present. This function assumes that
   /// an element has a "name" attribute that must be unique.
@@ -71,7 +82,7 @@ namespace sdf
   {
     Errors errors;
 
-    std::vector<std::string> names;
+    std::unordered_set<std::string> names;
 
     // Check that an element exists.
     if (_sdf->HasElement(_sdfName))
@@ -94,7 +105,7 @@ namespace sdf
           sdf::loadName(elem, name);
 
           // Check that the name does not exist.
-          if (std::find(names.begin(), names.end(), name) != names.end())
+          if (!names.insert(name).second)
           {
             errors.push_back({ErrorCode::DUPLICATE_NAME,
                 _sdfName + " with name[" + name + "] already exists."});
@@ -103,7 +114,6 @@ namespace sdf
           {
             // Add the object to the result if no errors have been encountered.
             _objs.push_back(std::move(obj));
-            names.push_back(name);
           }
 
           // Add the load errors to the master error list.
@@ -14,8 +14,12 @@
  * limitations under the License.
  *
 */
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 #include <ignition/math/Vector3.hh>
 
@@ -27,6 +31,7 @@
 #include "sdf/Types.hh"
 #include "sdf/World.hh"
 #include "FrameSemantics.hh"
+#include "NameIndex.hh"
 #include "Utils.hh"
 
 using namespace sdf;
@@ -81,6 +86,21 @@ class sdf::WorldPrivate
   /// \brief The physics profiles specified in this world.
   public: std::vector<Physics> physics;
 
+  /// \brief Index of the models by name.
+  public: NameIndex modelIndex;
+
+  /// \brief Index of the frames by name.
+  public: NameIndex frameIndex;
+
+  /// \brief Index of the lights by name.
+  public: NameIndex lightIndex;
+
+  /// \brief Index of the actors by name.
+  public: NameIndex actorIndex;
+
+  /// \brief Index of the physics profiles by name.
+  public: NameIndex physicsIndex;
+
   /// \brief The SDF element pointer used during load.
   public: sdf::ElementPtr sdf;
 
@@ -93,6 +113,26 @@ class sdf::WorldPrivate
 
   /// \brief Pose Relative-To Graph constructed during Load.
   public: std::shared_ptr<sdf::PoseRelativeToGraph> poseRelativeToGraph;
+
+  /// \brief True while the models, actors, lights, frames and graphs are
+  /// deferred.
+  public: std::atomic<bool> deferred{false};
+
+  /// \brief The elements of the deferred models, by position in models.
+  /// The element of a model is reset once the model is loaded, which may
+  /// happen before the rest of the world is loaded.
+  public: std::vector<sdf::ElementPtr> deferredModels;
+
+  /// \brief True while LoadDeferred runs, since building the graphs calls
+  /// the accessors of the world again.
+  public: bool loadingDeferred = false;
+
+  /// \brief Mutex that serializes LoadDeferred. It is recursive for the
+  /// accessors called while building the graphs.
+  public: std::recursive_mutex deferredMutex;
+
+  /// \brief Errors found by LoadDeferred.
+  public: Errors deferredErrors;
 };
 
 /////////////////////////////////////////////////
@@ -106,8 +146,16 @@ WorldPrivate::WorldPrivate(const WorldPrivate &_worldPrivate)
       models(_worldPrivate.models),
       name(_worldPrivate.name),
       physics(_worldPrivate.physics),
+      modelIndex(_worldPrivate.modelIndex),
+      frameIndex(_worldPrivate.frameIndex),
+      lightIndex(_worldPrivate.lightIndex),
+      actorIndex(_worldPrivate.actorIndex),
+      physicsIndex(_worldPrivate.physicsIndex),
       sdf(_worldPrivate.sdf),
-      windLinearVelocity(_worldPrivate.windLinearVelocity)
+      windLinearVelocity(_worldPrivate.windLinearVelocity),
+      deferred(_worldPrivate.deferred.load()),
+      deferredModels(_worldPrivate.deferredModels),
+      deferredErrors(_worldPrivate.deferredErrors)
 {
   if (_worldPrivate.atmosphere)
   {
@@ -187,8 +235,332 @@ World &World::operator=(World &&_world)
   return *this;
 }
 
+/////////////////////////////////////////////////
+/// \brief Load the models of a world.
+/// \param[in] _data Private data of the world.
+/// \return Errors found while loading.
+static Errors loadModels(WorldPrivate &_data)
+{
+  if (!_data.sdf->HasUniqueChildNames())
+  {
+    sdfwarn << "Non-unique names detected in XML children of world with name["
+            << _data.name << "].\n";
+  }
+
+  // Load all the models.
+  Errors errors = loadUniqueRepeated<Model>(_data.sdf, "model", _data.models);
+  _data.modelIndex.Build(_data.models);
+  return errors;
+}
+
+/////////////////////////////////////////////////
+/// \brief Find the models of a world and index them by name, without
+/// loading them, so that each one can be loaded when it is first accessed.
+/// Like loadUniqueRepeated, a model whose name is already used is skipped.
+/// \param[in] _data Private data of the world.
+/// \return Errors found while indexing.
+static Errors deferModels(WorldPrivate &_data)
+{
+  if (!_data.sdf->HasUniqueChildNames())
+  {
+    sdfwarn << "Non-unique names detected in XML children of world with name["
+            << _data.name << "].\n";
+  }
+
+  Errors errors;
+  _data.modelIndex = NameIndex();
+  _data.deferredModels.clear();
+  ElementPtr elem =
+      _data.sdf->HasElement("model") ? _data.sdf->GetElement("model") : nullptr;
+  for (; elem; elem = elem->GetNextElement("model"))
+  {
+    std::string name;
+    sdf::loadName(elem, name);
+    if (!_data.modelIndex.Insert(name, _data.deferredModels.size()))
+    {
+      errors.push_back({ErrorCode::DUPLICATE_NAME,
+          "model with name[" + name + "] already exists."});
+      continue;
+    }
+    _data.deferredModels.push_back(elem);
+  }
+
+  // The models are loaded in place, so pointers to them stay valid as the
+  // others are loaded.
+  _data.models.clear();
+  _data.models.resize(_data.deferredModels.size());
+  return errors;
+}
+
+/////////////////////////////////////////////////
+/// \brief Load a deferred model, if it is not loaded yet. The deferred
+/// mutex must be locked.
+/// \param[in] _data Private data of the world.
+/// \param[in] _index Position of the model.
+static void loadDeferredModel(WorldPrivate &_data, std::size_t _index)
+{
+  if (_index >= _data.deferredModels.size() || !_data.deferredModels[_index])
+    return;
+
+  Errors errors = _data.models[_index].Load(_data.deferredModels[_index]);
+  _data.deferredErrors.insert(_data.deferredErrors.end(),
+      errors.begin(), errors.end());
+  _data.deferredModels[_index].reset();
+}
+
+/////////////////////////////////////////////////
+/// \brief Get a model of a world, loading it first if it is deferred.
+/// \param[in] _data Private data of the world.
+/// \param[in] _index Position of the model.
+/// \return The model, or nullptr if the position is out of range.
+static const Model *deferredModel(WorldPrivate &_data, std::size_t _index)
+{
+  if (_index >= _data.models.size())
+    return nullptr;
+
+  if (_data.deferred)
+  {
+    std::lock_guard<std::recursive_mutex> lock(_data.deferredMutex);
+    loadDeferredModel(_data, _index);
+  }
+  return &_data.models[_index];
+}
+
+/////////////////////////////////////////////////
+/// \brief Load the actors, lights and frames of a world, after its models.
+/// \param[in] _data Private data of the world.
+/// \return Errors found while loading.
+static Errors loadActorsLightsFrames(WorldPrivate &_data)
+{
+  Errors errors;
+
+  // Set of implicit and explicit frame names in this model for tracking
+  // name collisions
+  std::unordered_set<std::string> frameNames;
+
+  // Models are loaded first, and loadUniqueRepeated ensures there are no
+  // duplicate names, so these names can be added to frameNames without
+  // checking uniqueness.
+  for (const auto &model : _data.models)
+  {
+    frameNames.insert(model.Name());
+  }
+
+  // Load all the actors.
+  Errors actorLoadErrors = loadUniqueRepeated<Actor>(_data.sdf, "actor",
+      _data.actors);
+  errors.insert(errors.end(), actorLoadErrors.begin(), actorLoadErrors.end());
+
+  // Load all the lights.
+  Errors lightLoadErrors = loadUniqueRepeated<Light>(_data.sdf, "light",
+      _data.lights);
+  errors.insert(errors.end(), lightLoadErrors.begin(), lightLoadErrors.end());
+
+  // Load all the frames.
+  Errors frameLoadErrors = loadUniqueRepeated<Frame>(_data.sdf, "frame",
+      _data.frames);
+  errors.insert(errors.end(), frameLoadErrors.begin(), frameLoadErrors.end());
+
+  // Check frames for name collisions and modify and warn if so.
+  for (auto &frame : _data.frames)
+  {
+    std::string frameName = frame.Name();
+    if (frameNames.count(frameName) > 0)
+    {
+      frameName += "_frame";
+      int i = 0;
+      while (frameNames.count(frameName) > 0)
+      {
+        frameName = frame.Name() + "_frame" + std::to_string(i++);
+      }
+      sdfwarn << "Frame with name [" << frame.Name() << "] "
+              << "in world with name [" << _data.name << "] "
+              << "has a name collision, changing frame name to ["
+              << frameName << "].\n";
+      frame.SetName(frameName);
+    }
+    frameNames.insert(frameName);
+  }
+
+  // Index the entities by name once the frames are renamed, and before the
+  // graphs are built, which look them up by name. The models are indexed
+  // when they are loaded.
+  _data.actorIndex.Build(_data.actors);
+  _data.lightIndex.Build(_data.lights);
+  _data.frameIndex.Build(_data.frames);
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors World::BuildGraphs() const
+{
+  Errors errors;
+
+  this->dataPtr->frameAttachedToGraph = std::make_shared<FrameAttachedToGraph>();
+  Errors frameAttachedToGraphErrors =
+  buildFrameAttachedToGraph(*this->dataPtr->frameAttachedToGraph, this);
+  errors.insert(errors.end(), frameAttachedToGraphErrors.begin(),
+                              frameAttachedToGraphErrors.end());
+  Errors validateFrameAttachedGraphErrors =
+    validateFrameAttachedToGraph(*this->dataPtr->frameAttachedToGraph);
+  errors.insert(errors.end(), validateFrameAttachedGraphErrors.begin(),
+                              validateFrameAttachedGraphErrors.end());
+  for (auto &frame : this->dataPtr->frames)
+  {
+    frame.SetFrameAttachedToGraph(this->dataPtr->frameAttachedToGraph);
+  }
+
+  this->dataPtr->poseRelativeToGraph = std::make_shared<PoseRelativeToGraph>();
+  Errors poseRelativeToGraphErrors =
+  buildPoseRelativeToGraph(*this->dataPtr->poseRelativeToGraph, this);
+  errors.insert(errors.end(), poseRelativeToGraphErrors.begin(),
+                              poseRelativeToGraphErrors.end());
+  Errors validatePoseGraphErrors =
+    validatePoseRelativeToGraph(*this->dataPtr->poseRelativeToGraph);
+  errors.insert(errors.end(), validatePoseGraphErrors.begin(),
+                              validatePoseGraphErrors.end());
+  for (auto &frame : this->dataPtr->frames)
+  {
+    frame.SetPoseRelativeToGraph(this->dataPtr->poseRelativeToGraph);
+  }
+  for (auto &model : this->dataPtr->models)
+  {
+    model.SetPoseRelativeToGraph(this->dataPtr->poseRelativeToGraph);
+  }
+  for (auto &light : this->dataPtr->lights)
+  {
+    light.SetXmlParentName("world");
+    light.SetPoseRelativeToGraph(this->dataPtr->poseRelativeToGraph);
+  }
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+void World::LoadDeferred() const
+{
+  WorldPrivate &data = *this->dataPtr;
+  if (!data.deferred)
+    return;
+
+  std::lock_guard<std::recursive_mutex> lock(data.deferredMutex);
+  if (!data.deferred || data.loadingDeferred)
+    return;
+  data.loadingDeferred = true;
+
+  // Load the models that were not accessed yet, in place, and keep the
+  // index built by deferModels, which other threads may read.
+  for (std::size_t i = 0; i < data.deferredModels.size(); ++i)
+    loadDeferredModel(data, i);
+  data.deferredModels.clear();
+
+  Errors entityErrors = loadActorsLightsFrames(data);
+  data.deferredErrors.insert(data.deferredErrors.end(),
+      entityErrors.begin(), entityErrors.end());
+  Errors graphErrors = this->BuildGraphs();
+  data.deferredErrors.insert(data.deferredErrors.end(),
+      graphErrors.begin(), graphErrors.end());
+
+  data.loadingDeferred = false;
+  data.deferred = false;
+}
+
+/////////////////////////////////////////////////
+Errors World::ReloadModels(std::vector<std::string> &_changed)
+{
+  this->LoadDeferred();
+
+  WorldPrivate &data = *this->dataPtr;
+  Errors errors;
+
+  if (!data.sdf->HasUniqueChildNames())
+  {
+    sdfwarn << "Non-unique names detected in XML children of world with name["
+            << data.name << "].\n";
+  }
+
+  // The previous models by element, to keep the ones whose element was not
+  // replaced.
+  std::vector<Model> previousModels = std::move(data.models);
+  data.models.clear();
+  std::unordered_map<const sdf::Element *, std::size_t> previous;
+  std::vector<std::string> previousNames;
+  for (std::size_t i = 0; i < previousModels.size(); ++i)
+  {
+    previous.emplace(previousModels[i].Element().get(), i);
+    previousNames.push_back(previousModels[i].Name());
+  }
+  std::vector<bool> kept(previousModels.size(), false);
+
+  // Load the models like loadUniqueRepeated.
+  std::unordered_set<std::string> names;
+  ElementPtr elem =
+      data.sdf->HasElement("model") ? data.sdf->GetElement("model") : nullptr;
+  for (; elem; elem = elem->GetNextElement("model"))
+  {
+    Model model;
+    Errors loadErrors;
+    auto it = previous.find(elem.get());
+    const bool reused = it != previous.end();
+    std::size_t index = 0;
+    if (reused)
+    {
+      index = it->second;
+      model = std::move(previousModels[index]);
+      previous.erase(it);
+    }
+    else
+    {
+      loadErrors = model.Load(elem);
+    }
+
+    std::string name;
+    sdf::loadName(elem, name);
+    if (!names.insert(name).second)
+    {
+      errors.push_back({ErrorCode::DUPLICATE_NAME,
+          "model with name[" + name + "] already exists."});
+    }
+    else
+    {
+      if (reused)
+        kept[index] = true;
+      else
+        _changed.push_back(name);
+      data.models.push_back(std::move(model));
+    }
+    errors.insert(errors.end(), loadErrors.begin(), loadErrors.end());
+  }
+
+  for (std::size_t i = 0; i < previousModels.size(); ++i)
+  {
+    if (!kept[i])
+      _changed.push_back(previousNames[i]);
+  }
+  data.modelIndex.Build(data.models);
+
+  // The actors, lights and frames may refer to any model, so they are
+  // loaded again with the graphs.
+  data.actors.clear();
+  data.lights.clear();
+  data.frames.clear();
+  Errors entityErrors = loadActorsLightsFrames(data);
+  errors.insert(errors.end(), entityErrors.begin(), entityErrors.end());
+  Errors graphErrors = this->BuildGraphs();
+  errors.insert(errors.end(), graphErrors.begin(), graphErrors.end());
+
+  return errors;
+}
+
 /////////////////////////////////////////////////
 Errors World::Load(sdf::ElementPtr _sdf)
+{
+  return this->Load(_sdf, ParserConfig());
+}
+
+/////////////////////////////////////////////////
+Errors World::Load(sdf::ElementPtr _sdf, const ParserConfig &_config)
 {
   Errors errors;
 
@@ -255,29 +627,15 @@ Errors World::Load(sdf::ElementPtr _sdf)
     _sdf->Get<ignition::math::Vector3d>("magnetic_field",
         this->dataPtr->magneticField).first;
 
-  if (!_sdf->HasUniqueChildNames())
-  {
-    sdfwarn << "Non-unique names detected in XML children of world with name["
-            << this->Name() << "].\n";
-  }
-
-  // Set of implicit and explicit frame names in this model for tracking
-  // name collisions
-  std::unordered_set<std::string> frameNames;
-
-  // Load all the models.
-  Errors modelLoadErrors = loadUniqueRepeated<Model>(_sdf, "model",
-      this->dataPtr->models);
+  // The models, actors, lights and frames and the graphs can be deferred,
+  // and are loaded in the same order either way.
+  // The models are indexed either way, which finds duplicate names, but
+  // lazily loaded models are only loaded when they are accessed.
+  const bool lazy = _config.LazyLoad();
+  Errors modelLoadErrors = lazy ? deferModels(*this->dataPtr) :
+      loadModels(*this->dataPtr);
   errors.insert(errors.end(), modelLoadErrors.begin(), modelLoadErrors.end());
 
-  // Models are loaded first, and loadUniqueRepeated ensures there are no
-  // duplicate names, so these names can be added to frameNames without
-  // checking uniqueness.
-  for (const auto &model : this->dataPtr->models)
-  {
-    frameNames.insert(model.Name());
-  }
-
   // Load all the physics.
   if (_sdf->HasElement("physics"))
   {
@@ -286,42 +644,14 @@ Errors World::Load(sdf::ElementPtr _sdf)
         this->dataPtr->physics);
     errors.insert(errors.end(), physicsLoadErrors.begin(),
         physicsLoadErrors.end());
+    this->dataPtr->physicsIndex.Build(this->dataPtr->physics);
   }
 
-  // Load all the actors.
-  Errors actorLoadErrors = loadUniqueRepeated<Actor>(_sdf, "actor",
-      this->dataPtr->actors);
-  errors.insert(errors.end(), actorLoadErrors.begin(), actorLoadErrors.end());
-
-  // Load all the lights.
-  Errors lightLoadErrors = loadUniqueRepeated<Light>(_sdf, "light",
-      this->dataPtr->lights);
-  errors.insert(errors.end(), lightLoadErrors.begin(), lightLoadErrors.end());
-
-  // Load all the frames.
-  Errors frameLoadErrors = loadUniqueRepeated<Frame>(_sdf, "frame",
-      this->dataPtr->frames);
-  errors.insert(errors.end(), frameLoadErrors.begin(), frameLoadErrors.end());
-
-  // Check frames for name collisions and modify and warn if so.
-  for (auto &frame : this->dataPtr->frames)
+  if (!lazy)
   {
-    std::string frameName = frame.Name();
-    if (frameNames.count(frameName) > 0)
-    {
-      frameName += "_frame";
-      int i = 0;
-      while (frameNames.count(frameName) > 0)
-      {
-        frameName = frame.Name() + "_frame" + std::to_string(i++);
-      }
-      sdfwarn << "Frame with name [" << frame.Name() << "] "
-              << "in world with name [" << this->Name() << "] "
-              << "has a name collision, changing frame name to ["
-              << frameName << "].\n";
-      frame.SetName(frameName);
-    }
-    frameNames.insert(frameName);
+    Errors entityLoadErrors = loadActorsLightsFrames(*this->dataPtr);
+    errors.insert(errors.end(), entityLoadErrors.begin(),
+        entityLoadErrors.end());
   }
 
   // Load the Gui
@@ -341,48 +671,26 @@ Errors World::Load(sdf::ElementPtr _sdf)
     errors.insert(errors.end(), sceneLoadErrors.begin(), sceneLoadErrors.end());
   }
 
-  // Build the graphs.
-  this->dataPtr->frameAttachedToGraph =
-      std::make_shared<FrameAttachedToGraph>();
-  Errors frameAttachedToGraphErrors =
-  buildFrameAttachedToGraph(*this->dataPtr->frameAttachedToGraph, this);
-  errors.insert(errors.end(), frameAttachedToGraphErrors.begin(),
-                              frameAttachedToGraphErrors.end());
-  Errors validateFrameAttachedGraphErrors =
-    validateFrameAttachedToGraph(*this->dataPtr->frameAttachedToGraph);
-  errors.insert(errors.end(), validateFrameAttachedGraphErrors.begin(),
-                              validateFrameAttachedGraphErrors.end());
-  for (auto &frame : this->dataPtr->frames)
+  if (lazy)
   {
-    frame.SetFrameAttachedToGraph(this->dataPtr->frameAttachedToGraph);
+    this->dataPtr->deferred = true;
+    return errors;
   }
 
-  this->dataPtr->poseRelativeToGraph = std::make_shared<PoseRelativeToGraph>();
-  Errors poseRelativeToGraphErrors =
-  buildPoseRelativeToGraph(*this->dataPtr->poseRelativeToGraph, this);
-  errors.insert(errors.end(), poseRelativeToGraphErrors.begin(),
-                              poseRelativeToGraphErrors.end());
-  Errors validatePoseGraphErrors =
-    validatePoseRelativeToGraph(*this->dataPtr->poseRelativeToGraph);
-  errors.insert(errors.end(), validatePoseGraphErrors.begin(),
-                              validatePoseGraphErrors.end());
-  for (auto &frame : this->dataPtr->frames)
-  {
-    frame.SetPoseRelativeToGraph(this->dataPtr->poseRelativeToGraph);
-  }
-  for (auto &model : this->dataPtr->models)
-  {
-    model.SetPoseRelativeToGraph(this->dataPtr->poseRelativeToGraph);
-  }
-  for (auto &light : this->dataPtr->lights)
-  {
-    light.SetXmlParentName("world");
-    light.SetPoseRelativeToGraph(this->dataPtr->poseRelativeToGraph);
-  }
+  // Build the graphs.
+  Errors graphErrors = this->BuildGraphs();
+  errors.insert(errors.end(), graphErrors.begin(), graphErrors.end());
 
   return errors;
 }
 
+/////////////////////////////////////////////////
+Errors World::LazyLoadErrors() const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->deferredMutex);
+  return this->dataPtr->deferredErrors;
+}
+
 /////////////////////////////////////////////////
 std::string World::Name() const
 {
@@ -452,35 +760,29 @@ uint64_t World::ModelCount() const
 /////////////////////////////////////////////////
 const Model *World::ModelByIndex(const uint64_t _index) const
 {
-  if (_index < this->dataPtr->models.size())
-    return &this->dataPtr->models[_index];
-  return nullptr;
+  return deferredModel(*this->dataPtr, _index);
 }
 
 /////////////////////////////////////////////////
 bool World::ModelNameExists(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->models)
+  if (this->dataPtr->deferred)
   {
-    if (m.Name() == _name)
-    {
-      return true;
-    }
+    return this->dataPtr->modelIndex.Position(_name) != NameIndex::npos;
   }
-  return false;
+  return this->dataPtr->modelIndex.Find(
+      this->dataPtr->models, _name) != nullptr;
 }
 
 /////////////////////////////////////////////////
 const Model *World::ModelByName(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->models)
+  if (this->dataPtr->deferred)
   {
-    if (m.Name() == _name)
-    {
-      return &m;
-    }
+    return deferredModel(*this->dataPtr,
+        this->dataPtr->modelIndex.Position(_name));
   }
-  return nullptr;
+  return this->dataPtr->modelIndex.Find(this->dataPtr->models, _name);
 }
 
 /////////////////////////////////////////////////
@@ -528,12 +830,14 @@ sdf::ElementPtr World::Element() const
 /////////////////////////////////////////////////
 uint64_t World::FrameCount() const
 {
+  this->LoadDeferred();
   return this->dataPtr->frames.size();
 }
 
 /////////////////////////////////////////////////
 const Frame *World::FrameByIndex(const uint64_t _index) const
 {
+  this->LoadDeferred();
   if (_index < this->dataPtr->frames.size())
     return &this->dataPtr->frames[_index];
   return nullptr;
@@ -542,38 +846,29 @@ const Frame *World::FrameByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool World::FrameNameExists(const std::string &_name) const
 {
-  for (auto const &f : this->dataPtr->frames)
-  {
-    if (f.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  this->LoadDeferred();
+  return this->dataPtr->frameIndex.Find(
+      this->dataPtr->frames, _name) != nullptr;
 }
 
 /////////////////////////////////////////////////
 const Frame *World::FrameByName(const std::string &_name) const
 {
-  for (auto const &f : this->dataPtr->frames)
-  {
-    if (f.Name() == _name)
-    {
-      return &f;
-    }
-  }
-  return nullptr;
+  this->LoadDeferred();
+  return this->dataPtr->frameIndex.Find(this->dataPtr->frames, _name);
 }
 
 /////////////////////////////////////////////////
 uint64_t World::LightCount() const
 {
+  this->LoadDeferred();
   return this->dataPtr->lights.size();
 }
 
 /////////////////////////////////////////////////
 const Light *World::LightByIndex(const uint64_t _index) const
 {
+  this->LoadDeferred();
   if (_index < this->dataPtr->lights.size())
     return &this->dataPtr->lights[_index];
   return nullptr;
@@ -582,25 +877,22 @@ const Light *World::LightByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool World::LightNameExists(const std::string &_name) const
 {
-  for (auto const &l : this->dataPtr->lights)
-  {
-    if (l.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  this->LoadDeferred();
+  return this->dataPtr->lightIndex.Find(
+      this->dataPtr->lights, _name) != nullptr;
 }
 
 /////////////////////////////////////////////////
 uint64_t World::ActorCount() const
 {
+  this->LoadDeferred();
   return this->dataPtr->actors.size();
 }
 
 /////////////////////////////////////////////////
 const Actor *World::ActorByIndex(const uint64_t _index) const
 {
+  this->LoadDeferred();
   if (_index < this->dataPtr->actors.size())
     return &this->dataPtr->actors[_index];
   return nullptr;
@@ -609,14 +901,9 @@ const Actor *World::ActorByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool World::ActorNameExists(const std::string &_name) const
 {
-  for (auto const &a : this->dataPtr->actors)
-  {
-    if (a.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  this->LoadDeferred();
+  return this->dataPtr->actorIndex.Find(
+      this->dataPtr->actors, _name) != nullptr;
 }
 
 //////////////////////////////////////////////////
@@ -653,13 +940,6 @@ const Physics *World::PhysicsDefault() const
 //////////////////////////////////////////////////
 bool World::PhysicsNameExists(const std::string &_name) const
 {
-  for (const Physics &physics : this->dataPtr->physics)
-  {
-    if (physics.Name() == _name)
-    {
-      return true;
-    }
-  }
-
-  return false;
+  return this->dataPtr->physicsIndex.Find(
+      this->dataPtr->physics, _name) != nullptr;
 }
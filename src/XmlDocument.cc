@@ -0,0 +1,1004 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include "XmlDocument.hh"
+
+namespace sdf
+{
+inline namespace SDF_VERSION_NAMESPACE {
+
+/// \brief Size of the first block of the arena of a document.
+static const std::size_t kFirstBlockSize = 16 * 1024;
+
+/// \brief Alignment of allocations from the arena.
+static const std::size_t kAlignment = alignof(std::max_align_t);
+
+/////////////////////////////////////////////////
+/// \brief Check for white space, like TiXmlBase::IsWhiteSpace.
+/// \param[in] _c The character.
+/// \return True if _c is white space.
+static bool isWhiteSpace(const char _c)
+{
+  return _c == ' ' || _c == '\t' || _c == '\n' || _c == '\v' ||
+      _c == '\f' || _c == '\r';
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether a character can start a name, like TinyXML, which
+/// accepts letters, underscores and all non-ASCII bytes.
+/// \param[in] _c The character.
+/// \return True if _c can start a name.
+static bool isNameStart(const char _c)
+{
+  const unsigned char c = static_cast<unsigned char>(_c);
+  return c >= 127 || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+      c == '_';
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether a character can be part of a name.
+/// \param[in] _c The character.
+/// \return True if _c can be part of a name.
+static bool isNameChar(const char _c)
+{
+  return isNameStart(_c) || (_c >= '0' && _c <= '9') || _c == '-' ||
+      _c == '.' || _c == ':';
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether a string starts with another one, comparing ASCII
+/// letters case-insensitively.
+/// \param[in] _str The string.
+/// \param[in] _prefix The prefix, in lower case.
+/// \return True if _str starts with _prefix.
+static bool startsWithIgnoreCase(std::string_view _str,
+                                 std::string_view _prefix)
+{
+  if (_str.size() < _prefix.size())
+    return false;
+
+  for (std::size_t i = 0; i < _prefix.size(); ++i)
+  {
+    char c = _str[i];
+    if (c >= 'A' && c <= 'Z')
+      c = static_cast<char>(c - 'A' + 'a');
+    if (c != _prefix[i])
+      return false;
+  }
+  return true;
+}
+
+
+/////////////////////////////////////////////////
+/// \brief Parser that builds the nodes of an XmlDocument. It follows the
+/// grammar, the encoding detection and the error reporting of TinyXML's
+/// parser, so that documents have the same elements, attributes and text as
+/// with TinyXML.
+///
+/// With a handler, elements are streamed: they are passed to the handler
+/// and released after their end tag, unless the handler keeps them.
+class XmlParser
+{
+  /// \brief Constructor.
+  /// \param[in] _doc Document to add nodes to.
+  /// \param[in] _text Text to parse.
+  /// \param[in] _handler Handler to stream the elements to, or nullptr.
+  public: XmlParser(XmlDocument &_doc, std::string_view _text,
+                    XmlHandler *_handler)
+    : doc(_doc), p(_text.data()), end(_text.data() + _text.size()),
+      handler(_handler)
+  {
+    // Like TinyXML, stop at an embedded null character.
+    const char *null =
+        static_cast<const char *>(std::memchr(this->p, '\0', _text.size()));
+    if (null)
+      this->end = null;
+
+    // A byte order mark sets the encoding to UTF-8.
+    if (this->StartsWith("\xEF\xBB\xBF"))
+    {
+      this->utf8 = true;
+      this->encodingKnown = true;
+    }
+  }
+
+  /// \brief Parse the document.
+  /// \return True if successful.
+  public: bool ParseDocument()
+  {
+    this->SkipWhiteSpace();
+    if (this->AtEnd())
+      return this->SetError("Error document empty.");
+
+    bool empty = true;
+    XmlElement *last = nullptr;
+    while (!this->AtEnd() && *this->p == '<')
+    {
+      empty = false;
+      XmlElement *element = nullptr;
+      bool parsed = this->ParseNode(element, nullptr, nullptr, true,
+                                    this->handler != nullptr);
+
+      if (element)
+      {
+        if (last)
+          last->nextSibling = element;
+        else
+          this->doc.root->firstChild = element;
+        last = element;
+      }
+
+      // Like TinyXML, stop without an error if a node other than an
+      // element is malformed.
+      if (!parsed)
+        return !this->doc.Error();
+
+      this->SkipWhiteSpace();
+    }
+
+    // Like TinyXML, ignore anything after the last node, but require one.
+    if (empty)
+      return this->SetError("Error document empty.");
+
+    return true;
+  }
+
+  /// \brief Parse a node that starts with '<'.
+  /// \param[out] _element The node if it is an element, otherwise nullptr.
+  /// \param[out] _text Set to the text if the node is CDATA.
+  /// \param[out] _isText Set to true if the node is CDATA.
+  /// \param[in] _topLevel True if the node is not in an element, so that
+  /// a declaration sets the encoding.
+  /// \param[in] _stream True to stream the node if it is an element.
+  /// \return True if successful. Malformed nodes other than elements don't
+  /// set an error.
+  private: bool ParseNode(XmlElement *&_element, std::string_view *_text,
+                          bool *_isText, const bool _topLevel,
+                          const bool _stream)
+  {
+    _element = nullptr;
+    if (this->StartsWith("<?xml", true))
+    {
+      return this->ParseDeclaration(_topLevel);
+    }
+    else if (this->StartsWith("<!--"))
+    {
+      this->SkipPast("-->", 4);
+    }
+    else if (this->StartsWith("<![CDATA["))
+    {
+      this->p += 9;
+      const char *start = this->p;
+      if (!this->SkipPast("]]>", 0) || this->AtEnd())
+        return false;
+      if (_text)
+      {
+        *_text = std::string_view(start, this->p - 3 - start);
+        *_isText = true;
+      }
+    }
+    else if (!this->AtElement())
+    {
+      // Unknown node, such as a DOCTYPE or a processing instruction.
+      this->SkipPast(">", 1);
+    }
+    else
+    {
+      return this->ParseElement(_element, _stream);
+    }
+    return true;
+  }
+
+  /// \brief Parse an XML declaration.
+  /// \param[in] _topLevel True to set the encoding from the declaration.
+  /// \return True if successful.
+  private: bool ParseDeclaration(const bool _topLevel)
+  {
+    this->p += 5;
+
+    std::string_view encodingValue;
+    const bool parsed = this->ParseDeclarationAttributes(encodingValue);
+
+    // Like TinyXML, only the first declaration sets the encoding, which is
+    // UTF-8 unless the declaration names another one.
+    if (_topLevel && !this->encodingKnown)
+    {
+      this->utf8 = encodingValue.empty() ||
+          startsWithIgnoreCase(encodingValue, "utf-8") ||
+          startsWithIgnoreCase(encodingValue, "utf8");
+      this->encodingKnown = true;
+    }
+    return parsed;
+  }
+
+  /// \brief Parse the attributes of an XML declaration, up to its '>'.
+  /// \param[out] _encoding The value of the encoding attribute, if any.
+  /// \return True if successful.
+  private: bool ParseDeclarationAttributes(std::string_view &_encoding)
+  {
+    while (!this->AtEnd())
+    {
+      if (*this->p == '>')
+      {
+        ++this->p;
+        return true;
+      }
+
+      this->SkipWhiteSpace();
+      if (this->AtEnd())
+        return false;
+
+      const bool encoding = this->StartsWith("encoding", true);
+      if (encoding || this->StartsWith("version", true) ||
+          this->StartsWith("standalone", true))
+      {
+        XmlAttribute attribute;
+        if (!this->ParseAttribute(attribute, false))
+          return false;
+
+        if (encoding)
+          _encoding = attribute.Value();
+      }
+      else
+      {
+        while (!this->AtEnd() && *this->p != '>' && !isWhiteSpace(*this->p))
+          ++this->p;
+      }
+    }
+
+    return false;
+  }
+
+  /// \brief Parse an element.
+  /// \param[out] _element The element, or nullptr if it was streamed and
+  /// released.
+  /// \param[in] _stream True to stream the element.
+  /// \return True if successful.
+  private: bool ParseElement(XmlElement *&_element, const bool _stream)
+  {
+    ++this->p;
+    this->SkipWhiteSpace();
+
+    const XmlDocument::ArenaMark mark = this->doc.Mark();
+    XmlElement *element = this->doc.Allocate<XmlElement>();
+    if (!this->ReadName(element->name) || this->AtEnd())
+      return this->SetError("Failed to read Element name");
+    _element = element;
+
+    XmlAttribute *lastAttribute = nullptr;
+    while (true)
+    {
+      this->SkipWhiteSpace();
+      if (this->AtEnd())
+        return this->SetError("Error reading Attributes.");
+
+      if (*this->p == '/')
+      {
+        ++this->p;
+        if (this->AtEnd() || *this->p != '>')
+          return this->SetError("Error: empty tag.");
+        ++this->p;
+        if (_stream)
+        {
+          this->StartElement(element);
+          this->EndElement(_element, mark);
+        }
+        return true;
+      }
+      else if (*this->p == '>')
+      {
+        ++this->p;
+        if (!this->ReadValue(element, _stream))
+          return false;
+
+        // Read the end tag, which may have white space before the '>'.
+        if (!this->StartsWith("</") ||
+            std::string_view(this->p + 2, this->end - this->p - 2)
+            .substr(0, element->name.size()) != element->name)
+        {
+          return this->SetError("Error reading end tag.");
+        }
+        this->p += 2 + element->name.size();
+        this->SkipWhiteSpace();
+        if (this->AtEnd() || *this->p != '>')
+          return this->SetError("Error reading end tag.");
+        ++this->p;
+        if (_stream)
+          this->EndElement(_element, mark);
+        return true;
+      }
+
+      XmlAttribute *attribute = this->doc.Allocate<XmlAttribute>();
+      if (!this->ParseAttribute(*attribute, true) || this->AtEnd())
+        return this->SetError("Error parsing Element.");
+
+      // Like TinyXML, reject duplicate attributes.
+      if (element->Attribute(attribute->name))
+        return this->SetError("Error parsing Element.");
+
+      if (lastAttribute)
+        lastAttribute->next = attribute;
+      else
+        element->firstAttribute = attribute;
+      lastAttribute = attribute;
+    }
+  }
+
+  /// \brief Parse an attribute.
+  /// \param[out] _attribute The attribute.
+  /// \param[in] _report True to set an error if the name, the '=' or the
+  /// value are missing.
+  /// \return True if successful.
+  private: bool ParseAttribute(XmlAttribute &_attribute, const bool _report)
+  {
+    if (!this->ReadName(_attribute.name) || this->AtEnd())
+      return _report && this->SetError("Error reading Attributes.");
+
+    this->SkipWhiteSpace();
+    if (this->AtEnd() || *this->p != '=')
+      return _report && this->SetError("Error reading Attributes.");
+    ++this->p;
+
+    this->SkipWhiteSpace();
+    if (this->AtEnd())
+      return _report && this->SetError("Error reading Attributes.");
+
+    const char quote = *this->p;
+    if (quote == '\'' || quote == '"')
+    {
+      ++this->p;
+      const char *start = this->p;
+      const char *stop = static_cast<const char *>(
+          std::memchr(start, quote, this->end - start));
+      if (!stop || stop + 1 == this->end)
+        return false;
+
+      if (!this->Decode(start, stop, false, _attribute.value))
+        return false;
+      this->p = stop + 1;
+    }
+    else
+    {
+      // Like TinyXML, accept a value without quotes.
+      const char *start = this->p;
+      while (!this->AtEnd() && !isWhiteSpace(*this->p) &&
+             *this->p != '/' && *this->p != '>')
+      {
+        if (*this->p == '\'' || *this->p == '"')
+          return _report && this->SetError("Error reading Attributes.");
+        ++this->p;
+      }
+      _attribute.value = std::string_view(start, this->p - start);
+    }
+
+    return true;
+  }
+
+  /// \brief Read the child nodes of an element, up to its end tag.
+  /// \param[in] _element The element.
+  /// \param[in] _stream True if the element is streamed, so that it is
+  /// passed to the handler once its first child node is known.
+  /// \return True if successful.
+  private: bool ReadValue(XmlElement *_element, const bool _stream)
+  {
+    bool firstNode = true;
+    XmlElement *lastChild = nullptr;
+
+    bool started = !_stream;
+    bool streamChildren = false;
+    auto start = [&]()
+    {
+      if (!started)
+      {
+        started = true;
+        streamChildren = this->StartElement(_element);
+      }
+    };
+
+    // Like TinyXML, report a missing end tag differently depending on
+    // whether the text ends with white space.
+    const char *beforeWhiteSpace = this->p;
+    this->SkipWhiteSpace();
+    while (!this->AtEnd())
+    {
+      std::string_view text;
+      bool isText = false;
+      XmlElement *child = nullptr;
+
+      if (*this->p != '<')
+      {
+        bool blank;
+        if (!this->ReadText(text, blank))
+          return this->SetError("Error reading Element value.");
+
+        // Like TinyXML, drop text that is only white space.
+        if (blank)
+        {
+          beforeWhiteSpace = this->p;
+          this->SkipWhiteSpace();
+          continue;
+        }
+        isText = true;
+      }
+      else if (this->StartsWith("</"))
+      {
+        start();
+        return true;
+      }
+      else
+      {
+        // The handler needs the element before its child elements.
+        if (this->AtElement())
+          start();
+
+        const bool parsed = this->ParseNode(child, &text, &isText, false,
+                                            streamChildren);
+        if (child)
+        {
+          if (lastChild)
+            lastChild->nextSibling = child;
+          else
+            _element->firstChild = child;
+          lastChild = child;
+        }
+        if (!parsed)
+          return this->SetError("Error reading Element value.");
+      }
+
+      // Only text that is the first child node is kept, as returned by
+      // TiXmlElement::GetText().
+      if (firstNode && isText)
+      {
+        _element->text = text;
+        _element->hasText = true;
+      }
+      firstNode = false;
+      start();
+
+      beforeWhiteSpace = this->p;
+      this->SkipWhiteSpace();
+    }
+
+    // The end tag is missing.
+    if (beforeWhiteSpace != this->p)
+      return this->SetError("Error reading end tag.");
+    return this->SetError("Error reading Element value.");
+  }
+
+  /// \brief Pass the start of a streamed element to the handler.
+  /// \param[in] _element The element.
+  /// \return True if the child elements are streamed too, false if they
+  /// are built as a tree for the handler.
+  private: bool StartElement(XmlElement *_element)
+  {
+    // Once the handler stopped, elements are still streamed, so that they
+    // are released.
+    if (!this->handler || this->stopped)
+      return true;
+
+    switch (this->handler->StartElement(*_element))
+    {
+      case XmlHandler::Action::KEEP:
+        return false;
+      case XmlHandler::Action::STOP:
+        this->stopped = true;
+        return true;
+      default:
+        return true;
+    }
+  }
+
+  /// \brief Pass the end of a streamed element to the handler, and release
+  /// the element unless the handler keeps it.
+  /// \param[out] _element Set to nullptr, streamed elements are not added
+  /// to their parent.
+  /// \param[in] _mark Position of the arena before the element.
+  private: void EndElement(XmlElement *&_element,
+                           const XmlDocument::ArenaMark &_mark)
+  {
+    XmlHandler::Action action = XmlHandler::Action::STREAM;
+    if (this->handler && !this->stopped)
+      action = this->handler->EndElement(*_element);
+
+    if (action == XmlHandler::Action::STOP)
+      this->stopped = true;
+    if (action != XmlHandler::Action::KEEP)
+      this->doc.Release(_mark);
+    _element = nullptr;
+  }
+
+  /// \brief Read text up to the next '<', condensing white space.
+  /// \param[out] _text The text.
+  /// \param[out] _blank Set to true if the text is only white space.
+  /// \return True if successful.
+  private: bool ReadText(std::string_view &_text, bool &_blank)
+  {
+    const char *start = this->p;
+    const char *stop = static_cast<const char *>(
+        std::memchr(start, '<', this->end - start));
+    if (!stop || stop + 1 == this->end)
+      return false;
+
+    this->p = stop;
+    return this->Decode(start, stop, true, _text, &_blank);
+  }
+
+  /// \brief Decode text, which is a view of the parsed text unless it has
+  /// entities or white space that must be condensed.
+  /// \param[in] _start Start of the text.
+  /// \param[in] _stop End of the text.
+  /// \param[in] _condense True to condense white space.
+  /// \param[out] _text The decoded text.
+  /// \param[out] _blank If not null, set to true if the decoded text is
+  /// only white space.
+  /// \return False if a character reference is malformed.
+  private: bool Decode(const char *_start, const char *_stop,
+                       const bool _condense, std::string_view &_text,
+                       bool *_blank = nullptr)
+  {
+    bool copy = false;
+    for (const char *c = _start; c < _stop && !copy; ++c)
+    {
+      if (*c == '&')
+      {
+        copy = true;
+      }
+      else if (_condense && isWhiteSpace(*c))
+      {
+        // A single space between other characters is kept as is.
+        copy = *c != ' ' || c == _start || c + 1 == _stop ||
+            isWhiteSpace(c[1]);
+      }
+    }
+
+    if (!copy)
+    {
+      _text = std::string_view(_start, _stop - _start);
+      if (_blank)
+        *_blank = std::all_of(_text.begin(), _text.end(), isWhiteSpace);
+      return true;
+    }
+
+    this->buffer.clear();
+    bool whiteSpace = false;
+    for (const char *c = _start; c < _stop;)
+    {
+      if (_condense && isWhiteSpace(*c))
+      {
+        whiteSpace = true;
+        ++c;
+        continue;
+      }
+
+      if (whiteSpace)
+      {
+        this->buffer.push_back(' ');
+        whiteSpace = false;
+      }
+
+      if (*c == '&')
+      {
+        if (!this->DecodeEntity(c, _stop))
+          return false;
+      }
+      else
+      {
+        this->buffer.push_back(*c);
+        ++c;
+      }
+    }
+
+    if (_blank)
+    {
+      *_blank = std::all_of(this->buffer.begin(), this->buffer.end(),
+                            isWhiteSpace);
+    }
+
+    // TinyXML returns values as C strings, which end at a decoded "&#0;".
+    this->buffer.resize(std::strlen(this->buffer.c_str()));
+
+    char *data = static_cast<char *>(this->doc.Allocate(this->buffer.size()));
+    std::memcpy(data, this->buffer.data(), this->buffer.size());
+    _text = std::string_view(data, this->buffer.size());
+    return true;
+  }
+
+  /// \brief Decode an entity and append it to the buffer. Like TinyXML,
+  /// the '&' of an unknown entity is dropped.
+  /// \param[in, out] _c Start of the entity, moved past it.
+  /// \param[in] _stop End of the text.
+  /// \return False if a character reference is malformed.
+  private: bool DecodeEntity(const char *&_c, const char *_stop)
+  {
+    static const struct
+    {
+      const char *str;
+      std::size_t length;
+      char chr;
+    } entities[] =
+    {
+      {"&amp;", 5, '&'},
+      {"&lt;", 4, '<'},
+      {"&gt;", 4, '>'},
+      {"&quot;", 6, '"'},
+      {"&apos;", 6, '\''}
+    };
+
+    if (this->end - _c > 2 && _c[1] == '#')
+    {
+      // Like TinyXML, read the digits backwards from the ';' to the '#' or
+      // the 'x' of a hexadecimal reference.
+      const char marker = _c[2] == 'x' ? 'x' : '#';
+      const unsigned long base = marker == 'x' ? 16 : 10;
+      const char *digits = _c + (marker == 'x' ? 3 : 2);
+      const char *semicolon = static_cast<const char *>(
+          std::memchr(digits, ';', std::max(_stop - digits, ptrdiff_t(0))));
+      if (!semicolon)
+        return false;
+
+      unsigned long ucs = 0;
+      unsigned long mult = 1;
+      for (const char *d = semicolon - 1; *d != marker; --d)
+      {
+        unsigned long value;
+        if (*d >= '0' && *d <= '9')
+          value = *d - '0';
+        else if (base == 16 && *d >= 'a' && *d <= 'f')
+          value = *d - 'a' + 10;
+        else if (base == 16 && *d >= 'A' && *d <= 'F')
+          value = *d - 'A' + 10;
+        else
+          return false;
+        ucs += mult * value;
+        mult *= base;
+      }
+
+      if (this->utf8)
+        this->AppendUtf8(ucs);
+      else
+        this->buffer.push_back(static_cast<char>(ucs));
+      _c = semicolon + 1;
+      return true;
+    }
+
+    const std::size_t left = this->end - _c;
+    for (const auto &entity : entities)
+    {
+      if (left >= entity.length &&
+          std::strncmp(_c, entity.str, entity.length) == 0)
+      {
+        this->buffer.push_back(entity.chr);
+        _c += entity.length;
+        return true;
+      }
+    }
+
+    ++_c;
+    return true;
+  }
+
+  /// \brief Append a character to the buffer as UTF-8. Like TinyXML,
+  /// characters above 0x1FFFFF are dropped.
+  /// \param[in] _ucs The character.
+  private: void AppendUtf8(unsigned long _ucs)
+  {
+    if (_ucs < 0x80)
+    {
+      this->buffer.push_back(static_cast<char>(_ucs));
+    }
+    else if (_ucs < 0x800)
+    {
+      this->buffer.push_back(static_cast<char>(0xC0 | (_ucs >> 6)));
+      this->buffer.push_back(static_cast<char>(0x80 | (_ucs & 0x3F)));
+    }
+    else if (_ucs < 0x10000)
+    {
+      this->buffer.push_back(static_cast<char>(0xE0 | (_ucs >> 12)));
+      this->buffer.push_back(static_cast<char>(0x80 | ((_ucs >> 6) & 0x3F)));
+      this->buffer.push_back(static_cast<char>(0x80 | (_ucs & 0x3F)));
+    }
+    else if (_ucs < 0x200000)
+    {
+      this->buffer.push_back(static_cast<char>(0xF0 | (_ucs >> 18)));
+      this->buffer.push_back(static_cast<char>(0x80 | ((_ucs >> 12) & 0x3F)));
+      this->buffer.push_back(static_cast<char>(0x80 | ((_ucs >> 6) & 0x3F)));
+      this->buffer.push_back(static_cast<char>(0x80 | (_ucs & 0x3F)));
+    }
+  }
+
+  /// \brief Read a name.
+  /// \param[out] _name The name.
+  /// \return False if there is no name at the current position.
+  private: bool ReadName(std::string_view &_name)
+  {
+    if (this->AtEnd() || !isNameStart(*this->p))
+      return false;
+
+    const char *start = this->p;
+    while (!this->AtEnd() && isNameChar(*this->p))
+      ++this->p;
+    _name = std::string_view(start, this->p - start);
+    return true;
+  }
+
+  /// \brief Move past the next occurrence of a string.
+  /// \param[in] _str The string.
+  /// \param[in] _skip Number of characters to skip before searching.
+  /// \return True if the string was found, otherwise the position is
+  /// moved to the end.
+  private: bool SkipPast(std::string_view _str, std::size_t _skip)
+  {
+    std::string_view rest(this->p, this->end - this->p);
+    std::size_t pos = rest.find(_str, std::min(_skip, rest.size()));
+    if (pos == std::string_view::npos)
+    {
+      this->p = this->end;
+      return false;
+    }
+    this->p += pos + _str.size();
+    return true;
+  }
+
+  /// \brief Skip white space, and the byte order marks that TinyXML skips
+  /// in UTF-8 documents.
+  private: void SkipWhiteSpace()
+  {
+    while (!this->AtEnd())
+    {
+      if (isWhiteSpace(*this->p))
+      {
+        ++this->p;
+      }
+      else if (this->utf8 &&
+               (this->StartsWith("\xEF\xBB\xBF") ||
+                this->StartsWith("\xEF\xBF\xBE") ||
+                this->StartsWith("\xEF\xBF\xBF")))
+      {
+        this->p += 3;
+      }
+      else
+      {
+        break;
+      }
+    }
+  }
+
+  /// \brief Check whether the current position starts with a string.
+  /// \param[in] _str The string.
+  /// \param[in] _ignoreCase True to compare ASCII letters case-insensitively.
+  /// \return True if it does.
+  private: bool StartsWith(std::string_view _str,
+                           const bool _ignoreCase = false) const
+  {
+    std::string_view rest(this->p, this->end - this->p);
+    return _ignoreCase ? startsWithIgnoreCase(rest, _str) :
+        rest.substr(0, _str.size()) == _str;
+  }
+
+  /// \brief Check whether the current position, which is a '<', starts an
+  /// element.
+  /// \return True if it does.
+  private: bool AtElement() const
+  {
+    return isNameStart(this->Peek(1));
+  }
+
+  /// \brief Get a character after the current position.
+  /// \param[in] _offset Offset from the current position.
+  /// \return The character, or '\0' past the end.
+  private: char Peek(const std::size_t _offset) const
+  {
+    return static_cast<std::size_t>(this->end - this->p) > _offset ?
+        this->p[_offset] : '\0';
+  }
+
+  /// \brief Check whether the whole text was read.
+  /// \return True at the end of the text.
+  private: bool AtEnd() const
+  {
+    return this->p >= this->end;
+  }
+
+  /// \brief Set the error of the document. Like TinyXML, only the first
+  /// error is kept.
+  /// \param[in] _desc Description of the error.
+  /// \return Always false.
+  private: bool SetError(const char *_desc)
+  {
+    if (this->doc.errorDesc.empty())
+      this->doc.errorDesc = _desc;
+    return false;
+  }
+
+  /// \brief The document.
+  private: XmlDocument &doc;
+
+  /// \brief Current position.
+  private: const char *p;
+
+  /// \brief End of the text.
+  private: const char *end;
+
+  /// \brief True if the document is known to be UTF-8, which changes how
+  /// character references are decoded.
+  private: bool utf8 = false;
+
+  /// \brief True once a byte order mark or a declaration set the encoding.
+  private: bool encodingKnown = false;
+
+  /// \brief Buffer to decode text that can't be a view of the parsed text.
+  private: std::string buffer;
+
+  /// \brief Handler to stream the elements to, or nullptr.
+  private: XmlHandler *handler;
+
+  /// \brief True once the handler stopped.
+  private: bool stopped = false;
+};
+
+/////////////////////////////////////////////////
+const XmlAttribute *XmlElement::Attribute(std::string_view _name) const
+{
+  for (const XmlAttribute *attribute = this->firstAttribute; attribute;
+       attribute = attribute->Next())
+  {
+    if (attribute->Name() == _name)
+      return attribute;
+  }
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+const XmlElement *XmlElement::FirstChildElement(std::string_view _name) const
+{
+  const XmlElement *child = this->firstChild;
+  while (child && child->name != _name)
+    child = child->nextSibling;
+  return child;
+}
+
+/////////////////////////////////////////////////
+const XmlElement *XmlElement::NextSiblingElement(std::string_view _name) const
+{
+  const XmlElement *sibling = this->nextSibling;
+  while (sibling && sibling->name != _name)
+    sibling = sibling->nextSibling;
+  return sibling;
+}
+
+/////////////////////////////////////////////////
+XmlDocument::XmlDocument()
+{
+  this->Clear();
+}
+
+/////////////////////////////////////////////////
+XmlDocument::~XmlDocument() = default;
+
+/////////////////////////////////////////////////
+bool XmlDocument::Parse(std::string_view _text)
+{
+  return this->Parse(_text, nullptr);
+}
+
+/////////////////////////////////////////////////
+bool XmlDocument::Parse(std::string_view _text, XmlHandler &_handler)
+{
+  return this->Parse(_text, &_handler);
+}
+
+/////////////////////////////////////////////////
+bool XmlDocument::Parse(std::string_view _text, XmlHandler *_handler)
+{
+  this->Clear();
+  XmlParser parser(*this, _text, _handler);
+  if (!parser.ParseDocument())
+  {
+    // Don't expose a partial tree.
+    this->root->firstChild = nullptr;
+    return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool XmlDocument::Error() const
+{
+  return !this->errorDesc.empty();
+}
+
+/////////////////////////////////////////////////
+const std::string &XmlDocument::ErrorDesc() const
+{
+  return this->errorDesc;
+}
+
+/////////////////////////////////////////////////
+const XmlElement *XmlDocument::FirstChildElement() const
+{
+  return this->root->FirstChildElement();
+}
+
+/////////////////////////////////////////////////
+const XmlElement *XmlDocument::FirstChildElement(std::string_view _name) const
+{
+  return this->root->FirstChildElement(_name);
+}
+
+/////////////////////////////////////////////////
+void *XmlDocument::Allocate(std::size_t _size)
+{
+  _size = (_size + kAlignment - 1) / kAlignment * kAlignment;
+  if (_size > this->blockLeft)
+  {
+    // Reuse the next block if it was released and is large enough.
+    // Otherwise each block is twice as large as the previous one, so the
+    // number of blocks grows with the logarithm of the document size.
+    std::size_t index = this->blocks.empty() ? 0 : this->blockIndex + 1;
+    if (index == this->blocks.size() || this->blocks[index].size < _size)
+    {
+      std::size_t blockSize = std::max(
+          kFirstBlockSize << std::min<std::size_t>(index, 8), _size);
+      this->blocks.insert(this->blocks.begin() + index,
+          Block{std::unique_ptr<char[]>(new char[blockSize]), blockSize});
+    }
+    this->blockIndex = index;
+    this->blockFree = this->blocks[index].data.get();
+    this->blockLeft = this->blocks[index].size;
+  }
+
+  void *result = this->blockFree;
+  this->blockFree += _size;
+  this->blockLeft -= _size;
+  return result;
+}
+
+/////////////////////////////////////////////////
+XmlDocument::ArenaMark XmlDocument::Mark() const
+{
+  return {this->blockIndex, this->blockFree, this->blockLeft};
+}
+
+/////////////////////////////////////////////////
+void XmlDocument::Release(const ArenaMark &_mark)
+{
+  this->blockIndex = _mark.block;
+  this->blockFree = _mark.free;
+  this->blockLeft = _mark.left;
+}
+
+/////////////////////////////////////////////////
+void XmlDocument::Clear()
+{
+  // Keep the first block, so that reusing a document doesn't allocate.
+  if (this->blocks.size() > 1)
+    this->blocks.resize(1);
+  this->blockIndex = 0;
+  if (!this->blocks.empty())
+  {
+    this->blockFree = this->blocks.front().data.get();
+    this->blockLeft = this->blocks.front().size;
+  }
+  this->errorDesc.clear();
+  this->root = this->Allocate<XmlElement>();
+}
+}
+}
@@ -0,0 +1,332 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_XMLDOCUMENT_HH_
+#define SDF_XMLDOCUMENT_HH_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "sdf/sdf_config.h"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \brief An attribute of an XmlElement.
+  class XmlAttribute
+  {
+    /// \brief Get the name of the attribute.
+    /// \return The name.
+    public: std::string_view Name() const
+    {
+      return this->name;
+    }
+
+    /// \brief Get the value of the attribute, with entities decoded.
+    /// \return The value.
+    public: std::string_view Value() const
+    {
+      return this->value;
+    }
+
+    /// \brief Get the next attribute of the element.
+    /// \return The next attribute, or nullptr if this is the last one.
+    public: const XmlAttribute *Next() const
+    {
+      return this->next;
+    }
+
+    /// \brief Name of the attribute.
+    private: std::string_view name;
+
+    /// \brief Value of the attribute.
+    private: std::string_view value;
+
+    /// \brief Next attribute of the element.
+    private: const XmlAttribute *next = nullptr;
+
+    friend class XmlParser;
+  };
+
+  /// \brief An element of an XmlDocument.
+  class XmlElement
+  {
+    /// \brief Get the name of the element.
+    /// \return The name.
+    public: std::string_view Name() const
+    {
+      return this->name;
+    }
+
+    /// \brief Check whether the first child node of the element is text,
+    /// like TiXmlElement::GetText() returning non-null.
+    /// \return True if the element has text.
+    public: bool HasText() const
+    {
+      return this->hasText;
+    }
+
+    /// \brief Get the text of the first child node of the element. Like
+    /// TinyXML, runs of white space are condensed to a single space, and
+    /// leading and trailing white space is removed, except in CDATA.
+    /// \return The text, which is empty if HasText() is false.
+    public: std::string_view Text() const
+    {
+      return this->text;
+    }
+
+    /// \brief Get the first attribute.
+    /// \return The first attribute, or nullptr if there are none.
+    public: const XmlAttribute *FirstAttribute() const
+    {
+      return this->firstAttribute;
+    }
+
+    /// \brief Find an attribute by name.
+    /// \param[in] _name Name of the attribute.
+    /// \return The attribute, or nullptr if there is none with that name.
+    public: const XmlAttribute *Attribute(std::string_view _name) const;
+
+    /// \brief Get the first child element.
+    /// \return The first child element, or nullptr if there are none.
+    public: const XmlElement *FirstChildElement() const
+    {
+      return this->firstChild;
+    }
+
+    /// \brief Get the first child element with a name.
+    /// \param[in] _name Name of the element.
+    /// \return The element, or nullptr if there is none with that name.
+    public: const XmlElement *FirstChildElement(std::string_view _name) const;
+
+    /// \brief Get the next sibling element.
+    /// \return The next sibling, or nullptr if this is the last one.
+    public: const XmlElement *NextSiblingElement() const
+    {
+      return this->nextSibling;
+    }
+
+    /// \brief Get the next sibling element with a name.
+    /// \param[in] _name Name of the element.
+    /// \return The element, or nullptr if there is none with that name.
+    public: const XmlElement *NextSiblingElement(std::string_view _name) const;
+
+    /// \brief Name of the element.
+    private: std::string_view name;
+
+    /// \brief Text of the first child node.
+    private: std::string_view text;
+
+    /// \brief True if the first child node is text.
+    private: bool hasText = false;
+
+    /// \brief First attribute.
+    private: const XmlAttribute *firstAttribute = nullptr;
+
+    /// \brief First child element.
+    private: const XmlElement *firstChild = nullptr;
+
+    /// \brief Next sibling element.
+    private: const XmlElement *nextSibling = nullptr;
+
+    friend class XmlDocument;
+    friend class XmlParser;
+  };
+
+  /// \brief Receives the elements of an XmlDocument while it is parsed, so
+  /// that they can be read without keeping the whole document.
+  class XmlHandler
+  {
+    /// \brief What the parser does with an element.
+    public: enum class Action
+    {
+      /// \brief Pass the child elements to the handler. After its end, the
+      /// element is released.
+      STREAM,
+
+      /// \brief Build the child elements as a tree, which is passed to
+      /// EndElement(). After its end, the element is kept until its parent
+      /// is released.
+      KEEP,
+
+      /// \brief Don't pass any more elements to the handler. The rest of
+      /// the text is still parsed to check that it is valid XML.
+      STOP
+    };
+
+    /// \brief Destructor.
+    public: virtual ~XmlHandler() = default;
+
+    /// \brief Called after the start tag and the first child node of an
+    /// element were parsed, so that its attributes and its text are known.
+    /// \param[in] _element The element, which has no child elements yet.
+    /// \return STREAM, KEEP or STOP.
+    public: virtual Action StartElement(const XmlElement &_element) = 0;
+
+    /// \brief Called after the end tag of an element was parsed.
+    /// \param[in] _element The element, with its child elements if
+    /// StartElement() returned KEEP.
+    /// \return KEEP to keep the element, STOP, or STREAM to release it.
+    public: virtual Action EndElement(const XmlElement &_element) = 0;
+  };
+
+  /// \brief An XML document parsed in situ.
+  ///
+  /// Unlike TiXmlDocument, which allocates every node and copies every name
+  /// and value into its own string, names and values are views of the
+  /// parsed text. Only values that contain entities or white space that
+  /// must be condensed are copied. Nodes and copied values are allocated in
+  /// blocks from an arena that is released with the document. Comments,
+  /// declarations and other nodes that are not elements or text are
+  /// skipped.
+  ///
+  /// The document is read-only, conversions between SDFormat versions need
+  /// a TiXmlDocument.
+  class XmlDocument
+  {
+    /// \brief Constructor.
+    public: XmlDocument();
+
+    /// \brief Copy constructor is deleted, the document owns its nodes.
+    public: XmlDocument(const XmlDocument &) = delete;
+
+    /// \brief Copy assignment is deleted, the document owns its nodes.
+    public: XmlDocument &operator=(const XmlDocument &) = delete;
+
+    /// \brief Destructor.
+    public: ~XmlDocument();
+
+    /// \brief Parse XML text, replacing the previous contents.
+    /// \param[in] _text The text. It is not copied, so it must stay valid
+    /// and unchanged while the document is used.
+    /// \return True if successful. Otherwise ErrorDesc() describes the
+    /// error.
+    public: bool Parse(std::string_view _text);
+
+    /// \brief Parse XML text, passing the elements to a handler instead of
+    /// keeping them. Only the elements that the handler keeps use memory
+    /// after their end, so the document has no top level elements
+    /// afterwards.
+    /// \param[in] _text The text. It must stay valid and unchanged while
+    /// the elements passed to the handler are used.
+    /// \param[in] _handler The handler.
+    /// \return True if the text is valid XML, even if the handler stopped.
+    /// Otherwise ErrorDesc() describes the error.
+    public: bool Parse(std::string_view _text, XmlHandler &_handler);
+
+    /// \brief Check whether the last Parse() failed.
+    /// \return True if there was an error.
+    public: bool Error() const;
+
+    /// \brief Get the description of the error of the last Parse(). The
+    /// descriptions are the same as TinyXML's.
+    /// \return The description, or an empty string if there was no error.
+    public: const std::string &ErrorDesc() const;
+
+    /// \brief Get the first top level element.
+    /// \return The element, or nullptr if there are none.
+    public: const XmlElement *FirstChildElement() const;
+
+    /// \brief Get the first top level element with a name.
+    /// \param[in] _name Name of the element.
+    /// \return The element, or nullptr if there is none with that name.
+    public: const XmlElement *FirstChildElement(std::string_view _name) const;
+
+    /// \brief Allocate memory from the arena of the document.
+    /// \param[in] _size Number of bytes.
+    /// \return The memory, aligned for any node type.
+    private: void *Allocate(std::size_t _size);
+
+    /// \brief Allocate a node from the arena of the document. Nodes are
+    /// trivially destructible, so they are never destroyed.
+    /// \return The node.
+    private: template <typename T> T *Allocate()
+    {
+      return new (this->Allocate(sizeof(T))) T();
+    }
+
+    /// \brief Position in the arena, to release what is allocated after it.
+    private: struct ArenaMark
+    {
+      /// \brief Index of the current block.
+      std::size_t block;
+
+      /// \brief Next free byte of the current block.
+      char *free;
+
+      /// \brief Number of free bytes in the current block.
+      std::size_t left;
+    };
+
+    /// \brief Get the current position in the arena.
+    /// \return The position.
+    private: ArenaMark Mark() const;
+
+    /// \brief Release everything allocated after a position in the arena.
+    /// The blocks are kept for the next allocations.
+    /// \param[in] _mark The position.
+    private: void Release(const ArenaMark &_mark);
+
+    /// \brief Parse XML text.
+    /// \param[in] _text The text.
+    /// \param[in] _handler Handler to pass the elements to, or nullptr to
+    /// keep them in the document.
+    /// \return True if successful.
+    private: bool Parse(std::string_view _text, XmlHandler *_handler);
+
+    /// \brief Release all memory of the arena.
+    private: void Clear();
+
+    /// \brief A block of the arena.
+    private: struct Block
+    {
+      /// \brief Memory of the block.
+      std::unique_ptr<char[]> data;
+
+      /// \brief Size of the block.
+      std::size_t size;
+    };
+
+    /// \brief Blocks of the arena.
+    private: std::vector<Block> blocks;
+
+    /// \brief Index of the block that is allocated from.
+    private: std::size_t blockIndex = 0;
+
+    /// \brief Next free byte of the current block.
+    private: char *blockFree = nullptr;
+
+    /// \brief Number of free bytes in the current block.
+    private: std::size_t blockLeft = 0;
+
+    /// \brief Virtual root whose children are the top level elements.
+    private: XmlElement *root = nullptr;
+
+    /// \brief Description of the parse error, if any.
+    private: std::string errorDesc;
+
+    friend class XmlParser;
+  };
+  }
+}
+#endif
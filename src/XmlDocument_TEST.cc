@@ -0,0 +1,261 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "XmlDocument.hh"
+
+/////////////////////////////////////////////////
+TEST(XmlDocument, Elements)
+{
+  const std::string xml =
+    "<?xml version='1.0'?>\n"
+    "<!-- comment -->\n"
+    "<sdf version='1.7'>\n"
+    "  <model name=\"box\" static='true'>\n"
+    "    <link name='link'/>\n"
+    "    <joint name='joint'/>\n"
+    "    <link name='link2'></link>\n"
+    "  </model>\n"
+    "</sdf>\n";
+
+  sdf::XmlDocument doc;
+  ASSERT_TRUE(doc.Parse(xml));
+  EXPECT_FALSE(doc.Error());
+  EXPECT_EQ("", doc.ErrorDesc());
+
+  const sdf::XmlElement *root = doc.FirstChildElement();
+  ASSERT_NE(nullptr, root);
+  EXPECT_EQ(root, doc.FirstChildElement("sdf"));
+  EXPECT_EQ(nullptr, doc.FirstChildElement("model"));
+  EXPECT_EQ("sdf", root->Name());
+  EXPECT_EQ(nullptr, root->NextSiblingElement());
+
+  const sdf::XmlAttribute *version = root->FirstAttribute();
+  ASSERT_NE(nullptr, version);
+  EXPECT_EQ("version", version->Name());
+  EXPECT_EQ("1.7", version->Value());
+  EXPECT_EQ(nullptr, version->Next());
+
+  const sdf::XmlElement *model = root->FirstChildElement();
+  ASSERT_NE(nullptr, model);
+  EXPECT_EQ("model", model->Name());
+  EXPECT_FALSE(model->HasText());
+  ASSERT_NE(nullptr, model->Attribute("static"));
+  EXPECT_EQ("true", model->Attribute("static")->Value());
+  EXPECT_EQ("box", model->Attribute("name")->Value());
+  EXPECT_EQ(nullptr, model->Attribute("pose"));
+
+  const sdf::XmlElement *link = model->FirstChildElement("link");
+  ASSERT_NE(nullptr, link);
+  EXPECT_EQ("link", link->Attribute("name")->Value());
+  EXPECT_EQ("joint", link->NextSiblingElement()->Name());
+
+  const sdf::XmlElement *link2 = link->NextSiblingElement("link");
+  ASSERT_NE(nullptr, link2);
+  EXPECT_EQ("link2", link2->Attribute("name")->Value());
+  EXPECT_EQ(nullptr, link2->NextSiblingElement("link"));
+  EXPECT_EQ(nullptr, link2->FirstChildElement());
+
+  // Names and values are views of the parsed text.
+  const char *begin = xml.data();
+  const char *end = begin + xml.size();
+  EXPECT_GE(model->Name().data(), begin);
+  EXPECT_LT(model->Name().data(), end);
+  EXPECT_GE(model->Attribute("name")->Value().data(), begin);
+  EXPECT_LT(model->Attribute("name")->Value().data(), end);
+}
+
+/////////////////////////////////////////////////
+TEST(XmlDocument, Text)
+{
+  sdf::XmlDocument doc;
+  ASSERT_TRUE(doc.Parse(
+    "<sdf>"
+    "  <pose>  1 2\n\t 3   0 0 0 </pose>"
+    "  <name>a &amp; b &lt;c&gt; &quot;d&quot; &apos;e&apos;</name>"
+    "  <numeric>&#65;&#x42;&#x63;</numeric>"
+    "  <unknown>&foo;</unknown>"
+    "  <cdata><![CDATA[  <not> &amp; parsed  ]]></cdata>"
+    "  <blank>   </blank>"
+    "  <commented><!-- comment -->text</commented>"
+    "  <attribute value='x &amp; y'/>"
+    "</sdf>"));
+
+  const sdf::XmlElement *root = doc.FirstChildElement();
+  ASSERT_NE(nullptr, root);
+
+  const sdf::XmlElement *pose = root->FirstChildElement("pose");
+  ASSERT_NE(nullptr, pose);
+  EXPECT_TRUE(pose->HasText());
+  EXPECT_EQ("1 2 3 0 0 0", pose->Text());
+
+  EXPECT_EQ("a & b <c> \"d\" 'e'", root->FirstChildElement("name")->Text());
+  EXPECT_EQ("ABc", root->FirstChildElement("numeric")->Text());
+
+  // Like TinyXML, the ampersand of an unknown entity is dropped.
+  EXPECT_EQ("foo;", root->FirstChildElement("unknown")->Text());
+
+  const sdf::XmlElement *cdata = root->FirstChildElement("cdata");
+  EXPECT_TRUE(cdata->HasText());
+  EXPECT_EQ("  <not> &amp; parsed  ", cdata->Text());
+
+  const sdf::XmlElement *blank = root->FirstChildElement("blank");
+  EXPECT_FALSE(blank->HasText());
+  EXPECT_EQ("", blank->Text());
+
+  // The first child node is a comment, so there is no text.
+  EXPECT_FALSE(root->FirstChildElement("commented")->HasText());
+
+  EXPECT_EQ("x & y",
+      root->FirstChildElement("attribute")->Attribute("value")->Value());
+}
+
+/////////////////////////////////////////////////
+TEST(XmlDocument, Errors)
+{
+  sdf::XmlDocument doc;
+  EXPECT_FALSE(doc.Parse(""));
+  EXPECT_TRUE(doc.Error());
+  EXPECT_EQ("Error document empty.", doc.ErrorDesc());
+  EXPECT_EQ(nullptr, doc.FirstChildElement());
+
+  EXPECT_FALSE(doc.Parse("  \n "));
+  EXPECT_EQ("Error document empty.", doc.ErrorDesc());
+
+  EXPECT_FALSE(doc.Parse("<sdf><model></sdf>"));
+  EXPECT_EQ("Error reading end tag.", doc.ErrorDesc());
+  EXPECT_EQ(nullptr, doc.FirstChildElement());
+
+  EXPECT_FALSE(doc.Parse("<sdf version='1.7></sdf>"));
+  EXPECT_EQ("Error parsing Element.", doc.ErrorDesc());
+
+  EXPECT_FALSE(doc.Parse("<sdf version></sdf>"));
+  EXPECT_EQ("Error reading Attributes.", doc.ErrorDesc());
+
+  // A document can be parsed again after an error.
+  EXPECT_TRUE(doc.Parse("<sdf/>"));
+  EXPECT_FALSE(doc.Error());
+  EXPECT_EQ("", doc.ErrorDesc());
+  ASSERT_NE(nullptr, doc.FirstChildElement());
+  EXPECT_EQ("sdf", doc.FirstChildElement()->Name());
+}
+
+/////////////////////////////////////////////////
+TEST(XmlDocument, Reuse)
+{
+  // Enough elements to need more than one block of the arena.
+  std::string xml = "<sdf>";
+  for (int i = 0; i < 5000; ++i)
+    xml += "<model name='m" + std::to_string(i) + "'>a &amp; b</model>";
+  xml += "</sdf>";
+
+  sdf::XmlDocument doc;
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    ASSERT_TRUE(doc.Parse(xml));
+    int count = 0;
+    for (const sdf::XmlElement *model =
+           doc.FirstChildElement()->FirstChildElement("model");
+         model; model = model->NextSiblingElement("model"))
+    {
+      EXPECT_EQ("m" + std::to_string(count),
+          model->Attribute("name")->Value());
+      EXPECT_EQ("a & b", model->Text());
+      ++count;
+    }
+    EXPECT_EQ(5000, count);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Handler that records the elements it is passed, keeps the
+/// <plugin> elements and stops after the first <model>.
+class RecordingHandler : public sdf::XmlHandler
+{
+  public: Action StartElement(const sdf::XmlElement &_element) override
+  {
+    std::string event = "start " + std::string(_element.Name());
+    if (_element.HasText())
+      event += " " + std::string(_element.Text());
+    this->events.push_back(event);
+    return _element.Name() == "plugin" ? Action::KEEP : Action::STREAM;
+  }
+
+  public: Action EndElement(const sdf::XmlElement &_element) override
+  {
+    std::string event = "end " + std::string(_element.Name());
+    for (const sdf::XmlElement *child = _element.FirstChildElement(); child;
+         child = child->NextSiblingElement())
+    {
+      event += " " + std::string(child->Name());
+    }
+    this->events.push_back(event);
+
+    if (_element.Name() == "model")
+      return Action::STOP;
+    return _element.Name() == "plugin" ? Action::KEEP : Action::STREAM;
+  }
+
+  public: std::vector<std::string> events;
+};
+
+/////////////////////////////////////////////////
+TEST(XmlDocument, Handler)
+{
+  const std::string xml =
+    "<sdf version='1.7'>\n"
+    "  <model name='box'>\n"
+    "    <pose>1 2 3 0 0 0</pose>\n"
+    "    <plugin name='p'><a/><b>x</b></plugin>\n"
+    "    <link/>\n"
+    "  </model>\n"
+    "  <model name='ignored'/>\n"
+    "</sdf>\n";
+
+  sdf::XmlDocument doc;
+  RecordingHandler handler;
+  ASSERT_TRUE(doc.Parse(xml, handler));
+  EXPECT_EQ(nullptr, doc.FirstChildElement());
+
+  const std::vector<std::string> expected = {
+    "start sdf",
+    "start model",
+    "start pose 1 2 3 0 0 0",
+    "end pose",
+    "start plugin",
+    "end plugin a b",
+    "start link",
+    "end link",
+    "end model",
+  };
+  EXPECT_EQ(expected, handler.events);
+
+  // Text that is not valid XML fails even after the handler stopped.
+  RecordingHandler invalidHandler;
+  EXPECT_FALSE(doc.Parse("<sdf><model></model><world></sdf>",
+      invalidHandler));
+  EXPECT_TRUE(doc.Error());
+
+  // The document can still be parsed as a whole afterwards.
+  ASSERT_TRUE(doc.Parse(xml));
+  ASSERT_NE(nullptr, doc.FirstChildElement());
+  EXPECT_EQ("sdf", doc.FirstChildElement()->Name());
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_XMLREADER_HH_
+#define SDF_XMLREADER_HH_
+
+#include <tinyxml.h>
+
+#include <string_view>
+
+#include "sdf/sdf_config.h"
+#include "XmlDocument.hh"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \brief Handle to a read-only attribute of either a TinyXML element or
+  /// an XmlElement. A default constructed handle refers to no attribute,
+  /// like a null pointer.
+  class XmlAttributeRef
+  {
+    /// \brief Constructor for a handle that refers to no attribute.
+    public: XmlAttributeRef() = default;
+
+    /// \brief Constructor.
+    /// \param[in] _attribute A TinyXML attribute, which may be null.
+    public: XmlAttributeRef(const TiXmlAttribute *_attribute)
+      : tinyXml(_attribute)
+    {
+    }
+
+    /// \brief Constructor.
+    /// \param[in] _attribute An attribute of an XmlDocument, which may be
+    /// null.
+    public: XmlAttributeRef(const XmlAttribute *_attribute)
+      : inSitu(_attribute)
+    {
+    }
+
+    /// \brief Check whether the handle refers to an attribute.
+    /// \return True if it does.
+    public: explicit operator bool() const
+    {
+      return this->tinyXml || this->inSitu;
+    }
+
+    /// \brief Get the name of the attribute.
+    /// \return The name.
+    public: std::string_view Name() const
+    {
+      return this->inSitu ? this->inSitu->Name() :
+          std::string_view(this->tinyXml->Name());
+    }
+
+    /// \brief Get the value of the attribute.
+    /// \return The value.
+    public: std::string_view Value() const
+    {
+      return this->inSitu ? this->inSitu->Value() :
+          std::string_view(this->tinyXml->Value());
+    }
+
+    /// \brief Get the next attribute of the element.
+    /// \return The next attribute, or an empty handle after the last one.
+    public: XmlAttributeRef Next() const
+    {
+      return this->inSitu ? XmlAttributeRef(this->inSitu->Next()) :
+          XmlAttributeRef(this->tinyXml->Next());
+    }
+
+    /// \brief The TinyXML attribute, if any.
+    private: const TiXmlAttribute *tinyXml = nullptr;
+
+    /// \brief The XmlDocument attribute, if any.
+    private: const XmlAttribute *inSitu = nullptr;
+  };
+
+  /// \brief Handle to a read-only element of either a TiXmlDocument or an
+  /// XmlDocument, so that the parser reads both the same way. A default
+  /// constructed handle refers to no element, like a null pointer.
+  ///
+  /// The names and values of the handles are views, which are valid as long
+  /// as the document that they refer to.
+  class XmlElementRef
+  {
+    /// \brief Constructor for a handle that refers to no element.
+    public: XmlElementRef() = default;
+
+    /// \brief Constructor.
+    /// \param[in] _element A TinyXML element, which may be null.
+    public: XmlElementRef(const TiXmlElement *_element)
+      : tinyXml(_element)
+    {
+    }
+
+    /// \brief Constructor.
+    /// \param[in] _element An element of an XmlDocument, which may be null.
+    public: XmlElementRef(const XmlElement *_element)
+      : inSitu(_element)
+    {
+    }
+
+    /// \brief Check whether the handle refers to an element.
+    /// \return True if it does.
+    public: explicit operator bool() const
+    {
+      return this->tinyXml || this->inSitu;
+    }
+
+    /// \brief Get the name of the element.
+    /// \return The name.
+    public: std::string_view Name() const
+    {
+      return this->inSitu ? this->inSitu->Name() :
+          std::string_view(this->tinyXml->Value());
+    }
+
+    /// \brief Check whether the element has text, like
+    /// TiXmlElement::GetText() returning non-null.
+    /// \return True if the element has text.
+    public: bool HasText() const
+    {
+      return this->inSitu ? this->inSitu->HasText() :
+          this->tinyXml->GetText() != nullptr;
+    }
+
+    /// \brief Get the text of the element.
+    /// \return The text, which is empty if HasText() is false.
+    public: std::string_view Text() const
+    {
+      if (this->inSitu)
+        return this->inSitu->Text();
+
+      const char *text = this->tinyXml->GetText();
+      return text ? std::string_view(text) : std::string_view();
+    }
+
+    /// \brief Get the first attribute.
+    /// \return The first attribute, or an empty handle if there are none.
+    public: XmlAttributeRef FirstAttribute() const
+    {
+      return this->inSitu ? XmlAttributeRef(this->inSitu->FirstAttribute()) :
+          XmlAttributeRef(this->tinyXml->FirstAttribute());
+    }
+
+    /// \brief Find an attribute by name.
+    /// \param[in] _name Name of the attribute.
+    /// \return The attribute, or an empty handle if there is none with that
+    /// name.
+    public: XmlAttributeRef Attribute(std::string_view _name) const
+    {
+      if (this->inSitu)
+        return this->inSitu->Attribute(_name);
+
+      XmlAttributeRef attribute = this->FirstAttribute();
+      while (attribute && attribute.Name() != _name)
+        attribute = attribute.Next();
+      return attribute;
+    }
+
+    /// \brief Get the first child element.
+    /// \return The element, or an empty handle if there are none.
+    public: XmlElementRef FirstChildElement() const
+    {
+      return this->inSitu ? XmlElementRef(this->inSitu->FirstChildElement()) :
+          XmlElementRef(this->tinyXml->FirstChildElement());
+    }
+
+    /// \brief Get the first child element with a name.
+    /// \param[in] _name Name of the element.
+    /// \return The element, or an empty handle if there is none with that
+    /// name.
+    public: XmlElementRef FirstChildElement(const char *_name) const
+    {
+      return this->inSitu ?
+          XmlElementRef(this->inSitu->FirstChildElement(_name)) :
+          XmlElementRef(this->tinyXml->FirstChildElement(_name));
+    }
+
+    /// \brief Get the next sibling element.
+    /// \return The element, or an empty handle after the last one.
+    public: XmlElementRef NextSiblingElement() const
+    {
+      return this->inSitu ?
+          XmlElementRef(this->inSitu->NextSiblingElement()) :
+          XmlElementRef(this->tinyXml->NextSiblingElement());
+    }
+
+    /// \brief Get the next sibling element with a name.
+    /// \param[in] _name Name of the element.
+    /// \return The element, or an empty handle if there is none with that
+    /// name.
+    public: XmlElementRef NextSiblingElement(const char *_name) const
+    {
+      return this->inSitu ?
+          XmlElementRef(this->inSitu->NextSiblingElement(_name)) :
+          XmlElementRef(this->tinyXml->NextSiblingElement(_name));
+    }
+
+    /// \brief The TinyXML element, if any.
+    private: const TiXmlElement *tinyXml = nullptr;
+
+    /// \brief The XmlDocument element, if any.
+    private: const XmlElement *inSitu = nullptr;
+  };
+  }
+}
+#endif
@@ -157,3 +157,31 @@ extern "C" SDFORMAT_VISIBLE int cmdPrint(const char *_path)
 
   return 0;
 }
+
+//////////////////////////////////////////////////
+/// \brief Convert the SDF files of a directory tree to the latest version.
+/// \param[in] _path Path of the directory.
+/// \return 0 on success, -1 if a file could not be converted.
+// cppcheck-suppress unusedFunction
+extern "C" SDFORMAT_VISIBLE int cmdUpgradeTree(const char *_path)
+{
+  sdf::ConvertTreeReport report;
+  sdf::Errors errors;
+  const bool result =
+      sdf::convertTree(_path, sdf::SDF::Version(), report, errors);
+
+  for (auto &error : errors)
+  {
+    std::cerr << "Error: " << error.Message() << std::endl;
+  }
+
+  const std::size_t files = report.converted + report.skipped + report.failed;
+  std::cout << "Converted " << report.converted << ", skipped "
+            << report.skipped << " and failed " << report.failed << " of "
+            << files << " files in " << report.seconds << " s";
+  if (report.seconds > 0)
+    std::cout << " (" << files / report.seconds << " files/s)";
+  std::cout << ".\n";
+
+  return result ? 0 : -1;
+}
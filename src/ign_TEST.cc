@@ -18,8 +18,10 @@
 #include <gtest/gtest.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <fstream>
 #include <string>
 
+#include "sdf/Filesystem.hh"
 #include "sdf/parser.hh"
 #include "sdf/SDFImpl.hh"
 #include "sdf/sdf_config.h"
@@ -638,6 +640,35 @@ TEST(print, SDF)
   }
 }
 
+/////////////////////////////////////////////////
+TEST(upgrade_tree, SDF)
+{
+  const std::string path = sdf::filesystem::append(PROJECT_BINARY_DIR,
+      "test", "ign_upgrade_tree");
+  sdf::filesystem::create_directory(path);
+  const std::string file = sdf::filesystem::append(path, "model.sdf");
+  {
+    std::ofstream out(file);
+    out << "<sdf version='1.6'><model name='m'><link name='l'/></model></sdf>";
+  }
+
+  std::string output =
+    custom_exec_str(g_ignCommand + " sdf --upgrade-tree " + path +
+        g_sdfVersion);
+  EXPECT_NE(std::string::npos, output.find("Converted 1, skipped 0 and "
+      "failed 0 of 1 files")) << output;
+
+  // The file is skipped the next time.
+  output = custom_exec_str(g_ignCommand + " sdf --upgrade-tree " + path +
+      g_sdfVersion);
+  EXPECT_NE(std::string::npos, output.find("Converted 0, skipped 1 and "
+      "failed 0 of 1 files")) << output;
+
+  std::remove(file.c_str());
+  std::remove(sdf::filesystem::append(path, ".sdformat_converted").c_str());
+  std::remove(path.c_str());
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
@@ -15,16 +15,34 @@
  *
  */
 
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <cstdint>
 #include <cstdlib>
+#include <exception>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <set>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <ignition/math/SemanticVersion.hh>
+#include <urdf_parser/urdf_parser.h>
 
 #include "sdf/Console.hh"
 #include "sdf/Filesystem.hh"
 #include "sdf/Frame.hh"
+#include "sdf/InternedString.hh"
 #include "sdf/Joint.hh"
 #include "sdf/Link.hh"
 #include "sdf/Model.hh"
@@ -36,8 +54,13 @@
 #include "sdf/parser_urdf.hh"
 #include "sdf/sdf_config.h"
 
+#include "CompiledCache.hh"
 #include "Converter.hh"
+#include "ElementSerializer.hh"
 #include "FrameSemantics.hh"
+#include "IncrementalReader.hh"
+#include "MappedFile.hh"
+#include "ParseArena.hh"
 #include "parser_private.hh"
 
 namespace sdf
@@ -54,12 +77,14 @@ inline namespace SDF_VERSION_NAMESPACE {
 /// \param[in] _sdf Pointer to an SDF object.
 /// \param[in] _convert Convert to the latest version if true.
 /// \param[out] _errors Parsing errors will be appended to this variable.
+/// \param[in] _context Context used to read included files.
 /// \return True if successful.
 bool readFileInternal(
     const std::string &_filename,
     SDFPtr _sdf,
     const bool _convert,
-    Errors &_errors);
+    Errors &_errors,
+    ParserContext &_context);
 
 /// \brief Internal helper for readString, which populates the SDF values
 /// from a string
@@ -71,12 +96,187 @@ bool readFileInternal(
 /// \param[in] _sdf Pointer to an SDF object.
 /// \param[in] _convert Convert to the latest version if true.
 /// \param[out] _errors Parsing errors will be appended to this variable.
+/// \param[in] _context Context used to read included files.
 /// \return True if successful.
 bool readStringInternal(
     const std::string &_xmlString,
     SDFPtr _sdf,
     const bool _convert,
-    Errors &_errors);
+    Errors &_errors,
+    ParserContext &_context);
+
+/// \brief Mutex that serializes URDF conversions. URDF2SDF keeps its
+/// options and the parsed extensions in global variables, so only one
+/// conversion can run at a time.
+static std::mutex g_urdfMutex;
+
+/// \brief XML document that files and strings are read into, selected with
+/// the SDF_XML_BACKEND CMake option. TinyXML is still used to convert
+/// documents and to read URDF, model.config and the specification.
+#ifdef SDF_XML_INSITU
+using ParserXmlDocument = XmlDocument;
+#else
+using ParserXmlDocument = TiXmlDocument;
+
+//////////////////////////////////////////////////
+/// \brief Populate the SDF values from a TinyXML document, with the
+/// arguments of the in-situ readDoc, so that callers can use either
+/// ParserXmlDocument.
+static bool readDoc(TiXmlDocument &_xmlDoc, const char * /*_xml*/,
+    SDFPtr _sdf, const std::string &_source, bool _convert, Errors &_errors,
+    ParserContext &_context)
+{
+  return readDoc(&_xmlDoc, _sdf, _source, _convert, _errors, _context);
+}
+
+//////////////////////////////////////////////////
+/// \brief Populate an SDF element from a TinyXML document, with the
+/// arguments of the in-situ readDoc.
+static bool readDoc(TiXmlDocument &_xmlDoc, const char * /*_xml*/,
+    ElementPtr _sdf, const std::string &_source, bool _convert,
+    Errors &_errors, ParserContext &_context)
+{
+  return readDoc(&_xmlDoc, _sdf, _source, _convert, _errors, _context);
+}
+#endif
+
+//////////////////////////////////////////////////
+/// \brief Parse XML text and populate the SDF values from it. With the
+/// in-situ backend, the elements are read while the text is parsed, unless
+/// the document is needed, such as to convert it.
+/// \param[in] _xmlDoc Document to parse the text with.
+/// \param[in] _xml The text, which ends with a null character.
+/// \param[in] _sdf Pointer to an SDF object.
+/// \param[in] _source Source of the text, like for readDoc.
+/// \param[in] _convert Convert to the latest version if true.
+/// \param[out] _errors Parsing errors will be appended to this variable.
+/// \param[in] _context Context used to read included files.
+/// \param[out] _xmlError Set to true if the text is not valid XML, as
+/// described by _xmlDoc.ErrorDesc().
+/// \return True if successful.
+static bool parseDoc(ParserXmlDocument &_xmlDoc, const char *_xml,
+    SDFPtr _sdf, const std::string &_source, bool _convert, Errors &_errors,
+    ParserContext &_context, bool &_xmlError);
+
+//////////////////////////////////////////////////
+/// \brief Check whether XML text is a URDF model, like URDF2SDF::IsURDF
+/// does for a file.
+/// \param[in] _xml The XML text.
+/// \return True if _xml is a URDF model.
+static bool isURDF(std::string_view _xml)
+{
+  return urdf::parseURDF(std::string(_xml)) != nullptr;
+}
+
+//////////////////////////////////////////////////
+ParserContext::ParserContext()
+  : includeTemplate(std::make_shared<IncludeTemplate>())
+{
+}
+
+//////////////////////////////////////////////////
+ParserContext::ParserContext(const ParserConfig &_config)
+  : config(_config), includeTemplate(Default().includeTemplate)
+{
+}
+
+//////////////////////////////////////////////////
+ParserContext &ParserContext::Default()
+{
+  static ParserContext context;
+  return context;
+}
+
+//////////////////////////////////////////////////
+const ParserConfig &ParserContext::Config() const
+{
+  return this->config;
+}
+
+//////////////////////////////////////////////////
+SDFPtr ParserContext::CreateIncludeSDF()
+{
+  // NOTE: sdf::init is an expensive call. For performance reason,
+  // a new sdf pointer is created here by cloning a fresh sdf template
+  // pointer instead of calling init for every include.
+  IncludeTemplate &tmpl = *this->includeTemplate;
+  std::call_once(tmpl.flag, [&tmpl]()
+    {
+      // The template is kept for the lifetime of the context, so it is not
+      // placed in the arena of the document that first includes a file.
+      ParseArena::Scope heapScope(nullptr);
+      tmpl.sdf.reset(new SDF);
+      init(tmpl.sdf);
+    });
+
+  SDFPtr includeSDF(new SDF);
+  includeSDF->Root(tmpl.sdf->Root()->CloneWithSharedDescriptions());
+  return includeSDF;
+}
+
+//////////////////////////////////////////////////
+void ParserContext::TrackDependencies()
+{
+  this->dependencies = std::make_shared<DependencyList>();
+}
+
+//////////////////////////////////////////////////
+void ParserContext::AddDependency(const std::string &_filename)
+{
+  if (!this->dependencies)
+    return;
+  std::lock_guard<std::mutex> lock(this->dependencies->mutex);
+  this->dependencies->filenames.insert(_filename);
+}
+
+//////////////////////////////////////////////////
+void ParserContext::AddDependencies(const std::vector<std::string> &_filenames)
+{
+  if (!this->dependencies)
+    return;
+  std::lock_guard<std::mutex> lock(this->dependencies->mutex);
+  this->dependencies->filenames.insert(_filenames.begin(), _filenames.end());
+}
+
+//////////////////////////////////////////////////
+std::vector<std::string> ParserContext::Dependencies() const
+{
+  if (!this->dependencies)
+    return {};
+  std::lock_guard<std::mutex> lock(this->dependencies->mutex);
+  return std::vector<std::string>(this->dependencies->filenames.begin(),
+      this->dependencies->filenames.end());
+}
+
+//////////////////////////////////////////////////
+void ParserContext::AddResolvedUri(const std::string &_uri,
+    const std::string &_path)
+{
+  if (!this->dependencies)
+    return;
+  std::lock_guard<std::mutex> lock(this->dependencies->mutex);
+  this->dependencies->uris[_uri] = _path;
+}
+
+//////////////////////////////////////////////////
+void ParserContext::AddResolvedUris(
+    const std::map<std::string, std::string> &_uris)
+{
+  if (!this->dependencies)
+    return;
+  std::lock_guard<std::mutex> lock(this->dependencies->mutex);
+  for (const auto &[uri, path] : _uris)
+    this->dependencies->uris[uri] = path;
+}
+
+//////////////////////////////////////////////////
+std::map<std::string, std::string> ParserContext::ResolvedUris() const
+{
+  if (!this->dependencies)
+    return {};
+  std::lock_guard<std::mutex> lock(this->dependencies->mutex);
+  return this->dependencies->uris;
+}
 
 //////////////////////////////////////////////////
 template <typename TPtr>
@@ -96,23 +296,69 @@ static inline bool _initFile(const std::string &_filename, TPtr _sdf)
 }
 
 //////////////////////////////////////////////////
-bool init(SDFPtr _sdf)
+/// \brief Get the description tree generated from an embedded spec file.
+///
+/// The first request for a given spec version and file parses the embedded
+/// XML with initXml. The resulting tree is kept for the lifetime of the
+/// process and is only ever read afterwards, so init() and initFile() can
+/// copy from it instead of running TinyXML over the spec again.
+/// \param[in] _filename Name of the embedded spec file, e.g. "root.sdf".
+/// \param[in] _quiet True to suppress an error if the file is not embedded.
+/// \return The shared description tree, or nullptr if the file is not an
+/// embedded spec or could not be parsed. Callers must not modify it.
+static ElementPtr embeddedSpecDescription(const std::string &_filename,
+                                          const bool _quiet)
 {
-  std::string xmldata = SDF::EmbeddedSpec("root.sdf", false);
+  static std::mutex specMutex;
+  static std::map<std::string, ElementPtr> specDescriptions;
+
+  const std::string key = SDF::Version() + "/" + _filename;
+  {
+    std::lock_guard<std::mutex> lock(specMutex);
+    auto it = specDescriptions.find(key);
+    if (it != specDescriptions.end())
+      return it->second;
+  }
+
+  const std::string &xmldata = SDF::EmbeddedSpec(_filename, _quiet);
+  if (xmldata.empty())
+    return nullptr;
+
+  // The lock is not held while building, since spec files <include> other
+  // spec files and initXml re-enters this function for them. If two threads
+  // race to build the same file, the first one stored wins.
+  // Descriptions are kept for the lifetime of the process, so they are
+  // never placed in the arena of the document being parsed.
+  ParseArena::Scope heapScope(nullptr);
   TiXmlDocument xmlDoc;
   xmlDoc.Parse(xmldata.c_str());
-  return initDoc(&xmlDoc, _sdf);
+  ElementPtr description(new Element);
+  if (!initDoc(&xmlDoc, description))
+    return nullptr;
+
+  std::lock_guard<std::mutex> lock(specMutex);
+  return specDescriptions.emplace(key, description).first->second;
+}
+
+//////////////////////////////////////////////////
+bool init(SDFPtr _sdf)
+{
+  ElementPtr description = embeddedSpecDescription("root.sdf", false);
+  if (!description)
+    return false;
+
+  _sdf->Root()->Copy(description);
+  return true;
 }
 
 //////////////////////////////////////////////////
 bool initFile(const std::string &_filename, SDFPtr _sdf)
 {
-  std::string xmldata = SDF::EmbeddedSpec(_filename, true);
-  if (!xmldata.empty())
+  ElementPtr description = embeddedSpecDescription(_filename, true);
+  if (description)
   {
-    TiXmlDocument xmlDoc;
-    xmlDoc.Parse(xmldata.c_str());
-    return initDoc(&xmlDoc, _sdf);
+    _sdf->Root()->Copy(description);
+    return true;
   }
   return _initFile(sdf::findFile(_filename), _sdf);
 }
@@ -120,12 +366,11 @@ bool initFile(const std::string &_filename, SDFPtr _sdf)
 //////////////////////////////////////////////////
 bool initFile(const std::string &_filename, ElementPtr _sdf)
 {
-  std::string xmldata = SDF::EmbeddedSpec(_filename, true);
-  if (!xmldata.empty())
+  ElementPtr description = embeddedSpecDescription(_filename, true);
+  if (description)
   {
-    TiXmlDocument xmlDoc;
-    xmlDoc.Parse(xmldata.c_str());
-    return initDoc(&xmlDoc, _sdf);
+    _sdf->Copy(description);
+    return true;
   }
   return _initFile(sdf::findFile(_filename), _sdf);
 }
@@ -202,7 +447,10 @@ bool initXml(TiXmlElement *_xml, ElementPtr _sdf)
     sdferr << "Element is missing the name attribute\n";
     return false;
   }
-  _sdf->SetName(std::string(nameString));
+  // The names of the specification are pooled, so that the elements and
+  // attributes that are created with them share them. Other names are
+  // user data, which Element::SetName and Param do not add to the pool.
+  _sdf->SetName(InternedString(nameString));
 
   const char *requiredString = _xml->Attribute("required");
   if (!requiredString)
@@ -267,7 +515,8 @@ bool initXml(TiXmlElement *_xml, ElementPtr _sdf)
       description = descriptionChild->GetText();
     }
 
-    _sdf->AddAttribute(name, type, defaultValue, required, description);
+    _sdf->AddAttribute(InternedString(name), type, defaultValue, required,
+                       description);
   }
 
   // Read the element description
@@ -335,6 +584,23 @@ SDFPtr readFile(const std::string &_filename, Errors &_errors)
   return sdfParsed;
 }
 
+//////////////////////////////////////////////////
+SDFPtr readFile(const std::string &_filename, const ParserConfig &_config,
+    Errors &_errors)
+{
+  // Create and initialize the data structure that will hold the parsed SDF data
+  sdf::SDFPtr sdfParsed(new sdf::SDF());
+  sdf::init(sdfParsed);
+
+  // Read an SDF file, and store the result in sdfParsed.
+  if (!sdf::readFile(_filename, _config, sdfParsed, _errors))
+  {
+    return SDFPtr();
+  }
+
+  return sdfParsed;
+}
+
 //////////////////////////////////////////////////
 SDFPtr readFile(const std::string &_filename)
 {
@@ -364,21 +630,87 @@ bool readFile(const std::string &_filename, SDFPtr _sdf)
 //////////////////////////////////////////////////
 bool readFile(const std::string &_filename, SDFPtr _sdf, Errors &_errors)
 {
-  return readFileInternal(_filename, _sdf, true, _errors);
+  // A default configuration stores compiled documents in the directory of
+  // SDF_COMPILED_CACHE_PATH, if it is set.
+  ParserConfig config;
+  if (!config.CompiledCacheDirectory().empty())
+    return readFile(_filename, config, _sdf, _errors);
+
+  return readFileInternal(_filename, _sdf, true, _errors,
+      ParserContext::Default());
+}
+
+//////////////////////////////////////////////////
+bool readFile(const std::string &_filename, const ParserConfig &_config,
+    SDFPtr _sdf, Errors &_errors)
+{
+  ParserContext context(_config);
+  ParseArena::Scope arenaScope(
+      _config.UseParseArena() ? ParseArena::Of(*_sdf).get() : nullptr);
+  if (_config.CompiledCacheDirectory().empty())
+    return readFileInternal(_filename, _sdf, true, _errors, context);
+
+  // Entries are named after the contents of the file, so resolve it like
+  // readFileInternal does.
+  std::string filename = sdf::findFile(_filename, true, true);
+  if (!filename.empty() && filesystem::is_directory(filename))
+    filename = getModelFilePath(filename);
+
+  CompiledCache cache(_config.CompiledCacheDirectory());
+  if (!filename.empty() && filesystem::exists(filename) &&
+      cache.Read(filename, _sdf))
+  {
+    return true;
+  }
+
+  context.TrackDependencies();
+  const std::size_t errorCount = _errors.size();
+  if (!readFileInternal(_filename, _sdf, true, _errors, context))
+    return false;
+
+  // Documents with errors are parsed again, to report them again.
+  if (_errors.size() == errorCount &&
+      !cache.Write(*_sdf, context.Dependencies(), context.ResolvedUris()))
+  {
+    sdfdbg << "Unable to write the compiled file of [" << filename
+           << "] to the cache directory ["
+           << _config.CompiledCacheDirectory() << "].\n";
+  }
+  return true;
 }
 
 //////////////////////////////////////////////////
 bool readFileWithoutConversion(
     const std::string &_filename, SDFPtr _sdf, Errors &_errors)
 {
-  return readFileInternal(_filename, _sdf, false, _errors);
+  return readFileInternal(_filename, _sdf, false, _errors,
+      ParserContext::Default());
+}
+
+//////////////////////////////////////////////////
+/// \brief Record the configuration file that getModelFilePath reads to
+/// choose the model file of a directory.
+/// \param[in] _modelDirPath Directory of the model.
+/// \param[in] _context Context that records the file.
+static void addModelConfigDependency(const std::string &_modelDirPath,
+    ParserContext &_context)
+{
+  for (const char *name : {"model.config", "manifest.xml"})
+  {
+    const std::string configFilePath =
+        sdf::filesystem::append(_modelDirPath, name);
+    if (sdf::filesystem::exists(configFilePath))
+    {
+      _context.AddDependency(configFilePath);
+      return;
+    }
+  }
 }
 
 //////////////////////////////////////////////////
 bool readFileInternal(const std::string &_filename, SDFPtr _sdf,
-      const bool _convert, Errors &_errors)
+      const bool _convert, Errors &_errors, ParserContext &_context)
 {
-  TiXmlDocument xmlDoc;
   std::string filename = sdf::findFile(_filename, true, true);
 
   if (filename.empty())
@@ -389,6 +721,7 @@ bool readFileInternal(const std::string &_filename, SDFPtr _sdf,
 
   if (filesystem::is_directory(filename))
   {
+    addModelConfigDependency(filename, _context);
     filename = getModelFilePath(filename);
   }
 
@@ -397,8 +730,23 @@ bool readFileInternal(const std::string &_filename, SDFPtr _sdf,
     sdferr << "File [" << filename << "] doesn't exist.\n";
     return false;
   }
+  _context.AddDependency(filename);
+
+  // Map the file once, and parse it from memory. The URDF fallback below
+  // reads the same mapping instead of loading the file again.
+  MappedFile file;
+  if (!file.Open(filename))
+  {
+    sdferr << "Error parsing XML in file [" << filename << "]: "
+           << "Failed to open file\n";
+    return false;
+  }
 
-  if (!xmlDoc.LoadFile(filename))
+  ParserXmlDocument xmlDoc;
+  bool xmlError;
+  const bool read = parseDoc(xmlDoc, file.CStr(), _sdf, filename, _convert,
+      _errors, _context, xmlError);
+  if (xmlError)
   {
     sdferr << "Error parsing XML in file [" << filename << "]: "
            << xmlDoc.ErrorDesc() << '\n';
@@ -407,15 +755,19 @@ bool readFileInternal(const std::string &_filename, SDFPtr _sdf,
 
   // Suppress deprecation for sdf::URDF2SDF
   SDF_SUPPRESS_DEPRECATED_BEGIN
-  if (readDoc(&xmlDoc, _sdf, filename, _convert, _errors))
+  if (read)
   {
     return true;
   }
-  else if (URDF2SDF::IsURDF(filename))
+  else if (isURDF(file.Data()))
   {
-    URDF2SDF u2g;
-    TiXmlDocument doc = u2g.InitModelFile(filename);
-    if (sdf::readDoc(&doc, _sdf, "urdf file", _convert, _errors))
+    TiXmlDocument doc;
+    {
+      std::lock_guard<std::mutex> lock(g_urdfMutex);
+      URDF2SDF u2g;
+      doc = u2g.InitModelString(std::string(file.Data()));
+    }
+    if (sdf::readDoc(&doc, _sdf, "urdf file", _convert, _errors, _context))
     {
       sdfdbg << "parse from urdf file [" << _filename << "].\n";
       return true;
@@ -431,6 +783,44 @@ bool readFileInternal(const std::string &_filename, SDFPtr _sdf,
   return false;
 }
 
+//////////////////////////////////////////////////
+bool readBinary(const std::string &_filename, SDFPtr _sdf, Errors &_errors)
+{
+  MappedFile file;
+  if (!file.Open(_filename, false))
+  {
+    _errors.push_back({ErrorCode::FILE_READ,
+        "Unable to read binary file[" + _filename + "]"});
+    return false;
+  }
+
+  if (!ElementSerializer::Deserialize(file.Data(), _sdf, _errors))
+  {
+    _errors.push_back({ErrorCode::FILE_READ,
+        "Unable to read binary file[" + _filename + "]"});
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::string binaryCachePath(const std::string &_filename)
+{
+  return _filename + ".sdfb";
+}
+
+//////////////////////////////////////////////////
+std::size_t compiledCacheHits()
+{
+  return CompiledCache::Hits();
+}
+
+//////////////////////////////////////////////////
+std::size_t compiledCacheMisses()
+{
+  return CompiledCache::Misses();
+}
+
 //////////////////////////////////////////////////
 bool readString(const std::string &_xmlString, SDFPtr _sdf)
 {
@@ -447,38 +837,47 @@ bool readString(const std::string &_xmlString, SDFPtr _sdf)
 //////////////////////////////////////////////////
 bool readString(const std::string &_xmlString, SDFPtr _sdf, Errors &_errors)
 {
-  return readStringInternal(_xmlString, _sdf, true, _errors);
+  return readStringInternal(_xmlString, _sdf, true, _errors,
+      ParserContext::Default());
 }
 
 //////////////////////////////////////////////////
 bool readStringWithoutConversion(
     const std::string &_filename, SDFPtr _sdf, Errors &_errors)
 {
-  return readStringInternal(_filename, _sdf, false, _errors);
+  return readStringInternal(_filename, _sdf, false, _errors,
+      ParserContext::Default());
 }
 
 //////////////////////////////////////////////////
 bool readStringInternal(const std::string &_xmlString, SDFPtr _sdf,
-    const bool _convert, Errors &_errors)
+    const bool _convert, Errors &_errors, ParserContext &_context)
 {
-  TiXmlDocument xmlDoc;
-  xmlDoc.Parse(_xmlString.c_str());
-  if (xmlDoc.Error())
+  ParserXmlDocument xmlDoc;
+  bool xmlError;
+  const bool read = parseDoc(xmlDoc, _xmlString.c_str(), _sdf, "data-string",
+      _convert, _errors, _context, xmlError);
+  if (xmlError)
   {
     sdferr << "Error parsing XML from string: " << xmlDoc.ErrorDesc() << '\n';
     return false;
   }
-  if (readDoc(&xmlDoc, _sdf, "data-string", _convert, _errors))
+  if (read)
   {
     return true;
   }
   else
   {
-    SDF_SUPPRESS_DEPRECATED_BEGIN
-    URDF2SDF u2g;
-    SDF_SUPPRESS_DEPRECATED_END
-    TiXmlDocument doc = u2g.InitModelString(_xmlString);
-    if (sdf::readDoc(&doc, _sdf, "urdf string", _convert, _errors))
+    TiXmlDocument doc;
+    {
+      std::lock_guard<std::mutex> lock(g_urdfMutex);
+      SDF_SUPPRESS_DEPRECATED_BEGIN
+      URDF2SDF u2g;
+      SDF_SUPPRESS_DEPRECATED_END
+      doc = u2g.InitModelString(_xmlString);
+    }
+    if (sdf::readDoc(&doc, _sdf, "urdf string", _convert, _errors,
+                     _context))
     {
       sdfdbg << "Parsing from urdf.\n";
       return true;
@@ -509,14 +908,15 @@ bool readString(const std::string &_xmlString, ElementPtr _sdf)
 //////////////////////////////////////////////////
 bool readString(const std::string &_xmlString, ElementPtr _sdf, Errors &_errors)
 {
-  TiXmlDocument xmlDoc;
+  ParserXmlDocument xmlDoc;
   xmlDoc.Parse(_xmlString.c_str());
   if (xmlDoc.Error())
   {
     sdferr << "Error parsing XML from string: " << xmlDoc.ErrorDesc() << '\n';
     return false;
   }
-  if (readDoc(&xmlDoc, _sdf, "data-string", true, _errors))
+  if (readDoc(xmlDoc, _xmlString.c_str(), _sdf, "data-string", true, _errors,
+                ParserContext::Default()))
   {
     return true;
   }
@@ -530,7 +930,8 @@ bool readString(const std::string &_xmlString, ElementPtr _sdf, Errors &_errors)
 
 //////////////////////////////////////////////////
 bool readDoc(TiXmlDocument *_xmlDoc, SDFPtr _sdf,
-    const std::string &_source, bool _convert, Errors &_errors)
+    const std::string &_source, bool _convert, Errors &_errors,
+    ParserContext &_context)
 {
   if (!_xmlDoc)
   {
@@ -577,7 +978,7 @@ bool readDoc(TiXmlDocument *_xmlDoc, SDFPtr _sdf,
 
     // parse new sdf xml
     TiXmlElement *elemXml = _xmlDoc->FirstChildElement(_sdf->Root()->GetName());
-    if (!readXml(elemXml, _sdf->Root(), _errors))
+    if (!readXml(elemXml, _sdf->Root(), _errors, _context))
     {
       _errors.push_back({ErrorCode::ELEMENT_INVALID,
           "Error reading element <" + _sdf->Root()->GetName() + ">"});
@@ -603,7 +1004,8 @@ bool readDoc(TiXmlDocument *_xmlDoc, SDFPtr _sdf,
 
 //////////////////////////////////////////////////
 bool readDoc(TiXmlDocument *_xmlDoc, ElementPtr _sdf,
-             const std::string &_source, bool _convert, Errors &_errors)
+             const std::string &_source, bool _convert, Errors &_errors,
+             ParserContext &_context)
 {
   if (!_xmlDoc)
   {
@@ -645,7 +1047,7 @@ bool readDoc(TiXmlDocument *_xmlDoc, ElementPtr _sdf,
     }
 
     // parse new sdf xml
-    if (!readXml(elemXml, _sdf, _errors))
+    if (!readXml(elemXml, _sdf, _errors, _context))
     {
       _errors.push_back({ErrorCode::ELEMENT_INVALID,
           "Unable to parse sdf element["+ _sdf->GetName() + "]"});
@@ -668,6 +1070,124 @@ bool readDoc(TiXmlDocument *_xmlDoc, ElementPtr _sdf,
   return true;
 }
 
+#ifdef SDF_XML_INSITU
+//////////////////////////////////////////////////
+bool readDoc(const XmlDocument &_xmlDoc, const char *_xml, SDFPtr _sdf,
+    const std::string &_source, bool _convert, Errors &_errors,
+    ParserContext &_context)
+{
+  // check sdf version
+  XmlElementRef sdfNode = _xmlDoc.FirstChildElement("sdf");
+  if (!sdfNode)
+  {
+    return false;
+  }
+
+  // The converter edits a TinyXML document, so parse the text again.
+  XmlAttributeRef version = sdfNode.Attribute("version");
+  if (_convert && version && version.Value() != SDF::Version())
+  {
+    TiXmlDocument xmlDoc;
+    xmlDoc.Parse(_xml);
+    return readDoc(&xmlDoc, _sdf, _source, _convert, _errors, _context);
+  }
+
+  if (nullptr == _sdf || nullptr == _sdf->Root())
+  {
+    sdferr << "SDF pointer or its Root is null.\n";
+    return false;
+  }
+
+  if (_source != "data-string")
+  {
+    _sdf->SetFilePath(_source);
+  }
+
+  if (!version)
+  {
+    sdfdbg << "SDF <sdf> element has no version in file["
+           << _source << "]\n";
+    return false;
+  }
+
+  if (_sdf->OriginalVersion().empty())
+  {
+    _sdf->SetOriginalVersion(std::string(version.Value()));
+  }
+
+  if (_sdf->Root()->OriginalVersion().empty())
+  {
+    _sdf->Root()->SetOriginalVersion(std::string(version.Value()));
+  }
+
+  // parse new sdf xml
+  XmlElementRef elemXml = _xmlDoc.FirstChildElement(_sdf->Root()->GetName());
+  if (!readXml(elemXml, _sdf->Root(), _errors, _context))
+  {
+    _errors.push_back({ErrorCode::ELEMENT_INVALID,
+        "Error reading element <" + _sdf->Root()->GetName() + ">"});
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool readDoc(const XmlDocument &_xmlDoc, const char *_xml, ElementPtr _sdf,
+    const std::string &_source, bool _convert, Errors &_errors,
+    ParserContext &_context)
+{
+  // check sdf version
+  XmlElementRef sdfNode = _xmlDoc.FirstChildElement("sdf");
+  if (!sdfNode)
+  {
+    return false;
+  }
+
+  // The converter edits a TinyXML document, so parse the text again.
+  XmlAttributeRef version = sdfNode.Attribute("version");
+  if (_convert && version && version.Value() != SDF::Version())
+  {
+    TiXmlDocument xmlDoc;
+    xmlDoc.Parse(_xml);
+    return readDoc(&xmlDoc, _sdf, _source, _convert, _errors, _context);
+  }
+
+  if (_source != "data-string")
+  {
+    _sdf->SetFilePath(_source);
+  }
+
+  if (!version)
+  {
+    sdfdbg << "<sdf> element has no version\n";
+    return false;
+  }
+
+  if (_sdf->OriginalVersion().empty())
+  {
+    _sdf->SetOriginalVersion(std::string(version.Value()));
+  }
+
+  XmlElementRef elemXml = sdfNode;
+  if (sdfNode.Name() != _sdf->GetName() &&
+      sdfNode.FirstChildElement(_sdf->GetName().c_str()))
+  {
+    elemXml = sdfNode.FirstChildElement(_sdf->GetName().c_str());
+  }
+
+  // parse new sdf xml
+  if (!readXml(elemXml, _sdf, _errors, _context))
+  {
+    _errors.push_back({ErrorCode::ELEMENT_INVALID,
+        "Unable to parse sdf element["+ _sdf->GetName() + "]"});
+    return false;
+  }
+
+  return true;
+}
+#endif
+
 //////////////////////////////////////////////////
 std::string getBestSupportedModelVersion(TiXmlElement *_modelXML,
                                          std::string &_modelFileName)
@@ -785,425 +1305,1984 @@ std::string getModelFilePath(const std::string &_modelDirPath)
 }
 
 //////////////////////////////////////////////////
-bool readXml(TiXmlElement *_xml, ElementPtr _sdf, Errors &_errors)
+/// \brief Process-wide cache of parsed included files, used when
+/// ParserConfig::CacheIncludes() is true. It keeps at most kMaxEntries
+/// files, and drops the least recently used one to add another.
+class IncludeCache
 {
-  // Check if the element pointer is deprecated.
-  if (_sdf->GetRequired() == "-1")
+  /// \brief Modification time and size of a file.
+  private: struct FileStamp
   {
-    sdfwarn << "SDF Element[" + _sdf->GetName() + "] is deprecated\n";
-  }
+    /// \brief Modification time of the file.
+    std::int64_t mtime = 0;
 
-  if (!_xml)
+    /// \brief Size of the file.
+    std::int64_t size = 0;
+  };
+
+  /// \brief A cached file.
+  private: struct Entry
   {
-    if (_sdf->GetRequired() == "1" || _sdf->GetRequired() =="+")
-    {
-      _errors.push_back({ErrorCode::ELEMENT_MISSING,
+    /// \brief Stamp of the file when it was parsed.
+    FileStamp stamp;
+
+    /// \brief The parsed file. It is never modified, only cloned.
+    SDFPtr sdf;
+
+    /// \brief Errors found while parsing the file.
+    Errors errors;
+
+    /// \brief Files read to parse the file, including itself.
+    std::vector<std::string> dependencies;
+
+    /// \brief Stamps of the dependencies after the file was parsed.
+    std::vector<FileStamp> dependencyStamps;
+
+    /// \brief Paths that the URIs of the includes of the file resolved to.
+    std::map<std::string, std::string> uris;
+  };
+
+  /// \brief An entry of the cache and its last use.
+  private: struct Slot
+  {
+    /// \brief The cached file, which is shared with the readers that
+    /// check it without holding the lock.
+    std::shared_ptr<const Entry> entry;
+
+    /// \brief Value of useCount when the entry was last read or stored.
+    std::uint64_t lastUse = 0;
+  };
+
+  /// \brief Maximum number of cached files.
+  private: static constexpr std::size_t kMaxEntries = 256;
+
+  /// \brief Get the cache.
+  /// \return The process-wide cache.
+  public: static IncludeCache &Instance()
+  {
+    static IncludeCache cache;
+    return cache;
+  }
+
+  /// \brief Read an included file, or clone it from the cache if neither
+  /// it nor the files read to parse it changed since it was read.
+  /// \param[in] _filename Path of the file.
+  /// \param[out] _errors Errors found while parsing the file.
+  /// \param[in] _context Context used to read the file.
+  /// \return The parsed file, or nullptr if it could not be read.
+  public: SDFPtr Read(const std::string &_filename, Errors &_errors,
+                      ParserContext &_context)
+  {
+    std::string key;
+    auto stamped = std::make_shared<Entry>();
+    if (!Stat(_filename, &key, stamped->stamp))
+    {
+      // Let readFileInternal report the problem, and don't cache the result.
+      Entry unused;
+      return this->Parse(_filename, _errors, _context, unused);
+    }
+
+    std::shared_ptr<const Entry> cached;
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      auto it = this->entries.find(key);
+      if (it != this->entries.end())
+      {
+        cached = it->second.entry;
+        it->second.lastUse = ++this->useCount;
+      }
+    }
+
+    // The files are checked without holding the lock, so that other files
+    // can be read in parallel.
+    if (cached && Unchanged(*cached, stamped->stamp))
+    {
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        ++this->hits;
+      }
+      _errors.insert(_errors.end(), cached->errors.begin(),
+          cached->errors.end());
+      _context.AddDependencies(cached->dependencies);
+      _context.AddResolvedUris(cached->uris);
+      SDFPtr includeSDF(new SDF);
+      includeSDF->Root(cached->sdf->Root()->CloneWithSharedDescriptions());
+      return includeSDF;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      ++this->misses;
+    }
+
+    // Two threads may parse the same file, then the last one wins. The
+    // cached file outlives the document, so it is not placed in the arena
+    // of the document, only its clones are.
+    {
+      ParseArena::Scope heapScope(nullptr);
+      stamped->sdf = this->Parse(_filename, stamped->errors, _context,
+          *stamped);
+    }
+    if (!stamped->sdf)
+    {
+      _errors.insert(_errors.end(), stamped->errors.begin(),
+          stamped->errors.end());
+      return SDFPtr();
+    }
+
+    SDFPtr includeSDF(new SDF);
+    includeSDF->Root(stamped->sdf->Root()->CloneWithSharedDescriptions());
+    _errors.insert(_errors.end(), stamped->errors.begin(),
+        stamped->errors.end());
+
+    // A dependency that can't be stamped can't be checked later, so the
+    // file is not cached.
+    stamped->dependencyStamps.resize(stamped->dependencies.size());
+    for (std::size_t i = 0; i < stamped->dependencies.size(); ++i)
+    {
+      if (!Stat(stamped->dependencies[i], nullptr,
+                stamped->dependencyStamps[i]))
+      {
+        return includeSDF;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->entries.size() >= kMaxEntries &&
+        this->entries.find(key) == this->entries.end())
+    {
+      auto oldest = this->entries.begin();
+      for (auto it = this->entries.begin(); it != this->entries.end(); ++it)
+      {
+        if (it->second.lastUse < oldest->second.lastUse)
+          oldest = it;
+      }
+      this->entries.erase(oldest);
+    }
+    Slot &slot = this->entries[key];
+    slot.entry = std::move(stamped);
+    slot.lastUse = ++this->useCount;
+    return includeSDF;
+  }
+
+  /// \brief Remove all files and reset the counts.
+  public: void Clear()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->entries.clear();
+    this->hits = 0;
+    this->misses = 0;
+  }
+
+  /// \brief Get the number of cache hits.
+  /// \return Number of hits.
+  public: std::size_t Hits()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->hits;
+  }
+
+  /// \brief Get the number of cache misses.
+  /// \return Number of misses.
+  public: std::size_t Misses()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->misses;
+  }
+
+  /// \brief Parse a file.
+  /// \param[in] _filename Path of the file.
+  /// \param[out] _errors Errors found while parsing the file.
+  /// \param[in] _context Context used to read the file.
+  /// \param[out] _entry Entry whose dependencies and uris are set to the
+  /// files read and the URIs resolved to parse the file, which are also
+  /// recorded in _context.
+  /// \return The parsed file, or nullptr if it could not be read.
+  private: SDFPtr Parse(const std::string &_filename, Errors &_errors,
+                        ParserContext &_context, Entry &_entry)
+  {
+    // Record the files of this file separately, so that a later hit can
+    // report them.
+    ParserContext fileContext(_context);
+    fileContext.TrackDependencies();
+
+    SDFPtr includeSDF = _context.CreateIncludeSDF();
+    const bool read = readFileInternal(_filename, includeSDF, true, _errors,
+        fileContext);
+    _entry.dependencies = fileContext.Dependencies();
+    _entry.uris = fileContext.ResolvedUris();
+    _context.AddDependencies(_entry.dependencies);
+    _context.AddResolvedUris(_entry.uris);
+    if (!read)
+      return SDFPtr();
+    return includeSDF;
+  }
+
+  /// \brief Check whether a cached file and its dependencies are unchanged.
+  /// \param[in] _entry The cached file.
+  /// \param[in] _stamp Current stamp of the file.
+  /// \return True if the file and all its dependencies have the stamps
+  /// they had when the file was parsed, and its URIs resolve to the same
+  /// paths.
+  private: static bool Unchanged(const Entry &_entry, const FileStamp &_stamp)
+  {
+    if (_entry.stamp.mtime != _stamp.mtime || _entry.stamp.size != _stamp.size)
+      return false;
+
+    for (std::size_t i = 0; i < _entry.dependencies.size(); ++i)
+    {
+      FileStamp stamp;
+      if (!Stat(_entry.dependencies[i], nullptr, stamp) ||
+          stamp.mtime != _entry.dependencyStamps[i].mtime ||
+          stamp.size != _entry.dependencyStamps[i].size)
+      {
+        return false;
+      }
+    }
+
+    for (const auto &[uri, path] : _entry.uris)
+    {
+      if (sdf::findFile(uri, true, true) != path)
+        return false;
+    }
+    return true;
+  }
+
+  /// \brief Get the modification time and size of a file, and optionally
+  /// its cache key.
+  /// \param[in] _filename Path of the file.
+  /// \param[out] _key Canonical path of the file, or nullptr.
+  /// \param[out] _stamp Modification time and size of the file.
+  /// \return False if the file does not exist.
+  private: static bool Stat(const std::string &_filename, std::string *_key,
+                            FileStamp &_stamp)
+  {
+#ifndef _WIN32
+    struct stat fileStat;
+    if (_filename.empty() || ::stat(_filename.c_str(), &fileStat) != 0)
+      return false;
+
+    if (_key)
+    {
+      char *canonical = ::realpath(_filename.c_str(), nullptr);
+      *_key = canonical ? canonical : _filename;
+      free(canonical);
+    }
+
+#if defined(__APPLE__)
+    _stamp.mtime = static_cast<std::int64_t>(fileStat.st_mtimespec.tv_sec) *
+        1000000000 + fileStat.st_mtimespec.tv_nsec;
+#else
+    _stamp.mtime = static_cast<std::int64_t>(fileStat.st_mtim.tv_sec) *
+        1000000000 + fileStat.st_mtim.tv_nsec;
+#endif
+#else
+    struct _stat64 fileStat;
+    if (_filename.empty() || ::_stat64(_filename.c_str(), &fileStat) != 0)
+      return false;
+
+    if (_key)
+    {
+      char *canonical = ::_fullpath(nullptr, _filename.c_str(), 0);
+      *_key = canonical ? canonical : _filename;
+      free(canonical);
+    }
+
+    _stamp.mtime = static_cast<std::int64_t>(fileStat.st_mtime);
+#endif
+    _stamp.size = static_cast<std::int64_t>(fileStat.st_size);
+    return true;
+  }
+
+  /// \brief Mutex that protects the members below.
+  private: std::mutex mutex;
+
+  /// \brief The cached files, by canonical path.
+  private: std::unordered_map<std::string, Slot> entries;
+
+  /// \brief Number of reads and stores of entries, which orders their
+  /// last uses.
+  private: std::uint64_t useCount = 0;
+
+  /// \brief Number of cache hits.
+  private: std::size_t hits = 0;
+
+  /// \brief Number of cache misses.
+  private: std::size_t misses = 0;
+};
+
+//////////////////////////////////////////////////
+void clearIncludeCache()
+{
+  IncludeCache::Instance().Clear();
+}
+
+//////////////////////////////////////////////////
+std::size_t includeCacheHits()
+{
+  return IncludeCache::Instance().Hits();
+}
+
+//////////////////////////////////////////////////
+std::size_t includeCacheMisses()
+{
+  return IncludeCache::Instance().Misses();
+}
+
+//////////////////////////////////////////////////
+/// \brief The file of an <include> element, read by loadInclude.
+struct IncludeFile
+{
+  /// \brief Errors found while resolving the URI.
+  Errors errors;
+
+  /// \brief True if the URI was resolved. Otherwise the include is skipped.
+  bool resolved = false;
+
+  /// \brief Path of the included file.
+  std::string filename;
+
+  /// \brief The parsed file, or nullptr if it could not be read.
+  SDFPtr sdf;
+
+  /// \brief Errors found while reading the file.
+  Errors readErrors;
+
+  /// \brief Exception thrown while loading the file on a worker thread,
+  /// which is rethrown when the include is inserted.
+  std::exception_ptr exception;
+};
+
+//////////////////////////////////////////////////
+/// \brief Resolve the URI of an <include> element and read its file.
+/// \param[in] _includeXml The <include> element.
+/// \param[in] _context Context used to read the file.
+/// \return The included file.
+static IncludeFile loadInclude(XmlElementRef _includeXml,
+    ParserContext &_context)
+{
+  IncludeFile include;
+
+  if (!_includeXml.FirstChildElement("uri"))
+  {
+    include.errors.push_back({ErrorCode::ATTRIBUTE_MISSING,
+        "<include> element missing 'uri' attribute"});
+    return include;
+  }
+
+  std::string uri(_includeXml.FirstChildElement("uri").Text());
+  std::string modelPath = sdf::findFile(uri, true, true);
+  _context.AddResolvedUri(uri, modelPath);
+
+  // Test the model path
+  if (modelPath.empty())
+  {
+    include.errors.push_back({ErrorCode::URI_LOOKUP,
+        "Unable to find uri[" + uri + "]"});
+
+    size_t modelFound = uri.find("model://");
+    if (modelFound != 0u)
+    {
+      include.errors.push_back({ErrorCode::URI_INVALID,
+          "Invalid uri[" + uri + "]. Should be model://" + uri});
+    }
+    return include;
+  }
+  else if (!sdf::filesystem::is_directory(modelPath))
+  {
+    include.errors.push_back({ErrorCode::DIRECTORY_NONEXISTANT,
+        "Directory doesn't exist[" + modelPath + "]"});
+    return include;
+  }
+
+  // Get the config.xml filename
+  addModelConfigDependency(modelPath, _context);
+  include.filename = getModelFilePath(modelPath);
+  include.resolved = true;
+
+  if (_context.Config().CacheIncludes())
+  {
+    include.sdf = IncludeCache::Instance().Read(include.filename,
+        include.readErrors, _context);
+  }
+  else
+  {
+    include.sdf = _context.CreateIncludeSDF();
+    if (!readFileInternal(include.filename, include.sdf, true,
+          include.readErrors, _context))
+    {
+      include.sdf.reset();
+    }
+  }
+
+  return include;
+}
+
+//////////////////////////////////////////////////
+/// \brief True on the threads that read the includes of an element in
+/// parallel. The includes of the files that they read are read serially,
+/// so that the number of threads stays within IncludeThreadCount.
+static thread_local bool g_readingIncludesInParallel = false;
+
+//////////////////////////////////////////////////
+/// \brief Read the files of the <include> children of an element on a pool
+/// of worker threads.
+/// \param[in] _xml The parent element.
+/// \param[in] _context Context used to read the files.
+/// \return The included files, in document order.
+static std::vector<IncludeFile> loadIncludesInParallel(XmlElementRef _xml,
+    ParserContext &_context)
+{
+  std::vector<XmlElementRef> includesXml;
+  for (XmlElementRef elemXml = _xml.FirstChildElement("include"); elemXml;
+       elemXml = elemXml.NextSiblingElement("include"))
+  {
+    includesXml.push_back(elemXml);
+  }
+
+  std::vector<IncludeFile> includes(includesXml.size());
+
+  std::size_t threadCount = _context.Config().IncludeThreadCount();
+  if (threadCount == 0)
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  threadCount = std::min(threadCount, includesXml.size());
+
+  // Each worker loads the next include that has not been taken yet.
+  std::atomic<std::size_t> next(0);
+  ParseArena *arena = ParseArena::Current();
+  auto worker = [&includesXml, &includes, &next, &_context, arena]()
+  {
+    ParseArena::Scope arenaScope(arena);
+    g_readingIncludesInParallel = true;
+    for (std::size_t i = next++; i < includesXml.size(); i = next++)
+    {
+      try
+      {
+        includes[i] = loadInclude(includesXml[i], _context);
+      }
+      catch(...)
+      {
+        includes[i].exception = std::current_exception();
+      }
+    }
+    g_readingIncludesInParallel = false;
+  };
+
+  /// \brief Joins the started threads, also when starting another thread
+  /// throws.
+  struct Joiner
+  {
+    /// \brief Destructor, which joins the threads.
+    public: ~Joiner()
+    {
+      for (auto &thread : this->threads)
+        thread.join();
+    }
+
+    /// \brief The started threads.
+    public: std::vector<std::thread> threads;
+  } joiner;
+
+  // The calling thread is one of the workers.
+  for (std::size_t t = 1; t < threadCount; ++t)
+    joiner.threads.emplace_back(worker);
+  worker();
+
+  return includes;
+}
+
+//////////////////////////////////////////////////
+/// \brief Warn if an element is deprecated.
+/// \param[in] _sdf The element.
+static void warnIfDeprecated(ElementPtr _sdf)
+{
+  if (_sdf->GetRequired() == "-1")
+  {
+    sdfwarn << "SDF Element[" + _sdf->GetName() + "] is deprecated\n";
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Read the value and the attributes of an element, which readXml
+/// does before reading its child elements.
+/// \param[in] _xml The XML element.
+/// \param[in] _sdf The SDF element.
+/// \param[out] _errors Errors found while reading.
+/// \return False if the value or an attribute is invalid, or if a required
+/// attribute is missing.
+static bool readXmlValues(XmlElementRef _xml, ElementPtr _sdf,
+    Errors &_errors)
+{
+  if (_xml.HasText() && _sdf->GetValue())
+  {
+    if (!_sdf->GetValue()->SetFromString(std::string(_xml.Text())))
+      return false;
+  }
+
+  // check for nested sdf
+  std::string refSDFStr = _sdf->ReferenceSDF();
+  if (!refSDFStr.empty())
+  {
+    ElementPtr refSDF;
+    refSDF.reset(new Element);
+    std::string refFilename = refSDFStr + ".sdf";
+    initFile(refFilename, refSDF);
+    _sdf->RemoveFromParent();
+    _sdf->Copy(refSDF);
+  }
+
+  XmlAttributeRef attribute = _xml.FirstAttribute();
+
+  unsigned int i = 0;
+
+  // Iterate over all the attributes defined in the give XML element
+  while (attribute)
+  {
+    const std::string attributeName(attribute.Name());
+
+    // Avoid printing a warning message for missing attributes if a namespaced
+    // attribute is found
+    if (attributeName.find(':') != std::string::npos)
+    {
+      _sdf->AddAttribute(attributeName, "string", "", 1, "");
+      _sdf->GetAttribute(attributeName)->SetFromString(
+          std::string(attribute.Value()));
+      attribute = attribute.Next();
+      continue;
+    }
+    // Find the matching attribute in SDF
+    ParamPtr p = _sdf->GetAttribute(attributeName);
+    if (p)
+    {
+      // Set the value of the SDF attribute
+      if (!p->SetFromString(std::string(attribute.Value())))
+      {
+        _errors.push_back({ErrorCode::ATTRIBUTE_INVALID,
+            "Unable to read attribute[" + p->GetKey() + "]"});
+        return false;
+      }
+    }
+    else
+    {
+      sdfwarn << "XML Attribute[" << attributeName
+              << "] in element[" << _xml.Name()
+              << "] not defined in SDF, ignoring.\n";
+    }
+
+    attribute = attribute.Next();
+  }
+
+  // Check that all required attributes have been set
+  for (i = 0; i < _sdf->GetAttributeCount(); ++i)
+  {
+    ParamPtr p = _sdf->GetAttribute(i);
+    if (p->GetRequired() && !p->GetSet())
+    {
+      _errors.push_back({ErrorCode::ATTRIBUTE_MISSING,
+          "Required attribute[" + p->GetKey() + "] in element[" +
+          std::string(_xml.Name()) + "] is not specified in SDF."});
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Insert the top level element of an included file, which readXml
+/// does for each <include> child element.
+/// \param[in] _includeXml The <include> element.
+/// \param[in] _include The included file, from loadInclude.
+/// \param[in] _sdf The parent of the <include> element.
+/// \param[out] _errors Errors found while inserting.
+/// \param[in] _context Context used to read the <plugin> elements.
+/// \return False if the file could not be read, or a plugin is invalid.
+/// Includes that are skipped with an error return true.
+static bool insertInclude(XmlElementRef _includeXml, IncludeFile &_include,
+    ElementPtr _sdf, Errors &_errors, ParserContext &_context)
+{
+  if (_include.exception)
+    std::rethrow_exception(_include.exception);
+
+  _errors.insert(_errors.end(), _include.errors.begin(),
+      _include.errors.end());
+  if (!_include.resolved)
+    return true;
+
+  // Output errors, like readFile
+  for (auto const &e : _include.readErrors)
+    std::cerr << e << std::endl;
+
+  if (!_include.sdf)
+  {
+    _errors.push_back({ErrorCode::FILE_READ,
+        "Unable to read file[" + _include.filename + "]"});
+    return false;
+  }
+
+  SDFPtr includeSDF = _include.sdf;
+
+  sdf::ElementPtr topLevelElem;
+  bool isModel{false};
+  bool isActor{false};
+  if (includeSDF->Root()->HasElement("model"))
+  {
+    topLevelElem = includeSDF->Root()->GetElement("model");
+    isModel = true;
+  }
+  else if (includeSDF->Root()->HasElement("actor"))
+  {
+    topLevelElem = includeSDF->Root()->GetElement("actor");
+    isActor = true;
+  }
+  else if (includeSDF->Root()->HasElement("light"))
+  {
+    topLevelElem = includeSDF->Root()->GetElement("light");
+  }
+  else
+  {
+    _errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Failed to find top level <model> / <actor> / <light> for "
+        "<include>\n"});
+    return true;
+  }
+
+  if (_includeXml.FirstChildElement("name"))
+  {
+    topLevelElem->GetAttribute("name")->SetFromString(
+          std::string(_includeXml.FirstChildElement("name").Text()));
+  }
+
+  XmlElementRef poseElemXml = _includeXml.FirstChildElement("pose");
+  if (poseElemXml)
+  {
+    sdf::ElementPtr poseElem = topLevelElem->GetElement("pose");
+
+    if (poseElemXml.HasText())
+    {
+      poseElem->GetValue()->SetFromString(std::string(poseElemXml.Text()));
+    }
+    else
+    {
+      poseElem->GetValue()->Reset();
+    }
+
+    XmlAttributeRef relativeTo = poseElemXml.Attribute("relative_to");
+    if (relativeTo)
+    {
+      poseElem->GetAttribute("relative_to")->SetFromString(
+          std::string(relativeTo.Value()));
+    }
+    else
+    {
+      poseElem->GetAttribute("relative_to")->Reset();
+    }
+  }
+
+  if (isModel && _includeXml.FirstChildElement("static"))
+  {
+    topLevelElem->GetElement("static")->GetValue()->SetFromString(
+          std::string(_includeXml.FirstChildElement("static").Text()));
+  }
+
+  if (isModel || isActor)
+  {
+    for (XmlElementRef childElemXml = _includeXml.FirstChildElement();
+         childElemXml; childElemXml = childElemXml.NextSiblingElement())
+    {
+      if (childElemXml.Name() == "plugin")
+      {
+        sdf::ElementPtr pluginElem;
+        pluginElem = topLevelElem->AddElement("plugin");
+
+        if (!readXml(childElemXml, pluginElem, _errors, _context))
+        {
+          _errors.push_back({ErrorCode::ELEMENT_INVALID,
+                             "Error reading plugin element"});
+          return false;
+        }
+      }
+    }
+  }
+
+  if (_sdf->GetName() == "model")
+  {
+    addNestedModel(_sdf, includeSDF->Root(), _errors);
+  }
+  else
+  {
+    includeSDF->Root()->GetFirstElement()->SetParent(_sdf);
+    _sdf->InsertElement(includeSDF->Root()->GetFirstElement());
+    // TODO: This was used to store the included filename so that when
+    // a world is saved, the included model's SDF is not stored in the
+    // world file. This highlights the need to make model inclusion
+    // a core feature of SDF, and not a hack that that parser handles
+    // includeSDF->Root()->GetFirstElement()->SetInclude(
+    // _includeXml->Attribute("filename"));
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Add the required child elements that are missing, which readXml
+/// does after reading the child elements.
+/// \param[in] _sdf The element.
+/// \param[out] _errors Errors found while checking.
+/// \return False if a required element of a joint is missing.
+static bool addRequiredElements(ElementPtr _sdf, Errors &_errors)
+{
+  for (unsigned int descCounter = 0;
+       descCounter != _sdf->GetElementDescriptionCount(); ++descCounter)
+  {
+    ElementPtr elemDesc = _sdf->GetElementDescription(descCounter);
+
+    if (elemDesc->GetRequired() == "1" || elemDesc->GetRequired() == "+")
+    {
+      if (!_sdf->HasElement(elemDesc->GetName()))
+      {
+        if (_sdf->GetName() == "joint" &&
+            _sdf->Get<std::string>("type") != "ball")
+        {
+          _errors.push_back({ErrorCode::ELEMENT_MISSING,
+              "XML Missing required element[" + elemDesc->GetName() +
+              "], child of element[" + _sdf->GetName() + "]"});
+          return false;
+        }
+        else
+        {
+          // Add default element
+          _sdf->AddElement(elemDesc->GetName());
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Read a child XML element into an element, like readXml does for
+/// each of its children. An <include> inserts the top level element of the
+/// included file, an element of the specification is read into a new child,
+/// and unknown elements are left to copyChildren.
+/// \param[in] _elemXml The child XML element.
+/// \param[in,out] _sdf The element to insert the child into.
+/// \param[in] _include The file of an <include> that was read in advance,
+/// or nullptr to read it now.
+/// \param[out] _errors Captures errors found during parsing.
+/// \param[in] _context Context used to read included files.
+/// \return True on success, false on error.
+static bool readXmlChild(XmlElementRef _elemXml, ElementPtr _sdf,
+    IncludeFile *_include, Errors &_errors, ParserContext &_context)
+{
+  if (_elemXml.Name() == "include")
+  {
+    if (_include)
+      return insertInclude(_elemXml, *_include, _sdf, _errors, _context);
+
+    IncludeFile include = loadInclude(_elemXml, _context);
+    return insertInclude(_elemXml, include, _sdf, _errors, _context);
+  }
+
+  // Find the matching element in SDF
+  ElementPtr elemDesc =
+      _sdf->GetElementDescription(std::string(_elemXml.Name()));
+  if (elemDesc)
+  {
+    ElementPtr element = elemDesc->CloneWithSharedDescriptions();
+    element->SetParent(_sdf);
+    if (readXml(_elemXml, element, _errors, _context))
+    {
+      _sdf->InsertElement(element);
+    }
+    else
+    {
+      _errors.push_back({ErrorCode::ELEMENT_INVALID,
+          "Error reading element <" + std::string(_elemXml.Name()) + ">"});
+      return false;
+    }
+  }
+  else
+  {
+    sdfdbg << "XML Element[" << _elemXml.Name()
+           << "], not defined in SDF. Copying[" << _elemXml.Name() << "] "
+           << "as children of [" << _sdf->GetName() << "].\n";
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Read an XML element like readXml, reading each of its children
+/// with a function.
+/// \param[in] _xml The XML element, of either XML backend.
+/// \param[in,out] _sdf SDF pointer to parse data into.
+/// \param[out] _errors Captures errors found during parsing.
+/// \param[in] _readChild Function that reads a child XML element into _sdf,
+/// and returns false on error.
+/// \return True on success, false on error.
+static bool readXmlElement(XmlElementRef _xml, ElementPtr _sdf,
+    Errors &_errors, const std::function<bool(XmlElementRef)> &_readChild)
+{
+  // Check if the element pointer is deprecated.
+  warnIfDeprecated(_sdf);
+
+  if (!_xml)
+  {
+    if (_sdf->GetRequired() == "1" || _sdf->GetRequired() =="+")
+    {
+      _errors.push_back({ErrorCode::ELEMENT_MISSING,
           "SDF Element<" + _sdf->GetName() + "> is missing"});
       return false;
     }
-    else
+    else
+    {
+      return true;
+    }
+  }
+
+  if (!readXmlValues(_xml, _sdf, _errors))
+    return false;
+
+  if (_sdf->GetCopyChildren())
+  {
+    copyChildren(_sdf, _xml, false);
+  }
+  else
+  {
+    // Iterate over all the child elements
+    XmlElementRef elemXml;
+    for (elemXml = _xml.FirstChildElement(); elemXml;
+         elemXml = elemXml.NextSiblingElement())
+    {
+      if (!_readChild(elemXml))
+        return false;
+    }
+
+    // Copy unknown elements outside the loop so it only happens one time
+    copyChildren(_sdf, _xml, true);
+
+    // Check that all required elements have been set
+    if (!addRequiredElements(_sdf, _errors))
+      return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool readXml(XmlElementRef _xml, ElementPtr _sdf, Errors &_errors,
+             ParserContext &_context)
+{
+  // Read the files of all includes up front if they are read in parallel.
+  // They are inserted in document order, like serial reads.
+  std::vector<IncludeFile> parallelIncludes;
+  if (_xml && !_sdf->GetCopyChildren() &&
+      _context.Config().ParallelIncludes() && !g_readingIncludesInParallel)
+  {
+    parallelIncludes = loadIncludesInParallel(_xml, _context);
+  }
+  std::size_t includeIndex = 0;
+
+  return readXmlElement(_xml, _sdf, _errors, [&](XmlElementRef _elemXml)
+  {
+    IncludeFile *include = nullptr;
+    if (_elemXml.Name() == "include" && !parallelIncludes.empty())
+      include = &parallelIncludes[includeIndex++];
+    return readXmlChild(_elemXml, _sdf, include, _errors, _context);
+  });
+}
+
+//////////////////////////////////////////////////
+/// \brief Hashes of the contents of files, which IncrementalReader::Read
+/// computes once per file.
+using FileHashes = std::map<std::string, std::uint64_t>;
+
+/// \brief Files that were read, with hashes of their contents.
+using FileList = std::vector<std::pair<std::string, std::uint64_t>>;
+
+//////////////////////////////////////////////////
+/// \brief Hash a string followed by a separator, so that consecutive
+/// strings hash differently when they are split differently.
+/// \param[in] _data The string.
+/// \param[in] _hash Hash of the preceding data.
+/// \return The hash.
+static std::uint64_t hashField(std::string_view _data, std::uint64_t _hash)
+{
+  return CompiledCache::Hash(std::string_view("", 1),
+      CompiledCache::Hash(_data, _hash));
+}
+
+//////////////////////////////////////////////////
+/// \brief Hash the name, attributes and text of an XML element.
+/// \param[in] _xml The XML element.
+/// \param[in] _hash Hash of the preceding data.
+/// \return The hash.
+static std::uint64_t hashXmlValues(XmlElementRef _xml, std::uint64_t _hash)
+{
+  _hash = hashField(_xml.Name(), _hash);
+  for (XmlAttributeRef attribute = _xml.FirstAttribute(); attribute;
+       attribute = attribute.Next())
+  {
+    _hash = hashField(attribute.Name(), _hash);
+    _hash = hashField(attribute.Value(), _hash);
+  }
+  _hash = hashField("", _hash);
+  return hashField(_xml.Text(), _hash);
+}
+
+//////////////////////////////////////////////////
+/// \brief Hash an XML element and its descendants.
+/// \param[in] _xml The XML element.
+/// \param[in] _hash Hash of the preceding data.
+/// \return The hash.
+static std::uint64_t hashXml(XmlElementRef _xml,
+    std::uint64_t _hash = CompiledCache::kHashSeed)
+{
+  _hash = hashXmlValues(_xml, _hash);
+  for (XmlElementRef child = _xml.FirstChildElement(); child;
+       child = child.NextSiblingElement())
+  {
+    _hash = hashXml(child, _hash);
+  }
+  return hashField("", _hash);
+}
+
+//////////////////////////////////////////////////
+/// \brief Check whether a child of a world is read separately by
+/// IncrementalReader.
+/// \param[in] _xml The XML child of the world.
+/// \return True for models and includes.
+static bool isIncrementalChild(XmlElementRef _xml)
+{
+  return _xml.Name() == "model" || _xml.Name() == "include";
+}
+
+//////////////////////////////////////////////////
+/// \brief Hash the parts of a document that IncrementalReader does not read
+/// separately, which is everything but the models and includes at the top
+/// level of its worlds.
+/// \param[in] _sdfXml The <sdf> element of the document.
+/// \return The hash.
+static std::uint64_t hashDocument(XmlElementRef _sdfXml)
+{
+  std::uint64_t hash = hashXmlValues(_sdfXml, CompiledCache::kHashSeed);
+  for (XmlElementRef child = _sdfXml.FirstChildElement(); child;
+       child = child.NextSiblingElement())
+  {
+    if (child.Name() != "world")
+    {
+      hash = hashXml(child, hash);
+      continue;
+    }
+
+    hash = hashXmlValues(child, hash);
+    for (XmlElementRef worldChild = child.FirstChildElement(); worldChild;
+         worldChild = worldChild.NextSiblingElement())
+    {
+      if (!isIncrementalChild(worldChild))
+        hash = hashXml(worldChild, hash);
+    }
+    hash = hashField("", hash);
+  }
+  return hashField("", hash);
+}
+
+//////////////////////////////////////////////////
+/// \brief Hash the contents of a file, or get the hash computed before.
+/// \param[in] _filename Path of the file.
+/// \param[in,out] _hashes Hashes computed before.
+/// \return The hash, which is 0 if the file can't be read.
+static std::uint64_t hashFile(const std::string &_filename,
+    FileHashes &_hashes)
+{
+  auto it = _hashes.find(_filename);
+  if (it != _hashes.end())
+    return it->second;
+
+  std::uint64_t hash = 0;
+  MappedFile file;
+  if (file.Open(_filename, false))
+    hash = CompiledCache::Hash(file.Data());
+  _hashes.emplace(_filename, hash);
+  return hash;
+}
+
+//////////////////////////////////////////////////
+/// \brief Hash the contents of files.
+/// \param[in] _filenames Paths of the files.
+/// \param[in,out] _hashes Hashes computed before.
+/// \return The files with their hashes.
+static FileList hashFiles(const std::vector<std::string> &_filenames,
+    FileHashes &_hashes)
+{
+  FileList files;
+  for (const std::string &filename : _filenames)
+    files.emplace_back(filename, hashFile(filename, _hashes));
+  return files;
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that files still have the contents they were hashed with.
+/// \param[in] _files The files with their hashes.
+/// \param[in,out] _hashes Hashes computed before.
+/// \return True if none of the files changed.
+static bool filesUnchanged(const FileList &_files, FileHashes &_hashes)
+{
+  return std::all_of(_files.begin(), _files.end(),
+      [&_hashes](const std::pair<std::string, std::uint64_t> &_file)
+      {
+        return hashFile(_file.first, _hashes) == _file.second;
+      });
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that URIs still resolve to the paths they resolved to.
+/// \param[in] _uris Paths by URI.
+/// \return True if none of the URIs resolves to another path.
+static bool urisUnchanged(const std::map<std::string, std::string> &_uris)
+{
+  return std::all_of(_uris.begin(), _uris.end(),
+      [](const std::pair<const std::string, std::string> &_uri)
+      {
+        return sdf::findFile(_uri.first, true, true) == _uri.second;
+      });
+}
+
+//////////////////////////////////////////////////
+/// \brief Private data for IncrementalReader.
+class IncrementalReaderPrivate
+{
+  /// \brief A model or include at the top level of a world.
+  public: struct ChildState
+  {
+    /// \brief Hash of the XML of the child.
+    std::uint64_t hash = 0;
+
+    /// \brief Files that were read for the child.
+    FileList files;
+
+    /// \brief Paths that the URIs of includes resolved to for the child.
+    std::map<std::string, std::string> uris;
+
+    /// \brief Elements that the child was read into, which is one element,
+    /// or none for an include that inserted nothing.
+    ElementPtr_V elements;
+
+    /// \brief Errors found while reading the child.
+    Errors errors;
+  };
+
+  /// \brief A world of the document.
+  public: struct WorldState
+  {
+    /// \brief The world element.
+    ElementPtr element;
+
+    /// \brief The models and includes at the top level of the world, in
+    /// document order.
+    std::vector<ChildState> children;
+
+    /// \brief Number of elements read from each of the other children of
+    /// the world, in document order. They precede the elements that the
+    /// world adds once its children are read.
+    std::vector<std::size_t> elementCounts;
+  };
+
+  /// \brief Read the whole document, and keep its state.
+  /// \param[in] _filename Path of the file.
+  /// \param[in] _sdfXml The <sdf> element of the document.
+  /// \param[in] _config Options that control how the file is parsed.
+  /// \param[in,out] _hashes Hashes of the files read by this Read.
+  /// \param[out] _errors Errors found while parsing.
+  /// \return The document, or nullptr on error.
+  public: SDFPtr ReadAll(const std::string &_filename, XmlElementRef _sdfXml,
+              const ParserConfig &_config, FileHashes &_hashes,
+              Errors &_errors);
+
+  /// \brief Read the models and includes that changed into the document of
+  /// the previous read.
+  /// \param[in] _sdfXml The <sdf> element of the document.
+  /// \param[in] _config Options that control how the file is parsed.
+  /// \param[in,out] _hashes Hashes of the files read by this Read.
+  /// \param[out] _errors Errors found while parsing.
+  /// \return True on success. On failure, which happens if anything else
+  /// changed or a child could not be read, the document is unchanged and
+  /// the state must be read again with ReadAll.
+  public: bool ReadChanges(XmlElementRef _sdfXml, const ParserConfig &_config,
+              FileHashes &_hashes, Errors &_errors);
+
+  /// \brief Read a model or include at the top level of a world, appending
+  /// its elements to the world element.
+  /// \param[in] _xml The XML of the child.
+  /// \param[in] _world The world element.
+  /// \param[in] _context Context used to read included files.
+  /// \param[in,out] _hashes Hashes of the files read by this Read.
+  /// \param[out] _child State of the child.
+  /// \return True on success, false on error.
+  public: static bool ReadChild(XmlElementRef _xml, ElementPtr _world,
+              ParserContext &_context, FileHashes &_hashes,
+              ChildState &_child);
+
+  /// \brief Append the errors of the document to a list.
+  /// \param[out] _errors The list.
+  public: void AppendErrors(Errors &_errors) const;
+
+  /// \brief Forget the document, so that the next read is whole.
+  public: void Reset();
+
+  /// \brief Resolved path of the file.
+  public: std::string filename;
+
+  /// \brief The document, or nullptr if there is none.
+  public: SDFPtr sdf;
+
+  /// \brief Hash of the document, without the children of the worlds.
+  public: std::uint64_t hash = 0;
+
+  /// \brief Files read for the document, without the children of the
+  /// worlds.
+  public: FileList files;
+
+  /// \brief Paths that URIs resolved to for the document, without the
+  /// children of the worlds.
+  public: std::map<std::string, std::string> uris;
+
+  /// \brief Errors found while reading the document, without the children
+  /// of the worlds.
+  public: Errors errors;
+
+  /// \brief The worlds of the document, in document order.
+  public: std::vector<WorldState> worlds;
+
+  /// \brief True if the last read was partial.
+  public: bool partial = false;
+};
+
+//////////////////////////////////////////////////
+bool IncrementalReaderPrivate::ReadChild(XmlElementRef _xml,
+    ElementPtr _world, ParserContext &_context, FileHashes &_hashes,
+    ChildState &_child)
+{
+  ParserContext context(_context);
+  context.TrackDependencies();
+
+  ElementPrivate::ElementVector &elements =
+      IncrementalReader::ChildElements(*_world);
+  const std::size_t first = elements.size();
+  const bool read = readXmlChild(_xml, _world, nullptr, _child.errors,
+      context);
+
+  _child.hash = hashXml(_xml);
+  _child.files = hashFiles(context.Dependencies(), _hashes);
+  _child.uris = context.ResolvedUris();
+  _child.elements.assign(elements.begin() + first, elements.end());
+  return read;
+}
+
+//////////////////////////////////////////////////
+SDFPtr IncrementalReaderPrivate::ReadAll(const std::string &_filename,
+    XmlElementRef _sdfXml, const ParserConfig &_config, FileHashes &_hashes,
+    Errors &_errors)
+{
+  this->Reset();
+
+  ParserContext context(_config);
+  context.TrackDependencies();
+  SDFPtr sdfParsed = context.CreateIncludeSDF();
+  ParseArena::Scope arenaScope(
+      _config.UseParseArena() ? ParseArena::Of(*sdfParsed).get() : nullptr);
+
+  // Set the file and version like readDoc.
+  const std::string version(_sdfXml.Attribute("version").Value());
+  sdfParsed->SetFilePath(_filename);
+  sdfParsed->SetOriginalVersion(version);
+  ElementPtr root = sdfParsed->Root();
+  root->SetOriginalVersion(version);
+
+  // The worlds are read like readXmlChild does, except that the models and
+  // includes at their top level are read by ReadChild.
+  std::vector<WorldState> worlds;
+  Errors errors;
+  const bool read = readXmlElement(_sdfXml, root, errors,
+      [&](XmlElementRef _xml)
+  {
+    if (_xml.Name() != "world")
+      return readXmlChild(_xml, root, nullptr, errors, context);
+
+    WorldState world;
+    world.element =
+        root->GetElementDescription("world")->CloneWithSharedDescriptions();
+    world.element->SetParent(root);
+    const bool worldRead = readXmlElement(_xml, world.element, errors,
+        [&](XmlElementRef _childXml)
+    {
+      if (!isIncrementalChild(_childXml))
+      {
+        const ElementPrivate::ElementVector &elements =
+            IncrementalReader::ChildElements(*world.element);
+        const std::size_t count = elements.size();
+        const bool childRead = readXmlChild(_childXml, world.element,
+            nullptr, errors, context);
+        world.elementCounts.push_back(
+            elements.size() > count ? elements.size() - count : 0);
+        return childRead;
+      }
+
+      ChildState child;
+      if (!ReadChild(_childXml, world.element, context, _hashes, child))
+      {
+        errors.insert(errors.end(), child.errors.begin(),
+            child.errors.end());
+        return false;
+      }
+      world.children.push_back(std::move(child));
+      return true;
+    });
+
+    if (!worldRead)
+    {
+      for (const ChildState &child : world.children)
+        errors.insert(errors.end(), child.errors.begin(), child.errors.end());
+      errors.push_back({ErrorCode::ELEMENT_INVALID,
+          "Error reading element <world>"});
+      return false;
+    }
+    root->InsertElement(world.element);
+    worlds.push_back(std::move(world));
+    return true;
+  });
+
+  if (!read)
+  {
+    for (const WorldState &world : worlds)
+    {
+      for (const ChildState &child : world.children)
+        errors.insert(errors.end(), child.errors.begin(), child.errors.end());
+    }
+    _errors.insert(_errors.end(), errors.begin(), errors.end());
+    _errors.push_back({ErrorCode::ELEMENT_INVALID,
+        "Error reading element <" + root->GetName() + ">"});
+    return SDFPtr();
+  }
+
+  this->filename = _filename;
+  this->sdf = sdfParsed;
+  this->hash = hashDocument(_sdfXml);
+  this->files = hashFiles(context.Dependencies(), _hashes);
+  this->uris = context.ResolvedUris();
+  this->errors = std::move(errors);
+  this->worlds = std::move(worlds);
+  this->AppendErrors(_errors);
+  return sdfParsed;
+}
+
+//////////////////////////////////////////////////
+bool IncrementalReaderPrivate::ReadChanges(XmlElementRef _sdfXml,
+    const ParserConfig &_config, FileHashes &_hashes, Errors &_errors)
+{
+  if (hashDocument(_sdfXml) != this->hash ||
+      !filesUnchanged(this->files, _hashes) || !urisUnchanged(this->uris))
+  {
+    return false;
+  }
+
+  // The elements that are replaced would stay in the arena of the document
+  // until it is destroyed, so the changes are read on the heap.
+  ParserContext context(_config);
+  ParseArena::Scope arenaScope(nullptr);
+
+  // Read the children that changed, which appends them to the world
+  // elements. The previous children are restored if one can't be read.
+  std::vector<ElementPrivate::ElementVector> previousElements;
+  std::vector<std::unordered_set<const Element *>> replaced;
+  std::vector<std::vector<ChildState>> children;
+  std::vector<XmlElementRef> worldsXml;
+  bool read = true;
+  XmlElementRef worldXml = _sdfXml.FirstChildElement("world");
+  for (WorldState &world : this->worlds)
+  {
+    if (!worldXml)
+    {
+      read = false;
+      break;
+    }
+    worldsXml.push_back(worldXml);
+
+    previousElements.push_back(
+        IncrementalReader::ChildElements(*world.element));
+    replaced.emplace_back();
+    for (const ChildState &child : world.children)
+    {
+      for (const ElementPtr &element : child.elements)
+        replaced.back().insert(element.get());
+    }
+    children.emplace_back();
+
+    // The previous children by hash, in reverse document order, so that
+    // identical children are reused in order.
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> previous;
+    for (std::size_t i = world.children.size(); i-- > 0;)
+      previous[world.children[i].hash].push_back(i);
+
+    for (XmlElementRef childXml = worldXml.FirstChildElement();
+         childXml && read; childXml = childXml.NextSiblingElement())
+    {
+      if (!isIncrementalChild(childXml))
+        continue;
+
+      auto it = previous.find(hashXml(childXml));
+      if (it != previous.end())
+      {
+        std::vector<std::size_t> &candidates = it->second;
+        auto reused = std::find_if(candidates.rbegin(), candidates.rend(),
+            [&](std::size_t _index)
+            {
+              const ChildState &previousChild = world.children[_index];
+              return filesUnchanged(previousChild.files, _hashes) &&
+                  urisUnchanged(previousChild.uris);
+            });
+        if (reused != candidates.rend())
+        {
+          children.back().push_back(std::move(world.children[*reused]));
+          candidates.erase(std::next(reused).base());
+          continue;
+        }
+      }
+
+      ChildState child;
+      read = ReadChild(childXml, world.element, context, _hashes, child);
+      children.back().push_back(std::move(child));
+    }
+
+    if (!read)
+      break;
+    worldXml = worldXml.NextSiblingElement("world");
+  }
+
+  if (!read)
+  {
+    for (std::size_t w = 0; w < previousElements.size(); ++w)
+    {
+      ElementPtr &element = this->worlds[w].element;
+      IncrementalReader::ChildElements(*element) =
+          std::move(previousElements[w]);
+      IncrementalReader::RebuildElementIndex(*element);
+    }
+    return false;
+  }
+
+  // Order the elements like a whole read would. The other children of the
+  // world didn't change, so their elements are taken in order from the
+  // previous elements, and the elements of each model and include are put
+  // where its XML is. The elements that the world added last follow.
+  // Then detach the elements that were replaced.
+  for (std::size_t w = 0; w < this->worlds.size(); ++w)
+  {
+    WorldState &world = this->worlds[w];
+    ElementPtr_V kept;
+    for (const ElementPtr &element : previousElements[w])
+    {
+      if (replaced[w].count(element.get()) == 0)
+        kept.push_back(element);
+    }
+
+    ElementPrivate::ElementVector result;
+    result.reserve(kept.size() + children[w].size());
+    auto nextKept = kept.begin();
+    auto nextChild = children[w].begin();
+    auto nextCount = world.elementCounts.begin();
+    for (XmlElementRef childXml = worldsXml[w].FirstChildElement(); childXml;
+         childXml = childXml.NextSiblingElement())
+    {
+      if (isIncrementalChild(childXml))
+      {
+        result.insert(result.end(), nextChild->elements.begin(),
+            nextChild->elements.end());
+        ++nextChild;
+      }
+      else if (nextCount != world.elementCounts.end())
+      {
+        const std::size_t count = std::min(*nextCount++,
+            static_cast<std::size_t>(kept.end() - nextKept));
+        result.insert(result.end(), nextKept, nextKept + count);
+        nextKept += count;
+      }
+    }
+    result.insert(result.end(), nextKept, kept.end());
+
+    for (const ChildState &child : children[w])
+    {
+      for (const ElementPtr &element : child.elements)
+        replaced[w].erase(element.get());
+    }
+    for (const ElementPtr &element : previousElements[w])
+    {
+      if (replaced[w].count(element.get()) > 0)
+        element->SetParent(ElementPtr());
+    }
+
+    IncrementalReader::ChildElements(*world.element) = std::move(result);
+    IncrementalReader::RebuildElementIndex(*world.element);
+    world.children = std::move(children[w]);
+  }
+
+  this->AppendErrors(_errors);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void IncrementalReaderPrivate::AppendErrors(Errors &_errors) const
+{
+  _errors.insert(_errors.end(), this->errors.begin(), this->errors.end());
+  for (const WorldState &world : this->worlds)
+  {
+    for (const ChildState &child : world.children)
+      _errors.insert(_errors.end(), child.errors.begin(), child.errors.end());
+  }
+}
+
+//////////////////////////////////////////////////
+void IncrementalReaderPrivate::Reset()
+{
+  this->filename.clear();
+  this->sdf.reset();
+  this->hash = 0;
+  this->files.clear();
+  this->uris.clear();
+  this->errors.clear();
+  this->worlds.clear();
+}
+
+//////////////////////////////////////////////////
+IncrementalReader::IncrementalReader()
+  : dataPtr(std::make_unique<IncrementalReaderPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+IncrementalReader::~IncrementalReader() = default;
+
+//////////////////////////////////////////////////
+SDFPtr IncrementalReader::Read(const std::string &_filename,
+    const ParserConfig &_config, Errors &_errors)
+{
+  IncrementalReaderPrivate &data = *this->dataPtr;
+  data.partial = false;
+
+  // Resolve the file like readFileInternal does.
+  std::string filename = sdf::findFile(_filename, true, true);
+  if (!filename.empty() && filesystem::is_directory(filename))
+    filename = getModelFilePath(filename);
+
+  MappedFile file;
+  ParserXmlDocument xmlDoc;
+  XmlElementRef sdfXml;
+  if (!filename.empty() && file.Open(filename))
+  {
+    xmlDoc.Parse(file.CStr());
+    if (!xmlDoc.Error())
+      sdfXml = XmlElementRef(xmlDoc.FirstChildElement("sdf"));
+  }
+
+  // Other files, such as URDF files, invalid files and documents that must
+  // be converted, are read by readFile, and read whole the next time.
+  XmlAttributeRef version =
+      sdfXml ? sdfXml.Attribute("version") : XmlAttributeRef();
+  if (!version || version.Value() != SDF::Version())
+  {
+    data.Reset();
+    return readFile(_filename, _config, _errors);
+  }
+
+  FileHashes hashes;
+  if (data.sdf && data.filename == filename &&
+      data.ReadChanges(sdfXml, _config, hashes, _errors))
+  {
+    data.partial = true;
+    return data.sdf;
+  }
+  return data.ReadAll(filename, sdfXml, _config, hashes, _errors);
+}
+
+//////////////////////////////////////////////////
+bool IncrementalReader::Partial() const
+{
+  return this->dataPtr->partial;
+}
+
+//////////////////////////////////////////////////
+ElementPrivate::ElementVector &IncrementalReader::ChildElements(
+    Element &_element)
+{
+  return _element.dataPtr->elements;
+}
+
+//////////////////////////////////////////////////
+void IncrementalReader::RebuildElementIndex(Element &_element)
+{
+  _element.RebuildElementIndex();
+}
+
+/////////////////////////////////////////////////
+static void replace_all(std::string &_str,
+                        const std::string &_from,
+                        const std::string &_to)
+{
+  if (_from.empty())
+  {
+    return;
+  }
+  size_t start_pos = 0;
+  while ((start_pos = _str.find(_from, start_pos)) != std::string::npos)
+  {
+    _str.replace(start_pos, _from.length(), _to);
+    // We need to advance our starting position beyond what we
+    // just replaced to deal with the case where the '_to' string
+    // happens to contain a piece of '_from'.
+    start_pos += _to.length();
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Copy a child element, which copyChildren does for each child.
+/// \param[in] _sdf The parent SDF element.
+/// \param[in] _xml The child XML element.
+/// \param[in] _onlyUnknown True to copy the child only if it isn't
+/// described in the parent.
+static void copyChild(ElementPtr _sdf, XmlElementRef _xml,
+    const bool _onlyUnknown)
+{
+  std::string elem_name(_xml.Name());
+
+  if (_sdf->HasElementDescription(elem_name))
+  {
+    if (!_onlyUnknown)
+    {
+      sdf::ElementPtr element = _sdf->AddElement(elem_name);
+
+      // FIXME: copy attributes
+      for (XmlAttributeRef attribute = _xml.FirstAttribute();
+           attribute; attribute = attribute.Next())
+      {
+        element->GetAttribute(std::string(attribute.Name()))->SetFromString(
+          std::string(attribute.Value()));
+      }
+
+      // copy value
+      std::string value(_xml.Text());
+      if (!value.empty())
+      {
+        element->GetValue()->SetFromString(value);
+      }
+      copyChildren(element, _xml, _onlyUnknown);
+    }
+  }
+  else
+  {
+    ElementPtr element = ParseArena::MakeShared<Element>();
+    element->SetParent(_sdf);
+    element->SetName(elem_name);
+    if (_xml.HasText())
     {
-      return true;
+      element->AddValue("string", std::string(_xml.Text()), "1");
+    }
+
+    for (XmlAttributeRef attribute = _xml.FirstAttribute();
+         attribute; attribute = attribute.Next())
+    {
+      const std::string attributeName(attribute.Name());
+      element->AddAttribute(attributeName, "string", "", 1, "");
+      element->GetAttribute(attributeName)->SetFromString(
+        std::string(attribute.Value()));
     }
+
+    copyChildren(element, _xml, _onlyUnknown);
+    _sdf->InsertElement(element);
   }
+}
 
-  if (_xml->GetText() != nullptr && _sdf->GetValue())
+/////////////////////////////////////////////////
+void copyChildren(ElementPtr _sdf, XmlElementRef _xml, const bool _onlyUnknown)
+{
+  // Iterate over all the child elements
+  XmlElementRef elemXml;
+  for (elemXml = _xml.FirstChildElement(); elemXml;
+       elemXml = elemXml.NextSiblingElement())
   {
-    if (!_sdf->GetValue()->SetFromString(_xml->GetText()))
-      return false;
+    copyChild(_sdf, elemXml, _onlyUnknown);
   }
+}
 
-  // check for nested sdf
-  std::string refSDFStr = _sdf->ReferenceSDF();
-  if (!refSDFStr.empty())
+#ifdef SDF_XML_INSITU
+/////////////////////////////////////////////////
+/// \brief Reads the SDF elements of a document while XmlDocument parses
+/// it, like readDoc and readXml do with a parsed document. Only the XML
+/// elements that are read as a whole, such as <include> elements, unknown
+/// elements and elements that copy their children, are kept until they
+/// end, so the document doesn't use memory for the rest.
+///
+/// The elements are read into a copy of the root element, and only moved
+/// to the SDF object by Commit, once the whole text is known to be valid
+/// XML.
+class ElementStreamReader : public XmlHandler
+{
+  /// \brief Constructor.
+  /// \param[in] _sdf SDF object to populate.
+  /// \param[in] _source Source of the document, like for readDoc.
+  /// \param[in] _convert True if the document must be converted to the
+  /// latest version, in which case it is not read.
+  /// \param[out] _errors Errors found while reading.
+  /// \param[in] _context Context used to read included files.
+  public: ElementStreamReader(SDFPtr _sdf, const std::string &_source,
+              const bool _convert, Errors &_errors, ParserContext &_context)
+    : sdf(_sdf), source(_source), convert(_convert), errors(_errors),
+      context(_context)
   {
-    ElementPtr refSDF;
-    refSDF.reset(new Element);
-    std::string refFilename = refSDFStr + ".sdf";
-    initFile(refFilename, refSDF);
-    _sdf->RemoveFromParent();
-    _sdf->Copy(refSDF);
   }
 
-  TiXmlAttribute *attribute = _xml->FirstAttribute();
+  /// \brief Check whether the document must be read by readDoc instead,
+  /// because it must be converted, or it doesn't start with an <sdf>
+  /// element with a version.
+  /// \return True if the document was not read.
+  public: bool NeedsDocument() const
+  {
+    return this->state == State::START ||
+        this->state == State::NEEDS_DOCUMENT;
+  }
 
-  unsigned int i = 0;
+  /// \brief Check whether the document was read successfully.
+  /// \return True if it was.
+  public: bool Succeeded() const
+  {
+    return this->state == State::DONE;
+  }
 
-  // Iterate over all the attributes defined in the give XML element
-  while (attribute)
+  /// \brief Move what was read to the SDF object, like readDoc would have
+  /// populated it.
+  public: void Commit()
   {
-    // Avoid printing a warning message for missing attributes if a namespaced
-    // attribute is found
-    if (std::strchr(attribute->Name(), ':') != NULL)
+    if (!this->root)
+      return;
+
+    if (this->source != "data-string")
     {
-      _sdf->AddAttribute(attribute->Name(), "string", "", 1, "");
-      _sdf->GetAttribute(attribute->Name())->SetFromString(
-          attribute->ValueStr());
-      attribute = attribute->Next();
-      continue;
+      this->sdf->SetFilePath(this->source);
     }
-    // Find the matching attribute in SDF
-    for (i = 0; i < _sdf->GetAttributeCount(); ++i)
+
+    if (this->sdf->OriginalVersion().empty())
+    {
+      this->sdf->SetOriginalVersion(this->version);
+    }
+
+    ElementPtr target = this->sdf->Root();
+    if (target->OriginalVersion().empty())
+    {
+      target->SetOriginalVersion(this->version);
+    }
+
+    for (std::size_t i = 0; i < this->root->GetAttributeCount(); ++i)
+    {
+      ParamPtr attribute = this->root->GetAttribute(i);
+      if (ParamPtr targetAttribute = target->GetAttribute(attribute->GetKey()))
+        *targetAttribute = *attribute;
+    }
+    if (this->root->GetValue() && target->GetValue())
+      *target->GetValue() = *this->root->GetValue();
+
+    for (const ElementPtr &child : this->root->Children())
+    {
+      child->SetParent(target);
+      target->InsertElement(child);
+    }
+    this->root.reset();
+  }
+
+  // Documentation inherited.
+  public: Action StartElement(const XmlElement &_xml) override
+  {
+    if (this->state == State::START)
+      return this->StartRoot(_xml);
+
+    Frame &parent = this->frames.back();
+    const std::string name(_xml.Name());
+
+    if (name == "include")
+    {
+      this->frames.push_back({FrameType::INCLUDE, name, nullptr, {}});
+      return Action::KEEP;
+    }
+
+    // Find the matching element in SDF
+    ElementPtr elemDesc = parent.sdf->GetElementDescription(name);
+    if (!elemDesc)
+    {
+      sdfdbg << "XML Element[" << name
+             << "], child of element[" << parent.name
+             << "], not defined in SDF. Copying[" << name << "] "
+             << "as children of [" << parent.name << "].\n";
+      this->frames.push_back({FrameType::UNKNOWN, name, nullptr, {}});
+      return Action::KEEP;
+    }
+
+    ElementPtr element = elemDesc->CloneWithSharedDescriptions();
+    element->SetParent(parent.sdf);
+    return this->ReadElement(_xml, element);
+  }
+
+  // Documentation inherited.
+  public: Action EndElement(const XmlElement &_xml) override
+  {
+    Frame &frame = this->frames.back();
+    switch (frame.type)
     {
-      ParamPtr p = _sdf->GetAttribute(i);
-      if (p->GetKey() == attribute->Name())
+      case FrameType::INCLUDE:
       {
-        // Set the value of the SDF attribute
-        if (!p->SetFromString(attribute->ValueStr()))
+        this->frames.pop_back();
+        Frame &parent = this->frames.back();
+        IncludeFile include = loadInclude(&_xml, this->context);
+        if (!insertInclude(&_xml, include, parent.sdf, this->errors,
+                           this->context))
         {
-          _errors.push_back({ErrorCode::ATTRIBUTE_INVALID,
-              "Unable to read attribute[" + p->GetKey() + "]"});
-          return false;
+          return this->Fail();
         }
+        return this->KeepIfUnknown(_xml);
+      }
+      case FrameType::UNKNOWN:
+      {
+        this->frames.pop_back();
+        return this->KeepIfUnknown(_xml);
+      }
+      case FrameType::COPY:
+      {
+        copyChildren(frame.sdf, &_xml, false);
+        break;
+      }
+      case FrameType::READ:
+      {
+        // Copy the unknown elements after the others, like readXml.
+        for (const XmlElement *unknown : frame.unknownChildren)
+          copyChild(frame.sdf, unknown, true);
+
+        if (!addRequiredElements(frame.sdf, this->errors))
+          return this->Fail();
         break;
       }
     }
 
-    if (i == _sdf->GetAttributeCount())
+    ElementPtr element = frame.sdf;
+    this->frames.pop_back();
+    if (this->frames.empty())
     {
-      sdfwarn << "XML Attribute[" << attribute->Name()
-              << "] in element[" << _xml->Value()
-              << "] not defined in SDF, ignoring.\n";
+      this->state = State::DONE;
+      return Action::STOP;
     }
 
-    attribute = attribute->Next();
+    this->frames.back().sdf->InsertElement(element);
+    return Action::STREAM;
   }
 
-  // Check that all required attributes have been set
-  for (i = 0; i < _sdf->GetAttributeCount(); ++i)
+  /// \brief Start reading the top level element, like readDoc.
+  /// \param[in] _xml The element.
+  /// \return What the parser does with the element.
+  private: Action StartRoot(const XmlElement &_xml)
   {
-    ParamPtr p = _sdf->GetAttribute(i);
-    if (p->GetRequired() && !p->GetSet())
+    // Leave documents that readDoc doesn't read as is to readDoc.
+    const XmlAttribute *version = _xml.Attribute("version");
+    if (_xml.Name() != "sdf" || this->sdf->Root()->GetName() != "sdf" ||
+        !version || (this->convert && version->Value() != SDF::Version()))
     {
-      _errors.push_back({ErrorCode::ATTRIBUTE_MISSING,
-          "Required attribute[" + p->GetKey() + "] in element[" + _xml->Value()
-          + "] is not specified in SDF."});
-      return false;
+      this->state = State::NEEDS_DOCUMENT;
+      return Action::STOP;
+    }
+    this->state = State::READING;
+    this->version = std::string(version->Value());
+
+    // The new children are added after the existing ones on commit, and
+    // inherit the file path and version that the root will have.
+    this->root = this->sdf->Root()->CloneWithSharedDescriptions();
+    this->root->ClearElements();
+    if (this->source != "data-string")
+    {
+      this->root->SetFilePath(this->source);
+    }
+
+    if (this->root->OriginalVersion().empty())
+    {
+      this->root->SetOriginalVersion(this->version);
     }
+
+    return this->ReadElement(_xml, this->root);
   }
 
-  if (_sdf->GetCopyChildren())
+  /// \brief Start reading an element, like readXml.
+  /// \param[in] _xml The XML element.
+  /// \param[in] _element The SDF element.
+  /// \return What the parser does with the element.
+  private: Action ReadElement(const XmlElement &_xml, ElementPtr _element)
   {
-    copyChildren(_sdf, _xml, false);
+    const FrameType type = _element->GetCopyChildren() ?
+        FrameType::COPY : FrameType::READ;
+    this->frames.push_back({type, std::string(_xml.Name()), _element, {}});
+
+    warnIfDeprecated(_element);
+    if (!readXmlValues(&_xml, _element, this->errors))
+      return this->Fail();
+
+    // The children of elements that copy them are copied as a whole.
+    return type == FrameType::COPY ? Action::KEEP : Action::STREAM;
   }
-  else
+
+  /// \brief Keep an element that ended if its parent copies it as an
+  /// unknown element, like readXml.
+  /// \param[in] _xml The element.
+  /// \return What the parser does with the element.
+  private: Action KeepIfUnknown(const XmlElement &_xml)
   {
-    std::string filename;
+    Frame &parent = this->frames.back();
+    if (parent.sdf->HasElementDescription(std::string(_xml.Name())))
+      return Action::STREAM;
 
-    // Iterate over all the child elements
-    TiXmlElement *elemXml = nullptr;
-    for (elemXml = _xml->FirstChildElement(); elemXml;
-         elemXml = elemXml->NextSiblingElement())
+    parent.unknownChildren.push_back(&_xml);
+    return Action::KEEP;
+  }
+
+  /// \brief Stop reading after an error. Like the readXml calls that
+  /// return false, each element that is being read adds an error.
+  /// \return Action::STOP.
+  private: Action Fail()
+  {
+    for (auto frame = this->frames.rbegin(); frame != this->frames.rend();
+         ++frame)
     {
-      if (std::string("include") == elemXml->Value())
-      {
-        std::string modelPath;
+      this->errors.push_back({ErrorCode::ELEMENT_INVALID,
+          "Error reading element <" + frame->name + ">"});
+    }
+    this->frames.clear();
+    this->state = State::FAILED;
+    return Action::STOP;
+  }
 
-        if (elemXml->FirstChildElement("uri"))
-        {
-          std::string uri = elemXml->FirstChildElement("uri")->GetText();
-          modelPath = sdf::findFile(uri, true, true);
+  /// \brief What is done with an element at its end.
+  private: enum class FrameType
+  {
+    /// \brief Read it like readXml, its children are streamed.
+    READ,
 
-          // Test the model path
-          if (modelPath.empty())
-          {
-            _errors.push_back({ErrorCode::URI_LOOKUP,
-                "Unable to find uri[" + uri + "]"});
+    /// \brief Copy its children, which are kept.
+    COPY,
 
-            size_t modelFound = uri.find("model://");
-            if (modelFound != 0u)
-            {
-              _errors.push_back({ErrorCode::URI_INVALID,
-                  "Invalid uri[" + uri + "]. Should be model://" + uri});
-            }
-            continue;
-          }
-          else
-          {
-            if (!sdf::filesystem::is_directory(modelPath))
-            {
-              _errors.push_back({ErrorCode::DIRECTORY_NONEXISTANT,
-                  "Directory doesn't exist[" + modelPath + "]"});
-              continue;
-            }
-          }
-
-          // Get the config.xml filename
-          filename = getModelFilePath(modelPath);
-        }
-        else
-        {
-          _errors.push_back({ErrorCode::ATTRIBUTE_MISSING,
-              "<include> element missing 'uri' attribute"});
-          continue;
-        }
+    /// \brief Insert the included file.
+    INCLUDE,
 
-        // NOTE: sdf::init is an expensive call. For performance reason,
-        // a new sdf pointer is created here by cloning a fresh sdf template
-        // pointer instead of calling init every iteration.
-        // SDFPtr includeSDF(new SDF);
-        // init(includeSDF);
-        static SDFPtr includeSDFTemplate;
-        if (!includeSDFTemplate)
-        {
-          includeSDFTemplate.reset(new SDF);
-          init(includeSDFTemplate);
-        }
-        SDFPtr includeSDF(new SDF);
-        includeSDF->Root(includeSDFTemplate->Root()->Clone());
+    /// \brief Copy it to its parent as an unknown element.
+    UNKNOWN
+  };
 
-        if (!readFile(filename, includeSDF))
-        {
-          _errors.push_back({ErrorCode::FILE_READ,
-              "Unable to read file[" + filename + "]"});
-          return false;
-        }
+  /// \brief An element that is being read.
+  private: struct Frame
+  {
+    /// \brief What is done with the element at its end.
+    FrameType type;
 
-        sdf::ElementPtr topLevelElem;
-        bool isModel{false};
-        bool isActor{false};
-        if (includeSDF->Root()->HasElement("model"))
-        {
-          topLevelElem = includeSDF->Root()->GetElement("model");
-          isModel = true;
-        }
-        else if (includeSDF->Root()->HasElement("actor"))
-        {
-          topLevelElem = includeSDF->Root()->GetElement("actor");
-          isActor = true;
-        }
-        else if (includeSDF->Root()->HasElement("light"))
-        {
-          topLevelElem = includeSDF->Root()->GetElement("light");
-        }
-        else
-        {
-          _errors.push_back({ErrorCode::ELEMENT_MISSING,
-              "Failed to find top level <model> / <actor> / <light> for "
-              "<include>\n"});
-          continue;
-        }
+    /// \brief Name of the XML element.
+    std::string name;
 
-        if (elemXml->FirstChildElement("name"))
-        {
-          topLevelElem->GetAttribute("name")->SetFromString(
-                elemXml->FirstChildElement("name")->GetText());
-        }
+    /// \brief The SDF element, if the element is read or copied.
+    ElementPtr sdf;
 
-        TiXmlElement *poseElemXml = elemXml->FirstChildElement("pose");
-        if (poseElemXml)
-        {
-          sdf::ElementPtr poseElem = topLevelElem->GetElement("pose");
-
-          if (poseElemXml->GetText())
-          {
-            poseElem->GetValue()->SetFromString(poseElemXml->GetText());
-          }
-          else
-          {
-            poseElem->GetValue()->Reset();
-          }
-
-          const char *relativeTo = poseElemXml->Attribute("relative_to");
-          if (relativeTo)
-          {
-            poseElem->GetAttribute("relative_to")->SetFromString(relativeTo);
-          }
-          else
-          {
-            poseElem->GetAttribute("relative_to")->Reset();
-          }
-        }
+    /// \brief Child elements to copy as unknown elements at the end.
+    std::vector<const XmlElement *> unknownChildren;
+  };
 
-        if (isModel && elemXml->FirstChildElement("static"))
-        {
-          topLevelElem->GetElement("static")->GetValue()->SetFromString(
-                elemXml->FirstChildElement("static")->GetText());
-        }
+  /// \brief State of the reader.
+  private: enum class State
+  {
+    /// \brief No element was started yet.
+    START,
 
-        if (isModel || isActor)
-        {
-          for (TiXmlElement *childElemXml = elemXml->FirstChildElement();
-               childElemXml; childElemXml = childElemXml->NextSiblingElement())
-          {
-            if (std::string("plugin") == childElemXml->Value())
-            {
-              sdf::ElementPtr pluginElem;
-              pluginElem = topLevelElem->AddElement("plugin");
-
-              if (!readXml(childElemXml, pluginElem, _errors))
-              {
-                _errors.push_back({ErrorCode::ELEMENT_INVALID,
-                                   "Error reading plugin element"});
-                return false;
-              }
-            }
-          }
-        }
+    /// \brief The document must be read by readDoc.
+    NEEDS_DOCUMENT,
 
-        if (_sdf->GetName() == "model")
-        {
-          addNestedModel(_sdf, includeSDF->Root(), _errors);
-        }
-        else
-        {
-          includeSDF->Root()->GetFirstElement()->SetParent(_sdf);
-          _sdf->InsertElement(includeSDF->Root()->GetFirstElement());
-          // TODO: This was used to store the included filename so that when
-          // a world is saved, the included model's SDF is not stored in the
-          // world file. This highlights the need to make model inclusion
-          // a core feature of SDF, and not a hack that that parser handles
-          // includeSDF->Root()->GetFirstElement()->SetInclude(
-          // elemXml->Attribute("filename"));
-        }
+    /// \brief Elements are being read.
+    READING,
 
-        continue;
-      }
+    /// \brief The top level element was read.
+    DONE,
 
-      // Find the matching element in SDF
-      unsigned int descCounter = 0;
-      for (descCounter = 0;
-           descCounter != _sdf->GetElementDescriptionCount(); ++descCounter)
-      {
-        ElementPtr elemDesc = _sdf->GetElementDescription(descCounter);
-        if (elemDesc->GetName() == elemXml->Value())
-        {
-          ElementPtr element = elemDesc->Clone();
-          element->SetParent(_sdf);
-          if (readXml(elemXml, element, _errors))
-          {
-            _sdf->InsertElement(element);
-          }
-          else
-          {
-            _errors.push_back({ErrorCode::ELEMENT_INVALID,
-                std::string("Error reading element <") +
-                elemXml->Value() + ">"});
-            return false;
-          }
-          break;
-        }
-      }
+    /// \brief Reading failed.
+    FAILED
+  };
 
-      if (descCounter == _sdf->GetElementDescriptionCount())
-      {
-        sdfdbg << "XML Element[" << elemXml->Value()
-               << "], child of element[" << _xml->Value()
-               << "], not defined in SDF. Copying[" << elemXml->Value() << "] "
-               << "as children of [" << _xml->Value() << "].\n";
-        continue;
-      }
-    }
+  /// \brief SDF object to populate.
+  private: SDFPtr sdf;
 
-    // Copy unknown elements outside the loop so it only happens one time
-    copyChildren(_sdf, _xml, true);
+  /// \brief Copy of the root element of the SDF object that the elements
+  /// are read into, until they are committed.
+  private: ElementPtr root;
 
-    // Check that all required elements have been set
-    for (unsigned int descCounter = 0;
-         descCounter != _sdf->GetElementDescriptionCount(); ++descCounter)
-    {
-      ElementPtr elemDesc = _sdf->GetElementDescription(descCounter);
+  /// \brief Version of the document.
+  private: std::string version;
 
-      if (elemDesc->GetRequired() == "1" || elemDesc->GetRequired() == "+")
-      {
-        if (!_sdf->HasElement(elemDesc->GetName()))
-        {
-          if (_sdf->GetName() == "joint" &&
-              _sdf->Get<std::string>("type") != "ball")
-          {
-            _errors.push_back({ErrorCode::ELEMENT_MISSING,
-                "XML Missing required element[" + elemDesc->GetName() +
-                "], child of element[" + _sdf->GetName() + "]"});
-            return false;
-          }
-          else
-          {
-            // Add default element
-            _sdf->AddElement(elemDesc->GetName());
-          }
-        }
-      }
-    }
-  }
+  /// \brief Source of the document.
+  private: const std::string &source;
 
-  return true;
-}
+  /// \brief True to convert documents to the latest version.
+  private: bool convert;
 
-/////////////////////////////////////////////////
-static void replace_all(std::string &_str,
-                        const std::string &_from,
-                        const std::string &_to)
-{
-  if (_from.empty())
-  {
-    return;
-  }
-  size_t start_pos = 0;
-  while ((start_pos = _str.find(_from, start_pos)) != std::string::npos)
-  {
-    _str.replace(start_pos, _from.length(), _to);
-    // We need to advance our starting position beyond what we
-    // just replaced to deal with the case where the '_to' string
-    // happens to contain a piece of '_from'.
-    start_pos += _to.length();
-  }
-}
+  /// \brief Errors found while reading.
+  private: Errors &errors;
 
-/////////////////////////////////////////////////
-void copyChildren(ElementPtr _sdf, TiXmlElement *_xml, const bool _onlyUnknown)
-{
-  // Iterate over all the child elements
-  TiXmlElement *elemXml = nullptr;
-  for (elemXml = _xml->FirstChildElement(); elemXml;
-       elemXml = elemXml->NextSiblingElement())
-  {
-    std::string elem_name = elemXml->ValueStr();
+  /// \brief Context used to read included files.
+  private: ParserContext &context;
 
-    if (_sdf->HasElementDescription(elem_name))
-    {
-      if (!_onlyUnknown)
-      {
-        sdf::ElementPtr element = _sdf->AddElement(elem_name);
+  /// \brief Elements that are being read, from the top level element.
+  private: std::vector<Frame> frames;
 
-        // FIXME: copy attributes
-        for (TiXmlAttribute *attribute = elemXml->FirstAttribute();
-             attribute; attribute = attribute->Next())
-        {
-          element->GetAttribute(attribute->Name())->SetFromString(
-            attribute->ValueStr());
-        }
+  /// \brief State of the reader.
+  private: State state = State::START;
+};
+#endif
 
-        // copy value
-        std::string value = elemXml->GetText();
-        if (!value.empty())
-        {
-          element->GetValue()->SetFromString(value);
-        }
-        copyChildren(element, elemXml, _onlyUnknown);
-      }
-    }
-    else
-    {
-      ElementPtr element(new Element);
-      element->SetParent(_sdf);
-      element->SetName(elem_name);
-      if (elemXml->GetText() != nullptr)
-      {
-        element->AddValue("string", elemXml->GetText(), "1");
-      }
+//////////////////////////////////////////////////
+static bool parseDoc(ParserXmlDocument &_xmlDoc, const char *_xml, SDFPtr _sdf,
+    const std::string &_source, bool _convert, Errors &_errors,
+    ParserContext &_context, bool &_xmlError)
+{
+  _xmlError = false;
 
-      for (TiXmlAttribute *attribute = elemXml->FirstAttribute();
-           attribute; attribute = attribute->Next())
-      {
-        element->AddAttribute(attribute->Name(), "string", "", 1, "");
-        element->GetAttribute(attribute->Name())->SetFromString(
-          attribute->ValueStr());
-      }
+#ifdef SDF_XML_INSITU
+  // Includes that are read in parallel are read up front for each element,
+  // which needs the document.
+  if (_sdf && _sdf->Root() && !_context.Config().ParallelIncludes())
+  {
+    // The errors are dropped if the text turns out not to be valid XML,
+    // like when the document is parsed before it is read.
+    Errors errors;
+    ElementStreamReader reader(_sdf, _source, _convert, errors, _context);
+    if (!_xmlDoc.Parse(_xml, reader))
+    {
+      _xmlError = true;
+      return false;
+    }
 
-      copyChildren(element, elemXml, _onlyUnknown);
-      _sdf->InsertElement(element);
+    if (!reader.NeedsDocument())
+    {
+      reader.Commit();
+      _errors.insert(_errors.end(), errors.begin(), errors.end());
+      return reader.Succeeded();
     }
   }
+#endif
+
+  _xmlDoc.Parse(_xml);
+  if (_xmlDoc.Error())
+  {
+    _xmlError = true;
+    return false;
+  }
+  return readDoc(_xmlDoc, _xml, _sdf, _source, _convert, _errors, _context);
 }
 
 /////////////////////////////////////////////////
@@ -1377,7 +3456,8 @@ bool convertFile(const std::string &_filename, const std::string &_version,
     if (sdf::Converter::Convert(&xmlDoc, _version, true))
     {
       Errors errors;
-      bool result = sdf::readDoc(&xmlDoc, _sdf, filename, false, errors);
+      bool result = sdf::readDoc(&xmlDoc, _sdf, filename, false, errors,
+          ParserContext::Default());
 
       // Output errors
       for (auto const &e : errors)
@@ -1424,7 +3504,8 @@ bool convertString(const std::string &_sdfString, const std::string &_version,
     if (sdf::Converter::Convert(&xmlDoc, _version, true))
     {
       Errors errors;
-      bool result = sdf::readDoc(&xmlDoc, _sdf, "data-string", false, errors);
+      bool result = sdf::readDoc(&xmlDoc, _sdf, "data-string", false,
+          errors, ParserContext::Default());
 
       // Output errors
       for (auto const &e : errors)
@@ -1603,19 +3684,28 @@ bool recursiveSameTypeUniqueNames(sdf::ElementPtr _elem)
   if (!shouldValidateElement(_elem))
     return true;
 
+  // Collect the names of each type of child in a single pass over the
+  // children, and report the types with duplicates in order.
   bool result = true;
-  auto typeNames = _elem->GetElementTypeNames();
-  for (const std::string &typeName : typeNames)
+  std::unordered_map<std::string, std::unordered_set<std::string>> typeNames;
+  std::set<std::string> duplicateTypes;
+  for (const sdf::ElementPtr &child : _elem->Children())
   {
-    if (!_elem->HasUniqueChildNames(typeName))
+    if (child->HasAttribute("name") &&
+        !typeNames[child->GetName()].insert(
+            child->Get<std::string>("name")).second)
     {
-      std::cerr << "Error: Non-unique names detected in type "
-                << typeName << " in\n"
-                << _elem->ToString("")
-                << std::endl;
-      result = false;
+      duplicateTypes.insert(child->GetName());
     }
   }
+  for (const std::string &typeName : duplicateTypes)
+  {
+    std::cerr << "Error: Non-unique names detected in type "
+              << typeName << " in\n"
+              << _elem->ToString("")
+              << std::endl;
+    result = false;
+  }
 
   sdf::ElementPtr child = _elem->GetFirstElement();
   while (child)
@@ -15,6 +15,9 @@
  *
  */
 
+#include <cstdio>
+#include <fstream>
+#include <string>
 #include <gtest/gtest.h>
 #include "sdf/parser.hh"
 #include "sdf/Element.hh"
@@ -472,6 +475,99 @@ TEST(Parser, NameUniqueness)
   }
 }
 
+/////////////////////////////////////////////////
+/// Check that repeated init calls produce independent description trees
+/// even though the embedded spec is only parsed once.
+TEST(Parser, InitSharedSpecDescription)
+{
+  sdf::SDFPtr sdf1 = InitSDF();
+  sdf::SDFPtr sdf2 = InitSDF();
+  ASSERT_NE(nullptr, sdf1->Root());
+  ASSERT_NE(nullptr, sdf2->Root());
+  EXPECT_NE(sdf1->Root(), sdf2->Root());
+
+  EXPECT_EQ("sdf", sdf1->Root()->GetName());
+  EXPECT_EQ(sdf1->Root()->GetElementDescriptionCount(),
+            sdf2->Root()->GetElementDescriptionCount());
+  EXPECT_EQ(sdf1->Root()->ToString(""), sdf2->Root()->ToString(""));
+
+  // Modifying one tree must not leak into the other or into later inits.
+  sdf::ElementPtr world1 = sdf1->Root()->GetElementDescription("world");
+  ASSERT_NE(nullptr, world1);
+  world1->SetDescription("modified");
+  sdf1->Root()->GetAttribute("version")->SetFromString("0.1");
+
+  sdf::SDFPtr sdf3 = InitSDF();
+  for (const auto &sdf : {sdf2, sdf3})
+  {
+    sdf::ElementPtr world = sdf->Root()->GetElementDescription("world");
+    ASSERT_NE(nullptr, world);
+    EXPECT_NE(world1, world);
+    EXPECT_NE("modified", world->GetDescription());
+    EXPECT_EQ(SDF_PROTOCOL_VERSION,
+              sdf->Root()->GetAttribute("version")->GetAsString());
+  }
+
+  // initFile on an element uses the same shared description.
+  sdf::ElementPtr model1(new sdf::Element);
+  sdf::ElementPtr model2(new sdf::Element);
+  EXPECT_TRUE(sdf::initFile("model.sdf", model1));
+  EXPECT_TRUE(sdf::initFile("model.sdf", model2));
+  EXPECT_EQ("model", model1->GetName());
+  EXPECT_NE(model1->GetElementDescription("link"),
+            model2->GetElementDescription("link"));
+}
+
+/////////////////////////////////////////////////
+TEST(Parser, TrailingSyntaxError)
+{
+  // The elements before the error are valid, and the include is resolved
+  // before the error is found.
+  const std::string xml =
+      "<?xml version='1.0'?>"
+      "<sdf version='" SDF_PROTOCOL_VERSION "'>"
+      "  <world name='default'>"
+      "    <include><uri>" PROJECT_SOURCE_PATH
+      "/test/integration/model/box</uri></include>"
+      "    <model name='model'><link name='link'/></model>"
+      "  </world>"
+      "</sdf>"
+      "<trailing";
+
+  // The SDF object is left as is on an XML error.
+  sdf::SDFPtr sdf = InitSDF();
+  sdf::Errors errors;
+  EXPECT_FALSE(sdf::readString(xml, sdf, errors));
+  EXPECT_FALSE(sdf->Root()->HasElement("world"));
+  EXPECT_EQ(nullptr, sdf->Root()->GetFirstElement());
+  EXPECT_TRUE(sdf->OriginalVersion().empty());
+  EXPECT_TRUE(sdf->Root()->OriginalVersion().empty());
+
+  const std::string path =
+      std::string(PROJECT_BINARY_DIR) + "/trailing_syntax_error.sdf";
+  {
+    std::ofstream file(path);
+    file << xml;
+  }
+  EXPECT_FALSE(sdf::readFile(path, sdf, errors));
+  EXPECT_EQ(nullptr, sdf->Root()->GetFirstElement());
+  EXPECT_TRUE(sdf->FilePath().empty());
+  EXPECT_TRUE(sdf->Root()->FilePath().empty());
+  EXPECT_TRUE(sdf->OriginalVersion().empty());
+
+  // The same document without the error is read.
+  const std::string validXml = xml.substr(0, xml.rfind('<'));
+  EXPECT_TRUE(sdf::readString(validXml, sdf, errors));
+  ASSERT_TRUE(sdf->Root()->HasElement("world"));
+  sdf::ElementPtr world = sdf->Root()->GetElement("world");
+  EXPECT_TRUE(world->HasElement("model"));
+  EXPECT_EQ(sdf->Root(), world->GetParent());
+  EXPECT_EQ(SDF_PROTOCOL_VERSION, sdf->OriginalVersion());
+  EXPECT_EQ(SDF_PROTOCOL_VERSION,
+            sdf->Root()->Get<std::string>("version"));
+  std::remove(path.c_str());
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
@@ -19,12 +19,21 @@
 
 #include <tinyxml.h>
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <vector>
 
+#include "sdf/ParserConfig.hh"
 #include "sdf/SDFImpl.hh"
 #include "sdf/sdf_config.h"
 #include "sdf/system_util.hh"
 
+#include "XmlDocument.hh"
+#include "XmlReader.hh"
+
 /// \ingroup sdf_parser
 /// \brief namespace for Simulation Description Format parser
 namespace sdf
@@ -33,6 +42,111 @@ namespace sdf
   inline namespace SDF_VERSION_NAMESPACE {
   //
 
+  /// \brief State shared while reading a document and the files that it
+  /// includes.
+  ///
+  /// The read functions below take a context instead of keeping state in
+  /// function-static variables. All member functions are thread-safe, so a
+  /// context can be shared by threads that read different documents at the
+  /// same time.
+  class ParserContext
+  {
+    /// \brief Constructor for a context with the default configuration.
+    public: ParserContext();
+
+    /// \brief Constructor. The context shares the include template of the
+    /// default context, so creating one per document is cheap.
+    /// \param[in] _config Options that control how documents are parsed.
+    public: explicit ParserContext(const ParserConfig &_config);
+
+    /// \brief Get the context used by the public parsing functions that do
+    /// not take a configuration.
+    /// \return The process-wide context.
+    public: static ParserContext &Default();
+
+    /// \brief Get the options that control how documents are parsed.
+    /// \return The parser configuration.
+    public: const ParserConfig &Config() const;
+
+    /// \brief Create an SDF object to read an included file into.
+    /// \return A new SDF object, initialized with the description of the
+    /// current SDF version.
+    public: SDFPtr CreateIncludeSDF();
+
+    /// \brief Start recording the files that are read with this context,
+    /// forgetting the files recorded before. Copies of the context made
+    /// afterwards record to the same list.
+    public: void TrackDependencies();
+
+    /// \brief Record a file that was read, if TrackDependencies was called.
+    /// \param[in] _filename Path of the file.
+    public: void AddDependency(const std::string &_filename);
+
+    /// \brief Record files that were read, if TrackDependencies was called.
+    /// \param[in] _filenames Paths of the files.
+    public: void AddDependencies(const std::vector<std::string> &_filenames);
+
+    /// \brief Get the files that were read since TrackDependencies was
+    /// called.
+    /// \return Paths of the files, sorted and without duplicates.
+    public: std::vector<std::string> Dependencies() const;
+
+    /// \brief Record the path that the URI of an include resolved to, if
+    /// TrackDependencies was called.
+    /// \param[in] _uri The URI.
+    /// \param[in] _path The path, or an empty string if it didn't resolve.
+    public: void AddResolvedUri(const std::string &_uri,
+                                const std::string &_path);
+
+    /// \brief Record the paths that URIs resolved to, if TrackDependencies
+    /// was called.
+    /// \param[in] _uris Paths by URI.
+    public: void AddResolvedUris(
+                const std::map<std::string, std::string> &_uris);
+
+    /// \brief Get the URIs that were resolved since TrackDependencies was
+    /// called.
+    /// \return Paths by URI.
+    public: std::map<std::string, std::string> ResolvedUris() const;
+
+    /// \brief Options that control how documents are parsed.
+    private: ParserConfig config;
+
+    /// \brief Initialized SDF object that CreateIncludeSDF clones, since
+    /// sdf::init is expensive.
+    private: struct IncludeTemplate
+    {
+      /// \brief Flag to initialize sdf only once.
+      std::once_flag flag;
+
+      /// \brief The SDF object. It is never modified after initialization,
+      /// so the clones can share its element descriptions.
+      SDFPtr sdf;
+    };
+
+    /// \brief Template for included files, which may be shared with other
+    /// contexts.
+    private: std::shared_ptr<IncludeTemplate> includeTemplate;
+
+    /// \brief Files read and URIs resolved with the context.
+    private: struct DependencyList
+    {
+      /// \brief Mutex that protects the members below, since includes may
+      /// be read in parallel.
+      std::mutex mutex;
+
+      /// \brief Paths of the files.
+      std::set<std::string> filenames;
+
+      /// \brief Paths that the URIs of includes resolved to, by URI.
+      std::map<std::string, std::string> uris;
+    };
+
+    /// \brief Files read with the context and its copies, or nullptr if they
+    /// are not recorded.
+    private: std::shared_ptr<DependencyList> dependencies;
+  };
+
   /// \brief Get the best SDF version from models supported by this sdformat
   /// \param[in] _modelXML XML element from config file pointing to the
   ///            model XML tag
@@ -53,25 +167,51 @@ namespace sdf
   /// \brief Populate the SDF values from a TinyXML document
   static bool readDoc(TiXmlDocument *_xmlDoc, SDFPtr _sdf,
                       const std::string &_source, bool _convert,
-                      Errors &_errors);
+                      Errors &_errors, ParserContext &_context);
 
   static bool readDoc(TiXmlDocument *_xmlDoc, ElementPtr _sdf,
-      const std::string &_source, bool _convert, Errors &_errors);
+      const std::string &_source, bool _convert, Errors &_errors,
+      ParserContext &_context);
+
+#ifdef SDF_XML_INSITU
+  /// \brief Populate the SDF values from an in-situ XML document.
+  /// Documents that must be converted to the current SDF version are parsed
+  /// again with TinyXML, since the converter edits a TiXmlDocument.
+  /// \param[in] _xmlDoc The parsed document.
+  /// \param[in] _xml The text that _xmlDoc was parsed from.
+  /// \param[in,out] _sdf SDF pointer to parse data into.
+  /// \param[in] _source Path of the file, or "data-string".
+  /// \param[in] _convert Convert to the latest version if true.
+  /// \param[out] _errors Captures errors found during parsing.
+  /// \param[in] _context Context used to read included files.
+  /// \return True on success, false on error.
+  static bool readDoc(const XmlDocument &_xmlDoc, const char *_xml,
+                      SDFPtr _sdf, const std::string &_source, bool _convert,
+                      Errors &_errors, ParserContext &_context);
+
+  /// \brief Populate an SDF element from an in-situ XML document.
+  /// \sa readDoc(const XmlDocument &, const char *, SDFPtr, ...)
+  static bool readDoc(const XmlDocument &_xmlDoc, const char *_xml,
+                      ElementPtr _sdf, const std::string &_source,
+                      bool _convert, Errors &_errors,
+                      ParserContext &_context);
+#endif
 
   /// \brief For internal use only. Do not use this function.
-  /// \param[in] _xml Pointer to the XML document
+  /// \param[in] _xml The XML element, of either XML backend.
   /// \param[in,out] _sdf SDF pointer to parse data into.
   /// \param[out] _errors Captures errors found during parsing.
+  /// \param[in] _context Context used to read included files.
   /// \return True on success, false on error.
-  static bool readXml(TiXmlElement *_xml, ElementPtr _sdf, Errors &_errors);
+  static bool readXml(XmlElementRef _xml, ElementPtr _sdf, Errors &_errors,
+                      ParserContext &_context);
 
   /// \brief Copy child XML elements into the _sdf element.
   /// \param[in] _sdf Parent Element.
-  /// \param[in] _xml Pointer to element from which child elements should be
-  /// copied.
+  /// \param[in] _xml Element from which child elements should be copied.
   /// \param[in] _onlyUnknown True to copy only elements that are NOT part of
   /// the SDF spec. Set this to false to copy everything.
-  static void copyChildren(ElementPtr _sdf, TiXmlElement *_xml,
+  static void copyChildren(ElementPtr _sdf, XmlElementRef _xml,
                     const bool _onlyUnknown);
   }
 }
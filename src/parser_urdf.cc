@@ -17,10 +17,12 @@
 
 #include <algorithm>
 #include <fstream>
+#include <locale>
 #include <map>
 #include <memory>
 #include <set>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -66,6 +68,13 @@ const int g_outputDecimalPrecision = 16;
 urdf::Vector3 ParseVector3(TiXmlNode* _key, double _scale = 1.0);
 urdf::Vector3 ParseVector3(const std::string &_str, double _scale = 1.0);
 
+/// \brief parse a double with the classic locale, since std::stod depends
+/// on the LC_NUMERIC locale of the process
+/// \param[in] _str string that starts with the number
+/// \return the number
+/// \throws std::invalid_argument if the string does not start with a number
+double ParseDouble(const std::string &_str);
+
 /// insert extensions into collision geoms
 void InsertSDFExtensionCollision(TiXmlElement *_elem,
                                  const std::string &_linkName);
@@ -264,6 +273,18 @@ bool URDF2SDF::IsURDF(const std::string &_filename)
   return false;
 }
 
+/////////////////////////////////////////////////
+double ParseDouble(const std::string &_str)
+{
+  std::istringstream stream(_str);
+  stream.imbue(std::locale::classic());
+  double value;
+  stream >> value;
+  if (stream.fail())
+    throw std::invalid_argument("[" + _str + "] is not a valid double");
+  return value;
+}
+
 /////////////////////////////////////////////////
 urdf::Vector3 ParseVector3(const std::string &_str, double _scale)
 {
@@ -276,7 +297,7 @@ urdf::Vector3 ParseVector3(const std::string &_str, double _scale)
     {
       try
       {
-        vals.push_back(_scale * std::stod(pieces[i]));
+        vals.push_back(_scale * ParseDouble(pieces[i]));
       }
       catch(std::invalid_argument &)
       {
@@ -1358,27 +1379,27 @@ void URDF2SDF::ParseSDFExtension(TiXmlDocument &_urdfXml)
       else if (childElem->ValueStr() == "dampingFactor")
       {
         sdf->isDampingFactor = true;
-        sdf->dampingFactor = std::stod(GetKeyValueAsString(childElem));
+        sdf->dampingFactor = ParseDouble(GetKeyValueAsString(childElem));
       }
       else if (childElem->ValueStr() == "maxVel")
       {
         sdf->isMaxVel = true;
-        sdf->maxVel = std::stod(GetKeyValueAsString(childElem));
+        sdf->maxVel = ParseDouble(GetKeyValueAsString(childElem));
       }
       else if (childElem->ValueStr() == "minDepth")
       {
         sdf->isMinDepth = true;
-        sdf->minDepth = std::stod(GetKeyValueAsString(childElem));
+        sdf->minDepth = ParseDouble(GetKeyValueAsString(childElem));
       }
       else if (childElem->ValueStr() == "mu1")
       {
         sdf->isMu1 = true;
-        sdf->mu1 = std::stod(GetKeyValueAsString(childElem));
+        sdf->mu1 = ParseDouble(GetKeyValueAsString(childElem));
       }
       else if (childElem->ValueStr() == "mu2")
       {
         sdf->isMu2 = true;
-        sdf->mu2 = std::stod(GetKeyValueAsString(childElem));
+        sdf->mu2 = ParseDouble(GetKeyValueAsString(childElem));
       }
       else if (childElem->ValueStr() == "fdir1")
       {
@@ -1387,12 +1408,12 @@ void URDF2SDF::ParseSDFExtension(TiXmlDocument &_urdfXml)
       else if (childElem->ValueStr() == "kp")
       {
         sdf->isKp = true;
-        sdf->kp = std::stod(GetKeyValueAsString(childElem));
+        sdf->kp = ParseDouble(GetKeyValueAsString(childElem));
       }
       else if (childElem->ValueStr() == "kd")
       {
         sdf->isKd = true;
-        sdf->kd = std::stod(GetKeyValueAsString(childElem));
+        sdf->kd = ParseDouble(GetKeyValueAsString(childElem));
       }
       else if (childElem->ValueStr() == "selfCollide")
       {
@@ -1418,32 +1439,32 @@ void URDF2SDF::ParseSDFExtension(TiXmlDocument &_urdfXml)
       else if (childElem->ValueStr() == "laserRetro")
       {
         sdf->isLaserRetro = true;
-        sdf->laserRetro = std::stod(GetKeyValueAsString(childElem));
+        sdf->laserRetro = ParseDouble(GetKeyValueAsString(childElem));
       }
       else if (childElem->ValueStr() == "springReference")
       {
         sdf->isSpringReference = true;
-        sdf->springReference = std::stod(GetKeyValueAsString(childElem));
+        sdf->springReference = ParseDouble(GetKeyValueAsString(childElem));
       }
       else if (childElem->ValueStr() == "springStiffness")
       {
         sdf->isSpringStiffness = true;
-        sdf->springStiffness = std::stod(GetKeyValueAsString(childElem));
+        sdf->springStiffness = ParseDouble(GetKeyValueAsString(childElem));
       }
       else if (childElem->ValueStr() == "stopCfm")
       {
         sdf->isStopCfm = true;
-        sdf->stopCfm = std::stod(GetKeyValueAsString(childElem));
+        sdf->stopCfm = ParseDouble(GetKeyValueAsString(childElem));
       }
       else if (childElem->ValueStr() == "stopErp")
       {
         sdf->isStopErp = true;
-        sdf->stopErp = std::stod(GetKeyValueAsString(childElem));
+        sdf->stopErp = ParseDouble(GetKeyValueAsString(childElem));
       }
       else if (childElem->ValueStr() == "fudgeFactor")
       {
         sdf->isFudgeFactor = true;
-        sdf->fudgeFactor = std::stod(GetKeyValueAsString(childElem));
+        sdf->fudgeFactor = ParseDouble(GetKeyValueAsString(childElem));
       }
       else if (childElem->ValueStr() == "provideFeedback")
       {
@@ -73,7 +73,7 @@ public:
       {
         try
         {
-          rgba.push_back(std::stof(pieces[i]));
+          rgba.push_back(static_cast<float>(urdf::strToDouble(pieces[i])));
         }
         catch (std::invalid_argument &/*e*/) {
           return false;
@@ -37,11 +37,32 @@
 #ifndef URDF_INTERFACE_UTILS_H
 #define URDF_INTERFACE_UTILS_H
 
+#include <locale>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 namespace urdf {
 
+// Replacement for std::stod, which depends on the LC_NUMERIC locale of the
+// process. Numbers are always parsed with the classic locale. Throws
+// std::invalid_argument like std::stod if no number can be read.
+inline
+double strToDouble(const std::string &input)
+{
+  std::istringstream stream(input);
+  stream.imbue(std::locale::classic());
+  double output;
+  stream >> output;
+  if (stream.fail())
+  {
+    throw std::invalid_argument("Failed converting [" + input +
+                                "] to a double");
+  }
+  return output;
+}
+
 // Replacement for boost::split( ... , ... , boost::is_any_of(" "))
 inline
 void split_string(std::vector<std::string> &result,
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <gtest/gtest.h>
+
+#include "sdf/Filesystem.hh"
+#include "sdf/Model.hh"
+#include "sdf/Root.hh"
+#include "sdf/SDFImpl.hh"
+#include "sdf/World.hh"
+#include "sdf/parser.hh"
+#include "test_config.h"
+
+const auto g_testPath = sdf::filesystem::append(PROJECT_SOURCE_PATH, "test");
+
+/////////////////////////////////////////////////
+std::string findFileCb(const std::string &_input)
+{
+  return sdf::filesystem::append(g_testPath, "integration", "model", _input);
+}
+
+/////////////////////////////////////////////////
+/// \brief Get a path for a binary file in the build directory.
+/// \param[in] _name Name of the file.
+/// \return Path of the file.
+std::string tempBinaryPath(const std::string &_name)
+{
+  return sdf::filesystem::append(PROJECT_BINARY_DIR, "test",
+      sdf::binaryCachePath(_name));
+}
+
+/////////////////////////////////////////////////
+/// \brief Read a file, write it in the binary format and read it back.
+/// \param[in] _filename Path of the SDF file.
+void checkRoundTrip(const std::string &_filename)
+{
+  sdf::SDFPtr parsed(new sdf::SDF());
+  ASSERT_TRUE(sdf::init(parsed));
+  sdf::Errors errors;
+  ASSERT_TRUE(sdf::readFile(_filename, parsed, errors)) << _filename;
+
+  const std::string binaryFile =
+      tempBinaryPath(sdf::filesystem::basename(_filename));
+  EXPECT_TRUE(parsed->WriteBinary(binaryFile, errors));
+  EXPECT_TRUE(errors.empty());
+
+  sdf::SDFPtr loaded(new sdf::SDF());
+  ASSERT_TRUE(sdf::init(loaded));
+  ASSERT_TRUE(sdf::readBinary(binaryFile, loaded, errors)) << _filename;
+  EXPECT_TRUE(errors.empty());
+
+  EXPECT_EQ(parsed->Root()->ToString(""), loaded->Root()->ToString(""));
+  EXPECT_EQ(parsed->FilePath(), loaded->FilePath());
+  EXPECT_EQ(parsed->OriginalVersion(), loaded->OriginalVersion());
+  EXPECT_EQ(parsed->Root()->OriginalVersion(),
+            loaded->Root()->OriginalVersion());
+
+  // Writing the loaded elements again gives the same file.
+  const std::string binaryFile2 = binaryFile + "2";
+  EXPECT_TRUE(loaded->WriteBinary(binaryFile2, errors));
+  std::ifstream in1(binaryFile, std::ios::binary);
+  std::ifstream in2(binaryFile2, std::ios::binary);
+  EXPECT_EQ(std::string(std::istreambuf_iterator<char>(in1), {}),
+            std::string(std::istreambuf_iterator<char>(in2), {}));
+
+  EXPECT_EQ(0, std::remove(binaryFile.c_str()));
+  EXPECT_EQ(0, std::remove(binaryFile2.c_str()));
+}
+
+/////////////////////////////////////////////////
+TEST(Binary, RoundTrip)
+{
+  sdf::setFindCallback(findFileCb);
+
+  checkRoundTrip(sdf::filesystem::append(g_testPath, "sdf", "includes.sdf"));
+  checkRoundTrip(
+      sdf::filesystem::append(g_testPath, "sdf", "double_pendulum.sdf"));
+  checkRoundTrip(sdf::filesystem::append(g_testPath, "integration",
+      "custom_elems_attrs.sdf"));
+  checkRoundTrip(sdf::filesystem::append(g_testPath, "integration",
+      "numeric.sdf"));
+}
+
+/////////////////////////////////////////////////
+TEST(Binary, Descriptions)
+{
+  const std::string xml =
+    "<sdf version='1.7'>"
+    "  <model name='m'>"
+    "    <link name='l'><pose>1 2 3 0 0 0.5</pose></link>"
+    "  </model>"
+    "</sdf>";
+
+  sdf::SDFPtr parsed(new sdf::SDF());
+  ASSERT_TRUE(sdf::init(parsed));
+  sdf::Errors errors;
+  ASSERT_TRUE(sdf::readString(xml, parsed, errors));
+
+  const std::string binaryFile = tempBinaryPath("descriptions.sdf");
+  ASSERT_TRUE(parsed->WriteBinary(binaryFile, errors));
+
+  sdf::SDFPtr loaded(new sdf::SDF());
+  ASSERT_TRUE(sdf::init(loaded));
+  ASSERT_TRUE(sdf::readBinary(binaryFile, loaded, errors));
+  EXPECT_EQ(0, std::remove(binaryFile.c_str()));
+
+  // The elements are described by the specification, so that missing
+  // elements have defaults and can be added.
+  sdf::ElementPtr link =
+      loaded->Root()->GetElement("model")->GetElement("link");
+  EXPECT_EQ(ignition::math::Pose3d(1, 2, 3, 0, 0, 0.5),
+            link->Get<ignition::math::Pose3d>("pose"));
+  EXPECT_TRUE(link->HasElementDescription("visual"));
+  EXPECT_FALSE(link->HasElement("gravity"));
+  EXPECT_TRUE(link->Get<bool>("gravity"));
+  EXPECT_NE(nullptr, link->AddElement("visual"));
+  EXPECT_EQ("l", link->Get<std::string>("name"));
+  EXPECT_TRUE(link->GetAttributeSet("name"));
+
+  // The DOM can be loaded from the elements.
+  sdf::Model model;
+  EXPECT_TRUE(model.Load(loaded->Root()->GetElement("model")).empty());
+  EXPECT_EQ("m", model.Name());
+  EXPECT_EQ(1u, model.LinkCount());
+}
+
+/////////////////////////////////////////////////
+TEST(Binary, Errors)
+{
+  sdf::Errors errors;
+  sdf::SDFPtr sdf(new sdf::SDF());
+  ASSERT_TRUE(sdf::init(sdf));
+  EXPECT_FALSE(sdf::readBinary("/this/file/does/not/exist.sdfb", sdf,
+      errors));
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::FILE_READ, errors[0].Code());
+
+  // A text file is not binary SDF.
+  errors.clear();
+  EXPECT_FALSE(sdf::readBinary(
+      sdf::filesystem::append(g_testPath, "sdf", "empty.sdf"), sdf, errors));
+  ASSERT_FALSE(errors.empty());
+  EXPECT_NE(std::string::npos,
+      errors[0].Message().find("not binary SDF")) << errors[0].Message();
+
+  // A truncated file is rejected.
+  sdf::SDFPtr parsed(new sdf::SDF());
+  ASSERT_TRUE(sdf::init(parsed));
+  ASSERT_TRUE(sdf::readFile(
+      sdf::filesystem::append(g_testPath, "sdf", "double_pendulum.sdf"),
+      parsed, errors));
+  const std::string binaryFile = tempBinaryPath("truncated.sdf");
+  ASSERT_TRUE(parsed->WriteBinary(binaryFile, errors));
+  std::string data;
+  {
+    std::ifstream in(binaryFile, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(in), {});
+  }
+  for (std::size_t size : {std::size_t(10), data.size() / 2,
+                           data.size() - 1})
+  {
+    {
+      std::ofstream out(binaryFile, std::ios::binary | std::ios::trunc);
+      out.write(data.data(), static_cast<std::streamsize>(size));
+    }
+    errors.clear();
+    sdf::SDFPtr truncated(new sdf::SDF());
+    ASSERT_TRUE(sdf::init(truncated));
+    EXPECT_FALSE(sdf::readBinary(binaryFile, truncated, errors)) << size;
+    EXPECT_FALSE(errors.empty());
+  }
+  EXPECT_EQ(0, std::remove(binaryFile.c_str()));
+
+  // Writing to a directory that does not exist fails.
+  errors.clear();
+  EXPECT_FALSE(parsed->WriteBinary("/this/dir/does/not/exist.sdfb", errors));
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::FILE_WRITE, errors[0].Code());
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cstdlib>
+#include <string>
+#include <gtest/gtest.h>
+
+#include "sdf/Filesystem.hh"
+#include "sdf/Model.hh"
+#include "sdf/ParserConfig.hh"
+#include "sdf/Root.hh"
+#include "sdf/World.hh"
+#include "sdf/parser.hh"
+#include "test_config.h"
+#include "test_utils.hh"
+
+const auto g_tempPath =
+    sdf::filesystem::append(PROJECT_BINARY_DIR, "test", "compiled_cache");
+
+using sdf::testing::removeDirectory;
+using sdf::testing::writeFile;
+
+/////////////////////////////////////////////////
+std::string findFileCb(const std::string &_input)
+{
+  return sdf::filesystem::append(g_tempPath, "models",
+      _input.substr(std::string("model://").size()));
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the model that the test world includes.
+/// \param[in] _pose Pose of the model.
+void writeModel(const std::string &_pose)
+{
+  writeFile(sdf::filesystem::append(g_tempPath, "models", "cached_model",
+      "model.sdf"),
+      "<sdf version='1.7'>"
+      "  <model name='cached_model'>"
+      "    <pose>" + _pose + "</pose>"
+      "    <link name='link'/>"
+      "  </model>"
+      "</sdf>");
+}
+
+/////////////////////////////////////////////////
+TEST(CompiledCache, HitsAndChanges)
+{
+  removeDirectory(g_tempPath);
+  ASSERT_TRUE(sdf::filesystem::create_directory(g_tempPath));
+  const std::string modelDir =
+      sdf::filesystem::append(g_tempPath, "models", "cached_model");
+  ASSERT_TRUE(sdf::filesystem::create_directory(
+      sdf::filesystem::append(g_tempPath, "models")));
+  ASSERT_TRUE(sdf::filesystem::create_directory(modelDir));
+  writeFile(sdf::filesystem::append(modelDir, "model.config"),
+      "<model><name>cached_model</name>"
+      "<sdf version='1.7'>model.sdf</sdf></model>");
+  writeModel("1 2 3 0 0 0");
+
+  const std::string worldFile =
+      sdf::filesystem::append(g_tempPath, "world.sdf");
+  writeFile(worldFile,
+      "<sdf version='1.7'>"
+      "  <world name='default'>"
+      "    <include><uri>model://cached_model</uri></include>"
+      "  </world>"
+      "</sdf>");
+  sdf::setFindCallback(findFileCb);
+
+  sdf::ParserConfig config;
+  config.SetCompiledCacheDirectory(
+      sdf::filesystem::append(g_tempPath, "cache"));
+
+  // Reading without a cache directory doesn't use it.
+  const std::size_t hits = sdf::compiledCacheHits();
+  const std::size_t misses = sdf::compiledCacheMisses();
+  sdf::ParserConfig uncachedConfig;
+  uncachedConfig.SetCompiledCacheDirectory("");
+  sdf::Root uncached;
+  EXPECT_TRUE(uncached.Load(worldFile, uncachedConfig).empty());
+  EXPECT_EQ(hits, sdf::compiledCacheHits());
+  EXPECT_EQ(misses, sdf::compiledCacheMisses());
+
+  // The first read parses the world and stores it.
+  sdf::Root root1;
+  EXPECT_TRUE(root1.Load(worldFile, config).empty());
+  EXPECT_EQ(hits, sdf::compiledCacheHits());
+  EXPECT_EQ(misses + 1, sdf::compiledCacheMisses());
+  EXPECT_TRUE(sdf::filesystem::is_directory(config.CompiledCacheDirectory()));
+
+  // The second read uses the stored world.
+  sdf::Root root2;
+  EXPECT_TRUE(root2.Load(worldFile, config).empty());
+  EXPECT_EQ(hits + 1, sdf::compiledCacheHits());
+  EXPECT_EQ(misses + 1, sdf::compiledCacheMisses());
+  EXPECT_EQ(uncached.Element()->ToString(""), root2.Element()->ToString(""));
+  ASSERT_NE(nullptr, root2.WorldByIndex(0));
+  const sdf::Model *model = root2.WorldByIndex(0)->ModelByIndex(0);
+  ASSERT_NE(nullptr, model);
+  EXPECT_EQ("cached_model", model->Name());
+  EXPECT_EQ(ignition::math::Pose3d(1, 2, 3, 0, 0, 0), model->RawPose());
+
+  // A change of the included file is detected.
+  writeModel("4 5 6 0 0 0");
+  sdf::Root root3;
+  EXPECT_TRUE(root3.Load(worldFile, config).empty());
+  EXPECT_EQ(hits + 1, sdf::compiledCacheHits());
+  EXPECT_EQ(misses + 2, sdf::compiledCacheMisses());
+  ASSERT_NE(nullptr, root3.WorldByIndex(0));
+  model = root3.WorldByIndex(0)->ModelByIndex(0);
+  ASSERT_NE(nullptr, model);
+  EXPECT_EQ(ignition::math::Pose3d(4, 5, 6, 0, 0, 0), model->RawPose());
+
+  // The included files are also recorded when they come from the cache of
+  // included files.
+  sdf::clearIncludeCache();
+  sdf::ParserConfig includeConfig;
+  includeConfig.SetCompiledCacheDirectory("");
+  includeConfig.SetCacheIncludes(true);
+  sdf::Root root4;
+  EXPECT_TRUE(root4.Load(worldFile, includeConfig).empty());
+  EXPECT_EQ(1u, sdf::includeCacheMisses());
+
+  const std::string world2File =
+      sdf::filesystem::append(g_tempPath, "world2.sdf");
+  writeFile(world2File,
+      "<sdf version='1.7'>"
+      "  <world name='world2'>"
+      "    <include><uri>model://cached_model</uri></include>"
+      "  </world>"
+      "</sdf>");
+  config.SetCacheIncludes(true);
+  sdf::Root root5;
+  EXPECT_TRUE(root5.Load(world2File, config).empty());
+  EXPECT_EQ(1u, sdf::includeCacheHits());
+  EXPECT_EQ(misses + 3, sdf::compiledCacheMisses());
+
+  writeModel("10 11 12 0 0 0");
+  sdf::Root root6;
+  EXPECT_TRUE(root6.Load(world2File, config).empty());
+  EXPECT_EQ(hits + 1, sdf::compiledCacheHits());
+  EXPECT_EQ(misses + 4, sdf::compiledCacheMisses());
+  ASSERT_NE(nullptr, root6.WorldByIndex(0));
+  model = root6.WorldByIndex(0)->ModelByIndex(0);
+  ASSERT_NE(nullptr, model);
+  EXPECT_EQ(ignition::math::Pose3d(10, 11, 12, 0, 0, 0), model->RawPose());
+  sdf::clearIncludeCache();
+
+  // A change of the world file itself uses another entry.
+  writeFile(worldFile,
+      "<sdf version='1.7'>"
+      "  <world name='changed'>"
+      "    <include><uri>model://cached_model</uri></include>"
+      "  </world>"
+      "</sdf>");
+  sdf::Root root7;
+  EXPECT_TRUE(root7.Load(worldFile, config).empty());
+  EXPECT_EQ(misses + 5, sdf::compiledCacheMisses());
+  ASSERT_NE(nullptr, root7.WorldByIndex(0));
+  EXPECT_EQ("changed", root7.WorldByIndex(0)->Name());
+
+  removeDirectory(g_tempPath);
+}
+
+/////////////////////////////////////////////////
+std::string otherFindFileCb(const std::string &_input)
+{
+  return sdf::filesystem::append(g_tempPath, "other_models",
+      _input.substr(std::string("model://").size()));
+}
+
+/////////////////////////////////////////////////
+TEST(CompiledCache, UriResolution)
+{
+  using sdf::filesystem::append;
+
+  removeDirectory(g_tempPath);
+  ASSERT_TRUE(sdf::filesystem::create_directory(g_tempPath));
+
+  // Two directories hold a model of the same name with another pose.
+  for (const auto &[dir, pose] : {std::make_pair("models", "1 2 3 0 0 0"),
+       std::make_pair("other_models", "7 8 9 0 0 0")})
+  {
+    const std::string modelDir = append(g_tempPath, dir, "cached_model");
+    ASSERT_TRUE(sdf::filesystem::create_directory(append(g_tempPath, dir)));
+    ASSERT_TRUE(sdf::filesystem::create_directory(modelDir));
+    writeFile(append(modelDir, "model.config"),
+        "<model><name>cached_model</name>"
+        "<sdf version='1.7'>model.sdf</sdf></model>");
+    writeFile(append(modelDir, "model.sdf"),
+        "<sdf version='1.7'>"
+        "  <model name='cached_model'>"
+        "    <pose>" + std::string(pose) + "</pose>"
+        "    <link name='link'/>"
+        "  </model>"
+        "</sdf>");
+  }
+
+  const std::string worldFile = append(g_tempPath, "world.sdf");
+  writeFile(worldFile,
+      "<sdf version='1.7'>"
+      "  <world name='default'>"
+      "    <include><uri>model://cached_model</uri></include>"
+      "  </world>"
+      "</sdf>");
+
+  sdf::ParserConfig config;
+  config.SetCompiledCacheDirectory(append(g_tempPath, "cache"));
+
+  auto modelPose = [&]()
+  {
+    sdf::Root root;
+    EXPECT_TRUE(root.Load(worldFile, config).empty());
+    const sdf::World *world = root.WorldByIndex(0);
+    if (!world || !world->ModelByIndex(0))
+    {
+      ADD_FAILURE() << "Missing cached_model";
+      return ignition::math::Pose3d();
+    }
+    return world->ModelByIndex(0)->RawPose();
+  };
+
+  sdf::setFindCallback(findFileCb);
+  const std::size_t hits = sdf::compiledCacheHits();
+  const std::size_t misses = sdf::compiledCacheMisses();
+  EXPECT_EQ(ignition::math::Pose3d(1, 2, 3, 0, 0, 0), modelPose());
+  EXPECT_EQ(ignition::math::Pose3d(1, 2, 3, 0, 0, 0), modelPose());
+  EXPECT_EQ(hits + 1, sdf::compiledCacheHits());
+  EXPECT_EQ(misses + 1, sdf::compiledCacheMisses());
+
+  // The include resolves to another directory, although no file changed.
+  sdf::setFindCallback(otherFindFileCb);
+  EXPECT_EQ(ignition::math::Pose3d(7, 8, 9, 0, 0, 0), modelPose());
+  EXPECT_EQ(hits + 1, sdf::compiledCacheHits());
+  EXPECT_EQ(misses + 2, sdf::compiledCacheMisses());
+
+  sdf::setFindCallback(findFileCb);
+  removeDirectory(g_tempPath);
+}
+
+#ifndef _WIN32
+/////////////////////////////////////////////////
+TEST(CompiledCache, EnvironmentVariable)
+{
+  removeDirectory(g_tempPath);
+  ASSERT_TRUE(sdf::filesystem::create_directory(g_tempPath));
+  const std::string worldFile =
+      sdf::filesystem::append(g_tempPath, "world.sdf");
+  writeFile(worldFile,
+      "<sdf version='1.7'>"
+      "  <world name='default'/>"
+      "</sdf>");
+
+  const std::string cacheDir = sdf::filesystem::append(g_tempPath, "cache");
+  ASSERT_EQ(0, setenv("SDF_COMPILED_CACHE_PATH", cacheDir.c_str(), 1));
+
+  // The functions that take no configuration use the directory like
+  // Root::Load does.
+  const std::size_t hits = sdf::compiledCacheHits();
+  const std::size_t misses = sdf::compiledCacheMisses();
+  sdf::Errors errors;
+  EXPECT_NE(nullptr, sdf::readFile(worldFile, errors));
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ(hits, sdf::compiledCacheHits());
+  EXPECT_EQ(misses + 1, sdf::compiledCacheMisses());
+
+  sdf::SDFPtr sdf(new sdf::SDF());
+  sdf::init(sdf);
+  EXPECT_TRUE(sdf::readFile(worldFile, sdf, errors));
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ(hits + 1, sdf::compiledCacheHits());
+
+  sdf::Root root;
+  EXPECT_TRUE(root.Load(worldFile).empty());
+  EXPECT_EQ(hits + 2, sdf::compiledCacheHits());
+  EXPECT_EQ(misses + 1, sdf::compiledCacheMisses());
+  ASSERT_NE(nullptr, root.WorldByIndex(0));
+  EXPECT_EQ("default", root.WorldByIndex(0)->Name());
+
+  ASSERT_EQ(0, unsetenv("SDF_COMPILED_CACHE_PATH"));
+  removeDirectory(g_tempPath);
+}
+#endif  // _WIN32
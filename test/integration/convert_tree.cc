@@ -0,0 +1,199 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+
+#include "sdf/Filesystem.hh"
+#include "sdf/Root.hh"
+#include "sdf/SDFImpl.hh"
+#include "sdf/parser.hh"
+#include "test_config.h"
+#include "test_utils.hh"
+
+const auto g_tempPath =
+    sdf::filesystem::append(PROJECT_BINARY_DIR, "test", "convert_tree");
+
+using sdf::testing::removeDirectory;
+using sdf::testing::writeFile;
+
+/////////////////////////////////////////////////
+/// \brief Read a file.
+/// \param[in] _path Path of the file.
+/// \return Contents of the file.
+std::string readFile(const std::string &_path)
+{
+  std::ifstream in(_path);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  return contents.str();
+}
+
+/////////////////////////////////////////////////
+TEST(ConvertTree, UpgradeInPlace)
+{
+  using sdf::filesystem::append;
+
+  removeDirectory(g_tempPath);
+  ASSERT_TRUE(sdf::filesystem::create_directory(g_tempPath));
+  for (const char *dir : {"old_model", "new_model", "worlds", "broken",
+       ".hidden"})
+  {
+    ASSERT_TRUE(sdf::filesystem::create_directory(append(g_tempPath, dir)));
+  }
+
+  // A model named by its model.config, which is converted with it.
+  const std::string oldModel = append(g_tempPath, "old_model", "model.xml");
+  const std::string oldConfig =
+      append(g_tempPath, "old_model", "model.config");
+  writeFile(oldConfig,
+      "<?xml version='1.0'?>"
+      "<model><name>old_model</name>"
+      "<sdf version='1.5'>model.xml</sdf></model>");
+  writeFile(oldModel,
+      "<?xml version='1.0'?>"
+      "<sdf version='1.5'>"
+      "  <model name='old_model'>"
+      "    <link name='link'/>"
+      "    <link name='arm'><pose frame='link'>1 0 0 0 0 0</pose></link>"
+      "  </model>"
+      "</sdf>");
+
+  // Files that are at the version, that fail and that are hidden.
+  const std::string newModel = append(g_tempPath, "new_model", "model.sdf");
+  const std::string newModelText =
+      "<sdf version='" + sdf::SDF::Version() + "'>"
+      "  <model name='new_model'><link name='link'/></model>"
+      "</sdf>";
+  writeFile(newModel, newModelText);
+  const std::string world = append(g_tempPath, "worlds", "empty.world");
+  writeFile(world,
+      "<sdf version='1.6'><world name='default'/></sdf>");
+  const std::string broken = append(g_tempPath, "broken", "broken.sdf");
+  writeFile(broken, "<sdf version='1.6'><model name='broken'>");
+  const std::string hidden = append(g_tempPath, ".hidden", "hidden.sdf");
+  const std::string hiddenText = "<sdf version='1.6'/>";
+  writeFile(hidden, hiddenText);
+
+  sdf::ConvertTreeReport report;
+  sdf::Errors errors;
+  EXPECT_FALSE(sdf::convertTree(g_tempPath, sdf::SDF::Version(), report,
+      errors, 2));
+  EXPECT_EQ(3u, report.converted);
+  EXPECT_EQ(1u, report.skipped);
+  EXPECT_EQ(1u, report.failed);
+  EXPECT_LE(0.0, report.seconds);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::FILE_READ, errors[0].Code());
+  EXPECT_NE(std::string::npos, errors[0].Message().find(broken))
+      << errors[0].Message();
+
+  // The converted files are at the version.
+  const std::string version = "version=\"" + sdf::SDF::Version() + "\"";
+  const std::string converted = readFile(oldModel);
+  EXPECT_NE(std::string::npos, converted.find(version));
+  EXPECT_NE(std::string::npos, converted.find("relative_to=\"link\""));
+  EXPECT_NE(std::string::npos, readFile(oldConfig).find(version));
+  EXPECT_NE(std::string::npos, readFile(world).find(version));
+  EXPECT_EQ(newModelText, readFile(newModel));
+  EXPECT_EQ(hiddenText, readFile(hidden));
+
+  sdf::Root root;
+  errors = root.Load(oldModel);
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ(sdf::SDF::Version(), root.Version());
+
+  // Converting the tree again skips the files by their hashes.
+  errors.clear();
+  EXPECT_FALSE(sdf::convertTree(g_tempPath, sdf::SDF::Version(), report,
+      errors));
+  EXPECT_EQ(0u, report.converted);
+  EXPECT_EQ(4u, report.skipped);
+  EXPECT_EQ(1u, report.failed);
+  EXPECT_EQ(1u, errors.size());
+  EXPECT_EQ(converted, readFile(oldModel));
+
+  errors.clear();
+  EXPECT_FALSE(sdf::convertTree(append(g_tempPath, "missing"),
+      sdf::SDF::Version(), report, errors));
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::DIRECTORY_NONEXISTANT, errors[0].Code());
+}
+
+/////////////////////////////////////////////////
+TEST(ConvertTree, ModelVersions)
+{
+  using sdf::filesystem::append;
+
+  removeDirectory(g_tempPath);
+  ASSERT_TRUE(sdf::filesystem::create_directory(g_tempPath));
+  ASSERT_TRUE(sdf::filesystem::create_directory(append(g_tempPath, "model")));
+
+  // A model with a file per version, of which the newest one is read.
+  const std::string config = append(g_tempPath, "model", "model.config");
+  writeFile(config,
+      "<?xml version='1.0'?>"
+      "<model><name>model</name>"
+      "<sdf version='1.5'>model-1_5.sdf</sdf>"
+      "<sdf version='1.6'>model.sdf</sdf></model>");
+  const std::string oldModel = append(g_tempPath, "model", "model-1_5.sdf");
+  const std::string oldModelText =
+      "<sdf version='1.5'><model name='model'><link name='link'/></model>"
+      "</sdf>";
+  writeFile(oldModel, oldModelText);
+  const std::string model = append(g_tempPath, "model", "model.sdf");
+  writeFile(model,
+      "<sdf version='1.6'><model name='model'><link name='link'/></model>"
+      "</sdf>");
+#ifndef _WIN32
+  ASSERT_EQ(0, chmod(model.c_str(), 0640));
+#endif
+
+  sdf::ConvertTreeReport report;
+  sdf::Errors errors;
+  EXPECT_TRUE(sdf::convertTree(g_tempPath, sdf::SDF::Version(), report,
+      errors));
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ(2u, report.converted);
+  EXPECT_EQ(1u, report.skipped);
+
+  // The file of the other version and its entry are kept.
+  const std::string version = "version=\"" + sdf::SDF::Version() + "\"";
+  EXPECT_EQ(oldModelText, readFile(oldModel));
+  const std::string configText = readFile(config);
+  EXPECT_NE(std::string::npos,
+      configText.find("<sdf version=\"1.5\">model-1_5.sdf</sdf>"))
+      << configText;
+  EXPECT_NE(std::string::npos,
+      configText.find("<sdf " + version + ">model.sdf</sdf>")) << configText;
+  EXPECT_NE(std::string::npos, readFile(model).find(version));
+
+  // The converted file keeps its permissions.
+#ifndef _WIN32
+  struct stat fileStat;
+  ASSERT_EQ(0, stat(model.c_str(), &fileStat));
+  EXPECT_EQ(0640u, fileStat.st_mode & 0777u);
+#endif
+
+  removeDirectory(g_tempPath);
+}
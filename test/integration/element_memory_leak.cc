@@ -15,7 +15,11 @@
  *
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <iostream>
+#include <new>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -59,6 +63,70 @@ std::string custom_exec(std::string _cmd)
   return result;
 }
 
+/// \brief Number of calls to the global operator new.
+static std::atomic<std::size_t> g_allocationCount{0};
+
+/// \brief Number of calls to the global operator delete.
+static std::atomic<std::size_t> g_deallocationCount{0};
+
+/////////////////////////////////////////////////
+void *operator new(std::size_t _size)
+{
+  ++g_allocationCount;
+  if (void *memory = std::malloc(_size ? _size : 1))
+    return memory;
+  throw std::bad_alloc();
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_memory) noexcept
+{
+  if (_memory)
+    ++g_deallocationCount;
+  std::free(_memory);
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_memory, std::size_t) noexcept
+{
+  operator delete(_memory);
+}
+
+#ifndef _WIN32
+/// \brief Number of blocks allocated with the aligned operator new that
+/// are not freed. Arenas allocate their blocks with it.
+static std::atomic<std::size_t> g_alignedBlockCount{0};
+
+/////////////////////////////////////////////////
+void *operator new(std::size_t _size, std::align_val_t _alignment)
+{
+  const std::size_t alignment = static_cast<std::size_t>(_alignment);
+  const std::size_t size =
+      (std::max<std::size_t>(_size, 1) + alignment - 1) / alignment * alignment;
+  if (void *memory = std::aligned_alloc(alignment, size))
+  {
+    ++g_alignedBlockCount;
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_memory, std::align_val_t) noexcept
+{
+  if (_memory)
+    --g_alignedBlockCount;
+  std::free(_memory);
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_memory, std::size_t,
+    std::align_val_t _alignment) noexcept
+{
+  operator delete(_memory, _alignment);
+}
+#endif
+
 const std::string sdfString(
   "<?xml version='1.0'?>\n"
   "<sdf version='1.5'>\n"
@@ -101,3 +169,110 @@ TEST(ElementMemoryLeak, SDFCreateDestroy)
             << getMemoryUsage()
             << std::endl;
 }
+
+#ifndef _WIN32
+//////////////////////////////////////////////////
+TEST(ElementMemoryLeak, ParseArenaInclude)
+{
+  // The first include of the process creates the template that included
+  // files are copied from. It lives as long as the process, so it must not
+  // be placed in the arena of the document that first includes a file,
+  // which would then never be freed.
+  const std::string testPath =
+      sdf::filesystem::append(PROJECT_SOURCE_PATH, "test");
+  sdf::setFindCallback([&testPath](const std::string &_uri)
+      {
+        return sdf::filesystem::append(testPath, "integration", "model",
+            _uri);
+      });
+
+  sdf::ParserConfig config;
+  config.SetUseParseArena(true);
+  config.SetCompiledCacheDirectory("");
+
+  sdf::SDFPtr sdf(new sdf::SDF());
+  ASSERT_TRUE(sdf::init(sdf));
+
+  const std::size_t blocksBefore = g_alignedBlockCount;
+  sdf::Errors errors;
+  ASSERT_TRUE(sdf::readFile(sdf::filesystem::append(testPath, "sdf",
+      "includes.sdf"), config, sdf, errors));
+  EXPECT_TRUE(errors.empty());
+#ifdef __GLIBCXX__
+  // libstdc++ allocates the blocks of memory resources aligned.
+  EXPECT_LT(blocksBefore, g_alignedBlockCount.load());
+#endif
+
+  // Releasing the document frees the blocks of its arena.
+  sdf.reset();
+  EXPECT_EQ(blocksBefore, g_alignedBlockCount.load());
+}
+
+//////////////////////////////////////////////////
+/// \brief Count the heap allocations made to read a file and to destroy it.
+/// \param[in] _useArena True to read the file in an arena.
+/// \param[out] _allocations Number of allocations made while reading.
+/// \param[out] _deallocations Number of deallocations made while
+/// destroying the document.
+void countAllocations(bool _useArena, std::size_t &_allocations,
+    std::size_t &_deallocations)
+{
+  const std::string testFile = sdf::filesystem::append(PROJECT_SOURCE_PATH,
+      "test", "sdf", "double_pendulum.sdf");
+  sdf::ParserConfig config;
+  config.SetUseParseArena(_useArena);
+  config.SetCompiledCacheDirectory("");
+
+  sdf::SDFPtr sdf(new sdf::SDF());
+  ASSERT_TRUE(sdf::init(sdf));
+
+  sdf::Errors errors;
+  const std::size_t allocationsBefore = g_allocationCount;
+  ASSERT_TRUE(sdf::readFile(testFile, config, sdf, errors));
+  _allocations = g_allocationCount - allocationsBefore;
+  EXPECT_TRUE(errors.empty());
+
+  const std::size_t deallocationsBefore = g_deallocationCount;
+  sdf.reset();
+  _deallocations = g_deallocationCount - deallocationsBefore;
+}
+
+//////////////////////////////////////////////////
+TEST(ElementMemoryLeak, ParseArena)
+{
+  // Read once to initialize the specification descriptions.
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+  countAllocations(false, allocations, deallocations);
+
+  countAllocations(false, allocations, deallocations);
+  std::size_t arenaAllocations = 0;
+  std::size_t arenaDeallocations = 0;
+  countAllocations(true, arenaAllocations, arenaDeallocations);
+
+  std::cout << "heap allocations without arena: " << allocations
+            << ", with arena: " << arenaAllocations << std::endl;
+  std::cout << "heap deallocations without arena: " << deallocations
+            << ", with arena: " << arenaDeallocations << std::endl;
+
+  // Elements, parameters, their reference counts, their private data and
+  // the containers of the private data are in the arena, so destroying the
+  // document frees few blocks on the heap, such as long string values.
+  EXPECT_LT(arenaAllocations, allocations);
+  EXPECT_LT(arenaDeallocations * 4, deallocations);
+
+  // Elements can outlive the SDF object they were read into.
+  sdf::ParserConfig config;
+  config.SetUseParseArena(true);
+  sdf::SDFPtr sdf(new sdf::SDF());
+  ASSERT_TRUE(sdf::init(sdf));
+  sdf::Errors errors;
+  ASSERT_TRUE(sdf::readFile(sdf::filesystem::append(PROJECT_SOURCE_PATH,
+      "test", "sdf", "double_pendulum.sdf"), config, sdf, errors));
+  sdf::ElementPtr model = sdf->Root()->GetElement("model");
+  sdf.reset();
+  EXPECT_EQ("double_pendulum_with_base",
+            model->Get<std::string>("name"));
+  EXPECT_NE(nullptr, model->Clone());
+}
+#endif
@@ -22,6 +22,7 @@
 #include "sdf/Actor.hh"
 #include "sdf/Collision.hh"
 #include "sdf/Filesystem.hh"
+#include "sdf/Frame.hh"
 #include "sdf/Geometry.hh"
 #include "sdf/Light.hh"
 #include "sdf/Link.hh"
@@ -33,6 +34,7 @@
 #include "sdf/Visual.hh"
 #include "sdf/World.hh"
 #include "test_config.h"
+#include "test_utils.hh"
 
 const auto g_testPath = sdf::filesystem::append(PROJECT_SOURCE_PATH, "test");
 const auto g_modelsPath =
@@ -318,3 +320,204 @@ TEST(IncludesTest, Includes_15_convert)
   EXPECT_EQ("1.6", modelElem->OriginalVersion());
   EXPECT_EQ("1.6", linkElem->OriginalVersion());
 }
+
+//////////////////////////////////////////////////
+TEST(IncludesTest, ParallelIncludes)
+{
+  sdf::setFindCallback(findFileCb);
+
+  const auto worldFile =
+    sdf::filesystem::append(g_testPath, "sdf", "includes_parallel.sdf");
+
+  sdf::Errors serialErrors;
+  sdf::SDFPtr serialSdf = sdf::readFile(worldFile, serialErrors);
+  ASSERT_NE(nullptr, serialSdf);
+
+  // The world includes a model whose directory doesn't exist.
+  ASSERT_EQ(1u, serialErrors.size());
+  EXPECT_EQ(sdf::ErrorCode::DIRECTORY_NONEXISTANT, serialErrors[0].Code());
+
+  sdf::ParserConfig config;
+  EXPECT_FALSE(config.ParallelIncludes());
+  config.SetParallelIncludes(true);
+  config.SetIncludeThreadCount(4);
+
+  sdf::Errors parallelErrors;
+  sdf::SDFPtr parallelSdf =
+    sdf::readFile(worldFile, config, parallelErrors);
+  ASSERT_NE(nullptr, parallelSdf);
+
+  // The parsed document and the errors don't depend on how the includes
+  // are read.
+  EXPECT_EQ(serialSdf->Root()->ToString(""),
+            parallelSdf->Root()->ToString(""));
+  ASSERT_EQ(serialErrors.size(), parallelErrors.size());
+  for (std::size_t i = 0; i < serialErrors.size(); ++i)
+  {
+    EXPECT_EQ(serialErrors[i].Code(), parallelErrors[i].Code());
+    EXPECT_EQ(serialErrors[i].Message(), parallelErrors[i].Message());
+  }
+
+  sdf::Root root;
+  sdf::Errors errors = root.Load(worldFile, config);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::DIRECTORY_NONEXISTANT, errors[0].Code());
+
+  const sdf::World *world = root.WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+
+  // Included and inline models keep the order of the document.
+  ASSERT_EQ(5u, world->ModelCount());
+  EXPECT_EQ("model_1", world->ModelByIndex(0)->Name());
+  EXPECT_EQ("inline_model", world->ModelByIndex(1)->Name());
+  EXPECT_EQ("model_2", world->ModelByIndex(2)->Name());
+  EXPECT_EQ("box", world->ModelByIndex(3)->Name());
+  EXPECT_EQ("model_3", world->ModelByIndex(4)->Name());
+  EXPECT_TRUE(world->ModelByIndex(4)->Static());
+
+  EXPECT_EQ(1u, world->LightCount());
+  EXPECT_EQ(1u, world->ActorCount());
+}
+
+//////////////////////////////////////////////////
+TEST(IncludesTest, CacheIncludes)
+{
+  sdf::setFindCallback(findFileCb);
+
+  const auto worldFile =
+    sdf::filesystem::append(g_testPath, "sdf", "includes_parallel.sdf");
+
+  sdf::clearIncludeCache();
+  EXPECT_EQ(0u, sdf::includeCacheHits());
+  EXPECT_EQ(0u, sdf::includeCacheMisses());
+
+  // Reading without the cache doesn't use it.
+  sdf::Errors uncachedErrors;
+  sdf::SDFPtr uncachedSdf = sdf::readFile(worldFile, uncachedErrors);
+  ASSERT_NE(nullptr, uncachedSdf);
+  EXPECT_EQ(1u, uncachedErrors.size());
+  EXPECT_EQ(0u, sdf::includeCacheHits());
+  EXPECT_EQ(0u, sdf::includeCacheMisses());
+
+  sdf::ParserConfig config;
+  config.SetCacheIncludes(true);
+
+  // The world includes test_model three times, and three other models once.
+  sdf::Errors cachedErrors;
+  sdf::SDFPtr cachedSdf = sdf::readFile(worldFile, config, cachedErrors);
+  ASSERT_NE(nullptr, cachedSdf);
+  EXPECT_EQ(2u, sdf::includeCacheHits());
+  EXPECT_EQ(4u, sdf::includeCacheMisses());
+
+  // The instances cloned from the cache keep their own overrides.
+  EXPECT_EQ(uncachedSdf->Root()->ToString(""),
+            cachedSdf->Root()->ToString(""));
+  EXPECT_EQ(1u, cachedErrors.size());
+
+  // A second read finds all the files in the cache, also in parallel.
+  config.SetParallelIncludes(true);
+  cachedErrors.clear();
+  cachedSdf = sdf::readFile(worldFile, config, cachedErrors);
+  ASSERT_NE(nullptr, cachedSdf);
+  EXPECT_EQ(8u, sdf::includeCacheHits());
+  EXPECT_EQ(4u, sdf::includeCacheMisses());
+  EXPECT_EQ(uncachedSdf->Root()->ToString(""),
+            cachedSdf->Root()->ToString(""));
+  EXPECT_EQ(1u, cachedErrors.size());
+
+  sdf::clearIncludeCache();
+  EXPECT_EQ(0u, sdf::includeCacheHits());
+  EXPECT_EQ(0u, sdf::includeCacheMisses());
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a model directory.
+/// \param[in] _dir Path of the directory.
+/// \param[in] _model XML of the model.
+void writeModelDir(const std::string &_dir, const std::string &_model)
+{
+  ASSERT_TRUE(sdf::filesystem::create_directory(_dir));
+  sdf::testing::writeFile(sdf::filesystem::append(_dir, "model.config"),
+      "<model><sdf version='1.7'>model.sdf</sdf></model>");
+  sdf::testing::writeFile(sdf::filesystem::append(_dir, "model.sdf"),
+      "<sdf version='1.7'>" + _model + "</sdf>");
+}
+
+//////////////////////////////////////////////////
+TEST(IncludesTest, CacheIncludesNestedChange)
+{
+  using sdf::filesystem::append;
+
+  const std::string tempPath =
+      append(PROJECT_BINARY_DIR, "test", "include_cache");
+  sdf::testing::removeDirectory(tempPath);
+  ASSERT_TRUE(sdf::filesystem::create_directory(tempPath));
+
+  // The world includes outer_model, which includes inner_model.
+  const std::string innerDir = append(tempPath, "inner_model");
+  const std::string outerDir = append(tempPath, "outer_model");
+  auto writeInner = [&innerDir](const std::string &_pose)
+  {
+    sdf::testing::writeFile(append(innerDir, "model.sdf"),
+        "<sdf version='1.7'>"
+        "  <model name='inner_model'>"
+        "    <pose>" + _pose + "</pose>"
+        "    <link name='link'/>"
+        "  </model>"
+        "</sdf>");
+  };
+  writeModelDir(innerDir, "<model name='inner_model'/>");
+  writeInner("1 2 3 0 0 0");
+  writeModelDir(outerDir,
+      "<model name='outer_model'>"
+      "  <link name='link'/>"
+      "  <include><uri>" + innerDir + "</uri></include>"
+      "</model>");
+  const std::string worldFile = append(tempPath, "world.sdf");
+  sdf::testing::writeFile(worldFile,
+      "<sdf version='1.7'>"
+      "  <world name='default'>"
+      "    <include><uri>" + outerDir + "</uri></include>"
+      "  </world>"
+      "</sdf>");
+
+  sdf::clearIncludeCache();
+  sdf::ParserConfig config;
+  config.SetCacheIncludes(true);
+
+  auto innerPose = [&]()
+  {
+    sdf::Root root;
+    EXPECT_TRUE(root.Load(worldFile, config).empty());
+    // The nested model is flattened into a frame of outer_model.
+    const sdf::World *world = root.WorldByIndex(0);
+    const sdf::Frame *frame = nullptr;
+    if (world && world->ModelByIndex(0))
+      frame = world->ModelByIndex(0)->FrameByName("inner_model::__model__");
+    if (!frame)
+    {
+      ADD_FAILURE() << "Missing inner_model";
+      return ignition::math::Pose3d();
+    }
+    return frame->RawPose();
+  };
+
+  EXPECT_EQ(ignition::math::Pose3d(1, 2, 3, 0, 0, 0), innerPose());
+  EXPECT_EQ(0u, sdf::includeCacheHits());
+  EXPECT_EQ(2u, sdf::includeCacheMisses());
+
+  // An unchanged tree is cloned from the cache.
+  EXPECT_EQ(ignition::math::Pose3d(1, 2, 3, 0, 0, 0), innerPose());
+  EXPECT_EQ(1u, sdf::includeCacheHits());
+  EXPECT_EQ(2u, sdf::includeCacheMisses());
+
+  // A change of the nested include is detected through outer_model, whose
+  // file is unchanged.
+  writeInner("10 20 30 0 0 0");
+  EXPECT_EQ(ignition::math::Pose3d(10, 20, 30, 0, 0, 0), innerPose());
+  EXPECT_EQ(1u, sdf::includeCacheHits());
+  EXPECT_EQ(4u, sdf::includeCacheMisses());
+
+  sdf::clearIncludeCache();
+  sdf::testing::removeDirectory(tempPath);
+}
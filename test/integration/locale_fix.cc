@@ -32,30 +32,44 @@ const std::string SDF_TEST_FILE =
 // Windows supports the setlocale call but we can not extract the
 // available locales using the Linux call
 #ifndef _MSC_VER
-TEST(CheckFixForLocal, MakeTestToFail)
+/////////////////////////////////////////////////
+/// \brief Find a locale whose decimal separator is a comma.
+/// \return Name of the locale, or an empty string if none is available.
+std::string latinLocale()
 {
   // Check if any of the latin locales is avilable
   FILE *fp = popen("locale -a | grep '^es\\|^pt_\\|^it_' | head -n 1", "r");
 
   if (!fp)
-  {
-    FAIL() << "locale -a call failed";
-    return;
-  }
+    return "";
 
   char buffer[1024];
   char *line = fgets(buffer, sizeof(buffer), fp);
   pclose(fp);
 
-  // Do not run test if not available
   if (!line)
+    return "";
+
+  std::string name(line);
+  while (!name.empty() && (name.back() == '\n' || name.back() == '\r'))
+    name.pop_back();
+  return name;
+}
+
+/////////////////////////////////////////////////
+TEST(CheckFixForLocal, MakeTestToFail)
+{
+  const std::string locale = latinLocale();
+
+  // Do not run test if not available
+  if (locale.empty())
   {
     std::cout << "No latin locale available. Skip test" << std::endl;
     SUCCEED();
     return;
   }
 
-  setlocale(LC_NUMERIC, line);
+  setlocale(LC_NUMERIC, locale.c_str());
 
   // fix to allow make test without make install
   sdf::SDFPtr p(new sdf::SDF());
@@ -81,4 +95,45 @@ TEST(CheckFixForLocal, MakeTestToFail)
   ASSERT_TRUE(param.Get<double>(tmp));
   ASSERT_DOUBLE_EQ(1.5, tmp);
 }
+
+/////////////////////////////////////////////////
+TEST(CheckFixForLocal, URDF)
+{
+  const std::string locale = latinLocale();
+
+  // Do not run test if not available
+  if (locale.empty())
+  {
+    std::cout << "No latin locale available. Skip test" << std::endl;
+    SUCCEED();
+    return;
+  }
+
+  setlocale(LC_NUMERIC, locale.c_str());
+
+  // The URDF and its gazebo extensions are converted with the classic
+  // locale, whatever the locale of the process.
+  const std::string urdfFile = sdf::filesystem::append(PROJECT_SOURCE_PATH,
+      "test", "integration", "urdf_gazebo_extensions.urdf");
+  sdf::SDFPtr robot(new sdf::SDF());
+  sdf::init(robot);
+  const bool read = sdf::readFile(urdfFile, robot);
+  setlocale(LC_NUMERIC, "C");
+  ASSERT_TRUE(read);
+
+  sdf::ElementPtr joint = robot->Root()->GetElement("model")
+    ->GetElement("joint");
+  while (joint && joint->Get<std::string>("name") != "joint01")
+    joint = joint->GetNextElement("joint");
+  ASSERT_NE(nullptr, joint);
+
+  sdf::ElementPtr ode = joint->GetElement("physics")->GetElement("ode");
+  EXPECT_DOUBLE_EQ(0.56789, ode->Get<double>("fudge_factor"));
+  EXPECT_DOUBLE_EQ(0.987, ode->GetElement("limit")->Get<double>("erp"));
+
+  sdf::ElementPtr dynamics = joint->GetElement("axis")
+    ->GetElement("dynamics");
+  EXPECT_DOUBLE_EQ(1.1111, dynamics->Get<double>("damping"));
+  EXPECT_DOUBLE_EQ(0.234, dynamics->Get<double>("spring_reference"));
+}
 #endif
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <clocale>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "sdf/sdf.hh"
+
+#include "test_config.h"
+
+// These tests are most useful when sdformat is built with
+// -DSDF_ENABLE_TSAN=ON, so that ThreadSanitizer reports any data race.
+
+/// \brief Number of threads that parse at the same time.
+const unsigned int THREAD_COUNT = 8;
+
+/// \brief Number of times each thread parses every file.
+const unsigned int ITERATIONS = 4;
+
+/////////////////////////////////////////////////
+/// \brief Find models included by the test files.
+/// \param[in] _uri URI of the model.
+/// \return Path of the model.
+static std::string findFileCb(const std::string &_uri)
+{
+  return sdf::filesystem::append(PROJECT_SOURCE_PATH, "test", "integration",
+                                 "model", _uri);
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the files parsed by the tests.
+/// \return Paths of SDFormat and URDF files of several versions.
+static std::vector<std::string> testFiles()
+{
+  const std::string sdfDir =
+    sdf::filesystem::append(PROJECT_SOURCE_PATH, "test", "sdf");
+  const std::string integrationDir =
+    sdf::filesystem::append(PROJECT_SOURCE_PATH, "test", "integration");
+
+  return {
+    sdf::filesystem::append(sdfDir, "world_complete.sdf"),
+    sdf::filesystem::append(sdfDir, "shapes.sdf"),
+    sdf::filesystem::append(sdfDir, "sensors.sdf"),
+    sdf::filesystem::append(sdfDir, "joint_complete.sdf"),
+    sdf::filesystem::append(sdfDir, "material.sdf"),
+    sdf::filesystem::append(sdfDir, "includes.sdf"),
+    sdf::filesystem::append(integrationDir, "model", "pr2.sdf"),
+    sdf::filesystem::append(integrationDir, "model", "double_pendulum.sdf"),
+    sdf::filesystem::append(integrationDir, "fixed_joint_reduction.urdf"),
+  };
+}
+
+/////////////////////////////////////////////////
+/// \brief Read a file into a string.
+/// \param[in] _filename Path of the file.
+/// \return The parsed document as a string, or an empty string on error.
+static std::string readFileAsString(const std::string &_filename)
+{
+  sdf::Errors errors;
+  sdf::SDFPtr sdfParsed = sdf::readFile(_filename, errors);
+  if (!sdfParsed || !errors.empty())
+    return "";
+  return sdfParsed->Root()->ToString("");
+}
+
+/////////////////////////////////////////////////
+/// Check that sdf::readFile gives the same result when several threads
+/// parse files at the same time.
+TEST(ParserConcurrency, ReadFile)
+{
+  sdf::setFindCallback(findFileCb);
+  const std::vector<std::string> files = testFiles();
+
+  // This is the first test, so that the threads race to initialize state
+  // that is created lazily, such as the template for included files.
+  const std::string localeBefore = std::setlocale(LC_NUMERIC, nullptr);
+
+  std::vector<std::vector<std::string>> results(THREAD_COUNT);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < THREAD_COUNT; ++t)
+  {
+    threads.emplace_back([&files, &results, t]()
+      {
+        // Start each thread with a different file.
+        for (unsigned int i = 0; i < ITERATIONS * files.size(); ++i)
+        {
+          const std::size_t index = (t + i) % files.size();
+          results[t].push_back(readFileAsString(files[index]));
+        }
+      });
+  }
+
+  for (auto &thread : threads)
+    thread.join();
+
+  std::vector<std::string> expected;
+  for (const auto &file : files)
+  {
+    expected.push_back(readFileAsString(file));
+    EXPECT_FALSE(expected.back().empty()) << file;
+  }
+
+  for (unsigned int t = 0; t < THREAD_COUNT; ++t)
+  {
+    ASSERT_EQ(ITERATIONS * files.size(), results[t].size());
+    for (unsigned int i = 0; i < results[t].size(); ++i)
+    {
+      const std::size_t index = (t + i) % files.size();
+      EXPECT_EQ(expected[index], results[t][i]) << files[index];
+    }
+  }
+
+  // Parsing must not change the global locale.
+  EXPECT_EQ(localeBefore, std::setlocale(LC_NUMERIC, nullptr));
+}
+
+/////////////////////////////////////////////////
+/// Check that sdf::Root::Load works when several threads load files at the
+/// same time.
+TEST(ParserConcurrency, RootLoad)
+{
+  sdf::setFindCallback(findFileCb);
+  const std::vector<std::string> files = testFiles();
+
+  std::vector<std::size_t> expectedModelCounts;
+  for (const auto &file : files)
+  {
+    sdf::Root root;
+    root.Load(file);
+    expectedModelCounts.push_back(root.ModelCount());
+  }
+
+  std::vector<std::vector<std::size_t>> modelCounts(THREAD_COUNT);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < THREAD_COUNT; ++t)
+  {
+    threads.emplace_back([&files, &modelCounts, t]()
+      {
+        for (unsigned int i = 0; i < ITERATIONS * files.size(); ++i)
+        {
+          const std::size_t index = (t + i) % files.size();
+          sdf::Root root;
+          root.Load(files[index]);
+          modelCounts[t].push_back(root.ModelCount());
+        }
+      });
+  }
+
+  for (auto &thread : threads)
+    thread.join();
+
+  for (unsigned int t = 0; t < THREAD_COUNT; ++t)
+  {
+    ASSERT_EQ(ITERATIONS * files.size(), modelCounts[t].size());
+    for (unsigned int i = 0; i < modelCounts[t].size(); ++i)
+    {
+      const std::size_t index = (t + i) % files.size();
+      EXPECT_EQ(expectedModelCounts[index], modelCounts[t][i])
+        << files[index];
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// Main
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
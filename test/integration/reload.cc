@@ -0,0 +1,386 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "sdf/Filesystem.hh"
+#include "sdf/Frame.hh"
+#include "sdf/Model.hh"
+#include "sdf/ParserConfig.hh"
+#include "sdf/Root.hh"
+#include "sdf/SemanticPose.hh"
+#include "sdf/World.hh"
+#include "sdf/parser.hh"
+#include "test_config.h"
+#include "test_utils.hh"
+
+const auto g_tempPath =
+    sdf::filesystem::append(PROJECT_BINARY_DIR, "test", "reload");
+
+using sdf::testing::removeDirectory;
+using sdf::testing::writeFile;
+
+/////////////////////////////////////////////////
+std::string findFileCb(const std::string &_input)
+{
+  return sdf::filesystem::append(g_tempPath, "models",
+      _input.substr(std::string("model://").size()));
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the model that the test world includes.
+/// \param[in] _pose Pose of the model.
+void writeModel(const std::string &_pose)
+{
+  writeFile(sdf::filesystem::append(g_tempPath, "models", "included_model",
+      "model.sdf"),
+      "<sdf version='1.7'>"
+      "  <model name='included_model'>"
+      "    <pose>" + _pose + "</pose>"
+      "    <link name='link'/>"
+      "  </model>"
+      "</sdf>");
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the test world.
+/// \param[in] _gravity Gravity of the world.
+/// \param[in] _models XML of the models of the world.
+void writeWorld(const std::string &_gravity, const std::string &_models)
+{
+  writeFile(sdf::filesystem::append(g_tempPath, "world.sdf"),
+      "<sdf version='1.7'>"
+      "  <world name='default'>"
+      "    <gravity>" + _gravity + "</gravity>"
+      + _models +
+      "    <include><uri>model://included_model</uri></include>"
+      "    <frame name='frame' attached_to='model_b'/>"
+      "  </world>"
+      "</sdf>");
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the XML of a model of the test world.
+/// \param[in] _name Name of the model.
+/// \param[in] _pose Pose of the model.
+/// \return The XML.
+std::string modelXml(const std::string &_name, const std::string &_pose)
+{
+  return "<model name='" + _name + "'>"
+         "  <pose>" + _pose + "</pose>"
+         "  <link name='link'/>"
+         "</model>";
+}
+
+/////////////////////////////////////////////////
+/// \brief Check that a reloaded root matches a root loaded from scratch.
+/// \param[in] _root The reloaded root.
+/// \param[in] _filename Name of the file.
+void expectLoaded(const sdf::Root &_root, const std::string &_filename)
+{
+  sdf::Root expected;
+  EXPECT_TRUE(expected.Load(_filename).empty());
+  EXPECT_EQ(expected.Element()->ToString(""), _root.Element()->ToString(""));
+
+  const sdf::World *world = _root.WorldByIndex(0);
+  const sdf::World *expectedWorld = expected.WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+  ASSERT_NE(nullptr, expectedWorld);
+  ASSERT_EQ(expectedWorld->ModelCount(), world->ModelCount());
+  for (uint64_t i = 0; i < world->ModelCount(); ++i)
+  {
+    EXPECT_EQ(expectedWorld->ModelByIndex(i)->Name(),
+        world->ModelByIndex(i)->Name());
+    EXPECT_EQ(expectedWorld->ModelByIndex(i)->RawPose(),
+        world->ModelByIndex(i)->RawPose());
+  }
+  ASSERT_EQ(1u, world->FrameCount());
+  ignition::math::Pose3d pose;
+  EXPECT_TRUE(
+      world->FrameByIndex(0)->SemanticPose().Resolve(pose, "world").empty());
+  ignition::math::Pose3d expectedPose;
+  EXPECT_TRUE(expectedWorld->FrameByIndex(0)->SemanticPose().Resolve(
+      expectedPose, "world").empty());
+  EXPECT_EQ(expectedPose, pose);
+}
+
+/////////////////////////////////////////////////
+/// \brief Sort names, to compare them regardless of their order.
+/// \param[in] _names The names.
+/// \return The sorted names.
+std::vector<std::string> sorted(std::vector<std::string> _names)
+{
+  std::sort(_names.begin(), _names.end());
+  return _names;
+}
+
+/////////////////////////////////////////////////
+TEST(Reload, ChangedModels)
+{
+  removeDirectory(g_tempPath);
+  ASSERT_TRUE(sdf::filesystem::create_directory(g_tempPath));
+  const std::string modelDir =
+      sdf::filesystem::append(g_tempPath, "models", "included_model");
+  ASSERT_TRUE(sdf::filesystem::create_directory(
+      sdf::filesystem::append(g_tempPath, "models")));
+  ASSERT_TRUE(sdf::filesystem::create_directory(modelDir));
+  writeFile(sdf::filesystem::append(modelDir, "model.config"),
+      "<model><name>included_model</name>"
+      "<sdf version='1.7'>model.sdf</sdf></model>");
+  writeModel("1 2 3 0 0 0");
+  writeWorld("0 0 -9.8",
+      modelXml("model_a", "1 0 0 0 0 0") +
+      modelXml("model_b", "2 0 0 0 0 0") +
+      modelXml("model_c", "3 0 0 0 0 0"));
+  sdf::setFindCallback(findFileCb);
+
+  const std::string worldFile =
+      sdf::filesystem::append(g_tempPath, "world.sdf");
+  sdf::ParserConfig config;
+  config.SetCompiledCacheDirectory("");
+
+  // The first reload loads everything.
+  sdf::Root root;
+  std::vector<std::string> changed;
+  EXPECT_TRUE(root.Reload(worldFile, config, changed).empty());
+  EXPECT_EQ(std::vector<std::string>({"default::included_model",
+      "default::model_a", "default::model_b", "default::model_c"}),
+      sorted(changed));
+  expectLoaded(root, worldFile);
+  const sdf::Model *modelA = root.WorldByIndex(0)->ModelByName("model_a");
+  ASSERT_NE(nullptr, modelA);
+  const sdf::ElementPtr modelAElement = modelA->Element();
+
+  // Nothing changed.
+  changed.clear();
+  EXPECT_TRUE(root.Reload(worldFile, config, changed).empty());
+  EXPECT_TRUE(changed.empty());
+  expectLoaded(root, worldFile);
+
+  // The pose of a model changed. The other models keep their elements.
+  writeWorld("0 0 -9.8",
+      modelXml("model_a", "1 0 0 0 0 0") +
+      modelXml("model_b", "5 0 0 0 0 0") +
+      modelXml("model_c", "3 0 0 0 0 0"));
+  changed.clear();
+  EXPECT_TRUE(root.Reload(worldFile, config, changed).empty());
+  EXPECT_EQ(std::vector<std::string>({"default::model_b"}), changed);
+  expectLoaded(root, worldFile);
+  EXPECT_EQ(modelAElement,
+      root.WorldByIndex(0)->ModelByName("model_a")->Element());
+  EXPECT_EQ(ignition::math::Pose3d(5, 0, 0, 0, 0, 0),
+      root.WorldByIndex(0)->ModelByName("model_b")->RawPose());
+
+  // The included file changed.
+  writeModel("4 5 6 0 0 0");
+  changed.clear();
+  EXPECT_TRUE(root.Reload(worldFile, config, changed).empty());
+  EXPECT_EQ(std::vector<std::string>({"default::included_model"}), changed);
+  expectLoaded(root, worldFile);
+  EXPECT_EQ(ignition::math::Pose3d(4, 5, 6, 0, 0, 0),
+      root.WorldByIndex(0)->ModelByName("included_model")->RawPose());
+
+  // A model was removed and another added.
+  writeWorld("0 0 -9.8",
+      modelXml("model_a", "1 0 0 0 0 0") +
+      modelXml("model_b", "5 0 0 0 0 0") +
+      modelXml("model_d", "7 0 0 0 0 0"));
+  changed.clear();
+  EXPECT_TRUE(root.Reload(worldFile, config, changed).empty());
+  EXPECT_EQ(std::vector<std::string>({"default::model_c", "default::model_d"}),
+      sorted(changed));
+  expectLoaded(root, worldFile);
+  EXPECT_EQ(nullptr, root.WorldByIndex(0)->ModelByName("model_c"));
+  EXPECT_EQ(modelAElement,
+      root.WorldByIndex(0)->ModelByName("model_a")->Element());
+
+  // Another element of the world changed, which loads everything.
+  writeWorld("0 0 -1",
+      modelXml("model_a", "1 0 0 0 0 0") +
+      modelXml("model_b", "5 0 0 0 0 0") +
+      modelXml("model_d", "7 0 0 0 0 0"));
+  changed.clear();
+  EXPECT_TRUE(root.Reload(worldFile, config, changed).empty());
+  EXPECT_EQ(std::vector<std::string>({"default::included_model",
+      "default::model_a", "default::model_b", "default::model_d"}),
+      sorted(changed));
+  expectLoaded(root, worldFile);
+  EXPECT_EQ(ignition::math::Vector3d(0, 0, -1),
+      root.WorldByIndex(0)->Gravity());
+  EXPECT_NE(modelAElement,
+      root.WorldByIndex(0)->ModelByName("model_a")->Element());
+
+  removeDirectory(g_tempPath);
+}
+
+/////////////////////////////////////////////////
+TEST(Reload, InterleavedChildren)
+{
+  removeDirectory(g_tempPath);
+  ASSERT_TRUE(sdf::filesystem::create_directory(g_tempPath));
+  const std::string worldFile =
+      sdf::filesystem::append(g_tempPath, "world.sdf");
+
+  // The models are separated by other elements of the world.
+  auto writeInterleaved = [&worldFile](const std::string &_poseB,
+      const std::string &_extraModel)
+  {
+    writeFile(worldFile,
+        "<sdf version='1.7'>"
+        "  <world name='default'>"
+        + modelXml("model_a", "1 0 0 0 0 0") +
+        "    <light name='light_a' type='point'/>"
+        + modelXml("model_b", _poseB) +
+        "    <frame name='frame' attached_to='model_a'/>"
+        + _extraModel +
+        "    <light name='light_b' type='point'/>"
+        + modelXml("model_c", "3 0 0 0 0 0") +
+        "  </world>"
+        "</sdf>");
+  };
+  writeInterleaved("2 0 0 0 0 0", "");
+
+  sdf::ParserConfig config;
+  config.SetCompiledCacheDirectory("");
+  sdf::Root root;
+  std::vector<std::string> changed;
+  EXPECT_TRUE(root.Reload(worldFile, config, changed).empty());
+
+  // A changed model keeps its place among the lights and the frame.
+  writeInterleaved("5 0 0 0 0 0", "");
+  changed.clear();
+  EXPECT_TRUE(root.Reload(worldFile, config, changed).empty());
+  EXPECT_EQ(std::vector<std::string>({"default::model_b"}), changed);
+  expectLoaded(root, worldFile);
+
+  // So does an added model.
+  writeInterleaved("5 0 0 0 0 0", modelXml("model_d", "7 0 0 0 0 0"));
+  changed.clear();
+  EXPECT_TRUE(root.Reload(worldFile, config, changed).empty());
+  EXPECT_EQ(std::vector<std::string>({"default::model_d"}), changed);
+  expectLoaded(root, worldFile);
+
+  removeDirectory(g_tempPath);
+}
+
+/////////////////////////////////////////////////
+TEST(Reload, ResolvedUris)
+{
+  removeDirectory(g_tempPath);
+  ASSERT_TRUE(sdf::filesystem::create_directory(g_tempPath));
+
+  // Two directories hold a model of the same name with another pose.
+  for (const auto &[dir, pose] : {std::make_pair("models", "1 2 3 0 0 0"),
+       std::make_pair("other_models", "7 8 9 0 0 0")})
+  {
+    const std::string modelDir =
+        sdf::filesystem::append(g_tempPath, dir, "included_model");
+    ASSERT_TRUE(sdf::filesystem::create_directory(
+        sdf::filesystem::append(g_tempPath, dir)));
+    ASSERT_TRUE(sdf::filesystem::create_directory(modelDir));
+    writeFile(sdf::filesystem::append(modelDir, "model.config"),
+        "<model><name>included_model</name>"
+        "<sdf version='1.7'>model.sdf</sdf></model>");
+    writeFile(sdf::filesystem::append(modelDir, "model.sdf"),
+        "<sdf version='1.7'>"
+        "  <model name='included_model'>"
+        "    <pose>" + std::string(pose) + "</pose>"
+        "    <link name='link'/>"
+        "  </model>"
+        "</sdf>");
+  }
+  writeWorld("0 0 -9.8", modelXml("model_b", "2 0 0 0 0 0"));
+  const std::string worldFile =
+      sdf::filesystem::append(g_tempPath, "world.sdf");
+
+  sdf::setFindCallback(findFileCb);
+  sdf::ParserConfig config;
+  config.SetCompiledCacheDirectory("");
+  sdf::Root root;
+  std::vector<std::string> changed;
+  EXPECT_TRUE(root.Reload(worldFile, config, changed).empty());
+  EXPECT_EQ(ignition::math::Pose3d(1, 2, 3, 0, 0, 0),
+      root.WorldByIndex(0)->ModelByName("included_model")->RawPose());
+
+  // The include resolves to another directory, although no file changed.
+  sdf::setFindCallback([](const std::string &_input)
+  {
+    return sdf::filesystem::append(g_tempPath, "other_models",
+        _input.substr(std::string("model://").size()));
+  });
+  changed.clear();
+  EXPECT_TRUE(root.Reload(worldFile, config, changed).empty());
+  EXPECT_EQ(std::vector<std::string>({"default::included_model"}), changed);
+  EXPECT_EQ(ignition::math::Pose3d(7, 8, 9, 0, 0, 0),
+      root.WorldByIndex(0)->ModelByName("included_model")->RawPose());
+
+  sdf::setFindCallback(findFileCb);
+  removeDirectory(g_tempPath);
+}
+
+/////////////////////////////////////////////////
+TEST(Reload, Errors)
+{
+  removeDirectory(g_tempPath);
+  ASSERT_TRUE(sdf::filesystem::create_directory(g_tempPath));
+  const std::string worldFile =
+      sdf::filesystem::append(g_tempPath, "world.sdf");
+  sdf::setFindCallback([](const std::string &) { return std::string(); });
+
+  // The errors of a model that is not read again are reported again.
+  writeFile(worldFile,
+      "<sdf version='1.7'>"
+      "  <world name='default'>"
+      "    <include><uri>model://missing_model</uri></include>"
+      + modelXml("model_a", "1 0 0 0 0 0") +
+      "  </world>"
+      "</sdf>");
+  sdf::Root root;
+  std::vector<std::string> changed;
+  sdf::Errors errors = root.Reload(worldFile, sdf::ParserConfig(), changed);
+  ASSERT_FALSE(errors.empty());
+  EXPECT_EQ(sdf::ErrorCode::URI_LOOKUP, errors[0].Code());
+
+  writeFile(worldFile,
+      "<sdf version='1.7'>"
+      "  <world name='default'>"
+      "    <include><uri>model://missing_model</uri></include>"
+      + modelXml("model_a", "2 0 0 0 0 0") +
+      "  </world>"
+      "</sdf>");
+  changed.clear();
+  errors = root.Reload(worldFile, sdf::ParserConfig(), changed);
+  ASSERT_FALSE(errors.empty());
+  EXPECT_EQ(sdf::ErrorCode::URI_LOOKUP, errors[0].Code());
+  EXPECT_EQ(std::vector<std::string>({"default::model_a"}), changed);
+
+  // A file that can't be read keeps the loaded objects.
+  writeFile(worldFile, "<sdf version='1.7'><world name='default'>");
+  changed.clear();
+  errors = root.Reload(worldFile, sdf::ParserConfig(), changed);
+  ASSERT_FALSE(errors.empty());
+  EXPECT_EQ(sdf::ErrorCode::FILE_READ, errors.back().Code());
+  EXPECT_TRUE(changed.empty());
+  ASSERT_NE(nullptr, root.WorldByIndex(0));
+  EXPECT_EQ(ignition::math::Pose3d(2, 0, 0, 0, 0, 0),
+      root.WorldByIndex(0)->ModelByName("model_a")->RawPose());
+
+  removeDirectory(g_tempPath);
+}
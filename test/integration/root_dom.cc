@@ -21,9 +21,12 @@
 #include "sdf/Error.hh"
 #include "sdf/Filesystem.hh"
 #include "sdf/Model.hh"
+#include "sdf/ParserConfig.hh"
 #include "sdf/Root.hh"
+#include "sdf/SemanticPose.hh"
 #include "sdf/Types.hh"
 #include "sdf/World.hh"
+#include "sdf/parser.hh"
 #include "test_config.h"
 
 /////////////////////////////////////////////////
@@ -109,3 +112,135 @@ TEST(DOMRoot, LoadDuplicateModels)
   EXPECT_EQ(1u, root.ModelCount());
   EXPECT_EQ("robot1", root.ModelByIndex(0)->Name());
 }
+
+/////////////////////////////////////////////////
+TEST(DOMRoot, LazyLoad)
+{
+  const std::string testFile =
+    sdf::filesystem::append(PROJECT_SOURCE_PATH, "test", "sdf",
+        "world_frame_relative_to.sdf");
+
+  sdf::Root eager;
+  EXPECT_TRUE(eager.Load(testFile).empty());
+
+  sdf::ParserConfig config;
+  config.SetLazyLoad(true);
+  sdf::Root root;
+  EXPECT_TRUE(root.Load(testFile, config).empty());
+  EXPECT_NE(nullptr, root.Element());
+  EXPECT_TRUE(root.LazyLoadErrors().empty());
+
+  // The objects are loaded when they are first accessed, and are the same
+  // as the ones of an eager load.
+  ASSERT_EQ(1u, root.WorldCount());
+  const sdf::World *world = root.WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+  EXPECT_EQ("world_frame_relative_to", world->Name());
+  EXPECT_EQ(eager.WorldByIndex(0)->Gravity(), world->Gravity());
+  EXPECT_EQ(4u, world->ModelCount());
+  EXPECT_EQ(4u, world->FrameCount());
+  ASSERT_NE(nullptr, world->ModelByName("M3"));
+  EXPECT_EQ("M2", world->ModelByName("M3")->PoseRelativeTo());
+
+  for (uint64_t i = 0; i < world->ModelCount(); ++i)
+  {
+    const sdf::Model *model = world->ModelByIndex(i);
+    const sdf::Model *eagerModel = eager.WorldByIndex(0)->ModelByIndex(i);
+    ASSERT_NE(nullptr, model);
+    ASSERT_NE(nullptr, eagerModel);
+    EXPECT_EQ(eagerModel->Name(), model->Name());
+
+    ignition::math::Pose3d pose;
+    ignition::math::Pose3d eagerPose;
+    EXPECT_TRUE(model->SemanticPose().Resolve(pose).empty());
+    EXPECT_TRUE(eagerModel->SemanticPose().Resolve(eagerPose).empty());
+    EXPECT_EQ(eagerPose, pose);
+  }
+  EXPECT_TRUE(root.LazyLoadErrors().empty());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMRoot, LazyLoadErrors)
+{
+  const std::string testFile =
+    sdf::filesystem::append(PROJECT_SOURCE_PATH, "test", "sdf",
+        "world_frame_invalid_relative_to.sdf");
+
+  sdf::ParserConfig config;
+  config.SetLazyLoad(true);
+  sdf::Root root;
+  EXPECT_TRUE(root.Load(testFile, config).empty());
+  EXPECT_TRUE(root.LazyLoadErrors().empty());
+
+  // The world is kept, and the errors of its objects are reported once they
+  // are loaded.
+  ASSERT_EQ(1u, root.WorldCount());
+  EXPECT_TRUE(root.LazyLoadErrors().empty());
+  EXPECT_LT(0u, root.WorldByIndex(0)->ModelCount());
+  EXPECT_TRUE(root.LazyLoadErrors().empty());
+  root.WorldByIndex(0)->FrameCount();
+
+  const sdf::Errors errors = root.LazyLoadErrors();
+  EXPECT_EQ(10u, errors.size());
+  ASSERT_FALSE(errors.empty());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_INVALID, errors[0].Code());
+  EXPECT_EQ(errors.size(), root.WorldByIndex(0)->LazyLoadErrors().size());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMRoot, LazyLoadModels)
+{
+  const std::string sdfString =
+    "<sdf version='1.7'>"
+    "  <world name='default'>"
+    "    <model name='valid'>"
+    "      <link name='link'/>"
+    "    </model>"
+    "    <model name='no_links'/>"
+    "    <model name='valid'>"
+    "      <link name='link'/>"
+    "    </model>"
+    "  </world>"
+    "</sdf>";
+
+  sdf::SDFPtr sdfParsed(new sdf::SDF());
+  sdf::init(sdfParsed);
+  ASSERT_TRUE(sdf::readString(sdfString, sdfParsed));
+
+  // Duplicate names are found without loading the models.
+  sdf::ParserConfig config;
+  config.SetLazyLoad(true);
+  sdf::World world;
+  sdf::Errors errors =
+      world.Load(sdfParsed->Root()->GetElement("world"), config);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::DUPLICATE_NAME, errors[0].Code());
+
+  EXPECT_EQ(2u, world.ModelCount());
+  EXPECT_TRUE(world.ModelNameExists("no_links"));
+  EXPECT_FALSE(world.ModelNameExists("missing"));
+  EXPECT_EQ(nullptr, world.ModelByName("missing"));
+  EXPECT_TRUE(world.LazyLoadErrors().empty());
+
+  // Each model is loaded when it is first accessed, without the others.
+  const sdf::Model *valid = world.ModelByName("valid");
+  ASSERT_NE(nullptr, valid);
+  EXPECT_EQ("valid", valid->Name());
+  EXPECT_EQ(1u, valid->LinkCount());
+  EXPECT_TRUE(world.LazyLoadErrors().empty());
+
+  const sdf::Model *noLinks = world.ModelByIndex(1);
+  ASSERT_NE(nullptr, noLinks);
+  EXPECT_EQ("no_links", noLinks->Name());
+  errors = world.LazyLoadErrors();
+  ASSERT_FALSE(errors.empty());
+  EXPECT_EQ(sdf::ErrorCode::MODEL_WITHOUT_LINK, errors[0].Code());
+
+  // Loading the rest of the world keeps the loaded models.
+  EXPECT_EQ(0u, world.FrameCount());
+  EXPECT_EQ(valid, world.ModelByName("valid"));
+  EXPECT_EQ(valid, world.ModelByIndex(0));
+  EXPECT_EQ(noLinks, world.ModelByName("no_links"));
+  ignition::math::Pose3d pose;
+  EXPECT_TRUE(valid->SemanticPose().Resolve(pose).empty());
+}
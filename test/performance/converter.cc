@@ -0,0 +1,131 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <tinyxml.h>
+
+#include "sdf/Filesystem.hh"
+#include "Converter.hh"
+
+#include "test_config.h"
+
+/////////////////////////////////////////////////
+/// \brief Make a large SDF 1.5 world, with the elements that the recipes
+/// up to 1.8 convert.
+/// \param[in] _models Number of models.
+/// \return The XML of the world.
+std::string largeWorld(int _models)
+{
+  std::ostringstream xml;
+  xml << "<?xml version='1.0'?>\n<sdf version='1.5'>\n<world name='w'>\n"
+      << "  <physics type='ode'><gravity>0 0 -9.8</gravity></physics>\n";
+  for (int i = 0; i < _models; ++i)
+  {
+    xml << "  <model name='model_" << i << "'>\n"
+        << "    <pose frame='world'>" << i << " 0 0.5 0 0 0</pose>\n"
+        << "    <link name='base'>\n"
+        << "      <pose frame='model'>0 0 0 0 0 0</pose>\n"
+        << "      <collision name='collision'>\n"
+        << "        <geometry><box><size>1 1 1</size></box></geometry>\n"
+        << "      </collision>\n"
+        << "      <visual name='visual'>\n"
+        << "        <geometry><box><size>1 1 1</size></box></geometry>\n"
+        << "      </visual>\n"
+        << "      <sensor name='imu' type='imu'>\n"
+        << "        <imu><noise><type>gaussian</type>\n"
+        << "          <rate><mean>0</mean><stddev>0.1</stddev></rate>\n"
+        << "          <accel><mean>0</mean><stddev>0.2</stddev></accel>\n"
+        << "        </noise></imu>\n"
+        << "      </sensor>\n"
+        << "    </link>\n"
+        << "    <link name='arm'/>\n"
+        << "    <joint name='joint' type='revolute'>\n"
+        << "      <parent>base</parent><child>arm</child>\n"
+        << "      <axis><xyz>0 0 1</xyz>\n"
+        << "        <use_parent_model_frame>true</use_parent_model_frame>\n"
+        << "      </axis>\n"
+        << "    </joint>\n"
+        << "    <plugin name='p' filename='p.so'><pose>1 2 3</pose></plugin>\n"
+        << "  </model>\n";
+  }
+  xml << "</world>\n</sdf>\n";
+  return xml.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Print a document.
+/// \param[in] _doc The document.
+/// \return The XML of the document.
+std::string print(const TiXmlDocument &_doc)
+{
+  TiXmlPrinter printer;
+  _doc.Accept(&printer);
+  return printer.CStr();
+}
+
+/////////////////////////////////////////////////
+TEST(Converter, LargeWorld_performance)
+{
+  using Clock = std::chrono::steady_clock;
+
+  const std::string xml = largeWorld(2000);
+  const int runs = 5;
+
+  // Convert with each recipe of the source tree in turn, for comparison.
+  TiXmlDocument expected;
+  expected.Parse(xml.c_str());
+  ASSERT_FALSE(expected.Error());
+  std::chrono::duration<double, std::milli> stepTime{0};
+  for (const char *step : {"1.6/1_5", "1.7/1_6", "1.8/1_7"})
+  {
+    TiXmlDocument recipe;
+    const std::string filename = sdf::filesystem::append(
+        PROJECT_SOURCE_PATH, "sdf", std::string(step) + ".convert");
+    ASSERT_TRUE(recipe.LoadFile(filename.c_str()));
+    const auto start = Clock::now();
+    sdf::Converter::Convert(&expected, &recipe);
+    stepTime += Clock::now() - start;
+  }
+  expected.FirstChildElement("sdf")->SetAttribute("version", "1.8");
+
+  // Convert to 1.8 in a single traversal.
+  std::string converted;
+  std::chrono::duration<double, std::milli> time{0};
+  for (int i = 0; i < runs; ++i)
+  {
+    TiXmlDocument doc;
+    doc.Parse(xml.c_str());
+    ASSERT_FALSE(doc.Error());
+    const auto start = Clock::now();
+    ASSERT_TRUE(sdf::Converter::Convert(&doc, "1.8", true));
+    time += Clock::now() - start;
+    if (i == 0)
+      converted = print(doc);
+  }
+
+  EXPECT_EQ(print(expected), converted);
+
+  std::cout << "large 1.5 world (" << xml.size() << " bytes)\n"
+            << "  recipes one at a time: " << stepTime.count() << " ms\n"
+            << "  single traversal:      " << time.count() / runs
+            << " ms per run\n";
+}
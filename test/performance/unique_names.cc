@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "sdf/Element.hh"
+#include "sdf/Root.hh"
+#include "sdf/SDFImpl.hh"
+#include "sdf/World.hh"
+#include "sdf/parser.hh"
+
+/////////////////////////////////////////////////
+/// \brief Make a world with sibling models.
+/// \param[in] _models Number of models.
+/// \return The XML of the world.
+std::string siblingWorld(int _models)
+{
+  std::ostringstream xml;
+  xml << "<?xml version='1.0'?>\n<sdf version='1.8'>\n<world name='w'>\n";
+  for (int i = 0; i < _models; ++i)
+  {
+    xml << "  <model name='model_" << i << "'>"
+        << "<link name='link'/></model>\n";
+  }
+  xml << "</world>\n</sdf>\n";
+  return xml.str();
+}
+
+/////////////////////////////////////////////////
+TEST(UniqueNames, Siblings_performance)
+{
+  using Clock = std::chrono::steady_clock;
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+
+  for (int models : {1000, 10000, 100000})
+  {
+    sdf::SDFPtr sdfParsed(new sdf::SDF());
+    sdf::init(sdfParsed);
+    ASSERT_TRUE(sdf::readString(siblingWorld(models), sdfParsed));
+    sdf::ElementPtr world = sdfParsed->Root()->GetElement("world");
+
+    auto start = Clock::now();
+    EXPECT_TRUE(world->HasUniqueChildNames("model"));
+    const Milliseconds checkTime = Clock::now() - start;
+
+    start = Clock::now();
+    EXPECT_TRUE(sdf::recursiveSameTypeUniqueNames(world));
+    const Milliseconds recursiveTime = Clock::now() - start;
+
+    sdf::Root root;
+    start = Clock::now();
+    const sdf::Errors errors = root.Load(sdfParsed);
+    const Milliseconds loadTime = Clock::now() - start;
+    EXPECT_TRUE(errors.empty());
+    ASSERT_NE(nullptr, root.WorldByIndex(0));
+    EXPECT_EQ(static_cast<uint64_t>(models),
+        root.WorldByIndex(0)->ModelCount());
+
+    std::cout << models << " sibling models\n"
+              << "  HasUniqueChildNames:          " << checkTime.count()
+              << " ms\n"
+              << "  recursiveSameTypeUniqueNames: " << recursiveTime.count()
+              << " ms\n"
+              << "  Root::Load:                   " << loadTime.count()
+              << " ms (" << 1000 * loadTime.count() / models
+              << " us per model)\n";
+  }
+}
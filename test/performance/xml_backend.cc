@@ -0,0 +1,133 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <tinyxml.h>
+
+#include "sdf/sdf.hh"
+#include "XmlDocument.hh"
+#include "XmlReader.hh"
+
+#include "test_config.h"
+
+/////////////////////////////////////////////////
+/// \brief Count the elements and attributes of a tree, and the length of
+/// its text, to compare the results of both backends.
+/// \param[in] _elem Root of the tree.
+/// \return Sum of the counts.
+size_t countTree(sdf::XmlElementRef _elem)
+{
+  size_t count = 1 + _elem.Text().size();
+  for (sdf::XmlAttributeRef attr = _elem.FirstAttribute(); attr;
+       attr = attr.Next())
+  {
+    count += 1 + attr.Value().size();
+  }
+  for (sdf::XmlElementRef child = _elem.FirstChildElement(); child;
+       child = child.NextSiblingElement())
+  {
+    count += countTree(child);
+  }
+  return count;
+}
+
+/////////////////////////////////////////////////
+/// \brief Parse a text repeatedly with TinyXML and XmlDocument, and print
+/// the time of each.
+/// \param[in] _label Name of the text.
+/// \param[in] _xml The text.
+/// \param[in] _runs Number of parses with each backend.
+void compareBackends(const std::string &_label, const std::string &_xml,
+    int _runs)
+{
+  using Clock = std::chrono::steady_clock;
+
+  size_t tinyXmlCount = 0;
+  auto start = Clock::now();
+  for (int i = 0; i < _runs; ++i)
+  {
+    TiXmlDocument doc;
+    doc.Parse(_xml.c_str());
+    ASSERT_FALSE(doc.Error());
+    tinyXmlCount = countTree(doc.FirstChildElement());
+  }
+  const std::chrono::duration<double, std::milli> tinyXmlTime =
+      Clock::now() - start;
+
+  size_t inSituCount = 0;
+  sdf::XmlDocument doc;
+  start = Clock::now();
+  for (int i = 0; i < _runs; ++i)
+  {
+    ASSERT_TRUE(doc.Parse(_xml));
+    inSituCount = countTree(doc.FirstChildElement());
+  }
+  const std::chrono::duration<double, std::milli> inSituTime =
+      Clock::now() - start;
+
+  EXPECT_EQ(tinyXmlCount, inSituCount);
+
+  std::cout << _label << " (" << _xml.size() << " bytes, " << _runs
+            << " runs)\n"
+            << "  TinyXML:     " << tinyXmlTime.count() << " ms\n"
+            << "  XmlDocument: " << inSituTime.count() << " ms\n";
+}
+
+/////////////////////////////////////////////////
+TEST(XmlBackend, AtlasURDF_performance)
+{
+  const std::string filename = sdf::filesystem::append(PROJECT_SOURCE_PATH,
+      "test", "performance", "parser_urdf_atlas.urdf");
+  std::ifstream file(filename);
+  ASSERT_TRUE(file.good());
+  std::stringstream text;
+  text << file.rdbuf();
+
+  compareBackends("parser_urdf_atlas.urdf", text.str(), 50);
+}
+
+/////////////////////////////////////////////////
+TEST(XmlBackend, LargeWorld_performance)
+{
+  std::ostringstream xml;
+  xml << "<?xml version='1.0'?>\n<sdf version='1.7'>\n<world name='w'>\n";
+  for (int i = 0; i < 2000; ++i)
+  {
+    xml << "  <model name='model_" << i << "'>\n"
+        << "    <pose>" << i << " 0 0.5 0 0 0</pose>\n"
+        << "    <link name='link'>\n"
+        << "      <inertial><mass>1.0</mass></inertial>\n"
+        << "      <collision name='collision'>\n"
+        << "        <geometry><box><size>1 1 1</size></box></geometry>\n"
+        << "      </collision>\n"
+        << "      <visual name='visual'>\n"
+        << "        <geometry><box><size>1 1 1</size></box></geometry>\n"
+        << "        <material><ambient>0.3 0.3 0.3 1</ambient></material>\n"
+        << "      </visual>\n"
+        << "    </link>\n"
+        << "  </model>\n";
+  }
+  xml << "</world>\n</sdf>\n";
+
+  compareBackends("large world", xml.str(), 5);
+}
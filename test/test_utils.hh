@@ -0,0 +1,63 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef SDF_TEST_UTILS_HH_
+#define SDF_TEST_UTILS_HH_
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "sdf/Filesystem.hh"
+
+namespace sdf
+{
+namespace testing
+{
+/////////////////////////////////////////////////
+/// \brief Write a file.
+/// \param[in] _path Path of the file.
+/// \param[in] _contents Contents of the file.
+inline void writeFile(const std::string &_path, const std::string &_contents)
+{
+  std::ofstream out(_path);
+  out << _contents;
+}
+
+/////////////////////////////////////////////////
+/// \brief Remove the files of a directory, and the directory.
+/// \param[in] _path Path of the directory.
+inline void removeDirectory(const std::string &_path)
+{
+  std::vector<std::string> files;
+  for (sdf::filesystem::DirIter file(_path);
+       file != sdf::filesystem::DirIter(); ++file)
+  {
+    files.push_back(*file);
+  }
+  for (const std::string &file : files)
+  {
+    if (sdf::filesystem::is_directory(file))
+      removeDirectory(file);
+    else
+      std::remove(file.c_str());
+  }
+  std::remove(_path.c_str());
+}
+}
+}
+#endif